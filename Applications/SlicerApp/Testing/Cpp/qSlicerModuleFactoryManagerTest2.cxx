@@ -0,0 +1,212 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDir>
+#include <QFile>
+#include <QRegExp>
+#include <QTemporaryDir>
+
+// CTK includes
+#include <ctkAbstractFileBasedFactory.h>
+
+// SlicerApp includes
+#include <qSlicerAbstractCoreModule.h>
+#include <qSlicerCoreApplication.h>
+#include <qSlicerModuleFactoryManager.h>
+#include <qSlicerModuleManager.h>
+#include <vtkSlicerApplicationLogic.h>
+
+// MRML includes
+#include <vtkMRMLCoreTestingMacros.h>
+
+// VTK includes
+#include <vtkNew.h>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+class qSlicerTestModule : public qSlicerAbstractCoreModule
+{
+public:
+  QString title()const override { return this->name(); }
+  qSlicerAbstractModuleRepresentation* createWidgetRepresentation() override
+  {
+    return nullptr;
+  }
+  vtkMRMLAbstractLogic* createLogic() override
+  {
+    return nullptr;
+  }
+protected:
+  void setup() override {}
+};
+
+//-----------------------------------------------------------------------------
+class qSlicerTestModuleFactoryItem
+  : public ctkAbstractFactoryFileBasedItem<qSlicerAbstractCoreModule>
+{
+public:
+  bool load() override { return true; }
+protected:
+  qSlicerAbstractCoreModule* instanciator() override
+  {
+    qSlicerTestModule* module = new qSlicerTestModule;
+    module->setPath(this->path());
+    return module;
+  }
+};
+
+//-----------------------------------------------------------------------------
+/// Recognize the "<ModuleName>.testmodule" files.
+class qSlicerTestModuleFactory
+  : public ctkAbstractFileBasedFactory<qSlicerAbstractCoreModule>
+{
+public:
+  QString fileNameToKey(const QString& fileName)const override
+  {
+    return QFileInfo(fileName).completeBaseName();
+  }
+protected:
+  bool isValidFile(const QFileInfo& file)const override
+  {
+    return file.suffix() == "testmodule";
+  }
+  ctkAbstractFactoryItem<qSlicerAbstractCoreModule>* createFactoryFileBasedItem() override
+  {
+    return new qSlicerTestModuleFactoryItem;
+  }
+};
+
+//-----------------------------------------------------------------------------
+bool createFile(const QString& fileName)
+{
+  QFile file(fileName);
+  return file.open(QIODevice::WriteOnly);
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int qSlicerModuleFactoryManagerTest2(int argc, char * argv[])
+{
+  qSlicerCoreApplication app(argc, argv);
+  Q_UNUSED(app);
+
+  // Search path i contains modules Module0 to Module<i>: Module<i> is first
+  // found in Path<i> and then in all the following paths, the first path must
+  // win even though the paths are scanned in parallel.
+  QTemporaryDir temporaryDir;
+  CHECK_BOOL(temporaryDir.isValid(), true);
+  const int numberOfPaths = 8;
+  QStringList searchPaths;
+  for (int pathIndex = 0; pathIndex < numberOfPaths; ++pathIndex)
+    {
+    QString path = temporaryDir.path() + QString("/Path%1").arg(pathIndex);
+    CHECK_BOOL(QDir().mkpath(path), true);
+    for (int moduleIndex = 0; moduleIndex <= pathIndex; ++moduleIndex)
+      {
+      CHECK_BOOL(createFile(path + QString("/Module%1.testmodule").arg(moduleIndex)), true);
+      }
+    // Not a module
+    CHECK_BOOL(createFile(path + "/README.txt"), true);
+    searchPaths << path;
+    }
+
+  qSlicerModuleManager moduleManager;
+  qSlicerModuleFactoryManager* factoryManager = moduleManager.factoryManager();
+  vtkNew<vtkSlicerApplicationLogic> appLogic;
+  factoryManager->setAppLogic(appLogic);
+  factoryManager->registerFactory(new qSlicerTestModuleFactory);
+  factoryManager->setSearchPaths(searchPaths);
+
+  QStringList registrationOrder;
+  QObject::connect(factoryManager, &qSlicerModuleFactoryManager::moduleRegistered,
+                   [&registrationOrder](const QString& moduleName) { registrationOrder << moduleName; });
+  factoryManager->registerModules();
+
+  // Modules are registered in search path order
+  QStringList expectedRegistrationOrder;
+  for (int moduleIndex = 0; moduleIndex < numberOfPaths; ++moduleIndex)
+    {
+    expectedRegistrationOrder << QString("Module%1").arg(moduleIndex);
+    }
+  CHECK_BOOL(registrationOrder == expectedRegistrationOrder, true);
+  CHECK_INT(factoryManager->registeredModuleNames().count(), numberOfPaths);
+
+  // Modules to load on demand are instantiated but not loaded
+  factoryManager->setModulesToLoadOnDemand(QStringList() << "Module1" << "Module5");
+  factoryManager->instantiateModules();
+  CHECK_INT(factoryManager->instantiatedModuleNames().count(), numberOfPaths);
+  for (int moduleIndex = 0; moduleIndex < numberOfPaths; ++moduleIndex)
+    {
+    // Module<i> is first found in Path<i>
+    QString moduleName = QString("Module%1").arg(moduleIndex);
+    qSlicerAbstractCoreModule* module = factoryManager->moduleInstance(moduleName);
+    CHECK_NOT_NULL(module);
+    CHECK_BOOL(QFileInfo(module->path()).absolutePath() == QFileInfo(searchPaths[moduleIndex]).absoluteFilePath(), true);
+    }
+  CHECK_INT(factoryManager->modulesToLoad().count(), numberOfPaths - 2);
+  CHECK_BOOL(factoryManager->modulesToLoad().contains("Module1"), false);
+  CHECK_INT(factoryManager->loadModules(), numberOfPaths - 2);
+  CHECK_BOOL(factoryManager->isLoaded("Module0"), true);
+  CHECK_BOOL(factoryManager->isLoadDeferred("Module0"), false);
+  CHECK_BOOL(factoryManager->isLoaded("Module1"), false);
+  CHECK_BOOL(factoryManager->isLoadDeferred("Module1"), true);
+  CHECK_BOOL(factoryManager->isLoadDeferred("NonExistentModule"), false);
+
+  // module() has no side effect
+  CHECK_NOT_NULL(moduleManager.module("Module0"));
+  CHECK_NULL(moduleManager.module("Module1"));
+  CHECK_BOOL(factoryManager->isLoadDeferred("Module1"), true);
+
+  // loadDeferredModule() loads the module the first time only
+  qSlicerAbstractCoreModule* deferredModule = moduleManager.loadDeferredModule("Module1");
+  CHECK_NOT_NULL(deferredModule);
+  CHECK_BOOL(factoryManager->isLoaded("Module1"), true);
+  CHECK_BOOL(factoryManager->isLoadDeferred("Module1"), false);
+  CHECK_POINTER(moduleManager.loadDeferredModule("Module1"), deferredModule);
+  CHECK_POINTER(moduleManager.module("Module1"), deferredModule);
+  // Loaded modules are returned as is
+  CHECK_POINTER(moduleManager.loadDeferredModule("Module0"), moduleManager.module("Module0"));
+  CHECK_NULL(moduleManager.loadDeferredModule("NonExistentModule"));
+  CHECK_BOOL(factoryManager->isLoadDeferred("Module5"), true);
+
+  // The timeline lists every step and every module
+  QString report = factoryManager->startupTimelineReport();
+  std::cout << qPrintable(report) << std::endl;
+  CHECK_BOOL(report.startsWith("Module startup timeline:"), true);
+  CHECK_BOOL(report.contains("  Search: "), true);
+  CHECK_BOOL(report.contains("  Instantiate: "), true);
+  CHECK_BOOL(report.contains("  Load: "), true);
+  CHECK_BOOL(report.contains("Cost per module:"), true);
+  foreach(const QString& path, searchPaths)
+    {
+    CHECK_BOOL(report.contains(path), true);
+    }
+  for (int moduleIndex = 0; moduleIndex < numberOfPaths; ++moduleIndex)
+    {
+    CHECK_BOOL(report.contains(QString(" Module%1 (Instantiate ").arg(moduleIndex)), true);
+    }
+  // Module5 is not loaded, it has no "Load" event
+  CHECK_BOOL(report.contains(" Module5 (Instantiate ") && !report.contains(QRegExp(" Module5 \\([^)]*Load ")), true);
+
+  factoryManager->unloadModules();
+
+  return EXIT_SUCCESS;
+}
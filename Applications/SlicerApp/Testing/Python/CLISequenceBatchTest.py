@@ -0,0 +1,165 @@
+import time
+
+import numpy as np
+
+import slicer
+from slicer.ScriptedLoadableModule import *
+
+
+#
+# CLISequenceBatchTest
+#
+
+class CLISequenceBatchTest(ScriptedLoadableModule):
+    def __init__(self, parent):
+        parent.title = "CLISequenceBatchTest"
+        parent.categories = ["Testing.TestCases"]
+        parent.dependencies = ["ThresholdScalarVolume"]
+        parent.contributors = ["3D Slicer Community"]
+        parent.helpText = """
+    This is a self test that runs a CLI on every frame of a sequence with
+    vtkSlicerCLIModuleLogic::ApplyToSequence().
+    """
+        parent.acknowledgementText = """"""
+        self.parent = parent
+
+        # Add this test to the SelfTest module's list for discovery when the module
+        # is created.  Since this module may be discovered before SelfTests itself,
+        # create the list if it doesn't already exist.
+        try:
+            slicer.selfTests
+        except AttributeError:
+            slicer.selfTests = {}
+        slicer.selfTests['CLISequenceBatchTest'] = self.runTest
+
+    def runTest(self):
+        tester = CLISequenceBatchTestTest()
+        tester.runTest()
+
+
+#
+# CLISequenceBatchTestWidget
+#
+
+class CLISequenceBatchTestWidget(ScriptedLoadableModuleWidget):
+
+    def setup(self):
+        ScriptedLoadableModuleWidget.setup(self)
+
+
+#
+# CLISequenceBatchTestTest
+#
+
+class CLISequenceBatchTestTest(ScriptedLoadableModuleTest):
+
+    numberOfFrames = 4
+    lower = -50
+    upper = 300
+    outsideValue = -1000
+
+    def setUp(self):
+        """ Reset the state for testing.
+        """
+        slicer.mrmlScene.Clear(0)
+
+    def runTest(self):
+        """Run as few or as many tests as needed here.
+        """
+        self.setUp()
+        self.test_ApplyToSequence()
+        self.setUp()
+        self.test_ApplyToSequenceCancel()
+
+    def createInputSequence(self):
+        """Create a sequence of small volumes, the source volumes are not kept in the scene."""
+        sequenceNode = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLSequenceNode", "Input")
+        sequenceNode.SetIndexName("time")
+        sequenceNode.SetIndexUnit("s")
+        frames = []
+        randomState = np.random.RandomState(42)
+        for frameIndex in range(self.numberOfFrames):
+            voxels = randomState.randint(-500, 1000, size=(6, 7, 8)).astype(np.int16)
+            volumeNode = slicer.util.addVolumeFromArray(voxels, name=f"Frame{frameIndex}")
+            indexValue = str(frameIndex * 0.5)
+            sequenceNode.SetDataNodeAtValue(volumeNode, indexValue)
+            slicer.mrmlScene.RemoveNode(volumeNode)
+            frames.append((indexValue, voxels))
+        return sequenceNode, frames
+
+    def createCLINode(self):
+        parameters = {
+            "ThresholdType": "Outside",
+            "Lower": self.lower,
+            "Upper": self.upper,
+            "OutsideValue": self.outsideValue,
+        }
+        return slicer.cli.createNode(slicer.modules.thresholdscalarvolume, parameters)
+
+    def waitForCompletion(self, cliNode, timeout=60.0):
+        """ApplyToSequence is non blocking, the frames are scheduled from the event loop."""
+        startTime = time.time()
+        while cliNode.IsBusy():
+            self.assertLess(time.time() - startTime, timeout, "Sequence processing timed out")
+            slicer.app.processEvents()
+            time.sleep(0.01)
+
+    def assertNoFrameNodesLeft(self):
+        # Only the CLI node given to ApplyToSequence remains, frame nodes are removed
+        self.assertEqual(slicer.mrmlScene.GetNodesByClass("vtkMRMLCommandLineModuleNode").GetNumberOfItems(), 1)
+        self.assertEqual(slicer.mrmlScene.GetNodesByClass("vtkMRMLScalarVolumeNode").GetNumberOfItems(), 0)
+
+    def test_ApplyToSequence(self):
+        self.delayDisplay('Running CLI on every frame of a sequence')
+
+        inputSequence, frames = self.createInputSequence()
+        outputSequence = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLSequenceNode", "Output")
+        cliNode = self.createCLINode()
+        logic = slicer.modules.thresholdscalarvolume.logic()
+
+        # frames are processed two at a time
+        self.assertTrue(logic.ApplyToSequence(cliNode, "InputVolume", inputSequence, "OutputVolume", outputSequence, 2))
+        self.waitForCompletion(cliNode)
+        self.assertEqual(cliNode.GetStatusString(), "Completed")
+
+        self.assertEqual(outputSequence.GetIndexName(), "time")
+        self.assertEqual(outputSequence.GetIndexUnit(), "s")
+        self.assertEqual(outputSequence.GetNumberOfDataNodes(), self.numberOfFrames)
+        for indexValue, voxels in frames:
+            outputVolume = outputSequence.GetDataNodeAtValue(indexValue)
+            self.assertIsNotNone(outputVolume, f"Missing output frame {indexValue}")
+            self.assertTrue(outputVolume.IsA("vtkMRMLScalarVolumeNode"))
+            expected = voxels.copy()
+            expected[(voxels < self.lower) | (voxels > self.upper)] = self.outsideValue
+            self.assertTrue(np.array_equal(slicer.util.arrayFromVolume(outputVolume), expected))
+
+        self.assertNoFrameNodesLeft()
+
+        # A busy node cannot process another sequence
+        self.assertTrue(logic.ApplyToSequence(cliNode, "InputVolume", inputSequence, "OutputVolume", outputSequence, 1))
+        self.assertTrue(cliNode.IsBusy())
+        self.assertFalse(logic.ApplyToSequence(cliNode, "InputVolume", inputSequence, "OutputVolume", outputSequence, 1))
+        self.waitForCompletion(cliNode)
+        self.assertEqual(cliNode.GetStatusString(), "Completed")
+        # output frames are replaced
+        self.assertEqual(outputSequence.GetNumberOfDataNodes(), self.numberOfFrames)
+
+        self.delayDisplay('Test passed')
+
+    def test_ApplyToSequenceCancel(self):
+        self.delayDisplay('Cancelling the processing of a sequence')
+
+        inputSequence, frames = self.createInputSequence()
+        outputSequence = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLSequenceNode", "Output")
+        cliNode = self.createCLINode()
+        logic = slicer.modules.thresholdscalarvolume.logic()
+
+        self.assertTrue(logic.ApplyToSequence(cliNode, "InputVolume", inputSequence, "OutputVolume", outputSequence, 1))
+        cliNode.Cancel()
+        self.waitForCompletion(cliNode)
+        self.assertEqual(cliNode.GetStatusString(), "Cancelled")
+        # At most the frame that was running when the processing was cancelled is stored
+        self.assertLessEqual(outputSequence.GetNumberOfDataNodes(), 1)
+        self.assertNoFrameNodesLeft()
+
+        self.delayDisplay('Test passed')
@@ -0,0 +1,169 @@
+import os
+import subprocess
+
+import numpy as np
+import vtk
+
+import slicer
+from slicer.ScriptedLoadableModule import *
+
+
+#
+# CLISharedMemoryTransferTest
+#
+
+class CLISharedMemoryTransferTest(ScriptedLoadableModule):
+    def __init__(self, parent):
+        parent.title = "CLISharedMemoryTransferTest"
+        parent.categories = ["Testing.TestCases"]
+        parent.dependencies = ["ThresholdScalarVolume"]
+        parent.contributors = ["3D Slicer Community"]
+        parent.helpText = """
+    This is a self test that checks that input volumes passed to a CLI through shared memory
+    give the same result as volumes passed through temporary files.
+    """
+        parent.acknowledgementText = """"""
+        self.parent = parent
+
+        # Add this test to the SelfTest module's list for discovery when the module
+        # is created.  Since this module may be discovered before SelfTests itself,
+        # create the list if it doesn't already exist.
+        try:
+            slicer.selfTests
+        except AttributeError:
+            slicer.selfTests = {}
+        slicer.selfTests['CLISharedMemoryTransferTest'] = self.runTest
+
+    def runTest(self):
+        tester = CLISharedMemoryTransferTestTest()
+        tester.runTest()
+
+
+#
+# CLISharedMemoryTransferTestWidget
+#
+
+class CLISharedMemoryTransferTestWidget(ScriptedLoadableModuleWidget):
+
+    def setup(self):
+        ScriptedLoadableModuleWidget.setup(self)
+
+
+#
+# CLISharedMemoryTransferTestTest
+#
+
+class CLISharedMemoryTransferTestTest(ScriptedLoadableModuleTest):
+
+    lower = -50
+    upper = 300
+    outsideValue = -1000
+
+    def setUp(self):
+        """ Reset the state for testing.
+        """
+        slicer.mrmlScene.Clear(0)
+
+    def runTest(self):
+        """Run as few or as many tests as needed here.
+        """
+        self.setUp()
+        self.test_CLISharedMemoryTransfer()
+        self.setUp()
+        self.test_SharedMemoryImageIO()
+
+    def createInputVolume(self):
+        voxels = np.random.RandomState(42).randint(-500, 1000, size=(12, 17, 23)).astype(np.int16)
+        # rotated, anisotropic geometry to detect any RAS/LPS or axis order mistake
+        ijkToRAS = np.array([[0.0, -0.8, 0.0, 10.5],
+                             [0.5, 0.0, 0.0, -20.25],
+                             [0.0, 0.0, 1.2, 30.0],
+                             [0.0, 0.0, 0.0, 1.0]])
+        volumeNode = slicer.util.addVolumeFromArray(voxels, ijkToRAS, name="Input")
+        return volumeNode, voxels, ijkToRAS
+
+    def expectedOutput(self, voxels):
+        expected = voxels.copy()
+        expected[(voxels < self.lower) | (voxels > self.upper)] = self.outsideValue
+        return expected
+
+    def assertVolume(self, volumeNode, expectedVoxels, expectedIJKToRAS):
+        self.assertTrue(np.array_equal(slicer.util.arrayFromVolume(volumeNode), expectedVoxels))
+        ijkToRAS = vtk.vtkMatrix4x4()
+        volumeNode.GetIJKToRASMatrix(ijkToRAS)
+        self.assertTrue(np.allclose(slicer.util.arrayFromVTKMatrix(ijkToRAS), expectedIJKToRAS, atol=1e-6))
+
+    def runThreshold(self, inputVolume, outputName):
+        outputVolume = slicer.mrmlScene.AddNewNodeByClass("vtkMRMLScalarVolumeNode", outputName)
+        parameters = {
+            "InputVolume": inputVolume.GetID(),
+            "OutputVolume": outputVolume.GetID(),
+            "ThresholdType": "Outside",
+            "Lower": self.lower,
+            "Upper": self.upper,
+            "OutsideValue": self.outsideValue,
+        }
+        cliNode = slicer.cli.runSync(slicer.modules.thresholdscalarvolume, None, parameters)
+        self.assertEqual(cliNode.GetStatusString(), "Completed")
+        slicer.mrmlScene.RemoveNode(cliNode)
+        return outputVolume
+
+    def test_CLISharedMemoryTransfer(self):
+        self.delayDisplay('Running CLI with shared memory and with file transfer')
+
+        logic = slicer.modules.thresholdscalarvolume.logic()
+        # enabled by the hidden AllowSharedMemoryTransfer parameter in the module description
+        self.assertEqual(logic.GetAllowSharedMemoryTransfer(), 1)
+
+        inputVolume, voxels, ijkToRAS = self.createInputVolume()
+        expected = self.expectedOutput(voxels)
+
+        sharedMemoryOutput = self.runThreshold(inputVolume, "SharedMemoryOutput")
+        self.assertVolume(sharedMemoryOutput, expected, ijkToRAS)
+
+        logic.SetAllowSharedMemoryTransfer(0)
+        try:
+            fileOutput = self.runThreshold(inputVolume, "FileOutput")
+        finally:
+            logic.SetAllowSharedMemoryTransfer(1)
+        self.assertVolume(fileOutput, expected, ijkToRAS)
+
+        self.delayDisplay('Test passed')
+
+    def test_SharedMemoryImageIO(self):
+        """Run the executable directly with a shared memory URI as input, to make sure
+        that the volume is read from the segment by the MRMLSharedMemoryImageIO.
+        """
+        if not slicer.vtkMRMLVolumeSharedMemory.IsSupported():
+            self.delayDisplay('Shared memory is not supported on this platform')
+            return
+        self.delayDisplay('Running CLI executable with a shared memory URI')
+
+        inputVolume, voxels, ijkToRAS = self.createInputVolume()
+        uri = slicer.vtkMRMLVolumeSharedMemory.GenerateUniqueURI()
+        self.assertTrue(uri.startswith("slicershm:/slicer_"))
+        ijkToRASMatrix = vtk.vtkMatrix4x4()
+        inputVolume.GetIJKToRASMatrix(ijkToRASMatrix)
+        self.assertTrue(slicer.vtkMRMLVolumeSharedMemory.WriteVolume(uri, inputVolume.GetImageData(), ijkToRASMatrix))
+
+        outputFileName = os.path.join(slicer.app.temporaryPath, "CLISharedMemoryTransferTestOutput.nrrd")
+        try:
+            result = subprocess.run([slicer.modules.thresholdscalarvolume.path,
+                                     "--thresholdtype", "Outside",
+                                     "--lower", str(self.lower),
+                                     "--upper", str(self.upper),
+                                     "--outsidevalue", str(self.outsideValue),
+                                     uri, outputFileName],
+                                    stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+        finally:
+            self.assertTrue(slicer.vtkMRMLVolumeSharedMemory.Remove(uri))
+        self.assertEqual(result.returncode, 0, result.stdout)
+
+        outputVolume = slicer.util.loadVolume(outputFileName)
+        os.remove(outputFileName)
+        self.assertVolume(outputVolume, self.expectedOutput(voxels), ijkToRAS)
+
+        # segment is removed, it cannot be read anymore
+        self.assertFalse(slicer.vtkMRMLVolumeSharedMemory().Open(uri))
+
+        self.delayDisplay('Test passed')
@@ -0,0 +1,306 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Slicer includes
+#include "vtkSlicerApplicationLogic.h"
+#include "vtkSlicerTask.h"
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+
+// ITK includes
+#include <itksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Logic running blocking tasks: a task records its start and waits until
+/// the tasks are released.
+class vtkTestTaskLogic : public vtkMRMLAbstractLogic
+{
+public:
+  static vtkTestTaskLogic *New();
+  vtkTypeMacro(vtkTestTaskLogic, vtkMRMLAbstractLogic);
+
+  void RunTask(void* clientData)
+  {
+    int taskId = *static_cast<int*>(clientData);
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    this->StartOrder.push_back(taskId);
+    this->NumberOfRunningTasks++;
+    this->MaximumNumberOfRunningTasks =
+      std::max(this->MaximumNumberOfRunningTasks, this->NumberOfRunningTasks);
+    this->Condition.notify_all();
+    this->Condition.wait_for(lock, std::chrono::seconds(30), [this] { return this->Released; });
+    this->NumberOfRunningTasks--;
+    this->NumberOfFinishedTasks++;
+    this->Condition.notify_all();
+  }
+
+  void Reset()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->StartOrder.clear();
+    this->MaximumNumberOfRunningTasks = 0;
+    this->NumberOfFinishedTasks = 0;
+    this->Released = false;
+  }
+
+  void Release()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Released = true;
+    this->Condition.notify_all();
+  }
+
+  bool WaitForStartedTasks(size_t numberOfTasks)
+  {
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    return this->Condition.wait_for(lock, std::chrono::seconds(30),
+      [this, numberOfTasks] { return this->StartOrder.size() >= numberOfTasks; });
+  }
+
+  bool WaitForFinishedTasks(int numberOfTasks)
+  {
+    std::unique_lock<std::mutex> lock(this->Mutex);
+    return this->Condition.wait_for(lock, std::chrono::seconds(30),
+      [this, numberOfTasks] { return this->NumberOfFinishedTasks >= numberOfTasks; });
+  }
+
+  std::vector<int> GetStartOrder()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    return this->StartOrder;
+  }
+
+  int GetMaximumNumberOfRunningTasks()
+  {
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    return this->MaximumNumberOfRunningTasks;
+  }
+
+protected:
+  vtkTestTaskLogic() = default;
+  ~vtkTestTaskLogic() override = default;
+
+  std::mutex Mutex;
+  std::condition_variable Condition;
+  std::vector<int> StartOrder;
+  int NumberOfRunningTasks{0};
+  int MaximumNumberOfRunningTasks{0};
+  int NumberOfFinishedTasks{0};
+  bool Released{false};
+};
+vtkStandardNewMacro(vtkTestTaskLogic);
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkSlicerTask> CreateTask(vtkTestTaskLogic* logic, int* taskId,
+                                          int priority = 0, int numberOfThreads = 1)
+{
+  vtkSmartPointer<vtkSlicerTask> task = vtkSmartPointer<vtkSlicerTask>::New();
+  task->SetTypeToProcessing();
+  task->SetTaskFunction(logic, (vtkSlicerTask::TaskFunctionPointer)&vtkTestTaskLogic::RunTask, taskId);
+  task->SetPriority(priority);
+  task->SetNumberOfThreads(numberOfThreads);
+  return task;
+}
+
+//----------------------------------------------------------------------------
+int TestDefaults(vtkSlicerApplicationLogic* appLogic)
+{
+  if (!itksys::SystemTools::GetEnv("SLICER_MAX_PROCESSING_TASKS"))
+    {
+    CHECK_INT(appLogic->GetMaximumNumberOfProcessingTasks(), 1);
+    }
+  appLogic->SetMaximumNumberOfProcessingTasks(0);
+  CHECK_INT(appLogic->GetMaximumNumberOfProcessingTasks(), 1);
+  appLogic->SetMaximumNumberOfProcessingTasks(1000);
+  CHECK_INT(appLogic->GetMaximumNumberOfProcessingTasks(), 64);
+  appLogic->SetMaximumNumberOfProcessingTasks(1);
+  CHECK_INT(appLogic->GetNumberOfRunningProcessingTasks(), 0);
+
+  // Tasks are not scheduled while the processing threads are not running
+  vtkNew<vtkTestTaskLogic> logic;
+  int taskId = 0;
+  vtkSmartPointer<vtkSlicerTask> task = CreateTask(logic, &taskId);
+  CHECK_BOOL(appLogic->ScheduleTask(task), false);
+  CHECK_INT(task->GetQueuePosition(), -1);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestPriorityAndCancellation(vtkSlicerApplicationLogic* appLogic)
+{
+  vtkNew<vtkTestTaskLogic> logic;
+  appLogic->SetMaximumNumberOfProcessingTasks(1);
+
+  int taskIds[] = {0, 1, 2, 3, 4};
+  vtkSmartPointer<vtkSlicerTask> blockingTask = CreateTask(logic, &taskIds[0]);
+  CHECK_BOOL(appLogic->ScheduleTask(blockingTask), true);
+  CHECK_BOOL(logic->WaitForStartedTasks(1), true);
+  CHECK_INT(blockingTask->GetQueuePosition(), -1);
+
+  // Queued tasks are sorted by decreasing priority, then by scheduling order
+  vtkSmartPointer<vtkSlicerTask> normalTask = CreateTask(logic, &taskIds[1], 0);
+  vtkSmartPointer<vtkSlicerTask> urgentTask = CreateTask(logic, &taskIds[2], 5);
+  vtkSmartPointer<vtkSlicerTask> cancelledTask = CreateTask(logic, &taskIds[3], 5);
+  vtkSmartPointer<vtkSlicerTask> lowTask = CreateTask(logic, &taskIds[4], -1);
+  CHECK_BOOL(appLogic->ScheduleTask(normalTask), true);
+  CHECK_BOOL(appLogic->ScheduleTask(urgentTask), true);
+  CHECK_BOOL(appLogic->ScheduleTask(cancelledTask), true);
+  CHECK_BOOL(appLogic->ScheduleTask(lowTask), true);
+  CHECK_INT(urgentTask->GetQueuePosition(), 0);
+  CHECK_INT(cancelledTask->GetQueuePosition(), 1);
+  CHECK_INT(normalTask->GetQueuePosition(), 2);
+  CHECK_INT(lowTask->GetQueuePosition(), 3);
+
+  // A queued task can be cancelled, the following tasks move up
+  CHECK_BOOL(appLogic->CancelTask(cancelledTask), true);
+  CHECK_INT(cancelledTask->GetQueuePosition(), -1);
+  CHECK_INT(urgentTask->GetQueuePosition(), 0);
+  CHECK_INT(normalTask->GetQueuePosition(), 1);
+  CHECK_INT(lowTask->GetQueuePosition(), 2);
+  CHECK_BOOL(appLogic->CancelTask(cancelledTask), false);
+  // A running task cannot be cancelled
+  CHECK_BOOL(appLogic->CancelTask(blockingTask), false);
+
+  // Only one task runs at a time
+  itksys::SystemTools::Delay(300);
+  CHECK_INT(static_cast<int>(logic->GetStartOrder().size()), 1);
+  CHECK_INT(appLogic->GetNumberOfRunningProcessingTasks(), 1);
+
+  logic->Release();
+  CHECK_BOOL(logic->WaitForFinishedTasks(4), true);
+  std::vector<int> expectedStartOrder = {0, 2, 1, 4};
+  CHECK_BOOL(logic->GetStartOrder() == expectedStartOrder, true);
+  CHECK_INT(logic->GetMaximumNumberOfRunningTasks(), 1);
+  CHECK_INT(lowTask->GetQueuePosition(), -1);
+  // A completed task cannot be cancelled
+  CHECK_BOOL(appLogic->CancelTask(lowTask), false);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestConcurrencyLimit(vtkSlicerApplicationLogic* appLogic)
+{
+  vtkNew<vtkTestTaskLogic> logic;
+  // Spawns the missing processing threads
+  appLogic->SetMaximumNumberOfProcessingTasks(3);
+  CHECK_INT(appLogic->GetMaximumNumberOfProcessingTasks(), 3);
+
+  const int numberOfTasks = 6;
+  int taskIds[numberOfTasks];
+  std::vector<vtkSmartPointer<vtkSlicerTask> > tasks;
+  for (int taskIndex = 0; taskIndex < numberOfTasks; ++taskIndex)
+    {
+    taskIds[taskIndex] = taskIndex;
+    tasks.push_back(CreateTask(logic, &taskIds[taskIndex]));
+    CHECK_BOOL(appLogic->ScheduleTask(tasks.back()), true);
+    }
+
+  CHECK_BOOL(logic->WaitForStartedTasks(3), true);
+  itksys::SystemTools::Delay(300);
+  CHECK_INT(static_cast<int>(logic->GetStartOrder().size()), 3);
+  CHECK_INT(appLogic->GetNumberOfRunningProcessingTasks(), 3);
+  CHECK_INT(tasks[3]->GetQueuePosition(), 0);
+  CHECK_INT(tasks[5]->GetQueuePosition(), 2);
+
+  logic->Release();
+  CHECK_BOOL(logic->WaitForFinishedTasks(numberOfTasks), true);
+  CHECK_INT(logic->GetMaximumNumberOfRunningTasks(), 3);
+  CHECK_INT(static_cast<int>(logic->GetStartOrder().size()), numberOfTasks);
+
+  // Threads that are not needed anymore stay idle
+  logic->Reset();
+  appLogic->SetMaximumNumberOfProcessingTasks(2);
+  for (int taskIndex = 0; taskIndex < numberOfTasks; ++taskIndex)
+    {
+    CHECK_BOOL(appLogic->ScheduleTask(tasks[taskIndex]), true);
+    }
+  CHECK_BOOL(logic->WaitForStartedTasks(2), true);
+  itksys::SystemTools::Delay(300);
+  CHECK_INT(static_cast<int>(logic->GetStartOrder().size()), 2);
+  logic->Release();
+  CHECK_BOOL(logic->WaitForFinishedTasks(numberOfTasks), true);
+  CHECK_INT(logic->GetMaximumNumberOfRunningTasks(), 2);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestThreadBudget(vtkSlicerApplicationLogic* appLogic)
+{
+  vtkNew<vtkTestTaskLogic> logic;
+  appLogic->SetMaximumNumberOfProcessingTasks(3);
+  appLogic->SetProcessingThreadBudget(4);
+
+  // The second task does not fit in the budget while the first one runs,
+  // and the third task does not overtake it.
+  int taskIds[] = {0, 1, 2};
+  vtkSmartPointer<vtkSlicerTask> firstTask = CreateTask(logic, &taskIds[0], 0, 3);
+  vtkSmartPointer<vtkSlicerTask> secondTask = CreateTask(logic, &taskIds[1], 0, 3);
+  vtkSmartPointer<vtkSlicerTask> thirdTask = CreateTask(logic, &taskIds[2], 0, 1);
+  CHECK_BOOL(appLogic->ScheduleTask(firstTask), true);
+  CHECK_BOOL(logic->WaitForStartedTasks(1), true);
+  CHECK_BOOL(appLogic->ScheduleTask(secondTask), true);
+  CHECK_BOOL(appLogic->ScheduleTask(thirdTask), true);
+
+  itksys::SystemTools::Delay(300);
+  CHECK_INT(static_cast<int>(logic->GetStartOrder().size()), 1);
+  CHECK_INT(secondTask->GetQueuePosition(), 0);
+  CHECK_INT(thirdTask->GetQueuePosition(), 1);
+
+  logic->Release();
+  CHECK_BOOL(logic->WaitForFinishedTasks(3), true);
+  std::vector<int> expectedStartOrder = {0, 1, 2};
+  CHECK_BOOL(logic->GetStartOrder() == expectedStartOrder, true);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkSlicerApplicationLogicTest2(int , char * [])
+{
+  vtkNew<vtkSlicerApplicationLogic> appLogic;
+  CHECK_EXIT_SUCCESS(TestDefaults(appLogic));
+
+  appLogic->CreateProcessingThread();
+  int result = TestPriorityAndCancellation(appLogic);
+  if (result == EXIT_SUCCESS)
+    {
+    result = TestConcurrencyLimit(appLogic);
+    }
+  if (result == EXIT_SUCCESS)
+    {
+    result = TestThreadBudget(appLogic);
+    }
+  appLogic->TerminateProcessingThread();
+  CHECK_EXIT_SUCCESS(result);
+
+  return EXIT_SUCCESS;
+}
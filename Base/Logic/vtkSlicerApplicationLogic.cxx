@@ -47,12 +47,15 @@
 # include <sys/resource.h>
 #endif
 
+#include <deque>
 #include <queue>
+#include <thread>
 
 #include "vtkSlicerApplicationLogicRequests.h"
 
 //----------------------------------------------------------------------------
-class ProcessingTaskQueue : public std::queue<vtkSmartPointer<vtkSlicerTask> > {};
+// Tasks are kept sorted by decreasing priority, in scheduling order for equal priorities
+class ProcessingTaskQueue : public std::deque<vtkSmartPointer<vtkSlicerTask> > {};
 class ModifiedQueue : public std::queue<vtkSmartPointer<vtkObject> > {};
 class ReadDataQueue : public std::queue<DataRequest*> {};
 class WriteDataQueue : public std::queue<DataRequest*> {};
@@ -64,9 +67,28 @@ vtkStandardNewMacro(vtkSlicerApplicationLogic);
 vtkSlicerApplicationLogic::vtkSlicerApplicationLogic()
 {
   this->ProcessingThreader = itk::PlatformMultiThreader::New();
-  this->ProcessingThreadId = -1;
   this->ProcessingThreadActive = false;
 
+  this->MaximumNumberOfProcessingTasks = 1;
+  const char* maximumNumberOfProcessingTasks = itksys::SystemTools::GetEnv("SLICER_MAX_PROCESSING_TASKS");
+  if (maximumNumberOfProcessingTasks)
+    {
+    try
+      {
+      this->MaximumNumberOfProcessingTasks = std::max(1, std::min(64, std::stoi(maximumNumberOfProcessingTasks)));
+      }
+    catch(...)
+      {
+      vtkWarningMacro("Invalid SLICER_MAX_PROCESSING_TASKS value ("
+        << maximumNumberOfProcessingTasks << "), expected an integer");
+      }
+    }
+  this->ProcessingThreadBudget = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  this->ProcessingMemoryBudget = 0.;
+  this->NumberOfRunningProcessingTasks = 0;
+  this->RunningProcessingThreads = 0;
+  this->RunningProcessingMemory = 0.;
+
   this->ModifiedQueueActive = false;
 
   this->ReadDataQueueActive = false;
@@ -88,18 +110,22 @@ vtkSlicerApplicationLogic::~vtkSlicerApplicationLogic()
   // Note that TerminateThread does not kill a thread, it only waits
   // for the thread to finish.  We need to signal the thread that we
   // want to terminate
-  if (this->ProcessingThreadId != -1 && this->ProcessingThreader)
+  std::unique_lock<std::mutex> processingThreadsLock(this->ProcessingThreadsLock);
+  if (!this->ProcessingThreadIDs.empty() && this->ProcessingThreader)
     {
-    // Signal the processingThread that we are terminating.
+    // Signal the processing threads that we are terminating.
     this->ProcessingThreadActiveLock.lock();
     this->ProcessingThreadActive = false;
     this->ProcessingThreadActiveLock.unlock();
 
-    // Wait for the thread to finish and clean up the state of the threader
-    this->ProcessingThreader->TerminateThread( this->ProcessingThreadId );
-
-    this->ProcessingThreadId = -1;
+    // Wait for the threads to finish and clean up the state of the threader
+    for (int threadId : this->ProcessingThreadIDs)
+      {
+      this->ProcessingThreader->TerminateThread( threadId );
+      }
+    this->ProcessingThreadIDs.clear();
     }
+  processingThreadsLock.unlock();
 
   delete this->InternalTaskQueue;
 
@@ -164,21 +190,22 @@ void vtkSlicerApplicationLogic::PrintSelf(ostream& os, vtkIndent indent)
   this->vtkObject::PrintSelf(os, indent);
 
   os << indent << "SlicerApplicationLogic:             " << this->GetClassName() << "\n";
+  os << indent << "MaximumNumberOfProcessingTasks: " << this->MaximumNumberOfProcessingTasks << "\n";
+  os << indent << "ProcessingThreadBudget: " << this->ProcessingThreadBudget << "\n";
+  os << indent << "ProcessingMemoryBudget: " << this->ProcessingMemoryBudget << "\n";
 }
 
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::CreateProcessingThread()
 {
-  if (this->ProcessingThreadId == -1)
+  std::lock_guard<std::mutex> processingThreadsLock(this->ProcessingThreadsLock);
+  if (this->ProcessingThreadIDs.empty())
     {
     this->ProcessingThreadActiveLock.lock();
     this->ProcessingThreadActive = true;
     this->ProcessingThreadActiveLock.unlock();
 
-    this->ProcessingThreadId
-      = this->ProcessingThreader
-      ->SpawnThread(vtkSlicerApplicationLogic::ProcessingThreaderCallback,
-                    this);
+    this->SpawnProcessingThreads();
 
     // Start four network threads (TODO: make the number of threads a setting)
     this->NetworkingThreadIDs.push_back ( this->ProcessingThreader
@@ -221,7 +248,8 @@ void vtkSlicerApplicationLogic::CreateProcessingThread()
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::TerminateProcessingThread()
 {
-  if (this->ProcessingThreadId != -1)
+  std::lock_guard<std::mutex> processingThreadsLock(this->ProcessingThreadsLock);
+  if (!this->ProcessingThreadIDs.empty())
     {
     this->ModifiedQueueActiveLock.lock();
     this->ModifiedQueueActive = false;
@@ -239,8 +267,11 @@ void vtkSlicerApplicationLogic::TerminateProcessingThread()
     this->ProcessingThreadActive = false;
     this->ProcessingThreadActiveLock.unlock();
 
-    this->ProcessingThreader->TerminateThread( this->ProcessingThreadId );
-    this->ProcessingThreadId = -1;
+    for (int threadId : this->ProcessingThreadIDs)
+      {
+      this->ProcessingThreader->TerminateThread( threadId );
+      }
+    this->ProcessingThreadIDs.clear();
 
     std::vector<int>::const_iterator idIterator;
     idIterator = this->NetworkingThreadIDs.begin();
@@ -273,6 +304,135 @@ vtkSlicerApplicationLogic::ProcessingThreaderCallback(void* arg)
   return itk::ITK_THREAD_RETURN_DEFAULT_VALUE;
 }
 
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SpawnProcessingThreads()
+{
+  while (static_cast<int>(this->ProcessingThreadIDs.size()) < this->MaximumNumberOfProcessingTasks)
+    {
+    int threadId = this->ProcessingThreader
+      ->SpawnThread(vtkSlicerApplicationLogic::ProcessingThreaderCallback, this);
+    if (threadId < 0)
+      {
+      vtkWarningMacro("SpawnProcessingThreads: failed to spawn a processing thread");
+      return;
+      }
+    this->ProcessingThreadIDs.push_back(threadId);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SetMaximumNumberOfProcessingTasks(int maximumNumberOfTasks)
+{
+  maximumNumberOfTasks = std::max(1, std::min(64, maximumNumberOfTasks));
+  this->ProcessingTaskQueueLock.lock();
+  this->MaximumNumberOfProcessingTasks = maximumNumberOfTasks;
+  this->ProcessingTaskQueueLock.unlock();
+  // Threads that are not needed anymore stay idle. The lock prevents
+  // spawning threads while the processing threads are created or terminated
+  // from another thread.
+  std::lock_guard<std::mutex> processingThreadsLock(this->ProcessingThreadsLock);
+  if (!this->ProcessingThreadIDs.empty())
+    {
+    this->SpawnProcessingThreads();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::GetMaximumNumberOfProcessingTasks()
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  return this->MaximumNumberOfProcessingTasks;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SetProcessingThreadBudget(int numberOfThreads)
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  this->ProcessingThreadBudget = std::max(1, numberOfThreads);
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::GetProcessingThreadBudget()
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  return this->ProcessingThreadBudget;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SetProcessingMemoryBudget(double memoryInMB)
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  this->ProcessingMemoryBudget = std::max(0., memoryInMB);
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerApplicationLogic::GetProcessingMemoryBudget()
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  return this->ProcessingMemoryBudget;
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::GetNumberOfRunningProcessingTasks()
+{
+  std::lock_guard<std::mutex> lock(this->ProcessingTaskQueueLock);
+  return this->NumberOfRunningProcessingTasks;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkSlicerTask> vtkSlicerApplicationLogic::TakeNextProcessingTask()
+{
+  if (this->NumberOfRunningProcessingTasks >= this->MaximumNumberOfProcessingTasks)
+    {
+    return nullptr;
+    }
+  ProcessingTaskQueue::iterator taskIt = std::find_if(
+    this->InternalTaskQueue->begin(), this->InternalTaskQueue->end(),
+    [](const vtkSmartPointer<vtkSlicerTask>& queuedTask)
+      { return queuedTask->GetType() == vtkSlicerTask::Processing; });
+  if (taskIt == this->InternalTaskQueue->end())
+    {
+    return nullptr;
+    }
+  vtkSmartPointer<vtkSlicerTask> task = *taskIt;
+  // Only the first task in priority order may start, so that tasks with large
+  // resource needs are not starved by smaller ones. A task always starts if no
+  // other task is running, even if it exceeds the budgets.
+  if (this->NumberOfRunningProcessingTasks > 0)
+    {
+    if (this->RunningProcessingThreads + task->GetNumberOfThreads() > this->ProcessingThreadBudget)
+      {
+      return nullptr;
+      }
+    if (this->ProcessingMemoryBudget > 0.
+      && this->RunningProcessingMemory + task->GetEstimatedMemory() > this->ProcessingMemoryBudget)
+      {
+      return nullptr;
+      }
+    }
+  this->InternalTaskQueue->erase(taskIt);
+  return task;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::UpdateTaskQueuePositions(std::vector<vtkSmartPointer<vtkSlicerTask> >& modifiedTasks)
+{
+  int position = 0;
+  for (vtkSlicerTask* task : *this->InternalTaskQueue)
+    {
+    if (task->GetType() != vtkSlicerTask::Processing)
+      {
+      continue;
+      }
+    if (task->GetQueuePosition() != position)
+      {
+      task->SetQueuePosition(position);
+      modifiedTasks.emplace_back(task);
+      }
+    ++position;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::ProcessProcessingTasks()
 {
@@ -288,30 +448,40 @@ void vtkSlicerApplicationLogic::ProcessProcessingTasks()
 
     if (active)
       {
-      // pull a task off the queue
+      // pull a task off the queue if the resources allow it
+      std::vector<vtkSmartPointer<vtkSlicerTask> > modifiedTasks;
       this->ProcessingTaskQueueLock.lock();
-      if ((*this->InternalTaskQueue).size() > 0)
+      task = this->TakeNextProcessingTask();
+      if (task)
         {
-        // std::cout << "Number of queued tasks: " << (*this->InternalTaskQueue).size() << std::endl;
-
-        // only handle processing tasks in this thread
-        task = (*this->InternalTaskQueue).front();
-        if ( task->GetType() == vtkSlicerTask::Processing )
-          {
-          (*this->InternalTaskQueue).pop();
-          }
-        else
-          {
-          task = nullptr;
-          }
+        this->NumberOfRunningProcessingTasks++;
+        this->RunningProcessingThreads += task->GetNumberOfThreads();
+        this->RunningProcessingMemory += task->GetEstimatedMemory();
+        task->SetQueuePosition(-1);
+        modifiedTasks.push_back(task);
+        this->UpdateTaskQueuePositions(modifiedTasks);
         }
       this->ProcessingTaskQueueLock.unlock();
 
-      // process the task (should this be in a separate thread?)
+      // notify observers of the queue positions in the main thread
+      for (vtkSlicerTask* modifiedTask : modifiedTasks)
+        {
+        this->RequestModified(modifiedTask);
+        }
+
       if (task)
         {
         task->Execute();
+
+        this->ProcessingTaskQueueLock.lock();
+        this->NumberOfRunningProcessingTasks--;
+        this->RunningProcessingThreads -= task->GetNumberOfThreads();
+        this->RunningProcessingMemory -= task->GetEstimatedMemory();
+        this->ProcessingTaskQueueLock.unlock();
         task = nullptr;
+
+        // look for the next task right away
+        continue;
         }
       }
 
@@ -357,15 +527,15 @@ void vtkSlicerApplicationLogic::ProcessNetworkingTasks()
       this->ProcessingTaskQueueLock.lock();
       if ((*this->InternalTaskQueue).size() > 0)
         {
-        // std::cout << "Number of queued tasks: " << (*this->InternalTaskQueue).size() << std::endl;
-        task = (*this->InternalTaskQueue).front();
-        if ( task->GetType() == vtkSlicerTask::Networking )
+        // only handle networking tasks in this thread
+        ProcessingTaskQueue::iterator taskIt = std::find_if(
+          this->InternalTaskQueue->begin(), this->InternalTaskQueue->end(),
+          [](const vtkSmartPointer<vtkSlicerTask>& queuedTask)
+            { return queuedTask->GetType() == vtkSlicerTask::Networking; });
+        if (taskIt != this->InternalTaskQueue->end())
           {
-          (*this->InternalTaskQueue).pop();
-          }
-        else
-          {
-          task = nullptr;
+          task = *taskIt;
+          this->InternalTaskQueue->erase(taskIt);
           }
         }
       this->ProcessingTaskQueueLock.unlock();
@@ -395,12 +565,47 @@ int vtkSlicerApplicationLogic::ScheduleTask( vtkSlicerTask *task )
     return false;
     }
 
+  std::vector<vtkSmartPointer<vtkSlicerTask> > modifiedTasks;
   this->ProcessingTaskQueueLock.lock();
-  (*this->InternalTaskQueue).push( task );
+  ProcessingTaskQueue::iterator insertIt = std::find_if(
+    this->InternalTaskQueue->begin(), this->InternalTaskQueue->end(),
+    [task](const vtkSmartPointer<vtkSlicerTask>& queuedTask)
+      { return queuedTask->GetPriority() < task->GetPriority(); });
+  this->InternalTaskQueue->insert(insertIt, task);
+  this->UpdateTaskQueuePositions(modifiedTasks);
   this->ProcessingTaskQueueLock.unlock();
+
+  for (vtkSlicerTask* modifiedTask : modifiedTasks)
+    {
+    this->RequestModified(modifiedTask);
+    }
   return true;
 }
 
+//----------------------------------------------------------------------------
+int vtkSlicerApplicationLogic::CancelTask( vtkSlicerTask *task )
+{
+  std::vector<vtkSmartPointer<vtkSlicerTask> > modifiedTasks;
+  this->ProcessingTaskQueueLock.lock();
+  ProcessingTaskQueue::iterator taskIt = std::find(
+    this->InternalTaskQueue->begin(), this->InternalTaskQueue->end(), task);
+  bool removed = (taskIt != this->InternalTaskQueue->end());
+  if (removed)
+    {
+    this->InternalTaskQueue->erase(taskIt);
+    task->SetQueuePosition(-1);
+    modifiedTasks.emplace_back(task);
+    this->UpdateTaskQueuePositions(modifiedTasks);
+    }
+  this->ProcessingTaskQueueLock.unlock();
+
+  for (vtkSlicerTask* modifiedTask : modifiedTasks)
+    {
+    this->RequestModified(modifiedTask);
+    }
+  return removed;
+}
+
 //----------------------------------------------------------------------------
 vtkMTimeType vtkSlicerApplicationLogic::RequestModified(vtkObject *obj)
 {
@@ -26,12 +26,14 @@
 
 // VTK includes
 #include <vtkCollection.h>
+#include <vtkSmartPointer.h>
 
 // ITK includes
 #include <itkPlatformMultiThreader.h>
 
 // STL includes
 #include <mutex>
+#include <vector>
 
 class vtkMRMLSelectionNode;
 class vtkMRMLInteractionNode;
@@ -68,11 +70,34 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
                           vtkDataIOManagerLogic *dataIOManagerLogic);
 
 
-  /// Create a thread for processing
+  /// Create the processing threads
   void CreateProcessingThread();
 
-  /// Shutdown the processing thread
+  /// Shutdown the processing threads
   void TerminateProcessingThread();
+
+  /// Maximum number of processing tasks that run concurrently.
+  /// Default is 1, it can be changed with the SLICER_MAX_PROCESSING_TASKS
+  /// environment variable. Value is clamped between 1 and 64.
+  void SetMaximumNumberOfProcessingTasks(int maximumNumberOfTasks);
+  int GetMaximumNumberOfProcessingTasks();
+
+  /// Number of CPU threads that running processing tasks may use together.
+  /// A queued task is not started while the estimated threads of the running
+  /// tasks and the task exceed the budget, except if no task is running.
+  /// Default is the number of CPU cores.
+  /// \sa vtkSlicerTask::SetNumberOfThreads()
+  void SetProcessingThreadBudget(int numberOfThreads);
+  int GetProcessingThreadBudget();
+
+  /// Memory, in megabytes, that running processing tasks may use together.
+  /// 0 (default) means there is no limit.
+  /// \sa vtkSlicerTask::SetEstimatedMemory()
+  void SetProcessingMemoryBudget(double memoryInMB);
+  double GetProcessingMemoryBudget();
+
+  /// Number of processing tasks currently running.
+  int GetNumberOfRunningProcessingTasks();
   /// List of events potentially fired by the application logic
   enum RequestEvents
     {
@@ -86,11 +111,20 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
       RequestProcessedEvent
     };
 
-  /// Schedule a task to run in the processing thread. Returns true if
+  /// Schedule a task to run in a processing thread. Returns true if
   /// task was successfully scheduled. ScheduleTask() is called from the
-  /// main thread to run something in the processing thread.
+  /// main thread to run something in a processing thread.
+  /// Processing tasks are started in order of priority, as soon as the
+  /// concurrency limit and the resource budgets allow it.
+  /// \sa vtkSlicerTask::SetPriority(), SetMaximumNumberOfProcessingTasks()
   int ScheduleTask( vtkSlicerTask* );
 
+  /// Remove a task from the queue before it starts. Returns true if the task
+  /// was queued and has been removed, false if it is already running, done or
+  /// unknown. The caller is responsible for releasing the resources
+  /// associated with the task client data.
+  int CancelTask( vtkSlicerTask* );
+
   /// Request a Modified call on an object.  This method allows a
   /// processing thread to request a Modified call on an object to be
   /// performed in the main thread.  This allows the call to Modified
@@ -233,9 +267,22 @@ protected:
    /// Callback used by a MultiThreader to start a networking thread
   static itk::ITK_THREAD_RETURN_TYPE NetworkingThreaderCallback( void * );
 
-  /// Task processing loop that is run in the processing thread
+  /// Task processing loop that is run in the processing threads
   void ProcessProcessingTasks();
 
+  /// Remove and return the next processing task that can be started,
+  /// nullptr if none. Must be called with ProcessingTaskQueueLock locked.
+  vtkSmartPointer<vtkSlicerTask> TakeNextProcessingTask();
+
+  /// Update the queue position of the queued processing tasks and append
+  /// the tasks whose position changed to \a modifiedTasks.
+  /// Must be called with ProcessingTaskQueueLock locked.
+  void UpdateTaskQueuePositions(std::vector<vtkSmartPointer<vtkSlicerTask> >& modifiedTasks);
+
+  /// Spawn processing threads until there are MaximumNumberOfProcessingTasks.
+  /// ProcessingThreadsLock must be locked by the caller.
+  void SpawnProcessingThreads();
+
   /// Networking Task processing loop that is run in a networking thread
   void ProcessNetworkingTasks();
 
@@ -258,6 +305,8 @@ private:
 
   itk::PlatformMultiThreader::Pointer ProcessingThreader;
   std::mutex ProcessingThreadActiveLock;
+  /// Protects ProcessingThreadIDs and NetworkingThreadIDs
+  std::mutex ProcessingThreadsLock;
   std::mutex ProcessingTaskQueueLock;
   std::mutex ModifiedQueueActiveLock;
   std::mutex ModifiedQueueLock;
@@ -266,13 +315,20 @@ private:
   std::mutex WriteDataQueueActiveLock;
   std::mutex WriteDataQueueLock;
   vtkTimeStamp RequestTimeStamp;
-  int ProcessingThreadId;
+  std::vector<int> ProcessingThreadIDs;
   std::vector<int> NetworkingThreadIDs;
   int ProcessingThreadActive;
   int ModifiedQueueActive;
   int ReadDataQueueActive;
   int WriteDataQueueActive;
 
+  int MaximumNumberOfProcessingTasks;
+  int ProcessingThreadBudget;
+  double ProcessingMemoryBudget;
+  int NumberOfRunningProcessingTasks;
+  int RunningProcessingThreads;
+  double RunningProcessingMemory;
+
   ProcessingTaskQueue* InternalTaskQueue;
   ModifiedQueue*       InternalModifiedQueue;
   ReadDataQueue*       InternalReadDataQueue;
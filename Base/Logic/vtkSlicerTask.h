@@ -6,6 +6,9 @@
 #include "vtkMRMLAbstractLogic.h"
 #include "vtkSlicerBaseLogic.h"
 
+// STD includes
+#include <atomic>
+
 class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerTask : public vtkObject
 {
 public:
@@ -38,6 +41,36 @@ public:
   void SetTypeToProcessing() {this->SetType(vtkSlicerTask::Processing);};
   void SetTypeToNetworking() {this->SetType(vtkSlicerTask::Networking);};
 
+  ///
+  /// Priority of the task. Queued processing tasks with higher priority
+  /// are started first, tasks with equal priority are started in the order
+  /// they were scheduled. Default is 0.
+  vtkSetMacro (Priority, int);
+  vtkGetMacro (Priority, int);
+
+  ///
+  /// Estimated number of CPU threads used by the task while it runs.
+  /// The application logic does not start a processing task if the
+  /// threads of the running tasks and this task would exceed the processing
+  /// thread budget. Default is 1.
+  /// \sa vtkSlicerApplicationLogic::SetProcessingThreadBudget()
+  vtkSetClampMacro (NumberOfThreads, int, 1, VTK_INT_MAX);
+  vtkGetMacro (NumberOfThreads, int);
+
+  ///
+  /// Estimated peak memory used by the task, in megabytes. Default is 0.
+  /// \sa vtkSlicerApplicationLogic::SetProcessingMemoryBudget()
+  vtkSetClampMacro (EstimatedMemory, double, 0., VTK_DOUBLE_MAX);
+  vtkGetMacro (EstimatedMemory, double);
+
+  ///
+  /// Number of queued processing tasks that will start before this task,
+  /// or -1 if the task is not queued (not scheduled yet, running or done).
+  /// Set by the application logic, that requests a Modified() on the task
+  /// in the main thread when the position changes.
+  int GetQueuePosition() const { return this->QueuePosition; }
+  void SetQueuePosition(int position) { this->QueuePosition = position; }
+
   const char* GetTypeAsString( ) {
     switch (this->Type)
       {
@@ -60,6 +93,10 @@ private:
   void *TaskClientData;
 
   int Type;
+  int Priority;
+  int NumberOfThreads;
+  double EstimatedMemory;
+  std::atomic<int> QueuePosition;
 
 };
 #endif
@@ -216,6 +216,9 @@ void qSlicerApplicationHelper::setupModuleFactoryManager(qSlicerModuleFactoryMan
   QStringList modulesToIgnore = modulesToAlwaysIgnore << modulesToTemporarlyIgnore;
   moduleFactoryManager->setModulesToIgnore(modulesToIgnore);
 
+  moduleFactoryManager->setModulesToLoadOnDemand(
+    app->revisionUserSettings()->value("Modules/LoadOnDemand").toStringList());
+
   moduleFactoryManager->setVerboseModuleDiscovery(app->commandOptions()->verboseModuleDiscovery());
 }
 
@@ -203,8 +203,8 @@ int qSlicerApplicationHelper::postInitializeApplication(
 #endif
     }
 
-  // Load all available modules
-  foreach(const QString& name, moduleFactoryManager->instantiatedModuleNames())
+  // Load all available modules, except the ones loaded on first use
+  foreach(const QString& name, moduleFactoryManager->modulesToLoad())
     {
     Q_ASSERT(!name.isNull());
     splashMessage(splashScreen, "Loading module \"" + name + "\"...");
@@ -213,6 +213,7 @@ int qSlicerApplicationHelper::postInitializeApplication(
   if (app.commandOptions()->verboseModuleDiscovery())
     {
     qDebug() << "Number of loaded modules:" << moduleManager->modulesNames().count();
+    qDebug().noquote() << moduleFactoryManager->startupTimelineReport();
     }
 
   splashMessage(splashScreen, QString());
@@ -0,0 +1,109 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDir>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QThreadPool>
+
+// Slicer includes
+#include "qSlicerCLIExecutableModuleFactory.h"
+#include "qSlicerCLILoadableModuleFactory.h"
+#include "qSlicerCLIModuleFactoryHelper.h"
+#include "qSlicerCoreApplication.h"
+#include "qSlicerModuleFactoryManager.h"
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+//-----------------------------------------------------------------------------
+int qSlicerCLIModuleFactoryCacheTest1(int argc, char * argv[])
+{
+  if (argc < 3)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/CLIModule4Test /path/to/CLIModule4TestLib" << std::endl;
+    return EXIT_FAILURE;
+    }
+  QString executablePath = QString::fromLocal8Bit(argv[1]);
+  QString libraryPath = QString::fromLocal8Bit(argv[2]);
+
+  // The CLI paths are not passed to the application, they would be considered as files to load
+  int appArgc = 1;
+  qSlicerCoreApplication::setAttribute(qSlicerCoreApplication::AA_DisablePython);
+  qSlicerCoreApplication app(appArgc, argv);
+
+  QTemporaryDir cacheDirectory;
+  CHECK_BOOL(cacheDirectory.isValid(), true);
+
+  //
+  // Executable CLI: the description is retrieved when the module is registered
+  //
+  {
+  qSlicerModuleFactoryManager factoryManager;
+  qSlicerCLIExecutableModuleFactory* factory = new qSlicerCLIExecutableModuleFactory;
+  // The cache directory of the application is used by default
+  CHECK_BOOL(factory->xmlDescriptionCacheDirectory().isEmpty(), false);
+  CHECK_BOOL(factory->xmlDescriptionCacheDirectory()
+             == qSlicerCLIModuleFactoryHelper::xmlModuleDescriptionCacheDirectory(), true);
+  QString executableCacheDirectory = QDir(cacheDirectory.path()).filePath("Executable");
+  factory->setXmlDescriptionCacheDirectory(executableCacheDirectory);
+  factoryManager.registerFactory(factory);
+  QString moduleName = factory->fileNameToKey(QFileInfo(executablePath).fileName());
+
+  // Ignored modules are not run
+  factoryManager.setModulesToIgnore(QStringList() << moduleName);
+  factoryManager.registerModule(QFileInfo(executablePath));
+  CHECK_BOOL(factoryManager.ignoredModuleNames().contains(moduleName), true);
+  QThreadPool::globalInstance()->waitForDone();
+  CHECK_BOOL(QDir(executableCacheDirectory).exists(), false);
+
+  factoryManager.setModulesToIgnore(QStringList());
+  factoryManager.registerModule(QFileInfo(executablePath));
+  CHECK_BOOL(factoryManager.registeredModuleNames().contains(moduleName), true);
+  // Registration does not wait for the description
+  QThreadPool::globalInstance()->waitForDone();
+  QString xmlDescription = qSlicerCLIModuleFactoryHelper::cachedXmlModuleDescription(
+    executableCacheDirectory, executablePath);
+  CHECK_BOOL(xmlDescription.startsWith("<?xml"), true);
+  CHECK_NOT_NULL(factoryManager.instantiateModule(moduleName));
+  }
+
+  //
+  // Loadable CLI: the description is cached when the module is instantiated
+  //
+  {
+  qSlicerModuleFactoryManager factoryManager;
+  qSlicerCLILoadableModuleFactory* factory = new qSlicerCLILoadableModuleFactory;
+  CHECK_BOOL(factory->xmlDescriptionCacheDirectory()
+             == qSlicerCLIModuleFactoryHelper::xmlModuleDescriptionCacheDirectory(), true);
+  QString libraryCacheDirectory = QDir(cacheDirectory.path()).filePath("Library");
+  factory->setXmlDescriptionCacheDirectory(libraryCacheDirectory);
+  factoryManager.registerFactory(factory);
+  QString moduleName = factory->fileNameToKey(QFileInfo(libraryPath).fileName());
+
+  factoryManager.registerModule(QFileInfo(libraryPath));
+  CHECK_BOOL(factoryManager.registeredModuleNames().contains(moduleName), true);
+  CHECK_BOOL(qSlicerCLIModuleFactoryHelper::cachedXmlModuleDescription(
+    libraryCacheDirectory, libraryPath).isEmpty(), true);
+  CHECK_NOT_NULL(factoryManager.instantiateModule(moduleName));
+  QString xmlDescription = qSlicerCLIModuleFactoryHelper::cachedXmlModuleDescription(
+    libraryCacheDirectory, libraryPath);
+  CHECK_BOOL(xmlDescription.startsWith("<?xml"), true);
+  }
+
+  return EXIT_SUCCESS;
+}
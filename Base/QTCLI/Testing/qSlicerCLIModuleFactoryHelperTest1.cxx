@@ -0,0 +1,66 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+  This file was originally developed by Jean-Christophe Fillion-Robin, Kitware Inc.
+  and was partially funded by NIH grant 3P41RR013218-12S1
+
+==============================================================================*/
+
+// Qt includes
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+// Slicer includes
+#include <qSlicerCLIModuleFactoryHelper.h>
+
+// STD includes
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+int qSlicerCLIModuleFactoryHelperTest1(int, char * [] )
+{
+  QTemporaryDir tempDir;
+  CHECK_BOOL(tempDir.isValid(), true);
+  QString cacheDirectory = QDir(tempDir.path()).filePath("cache");
+  QString cliPath = QDir(tempDir.path()).filePath("CLIModule4Test");
+
+  QFile cliFile(cliPath);
+  CHECK_BOOL(cliFile.open(QIODevice::WriteOnly), true);
+  cliFile.write("executable content");
+  cliFile.close();
+
+  QString xmlDescription("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n<executable>\n</executable>\n");
+
+  // Not cached yet
+  CHECK_BOOL(qSlicerCLIModuleFactoryHelper::cachedXmlModuleDescription(cacheDirectory, cliPath).isEmpty(), true);
+
+  // Cached
+  CHECK_BOOL(qSlicerCLIModuleFactoryHelper::cacheXmlModuleDescription(cacheDirectory, cliPath, xmlDescription), true);
+  CHECK_BOOL(qSlicerCLIModuleFactoryHelper::cachedXmlModuleDescription(cacheDirectory, cliPath) == xmlDescription, true);
+
+  // Cache is invalid after the CLI is modified
+  CHECK_BOOL(cliFile.open(QIODevice::Append), true);
+  cliFile.write(" modified");
+  cliFile.close();
+  CHECK_BOOL(qSlicerCLIModuleFactoryHelper::cachedXmlModuleDescription(cacheDirectory, cliPath).isEmpty(), true);
+
+  // No caching for files that do not exist or without cache directory
+  CHECK_BOOL(qSlicerCLIModuleFactoryHelper::cacheXmlModuleDescription(
+    cacheDirectory, cliPath + "NotExisting", xmlDescription), false);
+  CHECK_BOOL(qSlicerCLIModuleFactoryHelper::cacheXmlModuleDescription(QString(), cliPath, xmlDescription), false);
+
+  return EXIT_SUCCESS;
+}
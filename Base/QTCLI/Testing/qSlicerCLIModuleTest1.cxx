@@ -39,6 +39,7 @@
 #include <vtkSlicerCLIModuleLogic.h>
 
 // STD includes
+#include <sstream>
 
 namespace
 {
@@ -77,6 +78,22 @@ void runCli(void * data)
   // Execute synchronously so that we can check the content of the file after the module execution
   CLIModule->cliModuleLogic()->ApplyAndWait(cliModuleNode);
 
+  // Check that the execution stages have been measured
+  if (cliModuleNode->GetTelemetryValue("Compute.WallTime") < 0.
+      || cliModuleNode->GetTelemetryValue("TotalWallTime") < 0.)
+    {
+    ErrorString = QString("Telemetry of the module execution is missing !");
+    return;
+    }
+  // The telemetry is not saved with the scene
+  std::stringstream nodeXML;
+  cliModuleNode->WriteXML(nodeXML, 0);
+  if (nodeXML.str().find("Telemetry") != std::string::npos)
+    {
+    ErrorString = QString("Telemetry of the module execution is written in the scene !");
+    return;
+    }
+
   // Read outputFile
   QTextStream stream(&outputFile);
   QString operationResult = stream.readAll().trimmed();
@@ -20,7 +20,9 @@
 
 // Qt includes
 #include <QProcess>
+#include <QRunnable>
 #include <QStandardPaths>
+#include <QThreadPool>
 
 // Slicer includes
 #include "qSlicerCLIExecutableModuleFactory.h"
@@ -29,6 +31,10 @@
 #include "qSlicerUtils.h"
 #include <vtkSlicerCLIModuleLogic.h>
 
+// STD includes
+#include <functional>
+#include <memory>
+
 //-----------------------------------------------------------------------------
 QString findPython()
 {
@@ -49,8 +55,9 @@ QString findPython()
 
 //-----------------------------------------------------------------------------
 qSlicerCLIExecutableModuleFactoryItem::qSlicerCLIExecutableModuleFactoryItem(
-  const QString& newTempDirectory)
+  const QString& newTempDirectory, const QString& xmlDescriptionCacheDirectory)
   : TempDirectory(newTempDirectory)
+  , XmlDescriptionCacheDirectory(xmlDescriptionCacheDirectory)
   , CLIModule(nullptr)
 {
 }
@@ -58,6 +65,9 @@ qSlicerCLIExecutableModuleFactoryItem::qSlicerCLIExecutableModuleFactoryItem(
 //-----------------------------------------------------------------------------
 bool qSlicerCLIExecutableModuleFactoryItem::load()
 {
+  // Items are loaded when they are registered, which is done only for the
+  // modules that are not ignored.
+  this->fetchXmlModuleDescription();
   return true;
 }
 
@@ -116,7 +126,12 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
     }
   else
     {
-    xmlDescription = this->runCLIWithXmlArgument();
+    xmlDescription = qSlicerCLIModuleFactoryHelper::cachedXmlModuleDescription(
+      this->XmlDescriptionCacheDirectory, this->path());
+    if (xmlDescription.isEmpty())
+      {
+      xmlDescription = this->runCLIWithXmlArgument();
+      }
     }
   if (xmlDescription.isEmpty())
     {
@@ -134,21 +149,93 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
   return module.take();
 }
 
+//-----------------------------------------------------------------------------
+namespace
+{
+class qSlicerCLIXmlDescriptionRunnable : public QRunnable
+{
+public:
+  typedef std::function<void()> FunctionType;
+  qSlicerCLIXmlDescriptionRunnable(const FunctionType& function)
+    : Function(function)
+  {
+  }
+  void run() override
+  {
+    this->Function();
+  }
+private:
+  FunctionType Function;
+};
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactoryItem::fetchXmlModuleDescription()
+{
+  if (this->FetchedXmlDescription.valid()
+    || QFile::exists(this->xmlModuleDescriptionFilePath())
+    || !qSlicerCLIModuleFactoryHelper::cachedXmlModuleDescription(
+          this->XmlDescriptionCacheDirectory, this->path()).isEmpty())
+    {
+    return;
+    }
+  std::shared_ptr<std::promise<XmlModuleDescriptionResult> > result =
+    std::make_shared<std::promise<XmlModuleDescriptionResult> >();
+  this->FetchedXmlDescription = result->get_future().share();
+  // The runnable only refers to copies, the item may be deleted before it is run.
+  QString path = this->path();
+  QString xmlDescriptionCacheDirectory = this->XmlDescriptionCacheDirectory;
+  QThreadPool::globalInstance()->start(new qSlicerCLIXmlDescriptionRunnable(
+    [result, path, xmlDescriptionCacheDirectory]()
+    {
+    result->set_value(runCLIWithXmlArgument(path, xmlDescriptionCacheDirectory));
+    }));
+}
+
 //-----------------------------------------------------------------------------
 QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
 {
-  ctkScopedCurrentDir scopedCurrentDir(QFileInfo(this->path()).path());
+  XmlModuleDescriptionResult result;
+  if (this->FetchedXmlDescription.valid())
+    {
+    result = this->FetchedXmlDescription.get();
+    this->FetchedXmlDescription = std::shared_future<XmlModuleDescriptionResult>();
+    }
+  else
+    {
+    result = runCLIWithXmlArgument(this->path(), this->XmlDescriptionCacheDirectory);
+    }
+  foreach(const QString& errorString, result.ErrorStrings)
+    {
+    this->appendInstantiateErrorString(errorString);
+    }
+  foreach(const QString& warningString, result.WarningStrings)
+    {
+    this->appendInstantiateWarningString(warningString);
+    }
+  return result.XmlDescription;
+}
+
+//-----------------------------------------------------------------------------
+qSlicerCLIExecutableModuleFactoryItem::XmlModuleDescriptionResult
+qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument(
+  const QString& path, const QString& xmlDescriptionCacheDirectory)
+{
+  XmlModuleDescriptionResult result;
 
   int cliProcessTimeoutInMs = 5000;
   QProcess cli;
+  // Set the working directory of the process instead of changing the current
+  // directory, as this may run concurrently in several threads.
+  cli.setWorkingDirectory(QFileInfo(path).path());
   QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
   env.insert("ITK_AUTOLOAD_PATH", "");
   cli.setProcessEnvironment(env);
-  cli.start(this->path(), QStringList(QString("--xml")));
+  cli.start(path, QStringList(QString("--xml")));
   bool res = cli.waitForFinished(cliProcessTimeoutInMs);
   if (!res)
     {
-    this->appendInstantiateErrorString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
+    result.ErrorStrings << qSlicerCLIModule::tr("CLI executable: %1").arg(path);
     QString errorString;
     switch(cli.error())
       {
@@ -180,14 +267,14 @@ QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
               "Failed to execute process. An unknown error occurred.");
         break;
       }
-    this->appendInstantiateErrorString(errorString);
-    return nullptr;
+    result.ErrorStrings << errorString;
+    return result;
     }
   QString errors = cli.readAllStandardError();
   if (!errors.isEmpty())
     {
-    this->appendInstantiateErrorString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateErrorString(errors);
+    result.ErrorStrings << qSlicerCLIModule::tr("CLI executable: %1").arg(path);
+    result.ErrorStrings << errors;
     // TODO: More investigation for the following behavior:
     // on my machine (Ubuntu 10.04 with ITKv4), having standard error trims the
     // standard output results. The following readAllStandardOutput() is then
@@ -198,19 +285,26 @@ QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
   QString xmlDescription = cli.readAllStandardOutput();
   if (xmlDescription.isEmpty())
     {
-    this->appendInstantiateErrorString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateErrorString(qSlicerCLIModule::tr("Failed to retrieve XML Description"));
-    return QString();
+    result.ErrorStrings << qSlicerCLIModule::tr("CLI executable: %1").arg(path);
+    result.ErrorStrings << qSlicerCLIModule::tr("Failed to retrieve XML Description");
+    return result;
     }
   if (!xmlDescription.startsWith("<?xml"))
     {
-    this->appendInstantiateWarningString(qSlicerCLIModule::tr("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateWarningString(qSlicerCLIModule::tr("XML description doesn't start right away."));
-    this->appendInstantiateWarningString(qSlicerCLIModule::tr("Output before '<?xml' is [%1]").arg(
-                                           xmlDescription.mid(0, xmlDescription.indexOf("<?xml"))));
+    result.WarningStrings << qSlicerCLIModule::tr("CLI executable: %1").arg(path);
+    result.WarningStrings << qSlicerCLIModule::tr("XML description doesn't start right away.");
+    result.WarningStrings << qSlicerCLIModule::tr("Output before '<?xml' is [%1]").arg(
+                                           xmlDescription.mid(0, xmlDescription.indexOf("<?xml")));
     xmlDescription.remove(0, xmlDescription.indexOf("<?xml"));
     }
-  return xmlDescription;
+  result.XmlDescription = xmlDescription;
+  if (result.ErrorStrings.isEmpty() && result.WarningStrings.isEmpty())
+    {
+    // Only descriptions retrieved without any message are cached, so that
+    // messages are reported each time the application starts.
+    qSlicerCLIModuleFactoryHelper::cacheXmlModuleDescription(xmlDescriptionCacheDirectory, path, xmlDescription);
+    }
+  return result;
 }
 
 //-----------------------------------------------------------------------------
@@ -235,6 +329,7 @@ public:
 
 private:
   QString TempDirectory;
+  QString XmlDescriptionCacheDirectory;
 };
 
 //-----------------------------------------------------------------------------
@@ -242,6 +337,7 @@ qSlicerCLIExecutableModuleFactoryPrivate::qSlicerCLIExecutableModuleFactoryPriva
 :q_ptr(&object)
 {
   this->TempDirectory = QDir::tempPath();
+  this->XmlDescriptionCacheDirectory = qSlicerCLIModuleFactoryHelper::xmlModuleDescriptionCacheDirectory();
 }
 
 //-----------------------------------------------------------------------------
@@ -285,7 +381,7 @@ ctkAbstractFactoryItem<qSlicerAbstractCoreModule>* qSlicerCLIExecutableModuleFac
 ::createFactoryFileBasedItem()
 {
   Q_D(qSlicerCLIExecutableModuleFactory);
-  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory);
+  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory, d->XmlDescriptionCacheDirectory);
 }
 
 //-----------------------------------------------------------------------------
@@ -300,3 +396,17 @@ void qSlicerCLIExecutableModuleFactory::setTempDirectory(const QString& newTempD
   Q_D(qSlicerCLIExecutableModuleFactory);
   d->TempDirectory = newTempDirectory;
 }
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactory::setXmlDescriptionCacheDirectory(const QString& newXmlDescriptionCacheDirectory)
+{
+  Q_D(qSlicerCLIExecutableModuleFactory);
+  d->XmlDescriptionCacheDirectory = newXmlDescriptionCacheDirectory;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactory::xmlDescriptionCacheDirectory()const
+{
+  Q_D(const qSlicerCLIExecutableModuleFactory);
+  return d->XmlDescriptionCacheDirectory;
+}
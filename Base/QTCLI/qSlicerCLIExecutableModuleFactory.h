@@ -30,23 +30,49 @@ class qSlicerCLIModule;
 #include <ctkPimpl.h>
 #include <ctkAbstractPluginFactory.h>
 
+// STD includes
+#include <future>
+
 //-----------------------------------------------------------------------------
 class qSlicerCLIExecutableModuleFactoryItem
   : public ctkAbstractFactoryFileBasedItem<qSlicerAbstractCoreModule>
 {
 public:
-  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory);
+  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory,
+                                        const QString& xmlDescriptionCacheDirectory = QString());
   bool load() override;
   void uninstantiate() override;
+
+  /// Start retrieving the XML description in a background thread if there is
+  /// no XML description file next to the executable and the description is
+  /// not cached. The description is waited for only when the module is
+  /// instantiated, which allows running the executables of several modules
+  /// in parallel.
+  /// Called by load(), when the item is registered.
+  void fetchXmlModuleDescription();
+
 protected:
   /// Return path of the expected XML file.
   QString xmlModuleDescriptionFilePath();
 
   qSlicerAbstractCoreModule* instanciator() override;
   QString runCLIWithXmlArgument();
+
+  struct XmlModuleDescriptionResult
+  {
+    QString XmlDescription;
+    QStringList ErrorStrings;
+    QStringList WarningStrings;
+  };
+  /// Run the CLI executable \a path with "--xml" and cache the description
+  /// if it is retrieved without error. This method is thread-safe.
+  static XmlModuleDescriptionResult runCLIWithXmlArgument(const QString& path,
+                                                          const QString& xmlDescriptionCacheDirectory);
 private:
   QString TempDirectory;
+  QString XmlDescriptionCacheDirectory;
   qSlicerCLIModule* CLIModule;
+  std::shared_future<XmlModuleDescriptionResult> FetchedXmlDescription;
 };
 
 class qSlicerCLIExecutableModuleFactoryPrivate;
@@ -71,6 +97,12 @@ public:
 
   void setTempDirectory(const QString& newTempDirectory);
 
+  /// Directory where the XML descriptions retrieved by running the executables
+  /// are cached. Only items registered afterward use it.
+  /// By default, qSlicerCLIModuleFactoryHelper::xmlModuleDescriptionCacheDirectory().
+  void setXmlDescriptionCacheDirectory(const QString& newXmlDescriptionCacheDirectory);
+  QString xmlDescriptionCacheDirectory()const;
+
 protected:
   bool isValidFile(const QFileInfo& file)const override;
 
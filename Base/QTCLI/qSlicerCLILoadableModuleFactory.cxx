@@ -31,16 +31,24 @@
 
 //-----------------------------------------------------------------------------
 qSlicerCLILoadableModuleFactoryItem::qSlicerCLILoadableModuleFactoryItem(
-  const QString& newTempDirectory) : TempDirectory(newTempDirectory)
+  const QString& newTempDirectory, const QString& xmlDescriptionCacheDirectory)
+  : TempDirectory(newTempDirectory)
+  , XmlDescriptionCacheDirectory(xmlDescriptionCacheDirectory)
 {
 }
 
 //-----------------------------------------------------------------------------
 bool qSlicerCLILoadableModuleFactoryItem::load()
 {
-  // If XML description file exists, skip loading. It will be
-  // lazily done by calling ModuleDescription::GetTarget() method.
-  if (!QFile::exists(this->xmlModuleDescriptionFilePath()))
+  // If XML description file exists or the description is cached, skip loading.
+  // It will be lazily done by calling ModuleDescription::GetTarget() method.
+  if (QFile::exists(this->xmlModuleDescriptionFilePath()))
+    {
+    return true;
+    }
+  this->CachedXmlDescription = qSlicerCLIModuleFactoryHelper::cachedXmlModuleDescription(
+    this->XmlDescriptionCacheDirectory, this->path());
+  if (this->CachedXmlDescription.isEmpty())
     {
     return this->Superclass::load();
     }
@@ -95,8 +103,11 @@ qSlicerAbstractCoreModule* qSlicerCLILoadableModuleFactoryItem::instanciator()
   // description. The "ModuleEntryPoint" address will be lazily retrieved
   // after calling ModuleDescription::GetTarget() method.
   //
+  // If the description has been found in the cache when the item was loaded,
+  // use it the same way.
+  //
   // If not, directly resolve the symbols "XMLModuleDescription" and
-  // "ModuleEntryPoint" from the loaded library.
+  // "ModuleEntryPoint" from the loaded library, and cache the description.
   //
   QString xmlDescription;
   if (QFile::exists(xmlFilePath))
@@ -116,6 +127,13 @@ qSlicerAbstractCoreModule* qSlicerCLILoadableModuleFactoryItem::instanciator()
     module->moduleDescription().SetTargetCallback(
           this, qSlicerCLILoadableModuleFactoryItem::loadLibraryAndResolveSymbols);
     }
+  else if (!this->CachedXmlDescription.isEmpty())
+    {
+    xmlDescription = this->CachedXmlDescription;
+    // Set callback to allow lazy loading of target symbols.
+    module->moduleDescription().SetTargetCallback(
+          this, qSlicerCLILoadableModuleFactoryItem::loadLibraryAndResolveSymbols);
+    }
   else
     {
     // Library is expected to already be loaded
@@ -125,6 +143,8 @@ qSlicerAbstractCoreModule* qSlicerCLILoadableModuleFactoryItem::instanciator()
       {
       return nullptr;
       }
+    qSlicerCLIModuleFactoryHelper::cacheXmlModuleDescription(
+      this->XmlDescriptionCacheDirectory, this->path(), xmlDescription);
     }
   if (xmlDescription.isEmpty())
     {
@@ -270,6 +290,7 @@ public:
 
 private:
   QString TempDirectory;
+  QString XmlDescriptionCacheDirectory;
 };
 
 //-----------------------------------------------------------------------------
@@ -286,6 +307,7 @@ void qSlicerCLILoadableModuleFactoryPrivate::init()
   // if one of these symbols can't be resolved, the library won't be registered.
   q->setSymbols(QStringList() << "XMLModuleDescription" << "ModuleEntryPoint");
   this->TempDirectory = QDir::tempPath();
+  this->XmlDescriptionCacheDirectory = qSlicerCLIModuleFactoryHelper::xmlModuleDescriptionCacheDirectory();
 }
 
 //-----------------------------------------------------------------------------
@@ -314,7 +336,7 @@ ctkAbstractFactoryItem<qSlicerAbstractCoreModule>* qSlicerCLILoadableModuleFacto
 createFactoryFileBasedItem()
 {
   Q_D(qSlicerCLILoadableModuleFactory);
-  return new qSlicerCLILoadableModuleFactoryItem(d->TempDirectory);
+  return new qSlicerCLILoadableModuleFactoryItem(d->TempDirectory, d->XmlDescriptionCacheDirectory);
 }
 
 //-----------------------------------------------------------------------------
@@ -330,6 +352,20 @@ void qSlicerCLILoadableModuleFactory::setTempDirectory(const QString& newTempDir
   d->TempDirectory = newTempDirectory;
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerCLILoadableModuleFactory::setXmlDescriptionCacheDirectory(const QString& newXmlDescriptionCacheDirectory)
+{
+  Q_D(qSlicerCLILoadableModuleFactory);
+  d->XmlDescriptionCacheDirectory = newXmlDescriptionCacheDirectory;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLILoadableModuleFactory::xmlDescriptionCacheDirectory()const
+{
+  Q_D(const qSlicerCLILoadableModuleFactory);
+  return d->XmlDescriptionCacheDirectory;
+}
+
 //-----------------------------------------------------------------------------
 bool qSlicerCLILoadableModuleFactory::isValidFile(const QFileInfo& file)const
 {
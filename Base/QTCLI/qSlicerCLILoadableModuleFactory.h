@@ -40,7 +40,8 @@ class qSlicerCLILoadableModuleFactoryItem
 {
 public:
   typedef ctkFactoryLibraryItem<qSlicerAbstractCoreModule> Superclass;
-  qSlicerCLILoadableModuleFactoryItem(const QString& newTempDirectory);
+  qSlicerCLILoadableModuleFactoryItem(const QString& newTempDirectory,
+                                      const QString& xmlDescriptionCacheDirectory = QString());
   bool load() override;
 
   static void loadLibraryAndResolveSymbols(
@@ -56,6 +57,10 @@ protected:
   static bool updateLogo(qSlicerCLILoadableModuleFactoryItem* item, ModuleLogo& logo);
 private:
   QString TempDirectory;
+  QString XmlDescriptionCacheDirectory;
+  /// Description found in the cache when the item was loaded, the library is
+  /// not loaded in that case.
+  QString CachedXmlDescription;
 };
 
 class qSlicerCLILoadableModuleFactoryPrivate;
@@ -82,6 +87,12 @@ public:
 
   void setTempDirectory(const QString& newTempDirectory);
 
+  /// Directory where the XML descriptions retrieved from the libraries are
+  /// cached. Only items registered afterward use it.
+  /// By default, qSlicerCLIModuleFactoryHelper::xmlModuleDescriptionCacheDirectory().
+  void setXmlDescriptionCacheDirectory(const QString& newXmlDescriptionCacheDirectory);
+  QString xmlDescriptionCacheDirectory()const;
+
 protected:
   ctkAbstractFactoryItem<qSlicerAbstractCoreModule>*
     createFactoryFileBasedItem() override;
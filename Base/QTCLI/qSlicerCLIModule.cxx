@@ -103,6 +103,10 @@ vtkMRMLAbstractLogic* qSlicerCLIModule::createLogic()
     {
     logic->SetAllowInMemoryTransfer(0);
     }
+  if (d->Desc.GetParameterValue("AllowSharedMemoryTransfer") == "true")
+    {
+    logic->SetAllowSharedMemoryTransfer(1);
+    }
 
   return logic;
 }
@@ -19,6 +19,11 @@
 ==============================================================================*/
 
 // Qt includes
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
 #include <QSettings>
 
 // QtCLI includes
@@ -28,6 +33,33 @@
 #include "qSlicerCoreApplication.h" // For: Slicer_CLIMODULES_LIB_DIR
 #include "qSlicerUtils.h"
 
+namespace
+{
+//-----------------------------------------------------------------------------
+QString xmlModuleDescriptionCacheFilePath(const QString& cacheDirectory, const QString& path)
+{
+  QByteArray pathHash = QCryptographicHash::hash(
+    QFileInfo(path).absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+  return QDir(cacheDirectory).filePath(QString::fromLatin1(pathHash) + ".cache");
+}
+
+//-----------------------------------------------------------------------------
+// First lines of a cache file, they identify the version of the CLI file the
+// description was retrieved from.
+QByteArray xmlModuleDescriptionCacheHeader(const QString& path)
+{
+  QFileInfo info(path);
+  if (!info.exists())
+    {
+    return QByteArray();
+    }
+  return QString("%1\n%2\n%3\n")
+    .arg(info.absoluteFilePath())
+    .arg(info.lastModified().toMSecsSinceEpoch())
+    .arg(info.size()).toUtf8();
+}
+}
+
 //-----------------------------------------------------------------------------
 const QStringList qSlicerCLIModuleFactoryHelper::modulePaths()
 {
@@ -81,3 +113,59 @@ bool qSlicerCLIModuleFactoryHelper::isBuiltIn(const QString& path)
   qSlicerCoreApplication * app = qSlicerCoreApplication::application();
   return app ? qSlicerUtils::isPluginBuiltIn(path, app->slicerHome(), app->revision()) : true;
 }
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIModuleFactoryHelper::xmlModuleDescriptionCacheDirectory()
+{
+  qSlicerCoreApplication * app = qSlicerCoreApplication::application();
+  if (!app)
+    {
+    return QString();
+    }
+  return QDir(app->cachePath()).filePath("CLIModuleDescriptions");
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIModuleFactoryHelper::cachedXmlModuleDescription(
+  const QString& cacheDirectory, const QString& path)
+{
+  if (cacheDirectory.isEmpty())
+    {
+    return QString();
+    }
+  QFile cacheFile(xmlModuleDescriptionCacheFilePath(cacheDirectory, path));
+  if (!cacheFile.open(QIODevice::ReadOnly))
+    {
+    return QString();
+    }
+  QByteArray header = xmlModuleDescriptionCacheHeader(path);
+  QByteArray content = cacheFile.readAll();
+  if (header.isEmpty() || !content.startsWith(header))
+    {
+    // the CLI has been modified since the description was cached
+    return QString();
+    }
+  return QString::fromUtf8(content.mid(header.size()));
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerCLIModuleFactoryHelper::cacheXmlModuleDescription(
+  const QString& cacheDirectory, const QString& path, const QString& xmlDescription)
+{
+  QByteArray header = xmlModuleDescriptionCacheHeader(path);
+  if (cacheDirectory.isEmpty() || header.isEmpty() || xmlDescription.isEmpty()
+    || !QDir().mkpath(cacheDirectory))
+    {
+    return false;
+    }
+  // Write in a temporary file first, so that a partially written description
+  // is never read (by this or another application instance).
+  QSaveFile cacheFile(xmlModuleDescriptionCacheFilePath(cacheDirectory, path));
+  if (!cacheFile.open(QIODevice::WriteOnly))
+    {
+    return false;
+    }
+  cacheFile.write(header);
+  cacheFile.write(xmlDescription.toUtf8());
+  return cacheFile.commit();
+}
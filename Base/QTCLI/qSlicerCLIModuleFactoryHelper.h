@@ -40,6 +40,23 @@ public:
   /// Convenient method returning True if the given CLI path corresponds to a built-in module
   static bool isBuiltIn(const QString& path);
 
+  /// Directory where the XML descriptions of the CLIs that are not next to their
+  /// executable or library (and therefore require running the executable with
+  /// "--xml" or loading the library) are cached.
+  /// Returns an empty string if qSlicerCoreApplication is not instantiated.
+  static QString xmlModuleDescriptionCacheDirectory();
+
+  /// Return the XML description of the CLI \a path cached in \a cacheDirectory.
+  /// Returns an empty string if it is not cached or if the CLI file has changed
+  /// (path, modification time or size) since it was cached.
+  /// This method is thread-safe.
+  static QString cachedXmlModuleDescription(const QString& cacheDirectory, const QString& path);
+
+  /// Store the XML description of the CLI \a path in \a cacheDirectory.
+  /// This method is thread-safe.
+  static bool cacheXmlModuleDescription(const QString& cacheDirectory, const QString& path,
+                                        const QString& xmlDescription);
+
 private:
   /// Not implemented
   qSlicerCLIModuleFactoryHelper() = default;
@@ -376,6 +376,11 @@ void qSlicerCLIProgressBar::updateUiFromCommandLineModuleNode(
       d->ProgressBar->setMaximum(0);
       break;
     case vtkMRMLCommandLineModuleNode::Scheduled:
+      if (node->GetQueuePosition() >= 0)
+        {
+        d->StatusLabel->setText(tr("%1 (position %2 in queue)")
+          .arg(node->GetStatusString()).arg(node->GetQueuePosition() + 1));
+        }
       d->ProgressBar->setMaximum(0);
       break;
     case vtkMRMLCommandLineModuleNode::Running:
@@ -26,17 +26,25 @@
 #include <vtkMRMLModelHierarchyNode.h>
 #include <vtkMRMLModelNode.h>
 #include <vtkMRMLROIListNode.h>
+#include <vtkMRMLSequenceNode.h>
 #include <vtkMRMLStorageNode.h>
 #include <vtkMRMLModelStorageNode.h>
+#include <vtkMRMLTracer.h>
 #include <vtkMRMLTransformNode.h>
+#include <vtkMRMLVolumeNode.h>
+#include <vtkMRMLVolumeSharedMemory.h>
 
 // VTK includes
 #include <vtkCallbackCommand.h>
+#include <vtkImageData.h>
 #include <vtkIntArray.h>
+#include <vtkMatrix4x4.h>
 #include <vtkMultiThreader.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkStringArray.h>
+#include <vtkTimerLog.h>
+#include <vtkWeakPointer.h>
 #include <vtksys/SystemTools.hxx>
 
 // ITKSYS includes
@@ -46,14 +54,27 @@
 
 // STL includes
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstring>
 #include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <map>
 #include <mutex>
 #include <random>
 #include <set>
+#include <sstream>
+#include <vector>
 
 #ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
 #else
+#include <sys/resource.h>
+#include <sys/time.h>
 #include <sys/types.h>
 #include <unistd.h>
 #endif
@@ -72,9 +93,262 @@ struct DigitsToCharacters
     }
 };
 
+//----------------------------------------------------------------------------
+// Index appended to temporary file names so that concurrent executions
+// never share a file.
+static unsigned int NextTemporaryFileIndex()
+{
+  static std::atomic<unsigned int> temporaryFileIndex(0);
+  return temporaryFileIndex++;
+}
+
 typedef std::pair<vtkSlicerCLIModuleLogic *, vtkMRMLCommandLineModuleNode *> LogicNodePair;
 class MRMLIDMap : public std::map<std::string, std::string> {};
 
+//----------------------------------------------------------------------------
+// Removes the shared memory segments created for a module execution when
+// the execution ends, whichever way it ends.
+class vtkSlicerCLISharedMemorySegments : public std::set<std::string>
+{
+public:
+  ~vtkSlicerCLISharedMemorySegments()
+    {
+    for (const std::string& uri : *this)
+      {
+      vtkMRMLVolumeSharedMemory::Remove(uri);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+// Resource usage of the process at a given time. Values that are not
+// available on the platform are negative.
+struct vtkSlicerCLIResourceSample
+{
+  double WallTime = 0.;         // seconds since the epoch
+  double ThreadCPUTime = -1.;   // user + system time of the calling thread, in seconds
+  double ProcessCPUTime = -1.;  // user + system time of the process, in seconds
+  double ChildrenCPUTime = -1.; // user + system time of all the terminated child processes, in seconds
+  double MaxRSS = -1.;          // maximum resident set size of the process since it started, in MB
+  double ChildrenMaxRSS = -1.;  // maximum resident set size of the largest terminated child process, in MB
+
+  static vtkSlicerCLIResourceSample Now()
+    {
+    vtkSlicerCLIResourceSample sample;
+    sample.WallTime = vtkTimerLog::GetUniversalTime();
+#ifdef _WIN32
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+      {
+      sample.ThreadCPUTime = FileTimeToSeconds(kernelTime) + FileTimeToSeconds(userTime);
+      }
+    if (GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+      {
+      sample.ProcessCPUTime = FileTimeToSeconds(kernelTime) + FileTimeToSeconds(userTime);
+      }
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+      {
+      sample.ProcessCPUTime = TimeValToSeconds(usage.ru_utime) + TimeValToSeconds(usage.ru_stime);
+      sample.MaxRSS = MaxRSSToMegabytes(usage.ru_maxrss);
+      }
+    if (getrusage(RUSAGE_CHILDREN, &usage) == 0)
+      {
+      sample.ChildrenCPUTime = TimeValToSeconds(usage.ru_utime) + TimeValToSeconds(usage.ru_stime);
+      sample.ChildrenMaxRSS = MaxRSSToMegabytes(usage.ru_maxrss);
+      }
+# ifdef RUSAGE_THREAD
+    if (getrusage(RUSAGE_THREAD, &usage) == 0)
+      {
+      sample.ThreadCPUTime = TimeValToSeconds(usage.ru_utime) + TimeValToSeconds(usage.ru_stime);
+      }
+# endif
+#endif
+    return sample;
+    }
+
+private:
+#ifdef _WIN32
+  static double FileTimeToSeconds(const FILETIME& time)
+    {
+    ULARGE_INTEGER value;
+    value.LowPart = time.dwLowDateTime;
+    value.HighPart = time.dwHighDateTime;
+    return value.QuadPart * 1e-7;
+    }
+#else
+  static double TimeValToSeconds(const struct timeval& time)
+    {
+    return time.tv_sec + time.tv_usec * 1e-6;
+    }
+  static double MaxRSSToMegabytes(long maxRSS)
+    {
+# ifdef __APPLE__
+    // bytes on macOS
+    return maxRSS / (1024. * 1024.);
+# else
+    // kilobytes on Linux
+    return maxRSS / 1024.;
+# endif
+    }
+#endif
+};
+
+//----------------------------------------------------------------------------
+// Timing and resource usage of the stages of a module execution.
+// getrusage() does not report the usage of a given child process, nor the
+// peak memory of a time interval: the values are named after what they
+// actually measure (e.g. "ChildrenCPUTime") so that they are not mistaken
+// for the usage of the module alone.
+// \sa vtkSlicerCLIModuleLogic::Apply()
+class vtkSlicerCLIRunTelemetry
+{
+public:
+  /// Threads or processes whose resource usage is attributed to a stage.
+  enum UsageSource
+    {
+    ThreadCPU,
+    ProcessCPU,
+    ChildrenCPU
+    };
+
+  struct Stage
+    {
+    std::string Name;
+    double WallTime;
+    double CPUTime;
+    UsageSource CPUTimeSource;
+    double MaxRSS;
+    UsageSource MaxRSSSource;
+    unsigned long long Bytes;
+    };
+
+  /// Prefix of the names of the values measured on \a source:
+  /// "Thread", "Process" or "Children".
+  static const char* GetSourceName(UsageSource source)
+    {
+    switch (source)
+      {
+      case ThreadCPU: return "Thread";
+      case ProcessCPU: return "Process";
+      case ChildrenCPU: return "Children";
+      }
+    return "";
+    }
+
+  void Start()
+    {
+    this->Stages.clear();
+    this->RunStart = vtkSlicerCLIResourceSample::Now();
+    this->StageStart = this->RunStart;
+    }
+
+  void BeginStage(const std::string& name)
+    {
+    this->StageName = name;
+    this->StageStart = vtkSlicerCLIResourceSample::Now();
+    }
+
+  void EndStage(UsageSource cpuSource, unsigned long long bytes = 0)
+    {
+    vtkSlicerCLIResourceSample stageEnd = vtkSlicerCLIResourceSample::Now();
+    Stage stage;
+    stage.Name = this->StageName;
+    stage.WallTime = stageEnd.WallTime - this->StageStart.WallTime;
+    stage.CPUTime = -1.;
+    stage.CPUTimeSource = cpuSource;
+    stage.MaxRSS = stageEnd.MaxRSS;
+    stage.MaxRSSSource = ProcessCPU;
+    stage.Bytes = bytes;
+    switch (cpuSource)
+      {
+      case ThreadCPU:
+        if (this->StageStart.ThreadCPUTime >= 0. && stageEnd.ThreadCPUTime >= 0.)
+          {
+          stage.CPUTime = stageEnd.ThreadCPUTime - this->StageStart.ThreadCPUTime;
+          break;
+          }
+        // thread times are not available, fall back to process times
+        stage.CPUTimeSource = ProcessCPU;
+        [[fallthrough]];
+      case ProcessCPU:
+        if (this->StageStart.ProcessCPUTime >= 0. && stageEnd.ProcessCPUTime >= 0.)
+          {
+          stage.CPUTime = stageEnd.ProcessCPUTime - this->StageStart.ProcessCPUTime;
+          }
+        break;
+      case ChildrenCPU:
+        // includes the child processes of other modules terminated meanwhile
+        if (this->StageStart.ChildrenCPUTime >= 0. && stageEnd.ChildrenCPUTime >= 0.)
+          {
+          stage.CPUTime = stageEnd.ChildrenCPUTime - this->StageStart.ChildrenCPUTime;
+          }
+        stage.MaxRSS = stageEnd.ChildrenMaxRSS;
+        stage.MaxRSSSource = ChildrenCPU;
+        break;
+      }
+    this->Stages.push_back(stage);
+    }
+
+  double GetTotalWallTime() const
+    {
+    double totalWallTime = 0.;
+    for (const Stage& stage : this->Stages)
+      {
+      totalWallTime += stage.WallTime;
+      }
+    return totalWallTime;
+    }
+
+  /// Sum of the sizes of the existing files among \a fileNames.
+  static unsigned long long GetTotalFileSize(const std::set<std::string>& fileNames)
+    {
+    unsigned long long totalSize = 0;
+    for (const std::string& fileName : fileNames)
+      {
+      if (!fileName.empty() && vtksys::SystemTools::FileExists(fileName, true))
+        {
+        totalSize += vtksys::SystemTools::FileLength(fileName);
+        }
+      }
+    return totalSize;
+    }
+
+  std::vector<Stage> Stages;
+  vtkSlicerCLIResourceSample RunStart;
+  vtkSlicerCLIResourceSample StageStart;
+  std::string StageName;
+  std::string ModuleType;
+};
+
+//---------------------------------------------------------------------------
+// Reports the position of a scheduled task in the processing queue to the
+// CLI node the task has been created for.
+class vtkSlicerCLITaskObserver : public vtkCommand
+{
+public:
+  static vtkSlicerCLITaskObserver *New()
+  {
+    return new vtkSlicerCLITaskObserver;
+  }
+  void Execute(vtkObject* caller, unsigned long vtkNotUsed(eid), void* vtkNotUsed(callData)) override
+  {
+    vtkSlicerTask* task = vtkSlicerTask::SafeDownCast(caller);
+    if (task && this->Node
+        && this->Node->GetStatus() == vtkMRMLCommandLineModuleNode::Scheduled)
+      {
+      this->Node->SetQueuePosition(task->GetQueuePosition());
+      }
+  }
+
+  vtkWeakPointer<vtkMRMLCommandLineModuleNode> Node;
+
+protected:
+  vtkSlicerCLITaskObserver() = default;
+  ~vtkSlicerCLITaskObserver() override = default;
+};
+
 //---------------------------------------------------------------------------
 class vtkSlicerCLIRescheduleCallback : public vtkCallbackCommand
 {
@@ -192,6 +466,7 @@ public:
   ModuleDescription DefaultModuleDescription;
   int DeleteTemporaryFiles;
   int AllowInMemoryTransfer;
+  int AllowSharedMemoryTransfer;
 
   int RedirectModuleStreams;
 
@@ -224,6 +499,7 @@ public:
 
   void SetLastRequest(vtkMRMLCommandLineModuleNode* node, vtkMTimeType requestUID)
   {
+    std::lock_guard<std::mutex> lock(this->LastRequestsLock);
     RequestType::iterator it = std::find_if(
       this->LastRequests.begin(), this->LastRequests.end(), FindRequest(node));
     if (it == this->LastRequests.end())
@@ -238,11 +514,134 @@ public:
   }
   vtkMTimeType GetLastRequest(vtkMRMLCommandLineModuleNode* node)
   {
+    std::lock_guard<std::mutex> lock(this->LastRequestsLock);
     RequestType::iterator it = std::find_if(
       this->LastRequests.begin(), this->LastRequests.end(), FindRequest(node));
     return (it != this->LastRequests.end())? it->first : 0;
   }
 
+  /// Keep the telemetry of a run whose outputs are being loaded into the
+  /// scene by the application logic.
+  void AddPendingTelemetry(vtkMRMLCommandLineModuleNode* node, const vtkSlicerCLIRunTelemetry& telemetry)
+  {
+    std::lock_guard<std::mutex> lock(this->TelemetryLock);
+    this->PendingTelemetry[node] = telemetry;
+  }
+  /// Remove the pending telemetry of \a node and copy it into \a telemetry.
+  /// Returns false if there is no pending telemetry for \a node.
+  bool TakePendingTelemetry(vtkMRMLCommandLineModuleNode* node, vtkSlicerCLIRunTelemetry& telemetry)
+  {
+    std::lock_guard<std::mutex> lock(this->TelemetryLock);
+    std::map<vtkMRMLCommandLineModuleNode*, vtkSlicerCLIRunTelemetry>::iterator it =
+      this->PendingTelemetry.find(node);
+    if (it == this->PendingTelemetry.end())
+      {
+      return false;
+      }
+    telemetry = it->second;
+    this->PendingTelemetry.erase(it);
+    return true;
+  }
+
+  /// Store the telemetry of a completed run in \a node and append it to
+  /// the telemetry log file if any.
+  /// The node is not modified, it is safe to call from a processing thread:
+  /// the caller is expected to notify the change of status of the node
+  /// (e.g. with vtkSlicerApplicationLogic::RequestModified()).
+  void PublishTelemetry(vtkMRMLCommandLineModuleNode* node, const vtkSlicerCLIRunTelemetry& telemetry)
+  {
+    std::map<std::string, double> values;
+    for (const vtkSlicerCLIRunTelemetry::Stage& stage : telemetry.Stages)
+      {
+      const std::string prefix = stage.Name + ".";
+      values[prefix + "WallTime"] = stage.WallTime;
+      if (stage.CPUTime >= 0.)
+        {
+        values[prefix + vtkSlicerCLIRunTelemetry::GetSourceName(stage.CPUTimeSource) + "CPUTime"] = stage.CPUTime;
+        }
+      if (stage.MaxRSS >= 0.)
+        {
+        values[prefix + vtkSlicerCLIRunTelemetry::GetSourceName(stage.MaxRSSSource) + "MaxRSS"] = stage.MaxRSS;
+        }
+      values[prefix + "Bytes"] = static_cast<double>(stage.Bytes);
+      }
+    values["TotalWallTime"] = telemetry.GetTotalWallTime();
+    node->SetTelemetry(values, false);
+
+    std::lock_guard<std::mutex> lock(this->TelemetryLock);
+    if (this->TelemetryLogFileName.empty())
+      {
+      return;
+      }
+    std::ofstream log(this->TelemetryLogFileName.c_str(), std::ios::out | std::ios::app);
+    if (!log.is_open())
+      {
+      vtkGenericWarningMacro("Unable to open CLI telemetry log file " << this->TelemetryLogFileName);
+      return;
+      }
+    log << "{\"module\": " << JSONString(node->GetModuleDescription().GetTitle())
+        << ", \"nodeID\": " << JSONString(node->GetID() ? node->GetID() : "")
+        << ", \"moduleType\": " << JSONString(telemetry.ModuleType)
+        << ", \"status\": " << JSONString(node->GetStatusString())
+        << std::fixed << std::setprecision(6)
+        << ", \"startTime\": " << telemetry.RunStart.WallTime
+        << ", \"totalWallTime\": " << telemetry.GetTotalWallTime()
+        << ", \"stages\": [";
+    for (size_t stageIndex = 0; stageIndex < telemetry.Stages.size(); ++stageIndex)
+      {
+      const vtkSlicerCLIRunTelemetry::Stage& stage = telemetry.Stages[stageIndex];
+      log << (stageIndex > 0 ? ", " : "")
+          << "{\"name\": " << JSONString(stage.Name)
+          << ", \"wallTime\": " << stage.WallTime
+          << ", \"cpuTime\": " << JSONNumber(stage.CPUTime)
+          << ", \"cpuTimeSource\": " << JSONString(vtkSlicerCLIRunTelemetry::GetSourceName(stage.CPUTimeSource))
+          << ", \"maxRSS\": " << JSONNumber(stage.MaxRSS)
+          << ", \"maxRSSSource\": " << JSONString(vtkSlicerCLIRunTelemetry::GetSourceName(stage.MaxRSSSource))
+          << ", \"bytes\": " << stage.Bytes << "}";
+      }
+    log << "]}" << std::endl;
+  }
+
+  static std::string JSONString(const std::string& value)
+  {
+    std::ostringstream escaped;
+    escaped << '"';
+    for (char c : value)
+      {
+      switch (c)
+        {
+        case '"': escaped << "\\\""; break;
+        case '\\': escaped << "\\\\"; break;
+        case '\n': escaped << "\\n"; break;
+        case '\r': escaped << "\\r"; break;
+        case '\t': escaped << "\\t"; break;
+        default:
+          if (static_cast<unsigned char>(c) < 0x20)
+            {
+            escaped << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+            }
+          else
+            {
+            escaped << c;
+            }
+        }
+      }
+    escaped << '"';
+    return escaped.str();
+  }
+
+  /// Negative values are not available and written as null.
+  static std::string JSONNumber(double value)
+  {
+    if (value < 0.)
+      {
+      return "null";
+      }
+    std::ostringstream number;
+    number << std::fixed << std::setprecision(6) << value;
+    return number.str();
+  }
+
   /// Install the reschedule callback on a node and its references
   /// \sa StopRescheduleNodeEvents()
   void StartRescheduleNodeEvents(vtkMRMLNode* node)
@@ -287,7 +686,76 @@ public:
 
   /// List of read data/scene requests of the CLI nodes
   /// being executed with their.
+  /// Several CLIs may complete concurrently, access is guarded by
+  /// LastRequestsLock.
   RequestType LastRequests;
+  std::mutex LastRequestsLock;
+
+  /// Tasks scheduled for the CLI nodes, used to remove a task from the
+  /// processing queue when its node is cancelled before it starts.
+  /// Only accessed from the main thread.
+  std::map<vtkMRMLCommandLineModuleNode*, vtkWeakPointer<vtkSlicerTask> > ScheduledTasks;
+
+  /// Frame of a sequence processed by ApplyToSequence().
+  struct SequenceFrame
+  {
+    int FrameIndex;
+    vtkSmartPointer<vtkMRMLCommandLineModuleNode> CLINode;
+    vtkSmartPointer<vtkMRMLNode> InputNode;
+    vtkSmartPointer<vtkMRMLNode> OutputNode;
+  };
+  /// Sequence processed by ApplyToSequence().
+  struct SequenceBatch
+  {
+    vtkSmartPointer<vtkMRMLCommandLineModuleNode> Node;
+    std::string InputParameterName;
+    std::string OutputParameterName;
+    std::string OutputClassName;
+    vtkSmartPointer<vtkMRMLSequenceNode> InputSequence;
+    vtkSmartPointer<vtkMRMLSequenceNode> OutputSequence;
+    int NumberOfFrames{0};
+    int MaximumNumberOfConcurrentFrames{1};
+    int NextFrame{0};
+    int NumberOfProcessedFrames{0};
+    int NumberOfFailedFrames{0};
+    bool Cancelled{false};
+    double StartTime{0.};
+    std::vector<SequenceFrame> RunningFrames;
+  };
+  /// Return true if \a node is processing a sequence or a frame of a sequence.
+  bool IsSequenceBatchNode(vtkMRMLCommandLineModuleNode* node)
+  {
+    for (const auto& batchIt : this->SequenceBatches)
+      {
+      if (batchIt.first == node)
+        {
+        return true;
+        }
+      for (const SequenceFrame& frame : batchIt.second.RunningFrames)
+        {
+        if (frame.CLINode == node)
+          {
+          return true;
+          }
+        }
+      }
+    return false;
+  }
+  /// Sequences being processed, indexed by the CLI node given to
+  /// ApplyToSequence(). Only accessed from the main thread.
+  std::map<vtkMRMLCommandLineModuleNode*, SequenceBatch> SequenceBatches;
+  bool UpdatingSequenceBatches;
+  bool SequenceBatchesUpdatePending;
+  vtkSmartPointer<vtkCallbackCommand> SequenceBatchesCallbackCommand;
+
+  /// File the telemetry of the runs is appended to, telemetry is not
+  /// logged if empty.
+  /// Telemetry of the runs whose outputs are being loaded in the scene.
+  /// Both are accessed from the processing threads, access is guarded by
+  /// TelemetryLock.
+  std::string TelemetryLogFileName;
+  std::map<vtkMRMLCommandLineModuleNode*, vtkSlicerCLIRunTelemetry> PendingTelemetry;
+  std::mutex TelemetryLock;
 
   vtkSmartPointer<vtkSlicerCLIRescheduleCallback> RescheduleCallback;
   vtkSmartPointer<vtkSlicerCLIOneShotCallbackCallback>OneShotCallbackCallback;
@@ -305,7 +773,9 @@ vtkSlicerCLIModuleLogic::vtkSlicerCLIModuleLogic()
 
   this->Internal->DeleteTemporaryFiles = 1;
   this->Internal->AllowInMemoryTransfer = 1;
+  this->Internal->AllowSharedMemoryTransfer = 0;
   this->Internal->RedirectModuleStreams = 1;
+  itksys::SystemTools::GetEnv("SLICER_CLI_TELEMETRY_LOG", this->Internal->TelemetryLogFileName);
   this->Internal->RescheduleCallback =
     vtkSmartPointer<vtkSlicerCLIRescheduleCallback>::New();
   this->Internal->RescheduleCallback->SetCLIModuleLogic(this);
@@ -314,12 +784,21 @@ vtkSlicerCLIModuleLogic::vtkSlicerCLIModuleLogic()
 
   this->AddObserver(vtkSlicerCLIModuleLogic::RequestHierarchyEditEvent,
                                       this->Internal->OneShotCallbackCallback, 100000000.f);
+
+  this->Internal->UpdatingSequenceBatches = false;
+  this->Internal->SequenceBatchesUpdatePending = false;
+  this->Internal->SequenceBatchesCallbackCommand = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->Internal->SequenceBatchesCallbackCommand->SetCallback(vtkSlicerCLIModuleLogic::SequenceBatchesCallback);
+  this->Internal->SequenceBatchesCallbackCommand->SetClientData(this);
+  this->AddObserver(vtkSlicerCLIModuleLogic::RequestSequenceBatchesUpdateEvent,
+                    this->Internal->SequenceBatchesCallbackCommand);
 }
 
 //----------------------------------------------------------------------------
 vtkSlicerCLIModuleLogic::~vtkSlicerCLIModuleLogic()
 {
   this->RemoveObserver(this->Internal->OneShotCallbackCallback);
+  this->RemoveObserver(this->Internal->SequenceBatchesCallbackCommand);
 
   delete this->Internal;
 }
@@ -408,6 +887,36 @@ int vtkSlicerCLIModuleLogic::GetAllowInMemoryTransfer() const
   return this->Internal->AllowInMemoryTransfer;
 }
 
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetAllowSharedMemoryTransfer(int value)
+{
+  vtkDebugMacro(<< this->GetClassName() << " (" << this << "): setting AllowSharedMemoryTransfer to " << value);
+  if (this->Internal->AllowSharedMemoryTransfer != value)
+    {
+    this->Internal->AllowSharedMemoryTransfer = value;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetAllowSharedMemoryTransfer() const
+{
+  return this->Internal->AllowSharedMemoryTransfer;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetTelemetryLogFileName(const std::string& fileName)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->TelemetryLock);
+  this->Internal->TelemetryLogFileName = fileName;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkSlicerCLIModuleLogic::GetTelemetryLogFileName() const
+{
+  std::lock_guard<std::mutex> lock(this->Internal->TelemetryLock);
+  return this->Internal->TelemetryLogFileName;
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerCLIModuleLogic::RedirectModuleStreamsOn()
 {
@@ -467,6 +976,7 @@ vtkSlicerCLIModuleLogic
 #else
   pidString << getpid();
 #endif
+  pidString << "_" << NextTemporaryFileIndex();
   pid = pidString.str();
   std::transform(pid.begin(), pid.end(), pid.begin(), DigitsToCharacters());
 
@@ -515,12 +1025,10 @@ vtkSlicerCLIModuleLogic
   // running instances of slicer will not collide).  The filename
   // will be unique to the node in the process (the same node will be
   // encoded to the same filename every time within that running
-  // instance of Slicer).  This last point is an optimization to
-  // minimize the number of times a file is written when running a
-  // module.  However, if we change the execution model such that more
-  // than one module can run at the same time within the same Slicer
-  // process, then this encoding will need to be changed to be unique
-  // per module execution.
+  // instance of Slicer).  Several modules can run at the same time
+  // within the same Slicer process, therefore an execution index is
+  // appended to the pid to make the filename unique per module
+  // execution.
   //
 
   // Encode process id into a string.  To avoid confusing the
@@ -530,6 +1038,7 @@ vtkSlicerCLIModuleLogic
 #else
   pidString << getpid();
 #endif
+  pidString << "_" << NextTemporaryFileIndex();
   pid = pidString.str();
   std::transform(pid.begin(), pid.end(), pid.begin(), DigitsToCharacters());
 
@@ -680,6 +1189,314 @@ void vtkSlicerCLIModuleLogic::ApplyAndWait ( vtkMRMLCommandLineModuleNode* node,
     }
 }
 
+//-----------------------------------------------------------------------------
+// Remove a temporary node created for processing a sequence frame along
+// with the display and storage nodes that have been created for it.
+static void RemoveSequenceFrameNode(vtkMRMLScene* scene, vtkMRMLNode* node)
+{
+  if (!scene || !node)
+    {
+    return;
+    }
+  std::vector<vtkMRMLNode*> nodesToRemove;
+  vtkMRMLDisplayableNode* displayableNode = vtkMRMLDisplayableNode::SafeDownCast(node);
+  if (displayableNode)
+    {
+    for (int i = 0; i < displayableNode->GetNumberOfDisplayNodes(); ++i)
+      {
+      nodesToRemove.push_back(displayableNode->GetNthDisplayNode(i));
+      }
+    }
+  vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(node);
+  if (storableNode)
+    {
+    for (int i = 0; i < storableNode->GetNumberOfStorageNodes(); ++i)
+      {
+      nodesToRemove.push_back(storableNode->GetNthStorageNode(i));
+      }
+    }
+  scene->RemoveNode(node);
+  for (vtkMRMLNode* nodeToRemove : nodesToRemove)
+    {
+    if (nodeToRemove)
+      {
+      scene->RemoveNode(nodeToRemove);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic::ApplyToSequence(vtkMRMLCommandLineModuleNode* node,
+  const std::string& inputParameterName, vtkMRMLSequenceNode* inputSequence,
+  const std::string& outputParameterName, vtkMRMLSequenceNode* outputSequence,
+  int maximumNumberOfConcurrentFrames/*=0*/)
+{
+  vtkMRMLScene* scene = this->GetMRMLScene();
+  vtkSlicerApplicationLogic* appLogic = this->GetApplicationLogic();
+  if (!node || !inputSequence || !outputSequence || !scene || !appLogic)
+    {
+    vtkErrorMacro("ApplyToSequence: invalid node, sequences, scene or application logic");
+    return false;
+    }
+  if (node->GetScene() != scene)
+    {
+    vtkErrorMacro("ApplyToSequence: node " << node->GetName() << " is not in the scene of the logic");
+    return false;
+    }
+  if (node->IsBusy())
+    {
+    vtkErrorMacro("ApplyToSequence: node " << node->GetName() << " is busy");
+    return false;
+    }
+  if (!node->GetModuleDescription().HasParameter(inputParameterName)
+      || !node->GetModuleDescription().HasParameter(outputParameterName))
+    {
+    vtkErrorMacro("ApplyToSequence: module " << node->GetModuleTitle()
+      << " has no parameter named " << inputParameterName << " or " << outputParameterName);
+    return false;
+    }
+
+  vtkInternal::SequenceBatch batch;
+  batch.Node = node;
+  batch.InputParameterName = inputParameterName;
+  batch.OutputParameterName = outputParameterName;
+  batch.InputSequence = inputSequence;
+  batch.OutputSequence = outputSequence;
+  batch.NumberOfFrames = inputSequence->GetNumberOfDataNodes();
+  if (batch.NumberOfFrames == 0)
+    {
+    vtkWarningMacro("ApplyToSequence: input sequence " << inputSequence->GetName() << " is empty");
+    node->SetStatus(vtkMRMLCommandLineModuleNode::Completed);
+    return true;
+    }
+
+  // Output frames have the type of the node selected as output, if any,
+  // or the type of the input frames otherwise.
+  batch.OutputClassName = inputSequence->GetNthDataNode(0)->GetClassName();
+  vtkMRMLNode* selectedOutputNode = scene->GetNodeByID(node->GetParameterAsString(outputParameterName.c_str()));
+  if (selectedOutputNode)
+    {
+    batch.OutputClassName = selectedOutputNode->GetClassName();
+    }
+
+  batch.MaximumNumberOfConcurrentFrames = maximumNumberOfConcurrentFrames > 0 ?
+    maximumNumberOfConcurrentFrames : appLogic->GetMaximumNumberOfProcessingTasks();
+
+  if (outputSequence->GetNumberOfDataNodes() == 0)
+    {
+    outputSequence->SetIndexName(inputSequence->GetIndexName());
+    outputSequence->SetIndexUnit(inputSequence->GetIndexUnit());
+    outputSequence->SetIndexType(inputSequence->GetIndexType());
+    }
+
+  ModuleProcessInformation* batchInfo = node->GetModuleDescription().GetProcessInformation();
+  batchInfo->Abort = 0;
+  batchInfo->Progress = 0;
+  batchInfo->StageProgress = 0;
+  batchInfo->ElapsedTime = 0;
+  batch.StartTime = vtkTimerLog::GetUniversalTime();
+  this->Internal->SequenceBatches[node] = batch;
+  node->SetStatus(vtkMRMLCommandLineModuleNode::Running);
+
+  // Schedule the first frames
+  this->UpdateSequenceBatches();
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::UpdateSequenceBatches()
+{
+  if (this->Internal->UpdatingSequenceBatches)
+    {
+    return;
+    }
+  this->Internal->UpdatingSequenceBatches = true;
+  this->Internal->SequenceBatchesUpdatePending = false;
+  vtkMRMLScene* scene = this->GetMRMLScene();
+
+  std::vector<vtkSmartPointer<vtkMRMLCommandLineModuleNode> > batchNodes;
+  for (const auto& batchIt : this->Internal->SequenceBatches)
+    {
+    batchNodes.push_back(batchIt.second.Node);
+    }
+  for (vtkMRMLCommandLineModuleNode* node : batchNodes)
+    {
+    vtkInternal::SequenceBatch& batch = this->Internal->SequenceBatches[node];
+    bool frameDone = false;
+    // Frames processed in the main thread (if the processing threads are not
+    // running) are already done when they are scheduled: loop until all of
+    // them are collected.
+    bool updated = true;
+    while (updated)
+      {
+      updated = false;
+
+      if (!batch.Cancelled && node->GetStatus() == vtkMRMLCommandLineModuleNode::Cancelling)
+        {
+        batch.Cancelled = true;
+        for (vtkInternal::SequenceFrame& frame : batch.RunningFrames)
+          {
+          frame.CLINode->Cancel();
+          this->CancelScheduledTask(frame.CLINode);
+          }
+        }
+
+      for (std::vector<vtkInternal::SequenceFrame>::iterator frameIt = batch.RunningFrames.begin();
+           frameIt != batch.RunningFrames.end();)
+        {
+        const int status = frameIt->CLINode->GetStatus();
+        if (status != vtkMRMLCommandLineModuleNode::Completed
+            && status != vtkMRMLCommandLineModuleNode::CompletedWithErrors
+            && status != vtkMRMLCommandLineModuleNode::Cancelled)
+          {
+          ++frameIt;
+          continue;
+          }
+        if (status == vtkMRMLCommandLineModuleNode::Completed)
+          {
+          batch.OutputSequence->SetDataNodeAtValue(frameIt->OutputNode,
+            batch.InputSequence->GetNthIndexValue(frameIt->FrameIndex));
+          ++batch.NumberOfProcessedFrames;
+          }
+        else if (status == vtkMRMLCommandLineModuleNode::CompletedWithErrors)
+          {
+          vtkWarningMacro("ApplyToSequence: failed to process frame " << frameIt->FrameIndex
+            << " of " << batch.InputSequence->GetName() << ": " << frameIt->CLINode->GetErrorText());
+          ++batch.NumberOfFailedFrames;
+          }
+        RemoveSequenceFrameNode(scene, frameIt->InputNode);
+        RemoveSequenceFrameNode(scene, frameIt->OutputNode);
+        scene->RemoveNode(frameIt->CLINode);
+        frameIt = batch.RunningFrames.erase(frameIt);
+        frameDone = true;
+        }
+
+      // keep the pipeline full
+      while (!batch.Cancelled && batch.NextFrame < batch.NumberOfFrames
+             && static_cast<int>(batch.RunningFrames.size()) < batch.MaximumNumberOfConcurrentFrames)
+        {
+        vtkInternal::SequenceFrame frame;
+        frame.FrameIndex = batch.NextFrame++;
+        vtkMRMLNode* frameDataNode = batch.InputSequence->GetNthDataNode(frame.FrameIndex);
+        if (!frameDataNode)
+          {
+          ++batch.NumberOfFailedFrames;
+          frameDone = true;
+          continue;
+          }
+        std::ostringstream frameName;
+        frameName << batch.InputSequence->GetName() << "_"
+                  << batch.InputSequence->GetNthIndexValue(frame.FrameIndex);
+
+        // A frame is processed by its own CLI node (a copy of the batch node)
+        // between temporary input and output nodes. They are all in the scene,
+        // like the nodes of a regular run, but hidden and not saved.
+        frame.InputNode = vtkSmartPointer<vtkMRMLNode>::Take(scene->CreateNodeByClass(frameDataNode->GetClassName()));
+        frame.InputNode->CopyContent(frameDataNode, /* deepCopy= */ false);
+        frame.InputNode->SetName(frameName.str().c_str());
+        frame.InputNode->SetHideFromEditors(true);
+        frame.InputNode->SetSaveWithScene(false);
+        scene->AddNode(frame.InputNode);
+
+        frame.OutputNode = vtkSmartPointer<vtkMRMLNode>::Take(scene->CreateNodeByClass(batch.OutputClassName.c_str()));
+        frame.OutputNode->SetName((frameName.str() + "_" + batch.OutputParameterName).c_str());
+        frame.OutputNode->SetHideFromEditors(true);
+        frame.OutputNode->SetSaveWithScene(false);
+        scene->AddNode(frame.OutputNode);
+
+        frame.CLINode = vtkSmartPointer<vtkMRMLCommandLineModuleNode>::Take(
+          vtkMRMLCommandLineModuleNode::SafeDownCast(scene->CreateNodeByClass("vtkMRMLCommandLineModuleNode")));
+        frame.CLINode->CopyContent(node);
+        frame.CLINode->SetStatus(vtkMRMLCommandLineModuleNode::Idle, false);
+        frame.CLINode->SetParameterAsNode(batch.InputParameterName.c_str(), frame.InputNode);
+        frame.CLINode->SetParameterAsNode(batch.OutputParameterName.c_str(), frame.OutputNode);
+        frame.CLINode->SetName((frameName.str() + "_" + node->GetModuleTitle()).c_str());
+        frame.CLINode->SetHideFromEditors(true);
+        frame.CLINode->SetSaveWithScene(false);
+        scene->AddNode(frame.CLINode);
+        batch.RunningFrames.push_back(frame);
+
+        this->Apply(frame.CLINode, false);
+        if (frame.CLINode->GetStatus() == vtkMRMLCommandLineModuleNode::Idle)
+          {
+          // processing threads are not running, process the frame right away
+          this->ApplyAndWait(frame.CLINode, false);
+          updated = true;
+          }
+        }
+      }
+
+    if (frameDone)
+      {
+      // report per-frame progress and throughput
+      ModuleProcessInformation* batchInfo = node->GetModuleDescription().GetProcessInformation();
+      const double elapsedTime = vtkTimerLog::GetUniversalTime() - batch.StartTime;
+      const int numberOfDoneFrames = batch.NumberOfProcessedFrames + batch.NumberOfFailedFrames;
+      batchInfo->Progress = static_cast<float>(numberOfDoneFrames) / batch.NumberOfFrames;
+      batchInfo->ElapsedTime = elapsedTime;
+      std::ostringstream progressMessage;
+      progressMessage << "Frame " << numberOfDoneFrames << "/" << batch.NumberOfFrames;
+      if (elapsedTime > 0.)
+        {
+        progressMessage << " (" << std::fixed << std::setprecision(2)
+          << numberOfDoneFrames / elapsedTime << " frames/s)";
+        }
+      strncpy(batchInfo->ProgressMessage, progressMessage.str().c_str(), 1023);
+      node->Modified();
+      }
+
+    if (!batch.RunningFrames.empty()
+        || (!batch.Cancelled && batch.NextFrame < batch.NumberOfFrames))
+      {
+      continue;
+      }
+
+    // All frames are done
+    const double elapsedTime = vtkTimerLog::GetUniversalTime() - batch.StartTime;
+    vtkInfoMacro("ApplyToSequence: processed " << batch.NumberOfProcessedFrames << " of " << batch.NumberOfFrames
+      << " frames of " << batch.InputSequence->GetName() << " in " << elapsedTime << "s ("
+      << (elapsedTime > 0. ? batch.NumberOfProcessedFrames / elapsedTime : 0.) << " frames/s)");
+    ModuleProcessInformation* batchInfo = node->GetModuleDescription().GetProcessInformation();
+    batchInfo->Progress = 0;
+    batchInfo->ElapsedTime = elapsedTime;
+    int status = vtkMRMLCommandLineModuleNode::Completed;
+    if (batch.Cancelled)
+      {
+      status = vtkMRMLCommandLineModuleNode::Cancelled;
+      }
+    else if (batch.NumberOfFailedFrames > 0)
+      {
+      status = vtkMRMLCommandLineModuleNode::CompletedWithErrors;
+      }
+    this->Internal->SequenceBatches.erase(node);
+    node->SetStatus(status);
+    }
+
+  this->Internal->UpdatingSequenceBatches = false;
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::RequestSequenceBatchesUpdate()
+{
+  if (this->Internal->SequenceBatchesUpdatePending)
+    {
+    return;
+    }
+  this->Internal->SequenceBatchesUpdatePending = true;
+  // The update may remove the node that invokes the current event from the
+  // scene, it is done after the event is processed.
+  this->GetApplicationLogic()->InvokeEventWithDelay(
+    0, this, vtkSlicerCLIModuleLogic::RequestSequenceBatchesUpdateEvent);
+}
+
+//-----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SequenceBatchesCallback(vtkObject* vtkNotUsed(caller),
+  unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
+{
+  vtkSlicerCLIModuleLogic* self = reinterpret_cast<vtkSlicerCLIModuleLogic*>(clientData);
+  self->UpdateSequenceBatches();
+}
+
 //-----------------------------------------------------------------------------
 void vtkSlicerCLIModuleLogic::KillProcesses()
 {
@@ -710,6 +1527,33 @@ void vtkSlicerCLIModuleLogic::Apply ( vtkMRMLCommandLineModuleNode* node, bool u
                         &vtkSlicerCLIModuleLogic::ApplyTask,
                         node);
 
+  // Resources used by the task, they let the application logic decide
+  // how many tasks can run at the same time.
+  task->SetPriority(node->GetPriority());
+  vtkSlicerApplicationLogic* appLogic = this->GetApplicationLogic();
+  if (node->GetModuleDescription().GetType() == "SharedObjectModule")
+    {
+    // Shared object modules run in the Slicer process and their output
+    // streams are redirected globally: do not run them with other tasks.
+    task->SetNumberOfThreads(appLogic->GetProcessingThreadBudget());
+    }
+  else
+    {
+    std::string numberOfThreads = node->GetParameterAsString("NumberOfThreads");
+    if (numberOfThreads.empty())
+      {
+      numberOfThreads = node->GetParameterAsString("numberOfThreads");
+      }
+    int requestedThreads = numberOfThreads.empty() ? 1 : atoi(numberOfThreads.c_str());
+    task->SetNumberOfThreads(requestedThreads > 0 ?
+      requestedThreads : appLogic->GetProcessingThreadBudget());
+    }
+  task->SetEstimatedMemory(this->EstimateTaskMemory(node));
+
+  vtkNew<vtkSlicerCLITaskObserver> taskObserver;
+  taskObserver->Node = node;
+  task->AddObserver(vtkCommand::ModifiedEvent, taskObserver.GetPointer());
+
   // Client data on the task is just a regular pointer, up the
   // reference count on the node, we'll decrease the reference count
   // once the task actually runs
@@ -717,20 +1561,60 @@ void vtkSlicerCLIModuleLogic::Apply ( vtkMRMLCommandLineModuleNode* node, bool u
   node->SetAttribute("UpdateDisplay", updateDisplay ? "true" : "false");
 
   // Schedule the task
-  ret = this->GetApplicationLogic()->ScheduleTask( task.GetPointer() );
+  ret = appLogic->ScheduleTask( task.GetPointer() );
 
   if (!ret)
     {
     vtkWarningMacro( << "Could not schedule task" );
+    // the task will never release the node
+    node->UnRegister(this);
     }
   else
     {
+    // forget about the tasks that have been executed
+    for (auto it = this->Internal->ScheduledTasks.begin(); it != this->Internal->ScheduledTasks.end();)
+      {
+      it = (it->second == nullptr) ? this->Internal->ScheduledTasks.erase(it) : std::next(it);
+      }
+    this->Internal->ScheduledTasks[node] = task.GetPointer();
     node->SetOutputText("", false);
     node->SetErrorText("", false);
+    node->SetQueuePosition(task->GetQueuePosition(), false);
     node->SetStatus(vtkMRMLCommandLineModuleNode::Scheduled);
     }
 }
 
+//-----------------------------------------------------------------------------
+double vtkSlicerCLIModuleLogic::EstimateTaskMemory(vtkMRMLCommandLineModuleNode* node)
+{
+  vtkMRMLScene* scene = this->GetMRMLScene();
+  if (!node || !scene)
+    {
+    return 0.;
+    }
+  // Count the input volumes and assume the outputs (and intermediate
+  // results) take about as much memory as the inputs.
+  unsigned long inputKiB = 0;
+  const std::vector<ModuleParameterGroup>& groups = node->GetModuleDescription().GetParameterGroups();
+  for (const ModuleParameterGroup& group : groups)
+    {
+    for (const ModuleParameter& parameter : group.GetParameters())
+      {
+      if (parameter.GetTag() != "image" || parameter.GetChannel() != "input")
+        {
+        continue;
+        }
+      vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(
+        scene->GetNodeByID(parameter.GetValue()));
+      if (volumeNode && volumeNode->GetImageData())
+        {
+        inputKiB += volumeNode->GetImageData()->GetActualMemorySize();
+        }
+      }
+    }
+  return 2. * inputKiB / 1024.;
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerCLIModuleLogic
 ::SetMRMLApplicationLogic(vtkMRMLApplicationLogic* logic)
@@ -844,6 +1728,10 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     return;
     }
 
+  vtkSlicerCLIRunTelemetry telemetry;
+  telemetry.Start();
+  vtkMRMLTraceZoneMacro("CLI", "Run", node0->GetModuleDescription().GetTitle());
+
   // Set the callback for progress.  This will only be used for the
   // scope of this function.
   LogicNodePair lnp( this, node0 );
@@ -886,6 +1774,7 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     }
 
   vtkInfoMacro("ModuleType: " << node0->GetModuleDescription().GetType());
+  telemetry.ModuleType = node0->GetModuleDescription().GetType();
 
   // map to keep track of MRML Ids and filenames
   typedef std::map<std::string, std::string> MRMLIDToFileNameMap;
@@ -907,6 +1796,11 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
   // vector of files to delete
   std::set<std::string> filesToDelete;
 
+  // shared memory segments of the inputs that are passed through shared
+  // memory, and the files to use instead if a segment cannot be created
+  vtkSlicerCLISharedMemorySegments sharedMemorySegments;
+  MRMLIDToFileNameMap sharedMemoryFallbackFileNames;
+
   // iterators for parameter groups
   std::vector<ModuleParameterGroup>::iterator pgbeginit
     = node0->GetModuleDescription().GetParameterGroups().begin();
@@ -956,7 +1850,23 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
                                              (*pit).GetFileExtensions(),
                                              commandType);
 
-        filesToDelete.insert(fname);
+        // Scalar volumes and labelmaps given as input to an executable can
+        // be passed through shared memory instead of a temporary file
+        vtkMRMLNode* parameterNode = this->GetMRMLScene()->GetNodeByID(id.c_str());
+        if ((*pit).GetTag() == "image" && (*pit).GetChannel() == "input"
+            && commandType == CommandLineModule
+            && this->GetAllowSharedMemoryTransfer()
+            && vtkMRMLVolumeSharedMemory::IsSupported()
+            && (strcmp(parameterNode->GetClassName(), "vtkMRMLScalarVolumeNode") == 0
+                || strcmp(parameterNode->GetClassName(), "vtkMRMLLabelMapVolumeNode") == 0))
+          {
+          sharedMemoryFallbackFileNames[id] = fname;
+          fname = vtkMRMLVolumeSharedMemory::GenerateUniqueURI();
+          }
+        else
+          {
+          filesToDelete.insert(fname);
+          }
         if ((*pit).GetChannel() == "input")
           {
           nodesToWrite[id] = fname;
@@ -997,6 +1907,8 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
   // write out the input datasets
   //
   //
+  telemetry.BeginStage("WriteInputs");
+  unsigned long long sharedMemoryBytes = 0;
 
   std::set<std::string> MemoryTransferPossible;
   MemoryTransferPossible.insert("vtkMRMLScalarVolumeNode");
@@ -1110,6 +2022,35 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       this->AddCompleteModelHierarchyToMiniScene(miniscene.GetPointer(), mhnd, &sceneToMiniSceneMap, filesToDelete);
       }
 
+    // place the volume in shared memory if requested
+    if (vtkMRMLVolumeSharedMemory::IsSharedMemoryURI((*id2fn0).second))
+      {
+      out = nullptr;
+      vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(nd);
+      vtkNew<vtkMatrix4x4> ijkToRAS;
+      if (volumeNode)
+        {
+        volumeNode->GetIJKToRASMatrix(ijkToRAS.GetPointer());
+        }
+      if (volumeNode && vtkMRMLVolumeSharedMemory::WriteVolume(
+            (*id2fn0).second, volumeNode->GetImageData(), ijkToRAS.GetPointer()))
+        {
+        sharedMemorySegments.insert((*id2fn0).second);
+        vtkImageData* imageData = volumeNode->GetImageData();
+        sharedMemoryBytes += static_cast<unsigned long long>(imageData->GetScalarSize())
+          * imageData->GetNumberOfScalarComponents() * imageData->GetNumberOfPoints();
+        }
+      else
+        {
+        // Fall back to a temporary file
+        vtkWarningMacro("Unable to pass " << (*id2fn0).first << " through shared memory, using a temporary file");
+        std::string fileName = sharedMemoryFallbackFileNames[(*id2fn0).first];
+        filesToDelete.insert(fileName);
+        nodesToWrite[(*id2fn0).first] = fileName;
+        out = defaultOut;
+        }
+      }
+
     // if the file is to be written, then write it
     if (out)
       {
@@ -1197,9 +2138,11 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       vtkMultiThreader::GetCurrentThreadID(), true);
     }
   // write out the miniscene if needed
+  std::set<std::string> writtenFileNames;
   if (miniscene->GetNumberOfNodes() > 0)
     {
       miniscene->Commit( minisceneFilename.c_str() );
+      writtenFileNames.insert(minisceneFilename);
 
       // tell the storage nodes in the miniscene to write their data
       vtkCollection *nodes = miniscene->GetNodes();
@@ -1213,10 +2156,20 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
           if (storable->GetStorageNode())
           {
             storable->GetStorageNode()->WriteData(storable);
+            if (storable->GetStorageNode()->GetFileName())
+              {
+              writtenFileNames.insert(storable->GetStorageNode()->GetFileName());
+              }
           }
         }
       }
     }
+  for (id2fn0 = nodesToWrite.begin(); id2fn0 != nodesToWrite.end(); ++id2fn0)
+    {
+    writtenFileNames.insert((*id2fn0).second);
+    }
+  telemetry.EndStage(vtkSlicerCLIRunTelemetry::ThreadCPU,
+    sharedMemoryBytes + vtkSlicerCLIRunTelemetry::GetTotalFileSize(writtenFileNames));
 
   // build the command line
   //
@@ -1761,6 +2714,7 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     //
     // now run the process
     //
+    telemetry.BeginStage("Spawn");
     itksysProcess *process = itksysProcess_New();
 
     this->Internal->Processes.push_back(process);
@@ -1775,6 +2729,8 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
 
     // execute the command
     itksysProcess_Execute(process);
+    telemetry.EndStage(vtkSlicerCLIRunTelemetry::ThreadCPU);
+    telemetry.BeginStage("Compute");
 
     // restore the load path
     std::string putEnvString = ("ITK_AUTOLOAD_PATH=");
@@ -1910,6 +2866,8 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     this->Internal->ProcessesKillLock.lock();
     itksysProcess_WaitForExit(process, nullptr);
     this->Internal->ProcessesKillLock.unlock();
+    // the child process has been reaped, its resource usage is accounted
+    telemetry.EndStage(vtkSlicerCLIRunTelemetry::ChildrenCPU);
 
     vtkSlicerCLIModuleLogic::RemoveProgressInfoFromProcessOutput(stdoutbuffer);
     if (stdoutbuffer.size() > 0)
@@ -2017,6 +2975,8 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     std::streambuf* origcoutrdbuf = std::cout.rdbuf();
     std::streambuf* origcerrrdbuf = std::cerr.rdbuf();
     int returnValue = 0;
+    // the module may run its own threads, measure the whole process
+    telemetry.BeginStage("Compute");
     try
       {
       if (this->Internal->RedirectModuleStreams)
@@ -2075,6 +3035,7 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       std::cout.rdbuf( origcoutrdbuf );
       std::cerr.rdbuf( origcerrrdbuf );
       }
+    telemetry.EndStage(vtkSlicerCLIRunTelemetry::ProcessCPU);
     if (node0->GetStatus() == vtkMRMLCommandLineModuleNode::Cancelling)
       {
       node0->SetStatus(vtkMRMLCommandLineModuleNode::Cancelled, false);
@@ -2092,6 +3053,7 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       }
     }
 
+  telemetry.BeginStage("ReadOutputs");
   if (node0->GetStatus() == vtkMRMLCommandLineModuleNode::Cancelling)
     {
     node0->SetStatus(vtkMRMLCommandLineModuleNode::Cancelled, false);
@@ -2115,6 +3077,33 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       vtkMultiThreader::GetCurrentThreadID(), false);
     }
 
+  std::set<std::string> outputFileNames;
+  for (id2fn0 = nodesToReload.begin(); id2fn0 != nodesToReload.end(); ++id2fn0)
+    {
+    if (sceneToMiniSceneMap.find((*id2fn0).first) == sceneToMiniSceneMap.end())
+      {
+      outputFileNames.insert((*id2fn0).second);
+      }
+    }
+  if (miniscene->GetNumberOfNodes() > 0)
+    {
+    outputFileNames.insert(minisceneFilename);
+    }
+  telemetry.EndStage(vtkSlicerCLIRunTelemetry::ThreadCPU,
+    vtkSlicerCLIRunTelemetry::GetTotalFileSize(outputFileNames));
+  if (node0->GetStatus() == vtkMRMLCommandLineModuleNode::Completing)
+    {
+    // Outputs are loaded by the application logic in the main thread, the
+    // telemetry is published when the last request is processed.
+    telemetry.BeginStage("SceneUpdate");
+    this->Internal->AddPendingTelemetry(node0, telemetry);
+    }
+  else
+    {
+    this->Internal->PublishTelemetry(node0, telemetry);
+    this->GetApplicationLogic()->RequestModified( node0 );
+    }
+
   // import the results if the plugin was allowed to complete
   //
   //
@@ -2364,6 +3353,11 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
       this->Internal->GetLastRequest(node0) == 0)
     {
     node0->SetStatus(vtkMRMLCommandLineModuleNode::Completed, false);
+    if (this->Internal->TakePendingTelemetry(node0, telemetry))
+      {
+      telemetry.EndStage(vtkSlicerCLIRunTelemetry::ThreadCPU);
+      this->Internal->PublishTelemetry(node0, telemetry);
+      }
     this->GetApplicationLogic()->RequestModified( node0 );
     }
 }
@@ -2514,20 +3508,33 @@ void vtkSlicerCLIModuleLogic::ProcessMRMLLogicsEvents(vtkObject* caller,
       event == vtkSlicerApplicationLogic::RequestProcessedEvent)
     {
     vtkMTimeType uid = reinterpret_cast<vtkMTimeType>(callData);
+    vtkMRMLCommandLineModuleNode* node = nullptr;
+    {
+    std::lock_guard<std::mutex> lock(this->Internal->LastRequestsLock);
     vtkInternal::RequestType::iterator it =
       std::find_if(this->Internal->LastRequests.begin(),
       this->Internal->LastRequests.end(), vtkInternal::FindRequest(uid));
     if (it != this->Internal->LastRequests.end())
       {
-      vtkMRMLCommandLineModuleNode* node = it->second;
+      node = it->second;
+      // we are not interested in any request anymore because the cli node is
+      // Completed.
+      this->Internal->LastRequests.erase(it);
+      }
+    }
+    if (node)
+      {
       // If the status is not Completing, then there should be no request made
       // on the application logic.
       assert(node->GetStatus() == vtkMRMLCommandLineModuleNode::Completing);
-      this->Internal->LastRequests.erase(it);
-      // we are not interested in any request anymore because the cli node is
-      // Completed.
-
-      node->SetStatus(vtkMRMLCommandLineModuleNode::Completed);
+      node->SetStatus(vtkMRMLCommandLineModuleNode::Completed, false);
+      vtkSlicerCLIRunTelemetry telemetry;
+      if (this->Internal->TakePendingTelemetry(node, telemetry))
+        {
+        telemetry.EndStage(vtkSlicerCLIRunTelemetry::ProcessCPU);
+        this->Internal->PublishTelemetry(node, telemetry);
+        }
+      node->Modified();
       }
     }
 }
@@ -2542,6 +3549,12 @@ void vtkSlicerCLIModuleLogic
   // Observe only the CLI of the logic.
   vtkMRMLCommandLineModuleNode* cliNode =
     vtkMRMLCommandLineModuleNode::SafeDownCast(node);
+  if (cliNode && event == vtkCommand::ModifiedEvent &&
+      this->Internal->IsSequenceBatchNode(cliNode))
+    {
+    // A frame may be completed or the sequence processing cancelled.
+    this->RequestSequenceBatchesUpdate();
+    }
   if (cliNode &&
       cliNode->GetModuleTitle() ==
         this->Internal->DefaultModuleDescription.GetTitle())
@@ -2549,6 +3562,10 @@ void vtkSlicerCLIModuleLogic
     switch(event)
       {
       case vtkCommand::ModifiedEvent:
+        if (cliNode->GetStatus() == vtkMRMLCommandLineModuleNode::Cancelling)
+          {
+          this->CancelScheduledTask(cliNode);
+          }
         break;
       case vtkMRMLCommandLineModuleNode::AutoRunEvent:
         {
@@ -2596,6 +3613,30 @@ void vtkSlicerCLIModuleLogic
   this->Superclass::ProcessMRMLNodesEvents(caller, event, callData);
 }
 
+//---------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic
+::CancelScheduledTask(vtkMRMLCommandLineModuleNode* node)
+{
+  auto it = this->Internal->ScheduledTasks.find(node);
+  if (it == this->Internal->ScheduledTasks.end())
+    {
+    return;
+    }
+  vtkSmartPointer<vtkSlicerTask> task = it->second;
+  this->Internal->ScheduledTasks.erase(it);
+  if (!task || !this->GetApplicationLogic()->CancelTask(task))
+    {
+    // The task is already running (or done), it stops by itself.
+    return;
+    }
+  // The task will never run: do what ApplyTask does with a cancelled node,
+  // including releasing the reference taken in Apply().
+  node->SetOutputText("", false);
+  node->SetErrorText("", false);
+  node->SetStatus(vtkMRMLCommandLineModuleNode::Cancelled);
+  node->UnRegister(this);
+}
+
 //---------------------------------------------------------------------------
 void vtkSlicerCLIModuleLogic
 ::AutoRun(vtkMRMLCommandLineModuleNode* node)
@@ -24,6 +24,7 @@ class ModuleParameter;
 // MRML include
 #include "vtkMRMLScene.h"
 class vtkMRMLModelHierarchyNode;
+class vtkMRMLSequenceNode;
 class MRMLIDMap;
 
 // STL includes
@@ -96,6 +97,26 @@ public:
   void SetAllowInMemoryTransfer(int value);
   int GetAllowInMemoryTransfer() const;
 
+  /// Control use of shared memory for passing input scalar volumes and
+  /// labelmaps to command line module executables.
+  /// The executable is given a "slicershm:" URI instead of a file name,
+  /// it must read its images with an ITK ImageFileReader and load the
+  /// MRMLIDIO plugin (found through ITK_AUTOLOAD_PATH).
+  /// Other node types, outputs and platforms without shared memory support
+  /// always use temporary files. Disabled by default, a module can enable it
+  /// with a hidden "AllowSharedMemoryTransfer" parameter set to "true".
+  /// \sa vtkMRMLVolumeSharedMemory
+  void SetAllowSharedMemoryTransfer(int value);
+  int GetAllowSharedMemoryTransfer() const;
+
+  /// Append the telemetry of every module execution to \a fileName, as one
+  /// JSON object per line. The telemetry is not logged if the file name is
+  /// empty. The default file name is read from the SLICER_CLI_TELEMETRY_LOG
+  /// environment variable.
+  /// \sa Apply()
+  void SetTelemetryLogFileName(const std::string& fileName);
+  std::string GetTelemetryLogFileName() const;
+
   /// For debugging, control redirection of cout and cerr
   virtual void RedirectModuleStreamsOn();
   virtual void RedirectModuleStreamsOff();
@@ -108,6 +129,38 @@ public:
   /// If \a updateDisplay is 'true' the selection node will be updated with the
   /// the created nodes, which would automatically select the created nodes
   /// in the node selectors.
+  ///
+  /// When the execution ends, the timing and resource usage of each stage
+  /// are stored in the node, see vtkMRMLCommandLineModuleNode::GetTelemetryValue()
+  /// (they are not saved with the scene):
+  ///  - "<Stage>.WallTime": elapsed time in seconds.
+  ///  - "<Stage>.ThreadCPUTime": user + system time of the processing thread,
+  ///    in seconds. "<Stage>.ProcessCPUTime" is used instead for the stages
+  ///    running in the main thread, for shared object modules and on platforms
+  ///    without thread times: it includes the other threads of the application.
+  ///  - "<Stage>.ChildrenCPUTime": user + system time of all the child processes
+  ///    of the application terminated during the stage, in seconds. It includes
+  ///    the executables of the other modules that ended meanwhile.
+  ///  - "<Stage>.ProcessMaxRSS": maximum resident set size of the application
+  ///    since it started, in MB, not the peak of the stage.
+  ///  - "<Stage>.ChildrenMaxRSS": maximum resident set size of the largest child
+  ///    process terminated since the application started, in MB.
+  ///  - "<Stage>.Bytes": size of the data transferred by the stage.
+  ///  - "TotalWallTime": sum of the wall times of the stages.
+  /// The stages are:
+  ///  - WriteInputs: writing the input nodes to temporary files, shared memory
+  ///    or the mini-scene. Bytes is the size of the written data.
+  ///  - Spawn: starting the executable (command line modules only).
+  ///  - Compute: running the module. Command line modules report the children
+  ///    values, shared object modules the process values.
+  ///  - ReadOutputs: collecting the outputs of the module. Bytes is the size of
+  ///    the output files.
+  ///  - SceneUpdate: loading the outputs into the scene, done by the
+  ///    application logic in the main thread.
+  /// Values that are not available on the platform are not reported (e.g. the
+  /// resident set sizes on Windows).
+  /// Stages that are not executed (e.g. because the module failed) are not reported.
+  /// \sa SetTelemetryLogFileName()
   void Apply( vtkMRMLCommandLineModuleNode* node, bool updateDisplay = true );
 
   /// Don't start the CLI in a separate thread, but run it in the main thread.
@@ -118,6 +171,33 @@ public:
   /// in the node selectors.
   void ApplyAndWait ( vtkMRMLCommandLineModuleNode* node, bool updateDisplay = true);
 
+  /// Run the module on every frame of \a inputSequence and store the results
+  /// into \a outputSequence, at the same index values.
+  /// For each frame, the node selected for \a inputParameterName is replaced by
+  /// the frame data node and the node selected for \a outputParameterName by a
+  /// new node (of the same type as the selected output node, or of the same type
+  /// as the input frames if no output node is selected). Other parameters are
+  /// taken from \a node.
+  /// Frames are processed as a pipeline: up to \a maximumNumberOfConcurrentFrames
+  /// frames are scheduled at the same time (the maximum number of processing
+  /// tasks of the application logic if 0), the next frame is scheduled as soon
+  /// as a frame is completed. Each frame is run by a copy of \a node, the
+  /// copies and the frame nodes are added to the scene (hidden and not saved)
+  /// and removed once the frame is stored in \a outputSequence.
+  /// Like Apply(), this method is non blocking: \a node must be in the scene,
+  /// it is Running until all frames are processed and then Completed,
+  /// CompletedWithErrors (if a frame failed) or Cancelled. The next frames
+  /// are scheduled from the application event loop. If the processing threads
+  /// are not running, the frames are run in the main thread and the method
+  /// returns once they are all processed.
+  /// The progress of \a node is updated after every frame with the number of
+  /// processed frames and the throughput. Cancelling \a node stops the processing.
+  /// Returns false if the processing could not be started.
+  bool ApplyToSequence(vtkMRMLCommandLineModuleNode* node,
+                       const std::string& inputParameterName, vtkMRMLSequenceNode* inputSequence,
+                       const std::string& outputParameterName, vtkMRMLSequenceNode* outputSequence,
+                       int maximumNumberOfConcurrentFrames = 0);
+
   void KillProcesses();
 
 //   void LazyEvaluateModuleTarget(ModuleDescription& moduleDescriptionObject);
@@ -166,10 +246,33 @@ protected:
   /// Call apply because the node requests it.
   void AutoRun(vtkMRMLCommandLineModuleNode* cliNode);
 
+  /// Remove the task of a cancelled node from the processing queue if it
+  /// has not started yet.
+  /// \sa vtkSlicerApplicationLogic::CancelTask()
+  void CancelScheduledTask(vtkMRMLCommandLineModuleNode* cliNode);
+
+  /// Collect the completed frames of the sequences processed by
+  /// ApplyToSequence(), schedule the next frames and update the status of
+  /// the sequence processing nodes.
+  /// \sa RequestSequenceBatchesUpdate()
+  void UpdateSequenceBatches();
+
+  /// Call UpdateSequenceBatches() from the application event loop.
+  /// Requests are merged until the update is done.
+  void RequestSequenceBatchesUpdate();
+  static void SequenceBatchesCallback(vtkObject* caller, unsigned long eid,
+                                      void* clientData, void* callData);
+
+  /// Estimate the memory (in MB) needed to run the module on the node
+  /// parameters. It is used by the application logic to limit the number
+  /// of modules running at the same time.
+  double EstimateTaskMemory(vtkMRMLCommandLineModuleNode* cliNode);
+
     /// List of custom events fired by the class.
   enum Events
     {
-    RequestHierarchyEditEvent = vtkCommand::UserEvent + 1
+    RequestHierarchyEditEvent = vtkCommand::UserEvent + 1,
+    RequestSequenceBatchesUpdateEvent
     };
 
   // Add a model hierarchy node and all its descendents to a scene (miniscene to sent to a CLI).
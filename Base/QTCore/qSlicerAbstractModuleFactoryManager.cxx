@@ -20,16 +20,105 @@
 
 // Qt includes
 #include <QDir>
+#include <QElapsedTimer>
+#include <QPair>
+#include <QRunnable>
+#include <QTextStream>
+#include <QThreadPool>
 
 // Slicer includes
 #include "qSlicerCoreApplication.h"
 #include "qSlicerAbstractModuleFactoryManager.h"
 #include "qSlicerAbstractCoreModule.h"
 
+// MRML includes
+#include <vtkMRMLTracer.h>
+
 // STD includes
+#include <algorithm>
 #include <csignal>
 #include <typeinfo>
 
+namespace
+{
+typedef qSlicerAbstractModuleFactoryManager::qSlicerFileBasedModuleFactory
+  qSlicerFileBasedModuleFactory;
+
+//-----------------------------------------------------------------------------
+struct qSlicerSearchPathScan
+{
+  qSlicerSearchPathScan() : ElapsedNSecs(0) {}
+  /// Files of the search path recognized by a factory, in directory order.
+  QList<QPair<QFileInfo, qSlicerFileBasedModuleFactory*> > ModuleFiles;
+  QElapsedTimer Timer;
+  qint64 ElapsedNSecs;
+};
+
+//-----------------------------------------------------------------------------
+qSlicerFileBasedModuleFactory* moduleFileFactory(const QFileInfo& file,
+  const QVector<qSlicerFileBasedModuleFactory*>& factories, bool verbose)
+{
+  foreach(qSlicerFileBasedModuleFactory* factory, factories)
+    {
+    if (verbose)
+      {
+      qDebug() << " checking file: " << file.absoluteFilePath() << " as a " << typeid(*factory).name();
+      }
+    if (!factory->isValidFile(file))
+      {
+      continue;
+      }
+    if (verbose)
+      {
+      qDebug() << " recognized file: " << file.absoluteFilePath() << " as a " << typeid(*factory).name();
+      }
+    return factory;
+    }
+  return nullptr;
+}
+
+//-----------------------------------------------------------------------------
+/// List the files of a search path and find the factory of each file.
+/// isValidFile() looks at the file name and file system attributes, and reads
+/// the first line of .py files to recognize scripted CLIs
+/// (qSlicerUtils::isCLIScriptedExecutable). It only uses local file objects,
+/// it is safe to call it from multiple threads. Nothing is logged from the
+/// worker threads, recognized files are reported once the scan is done.
+class qSlicerSearchPathScanner : public QRunnable
+{
+public:
+  qSlicerSearchPathScanner(const QString& path,
+                           const QVector<qSlicerFileBasedModuleFactory*>& factories,
+                           qSlicerSearchPathScan* scan)
+    : Path(path), Factories(factories), Scan(scan)
+  {
+  }
+
+  void run() override
+  {
+    vtkMRMLTraceZoneMacro("Modules", "Search",
+      vtkMRMLTracer::IsEnabled() ? this->Path.toStdString() : std::string());
+    this->Scan->Timer.start();
+    QDir directory(this->Path);
+    /// \tbd recursive search ?
+    foreach (const QFileInfo& file, directory.entryInfoList(QDir::Files))
+      {
+      qSlicerFileBasedModuleFactory* factory = moduleFileFactory(file, this->Factories, false);
+      if (factory)
+        {
+        this->Scan->ModuleFiles << qMakePair(file, factory);
+        }
+      }
+    this->Scan->ElapsedNSecs = this->Scan->Timer.nsecsElapsed();
+  }
+
+protected:
+  QString Path;
+  QVector<qSlicerFileBasedModuleFactory*> Factories;
+  qSlicerSearchPathScan* Scan;
+};
+}
+
 //-----------------------------------------------------------------------------
 class qSlicerAbstractModuleFactoryManagerPrivate
 {
@@ -52,6 +141,19 @@ public:
   // the risk of creating a nullptr entry if the module is not registered.
   qSlicerModuleFactory* registeredModuleFactory(const QString& moduleName)const;
 
+  /// Scan the search paths in parallel and register the modules that are
+  /// found in the order of \a paths.
+  void registerModules(const QStringList& paths);
+  void registerModule(const QFileInfo& file, qSlicerFileBasedModuleFactory* moduleFactory);
+
+  struct TimelineEvent
+  {
+    QString Step;
+    QString Name;
+    qint64 StartMSecs;
+    qint64 ElapsedNSecs;
+  };
+
   QStringList SearchPaths;
   QStringList ExplicitModules;
   QStringList ModulesToIgnore;
@@ -60,6 +162,10 @@ public:
   QMap<QString, qSlicerModuleFactory*> RegisteredModules;
   QMap<QString, QStringList> ModuleDependees;
 
+  /// Started at construction, events are timed relatively to it.
+  QElapsedTimer Timer;
+  QList<TimelineEvent> Timeline;
+
   bool Verbose;
 };
 
@@ -69,6 +175,7 @@ qSlicerAbstractModuleFactoryManagerPrivate::qSlicerAbstractModuleFactoryManagerP
   : q_ptr(&object)
 {
   this->Verbose = false;
+  this->Timer.start();
 }
 
 //-----------------------------------------------------------------------------
@@ -250,6 +357,7 @@ QStringList qSlicerAbstractModuleFactoryManager::ignoredModuleNames()const
 void qSlicerAbstractModuleFactoryManager::registerModules()
 {
   Q_D(qSlicerAbstractModuleFactoryManager);
+  vtkMRMLTraceZoneMacro("Modules", "Register");
   // Register "regular" factories first
   // \todo: don't support factories other than filebased factories
   foreach(qSlicerModuleFactory* factory, d->notFileBasedFactories())
@@ -266,67 +374,85 @@ void qSlicerAbstractModuleFactoryManager::registerModules()
       }
     }
   // then register file based factories
-  foreach(const QString& path, d->SearchPaths)
+  if (d->Verbose)
     {
-    if (d->Verbose)
+    foreach(const QString& path, d->SearchPaths)
       {
       qDebug() << "Searching path: " << path;
       }
-    this->registerModules(path);
     }
+  d->registerModules(d->SearchPaths);
   emit this->modulesRegistered(d->RegisteredModules.keys());
 }
 
 //-----------------------------------------------------------------------------
 void qSlicerAbstractModuleFactoryManager::registerModules(const QString& path)
 {
-  QDir directory(path);
-  /// \tbd recursive search ?
-  foreach (const QFileInfo& file,
-           directory.entryInfoList(QDir::Files))
-    {
-    this->registerModule(file);
-    }
+  Q_D(qSlicerAbstractModuleFactoryManager);
+  d->registerModules(QStringList(path));
 }
 
 //-----------------------------------------------------------------------------
 void qSlicerAbstractModuleFactoryManager::registerModule(const QFileInfo& file)
 {
   Q_D(qSlicerAbstractModuleFactoryManager);
-
-  qSlicerFileBasedModuleFactory* moduleFactory = nullptr;
-  foreach(qSlicerFileBasedModuleFactory* factory, d->fileBasedFactories())
-    {
-    if (d->Verbose)
-      {
-      qDebug() << " checking file: " << file.absoluteFilePath() << " as a " << typeid(*factory).name();
-      }
-    if (!factory->isValidFile(file))
-      {
-      continue;
-      }
-    if (d->Verbose)
-      {
-      qDebug() << " recognized file: " << file.absoluteFilePath() << " as a " << typeid(*factory).name();
-      }
-    moduleFactory = factory;
-    break;
-    }
+  qSlicerFileBasedModuleFactory* moduleFactory =
+    moduleFileFactory(file, d->fileBasedFactories(), d->Verbose);
   // File not supported by any factory
   if (moduleFactory == nullptr)
     {
     return;
     }
+  d->registerModule(file, moduleFactory);
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerAbstractModuleFactoryManagerPrivate::registerModules(const QStringList& paths)
+{
+  Q_Q(qSlicerAbstractModuleFactoryManager);
+  // Listing the directories and checking the files is mostly waiting on the
+  // file system, do it for all the paths at once. Registration is done
+  // afterward, sequentially, as the order of the paths matters when modules
+  // with the same name are found in multiple paths.
+  QVector<qSlicerSearchPathScan> scans(paths.count());
+  QVector<qSlicerFileBasedModuleFactory*> factories = this->fileBasedFactories();
+  QThreadPool threadPool;
+  for (int i = 0; i < paths.count(); ++i)
+    {
+    threadPool.start(new qSlicerSearchPathScanner(paths[i], factories, &scans[i]));
+    }
+  threadPool.waitForDone();
+
+  for (int i = 0; i < paths.count(); ++i)
+    {
+    q->addTimelineEvent("Search", paths[i], scans[i].Timer, scans[i].ElapsedNSecs);
+    for (const QPair<QFileInfo, qSlicerFileBasedModuleFactory*>& moduleFile : scans[i].ModuleFiles)
+      {
+      if (this->Verbose)
+        {
+        qDebug() << " recognized file: " << moduleFile.first.absoluteFilePath()
+                 << " as a " << typeid(*moduleFile.second).name();
+        }
+      this->registerModule(moduleFile.first, moduleFile.second);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerAbstractModuleFactoryManagerPrivate::registerModule(
+  const QFileInfo& file, qSlicerFileBasedModuleFactory* moduleFactory)
+{
+  Q_Q(qSlicerAbstractModuleFactoryManager);
   QString moduleName = moduleFactory->itemKey(file);
   bool dontEmitSignal = false;
   // Has the module been already registered
-  qSlicerModuleFactory* existingModuleFactory = d->registeredModuleFactory(moduleName);
+  qSlicerModuleFactory* existingModuleFactory = this->registeredModuleFactory(moduleName);
   if (existingModuleFactory)
     {
-    if (d->Factories[existingModuleFactory] >=
-        d->Factories[moduleFactory])
+    if (this->Factories[existingModuleFactory] >=
+        this->Factories[moduleFactory])
       {
-      if (d->Verbose)
+      if (this->Verbose)
         {
         qDebug() << " file: " << file.absoluteFilePath() << " already registered";
         }
@@ -337,33 +463,33 @@ void qSlicerAbstractModuleFactoryManager::registerModule(const QFileInfo& file)
     //existingModuleFactory->unregisterItem(file);
     dontEmitSignal = true;
     }
-  if (d->ModulesToIgnore.contains(moduleName))
+  if (this->ModulesToIgnore.contains(moduleName))
     {
     //qDebug() << "Ignore module" << moduleName;
-    if (d->Verbose)
+    if (this->Verbose)
       {
       qDebug() << " file: " << file.absoluteFilePath() << " is in ignore list";
       }
-    d->IgnoredModules[moduleName] = file;
-    emit moduleIgnored(moduleName);
+    this->IgnoredModules[moduleName] = file;
+    emit q->moduleIgnored(moduleName);
     return;
     }
   QString registeredModuleName = moduleFactory->registerFileItem(file);
   if (registeredModuleName != moduleName)
     {
     //qDebug() << "Ignore module" << moduleName;
-    if (d->Verbose)
+    if (this->Verbose)
       {
       qDebug() << " file: " << file.absoluteFilePath() << " ignored because moduleName does not match registeredModuleName";
       }
-    d->IgnoredModules[moduleName] = file;
-    emit moduleIgnored(moduleName);
+    this->IgnoredModules[moduleName] = file;
+    emit q->moduleIgnored(moduleName);
     return;
     }
-  d->RegisteredModules[moduleName] = moduleFactory;
+  this->RegisteredModules[moduleName] = moduleFactory;
   if (!dontEmitSignal)
     {
-    emit moduleRegistered(moduleName);
+    emit q->moduleRegistered(moduleName);
     }
 }
 
@@ -400,7 +526,12 @@ qSlicerAbstractCoreModule* qSlicerAbstractModuleFactoryManager
     qCritical() << "Fail to instantiate module " << moduleName << " (not registered)";
     return nullptr;
     }
+  vtkMRMLTraceZoneMacro("Modules", "Instantiate",
+    vtkMRMLTracer::IsEnabled() ? moduleName.toStdString() : std::string());
+  QElapsedTimer timer;
+  timer.start();
   qSlicerAbstractCoreModule* module = factory->instantiate(moduleName);
+  this->addTimelineEvent("Instantiate", moduleName, timer, timer.nsecsElapsed());
   if (!module)
     {
     qCritical() << "Fail to instantiate module " << moduleName;
@@ -554,3 +685,78 @@ void qSlicerAbstractModuleFactoryManager::setIsVerbose(bool flag)
   d->Verbose = flag;
 }
 
+
+//---------------------------------------------------------------------------
+void qSlicerAbstractModuleFactoryManager::addTimelineEvent(const QString& step, const QString& name,
+                                                           const QElapsedTimer& timer, qint64 elapsedNSecs)
+{
+  Q_D(qSlicerAbstractModuleFactoryManager);
+  qSlicerAbstractModuleFactoryManagerPrivate::TimelineEvent event;
+  event.Step = step;
+  event.Name = name;
+  event.StartMSecs = timer.isValid() ?
+    timer.msecsSinceReference() - d->Timer.msecsSinceReference() : 0;
+  event.ElapsedNSecs = elapsedNSecs;
+  d->Timeline << event;
+}
+
+//---------------------------------------------------------------------------
+QString qSlicerAbstractModuleFactoryManager::startupTimelineReport()const
+{
+  Q_D(const qSlicerAbstractModuleFactoryManager);
+  typedef qSlicerAbstractModuleFactoryManagerPrivate::TimelineEvent TimelineEvent;
+  auto toMSecs = [](qint64 nsecs) { return QString::number(nsecs / 1.e6, 'f', 1); };
+
+  // Time spent in each step, and when the step started and ended.
+  QStringList steps;
+  QMap<QString, qint64> stepElapsedNSecs;
+  QMap<QString, qint64> stepStartMSecs;
+  QMap<QString, qint64> stepEndMSecs;
+  // Time spent for each module (or search path), per step.
+  QStringList names;
+  QMap<QString, qint64> nameElapsedNSecs;
+  QMap<QString, QStringList> nameSteps;
+  foreach(const TimelineEvent& event, d->Timeline)
+    {
+    qint64 endMSecs = event.StartMSecs + event.ElapsedNSecs / 1000000;
+    if (!steps.contains(event.Step))
+      {
+      steps << event.Step;
+      stepStartMSecs[event.Step] = event.StartMSecs;
+      stepEndMSecs[event.Step] = endMSecs;
+      }
+    stepElapsedNSecs[event.Step] += event.ElapsedNSecs;
+    stepStartMSecs[event.Step] = qMin(stepStartMSecs[event.Step], event.StartMSecs);
+    stepEndMSecs[event.Step] = qMax(stepEndMSecs[event.Step], endMSecs);
+
+    if (!names.contains(event.Name))
+      {
+      names << event.Name;
+      }
+    nameElapsedNSecs[event.Name] += event.ElapsedNSecs;
+    nameSteps[event.Name] << QString("%1 %2 ms").arg(event.Step).arg(toMSecs(event.ElapsedNSecs));
+    }
+  std::stable_sort(names.begin(), names.end(),
+    [&nameElapsedNSecs](const QString& name1, const QString& name2)
+    {
+    return nameElapsedNSecs[name1] > nameElapsedNSecs[name2];
+    });
+
+  QString report;
+  QTextStream stream(&report);
+  stream << "Module startup timeline:\n";
+  foreach(const QString& step, steps)
+    {
+    stream << QString("  %1: %2 ms (from %3 ms to %4 ms)\n")
+      .arg(step).arg(toMSecs(stepElapsedNSecs[step]))
+      .arg(stepStartMSecs[step]).arg(stepEndMSecs[step]);
+    }
+  stream << "Cost per module:\n";
+  foreach(const QString& name, names)
+    {
+    stream << QString("  %1 ms %2 (%3)\n")
+      .arg(toMSecs(nameElapsedNSecs[name]), 8).arg(name)
+      .arg(nameSteps[name].join(", "));
+    }
+  return report;
+}
@@ -24,6 +24,7 @@
 // Qt includes
 #include <QObject>
 #include <QString>
+class QElapsedTimer;
 
 // CTK includes
 #include <ctkAbstractFileBasedFactory.h>
@@ -54,6 +55,8 @@ class qSlicerAbstractModuleFactoryManagerPrivate;
 /// factory if they can load the file. If there is a factory that supports the
 /// file, the manager associates the factory to the file path, otherwise the
 /// file is discarded.
+/// The search paths are scanned in parallel, the modules are then registered
+/// in the order of the search paths.
 ///   factoryManager->registerModules();
 /// 5) Instantiate all the registered modules
 ///   factoryManager->instantiateModules();
@@ -196,6 +199,11 @@ public:
   /// \sa dependentModules(), qSlicerAbstractCoreModule::dependencies()
   QStringList moduleDependees(const QString& module)const;
 
+  /// Return a human readable report of the time spent scanning each search
+  /// path, instantiating and loading each module. Modules are sorted from the
+  /// most to the least expensive.
+  Q_INVOKABLE QString startupTimelineReport()const;
+
 signals:
   /// \brief This signal is emitted when all the modules associated with the
   /// registered factories have been loaded
@@ -233,6 +241,12 @@ protected:
   /// Uninstantiate a module given its \a moduleName
   virtual void uninstantiateModule(const QString& moduleName);
 
+  /// Add to the startup timeline that the \a step (e.g. "Load") of module
+  /// \a name started when \a timer was started and lasted \a elapsedNSecs.
+  /// \sa startupTimelineReport()
+  void addTimelineEvent(const QString& step, const QString& name,
+                        const QElapsedTimer& timer, qint64 elapsedNSecs);
+
 private:
   Q_DECLARE_PRIVATE(qSlicerAbstractModuleFactoryManager);
   Q_DISABLE_COPY(qSlicerAbstractModuleFactoryManager);
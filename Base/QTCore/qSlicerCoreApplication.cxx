@@ -99,6 +99,7 @@
 # include <vtkMRMLCommandLineModuleNode.h>
 #endif
 #include <vtkMRMLScene.h>
+#include <vtkMRMLTracer.h>
 
 // CTK includes
 #include <ctkUtils.h>
@@ -241,6 +242,12 @@ void qSlicerCoreApplicationPrivate::init()
 
   this->parseArguments();
 
+  // Start tracing as early as possible, the trace is written at exit
+  if (!this->CoreCommandOptions->traceFile().isEmpty())
+    {
+    vtkMRMLTracer::GetInstance()->EnabledOn();
+    }
+
   this->SlicerHome = this->discoverSlicerHomeDirectory();
 
   // Save the environment if no launcher is used (this is for example the case
@@ -2011,6 +2018,17 @@ void qSlicerCoreApplication::onAboutToQuit()
 
   d->ModuleManager->factoryManager()->unloadModules();
 
+  QString traceFile = this->coreCommandOptions()->traceFile();
+  if (!traceFile.isEmpty())
+    {
+    vtkMRMLTracer* tracer = vtkMRMLTracer::GetInstance();
+    tracer->EnabledOff();
+    if (!tracer->WriteChromeTrace(traceFile.toUtf8()))
+      {
+      qWarning() << "Failed to write trace file" << traceFile;
+      }
+    }
+
 #ifdef Slicer_USE_PYTHONQT
   // Override return code only if testing mode is enabled
   if (this->corePythonManager()->pythonErrorOccured() && this->testAttribute(AA_EnableTesting))
@@ -334,6 +334,13 @@ bool qSlicerCoreCommandOptions::verboseModuleDiscovery() const
   return d->ParsedArgs.value("verbose-module-discovery").toBool();
 }
 
+//-----------------------------------------------------------------------------
+QString qSlicerCoreCommandOptions::traceFile() const
+{
+  Q_D(const qSlicerCoreCommandOptions);
+  return d->ParsedArgs.value("trace-file").toString();
+}
+
 //-----------------------------------------------------------------------------
 bool qSlicerCoreCommandOptions::verbose()const
 {
@@ -483,6 +490,10 @@ void qSlicerCoreCommandOptions::addArguments()
   this->addArgument("verbose-module-discovery", "", QVariant::Bool,
                     /*no tr*/"Enable verbose output during module discovery process.");
 
+  this->addArgument("trace-file", "", QVariant::String,
+                    /*no tr*/"Record the time spent loading modules, importing scenes, reading and writing data, "
+                    "updating views and running CLIs, and write it to this file in Chrome trace format at exit.");
+
   this->addArgument("disable-settings", "", QVariant::Bool,
                     /*no tr*/"Start application ignoring user settings and using new temporary settings.");
 
@@ -18,6 +18,9 @@
 
 ==============================================================================*/
 
+// Qt includes
+#include <QElapsedTimer>
+
 // Slicer includes
 #include "qSlicerModuleFactoryManager.h"
 #include "qSlicerAbstractCoreModule.h"
@@ -26,6 +29,9 @@
 
 #include <vtkSlicerApplicationLogic.h>
 
+// MRML includes
+#include <vtkMRMLTracer.h>
+
 // STD includes
 #include <algorithm>
 
@@ -39,6 +45,7 @@ public:
   qSlicerModuleFactoryManagerPrivate(qSlicerModuleFactoryManager& object);
 
   QStringList LoadedModules;
+  QStringList ModulesToLoadOnDemand;
   vtkSlicerApplicationLogic* AppLogic;
   vtkMRMLScene* MRMLScene;
 };
@@ -74,12 +81,14 @@ void qSlicerModuleFactoryManager::printAdditionalInfo()
   Q_D(qSlicerModuleFactoryManager);
   this->Superclass::printAdditionalInfo();
   qDebug() << "LoadedModules: " << d->LoadedModules;
+  qDebug() << "ModulesToLoadOnDemand: " << d->ModulesToLoadOnDemand;
+  qDebug().noquote() << this->startupTimelineReport();
 }
 
 //-----------------------------------------------------------------------------
 int qSlicerModuleFactoryManager::loadModules()
 {
-  foreach(const QString& name, this->instantiatedModuleNames())
+  foreach(const QString& name, this->modulesToLoad())
     {
     this->loadModule(name);
     }
@@ -87,6 +96,21 @@ int qSlicerModuleFactoryManager::loadModules()
   return this->loadedModuleNames().count();
 }
 
+//---------------------------------------------------------------------------
+QStringList qSlicerModuleFactoryManager::modulesToLoad()const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  QStringList moduleNames;
+  foreach(const QString& name, this->instantiatedModuleNames())
+    {
+    if (!d->ModulesToLoadOnDemand.contains(name))
+      {
+      moduleNames << name;
+      }
+    }
+  return moduleNames;
+}
+
 //---------------------------------------------------------------------------
 bool qSlicerModuleFactoryManager::loadModules(const QStringList& modules)
 {
@@ -151,6 +175,10 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
     qDebug() << "Loading module" << name;
     }
 
+  // Includes the loading of the dependencies
+  vtkMRMLTraceZoneMacro("Modules", "Load",
+    vtkMRMLTracer::IsEnabled() ? name.toStdString() : std::string());
+
   // Instantiate the module if needed
   qSlicerAbstractCoreModule* instance = this->moduleInstance(name);
   if (!instance)
@@ -173,6 +201,10 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
       }
     }
 
+  // Dependencies are timed separately
+  QElapsedTimer timer;
+  timer.start();
+
   // Update internal Map
   d->LoadedModules << name;
 
@@ -201,6 +233,8 @@ bool qSlicerModuleFactoryManager::loadModule(const QString& name, const QString&
   // Handle post-load initialization
   emit this->moduleLoaded(name);
 
+  this->addTimelineEvent("Load", name, timer, timer.nsecsElapsed());
+
   return true;
 }
 
@@ -211,6 +245,28 @@ bool qSlicerModuleFactoryManager::isLoaded(const QString& name)const
   return d->LoadedModules.contains(name);
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerModuleFactoryManager::setModulesToLoadOnDemand(const QStringList& moduleNames)
+{
+  Q_D(qSlicerModuleFactoryManager);
+  d->ModulesToLoadOnDemand = moduleNames;
+}
+
+//-----------------------------------------------------------------------------
+QStringList qSlicerModuleFactoryManager::modulesToLoadOnDemand()const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  return d->ModulesToLoadOnDemand;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerModuleFactoryManager::isLoadDeferred(const QString& name)const
+{
+  Q_D(const qSlicerModuleFactoryManager);
+  return d->ModulesToLoadOnDemand.contains(name)
+    && this->isInstantiated(name) && !this->isLoaded(name);
+}
+
 //-----------------------------------------------------------------------------
 QStringList qSlicerModuleFactoryManager::loadedModuleNames()const
 {
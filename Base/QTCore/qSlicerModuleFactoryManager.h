@@ -38,6 +38,18 @@ class Q_SLICER_BASE_QTCORE_EXPORT qSlicerModuleFactoryManager
   : public qSlicerAbstractModuleFactoryManager
 {
   Q_OBJECT
+  /// This property holds the names of the modules to load on demand.
+  ///
+  /// These modules are registered and instantiated with the other modules,
+  /// their metadata (title, categories, associated node types...) is then
+  /// available, but they are not loaded by loadModules(): their logic is
+  /// created and connected to the scene only the first time they are
+  /// requested with loadModule() (e.g. by qSlicerModuleManager::loadDeferredModule())
+  /// or when a loaded module depends on them.
+  /// Modules whose logic registers MRML node classes should not be loaded on
+  /// demand if scenes containing these nodes can be loaded before the module
+  /// is used.
+  Q_PROPERTY(QStringList modulesToLoadOnDemand READ modulesToLoadOnDemand WRITE setModulesToLoadOnDemand)
 public:
   typedef qSlicerAbstractModuleFactoryManager Superclass;
   qSlicerModuleFactoryManager(QObject* newParent = nullptr);
@@ -47,7 +59,7 @@ public:
 
   void printAdditionalInfo() override;
 
-  /// Load all the instantiated modules.
+  /// Load all the instantiated modules except the modules to load on demand.
   /// To register and initialize modules, please use
   /// qSlicerModuleFactoryManager::registerModules();
   /// qSlicerModuleFactoryManager::initializeModules();
@@ -56,6 +68,11 @@ public:
   /// \sa qSlicerModuleFactoryManager::instantiateModules()
   Q_INVOKABLE int loadModules();
 
+  /// Return the instantiated modules that are loaded by loadModules(), that is
+  /// all of them except the modules to load on demand.
+  /// \sa modulesToLoadOnDemand
+  Q_INVOKABLE QStringList modulesToLoad()const;
+
   /// Return the list of all the loaded modules
   Q_INVOKABLE QStringList loadedModuleNames()const;
 
@@ -88,6 +105,14 @@ public:
   /// \todo move it as protected
   bool loadModule(const QString& name);
 
+  void setModulesToLoadOnDemand(const QStringList& moduleNames);
+  QStringList modulesToLoadOnDemand()const;
+
+  /// Return true if module \a name is instantiated but not loaded yet
+  /// because it is loaded on demand.
+  /// \sa modulesToLoadOnDemand
+  Q_INVOKABLE bool isLoadDeferred(const QString& name)const;
+
   /// Return all module paths that are direct child of \a basePath.
   QStringList modulePaths(const QString& basePath);
 
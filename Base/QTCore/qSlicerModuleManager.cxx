@@ -72,6 +72,17 @@ qSlicerAbstractCoreModule* qSlicerModuleManager::module(const QString& name)cons
   return d->ModuleFactoryManager->loadedModule(name);
 }
 
+//---------------------------------------------------------------------------
+qSlicerAbstractCoreModule* qSlicerModuleManager::loadDeferredModule(const QString& name)
+{
+  Q_D(qSlicerModuleManager);
+  if (d->ModuleFactoryManager->isLoadDeferred(name))
+    {
+    d->ModuleFactoryManager->loadModule(name);
+    }
+  return d->ModuleFactoryManager->loadedModule(name);
+}
+
 //---------------------------------------------------------------------------
 QStringList qSlicerModuleManager::modulesNames()const
 {
@@ -52,9 +52,18 @@ public:
   /// Return the list of all the loaded modules
   Q_INVOKABLE QStringList modulesNames()const;
 
-  /// Return the loaded module identified by \a name
+  /// Return the loaded module identified by \a name, nullptr if the module
+  /// is not loaded. A module loaded on demand is not loaded by this function.
+  /// \sa loadDeferredModule()
   Q_INVOKABLE qSlicerAbstractCoreModule* module(const QString& name)const;
 
+  /// Load the module \a name if it is loaded on demand and not loaded yet,
+  /// then return the loaded module identified by \a name.
+  /// To be called when the module is about to be used (e.g. selected by the
+  /// user).
+  /// \sa module(), qSlicerModuleFactoryManager::modulesToLoadOnDemand
+  Q_INVOKABLE qSlicerAbstractCoreModule* loadDeferredModule(const QString& name);
+
 signals:
   void moduleLoaded(const QString& module);
   void moduleAboutToBeUnloaded(const QString& module);
@@ -756,7 +756,8 @@ QString qSlicerApplication::nodeModule(vtkMRMLNode* node, double* confidence/*=n
 
   foreach(const QString& moduleName, moduleNames)
     {
-    qSlicerAbstractCoreModule* module = this->moduleManager()->module(moduleName);
+    // The widget of the module is needed, load the module if it is loaded on demand
+    qSlicerAbstractCoreModule* module = this->moduleManager()->loadDeferredModule(moduleName);
     if (!module)
       {
       qWarning() << "Module " << moduleName << " associated with node class " << nodeClassName << " was not found";
@@ -175,6 +175,11 @@ void qSlicerModuleFinderDialog::onSelectionChanged(const QItemSelection& selecte
       {
       module = moduleManager->module(moduleName);
       }
+    else if (factoryManager->isLoadDeferred(moduleName))
+      {
+      // Metadata of modules loaded on demand is available without loading them
+      module = factoryManager->moduleInstance(moduleName);
+      }
     }
 
   d->CurrentModuleName = moduleName;
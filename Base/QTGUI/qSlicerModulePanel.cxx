@@ -34,6 +34,9 @@
 #include "qSlicerAbstractModuleWidget.h"
 #include "qSlicerUtils.h"
 
+// MRML includes
+#include <vtkMRMLTracer.h>
+
 //---------------------------------------------------------------------------
 class qSlicerModulePanelPrivate: public Ui_qSlicerModulePanel
 {
@@ -92,11 +95,14 @@ void qSlicerModulePanel::setModule(const QString& moduleName)
   // Log when the user switches between modules so that if the application crashed
   // we knew which module was active.
   qDebug() << "Switch to module: " << moduleName;
+  // Includes loading the module if it is loaded on demand and creating its widget
+  vtkMRMLTraceZoneMacro("Modules", "Switch",
+    vtkMRMLTracer::IsEnabled() ? moduleName.toStdString() : std::string());
 
   qSlicerAbstractCoreModule * module = nullptr;
   if (!moduleName.isEmpty())
     {
-    module = this->moduleManager()->module(moduleName);
+    module = this->moduleManager()->loadDeferredModule(moduleName);
     Q_ASSERT(module);
     }
   this->setModule(module);
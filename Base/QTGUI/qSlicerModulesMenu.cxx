@@ -24,6 +24,7 @@
 
 // CTK includes
 #include "qSlicerAbstractModule.h"
+#include "qSlicerModuleFactoryManager.h"
 #include "qSlicerModuleManager.h"
 
 // Slicer includes
@@ -486,6 +487,16 @@ void qSlicerModulesMenu::setModuleManager(qSlicerModuleManager* moduleManager)
                    SIGNAL(moduleAboutToBeUnloaded(QString)),
                    this, SLOT(removeModule(QString)));
   this->addModules(d->ModuleManager->modulesNames());
+  // Modules loaded on demand are listed before being loaded, selecting them
+  // loads them.
+  qSlicerModuleFactoryManager* factoryManager = d->ModuleManager->factoryManager();
+  foreach(const QString& moduleName, factoryManager->modulesToLoadOnDemand())
+    {
+    if (factoryManager->isLoadDeferred(moduleName))
+      {
+      this->addModule(factoryManager->moduleInstance(moduleName));
+      }
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -542,6 +553,11 @@ void qSlicerModulesMenu::addModule(qSlicerAbstractCoreModule* moduleToAdd)
 
   QAction* moduleAction = module->action();
   Q_ASSERT(moduleAction);
+  // Modules loaded on demand are already listed when they get loaded
+  if (d->action(moduleAction->data()))
+    {
+    return;
+    }
   if (d->DuplicateActions)
     {
     QAction* duplicateAction = new QAction(moduleAction->icon(), moduleAction->text(), this);
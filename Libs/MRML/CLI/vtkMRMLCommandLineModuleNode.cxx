@@ -66,6 +66,11 @@ public:
   /// Last time an input parameter was modified.
   vtkTimeStamp InputMTime;
 
+  /// Number of tasks queued before the CLI, -1 if not queued
+  int QueuePosition;
+  /// Scheduling priority of the CLI
+  int Priority;
+
   /// Flag to trigger or not the StatusModifiedEvent
   mutable bool InvokeStatusModifiedEvent;
 
@@ -75,6 +80,8 @@ public:
   std::string OutputText;
   /// Error messages of last execution (printed to stderr)
   std::string ErrorText;
+  /// Timing and resource usage of last execution
+  std::map<std::string, double> Telemetry;
 };
 
 ModuleDescriptionMap vtkMRMLCommandLineModuleNode::vtkInternal::RegisteredModules;
@@ -94,6 +101,8 @@ vtkMRMLCommandLineModuleNode::vtkMRMLCommandLineModuleNode()
   this->Internal = new vtkInternal();
   this->HideFromEditors = true;
   this->Internal->Status = vtkMRMLCommandLineModuleNode::Idle;
+  this->Internal->QueuePosition = -1;
+  this->Internal->Priority = 0;
   this->Internal->AutoRun = false;
   this->Internal->AutoRunMode =
     vtkMRMLCommandLineModuleNode::AutoRunOnChangedParameter
@@ -287,6 +296,8 @@ void vtkMRMLCommandLineModuleNode::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
   os << indent << "Status: " << this->GetStatusString() << "\n";
+  os << indent << "QueuePosition: " << this->Internal->QueuePosition << "\n";
+  os << indent << "Priority: " << this->Internal->Priority << "\n";
   os << indent << "AutoRun:" << this->GetAutoRun() << "\n";
   os << indent << "AutoRunMode:" << this->GetAutoRunMode() << "\n";
 
@@ -545,6 +556,10 @@ void vtkMRMLCommandLineModuleNode::SetStatus(int status, bool modify)
   if (this->Internal->Status != status)
     {
     this->Internal->Status = status;
+    if (status != vtkMRMLCommandLineModuleNode::Scheduled)
+      {
+      this->Internal->QueuePosition = -1;
+      }
     switch (this->Internal->Status)
       {
       case vtkMRMLCommandLineModuleNode::Running:
@@ -572,6 +587,45 @@ int vtkMRMLCommandLineModuleNode
   return this->Internal->Status;
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLCommandLineModuleNode::SetQueuePosition(int position, bool modify)
+{
+  if (this->Internal->QueuePosition == position)
+    {
+    return;
+    }
+  this->Internal->QueuePosition = position;
+  // Displayed along with the status
+  this->Internal->InvokeStatusModifiedEvent = true;
+  if (modify)
+    {
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLCommandLineModuleNode::GetQueuePosition() const
+{
+  return this->Internal->QueuePosition;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLCommandLineModuleNode::SetPriority(int priority)
+{
+  if (this->Internal->Priority == priority)
+    {
+    return;
+    }
+  this->Internal->Priority = priority;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLCommandLineModuleNode::GetPriority() const
+{
+  return this->Internal->Priority;
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLCommandLineModuleNode::IsBusy() const
 {
@@ -1109,6 +1163,45 @@ void vtkMRMLCommandLineModuleNode::SetOutputText(const std::string& text, bool m
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLCommandLineModuleNode::SetTelemetry(const std::map<std::string, double>& telemetry, bool modify)
+{
+  {
+    std::lock_guard<std::recursive_mutex> lock(this->Internal->NodeAccessMutex);
+    if (this->Internal->Telemetry == telemetry)
+      {
+      return;
+      }
+    this->Internal->Telemetry = telemetry;
+  }
+  if (modify)
+    {
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+std::vector<std::string> vtkMRMLCommandLineModuleNode::GetTelemetryNames() const
+{
+  std::vector<std::string> names;
+    {
+    std::lock_guard<std::recursive_mutex> lock(this->Internal->NodeAccessMutex);
+    for (const std::pair<const std::string, double>& nameValue : this->Internal->Telemetry)
+      {
+      names.push_back(nameValue.first);
+      }
+    }
+  return names;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLCommandLineModuleNode::GetTelemetryValue(const std::string& name, double defaultValue) const
+{
+  std::lock_guard<std::recursive_mutex> lock(this->Internal->NodeAccessMutex);
+  std::map<std::string, double>::const_iterator it = this->Internal->Telemetry.find(name);
+  return it != this->Internal->Telemetry.end() ? it->second : defaultValue;
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLCommandLineModuleNode::StartContinuousOutputUpdate()
 {
@@ -15,6 +15,9 @@
 
 #include "vtkMRMLCLIExport.h"
 
+// STD includes
+#include <map>
+
 class ModuleDescription;
 
 /// \brief MRML node for representing the parameters allowing to run a command
@@ -117,6 +120,24 @@ public:
   /// \sa GetStatus(), IsBusy()
   const char* GetStatusString() const;
 
+  /// Set the number of queued tasks that will start before the CLI while it
+  /// is Scheduled, -1 if the CLI is not waiting in the queue.
+  /// The position is reset to -1 when the status changes to anything but
+  /// Scheduled. It is not stored persistently in the scene file.
+  /// Do not call manually, only the logic should change the queue position.
+  /// \sa GetQueuePosition(), SetStatus()
+  void SetQueuePosition(int position, bool modify=true);
+  /// \sa SetQueuePosition()
+  int GetQueuePosition() const;
+
+  /// Priority of the CLI execution. When several CLIs are scheduled, the ones
+  /// with higher priority are started first. 0 by default.
+  /// It is not stored persistently in the scene file.
+  /// \sa vtkSlicerTask::SetPriority()
+  void SetPriority(int priority);
+  /// \sa SetPriority()
+  int GetPriority() const;
+
   //@{
   /// Start/stop continuous updating of output and error texts during execution.
   ///
@@ -149,6 +170,19 @@ public:
   std::string GetErrorText() const;
   //@}
 
+  //@{
+  /// Get/set the telemetry of the latest execution: timing and resource
+  /// usage values indexed by name (e.g. "Compute.WallTime").
+  /// Setting the telemetry replaces the values of the previous execution.
+  /// GetTelemetryValue() returns \a defaultValue if \a name has no value.
+  /// This value is not stored persistently in the scene file.
+  /// It is safe to call these methods from a non-main thread (with modify=false).
+  /// \sa vtkSlicerCLIModuleLogic::Apply()
+  void SetTelemetry(const std::map<std::string, double>& telemetry, bool modify = true);
+  std::vector<std::string> GetTelemetryNames() const;
+  double GetTelemetryValue(const std::string& name, double defaultValue = -1.) const;
+  //@}
+
   /// Return true if the module is in a busy state: Scheduled, Running,
   /// Cancelling, Completing.
   /// \sa SetStatus(), GetStatus(), BusyMask, Cancel()
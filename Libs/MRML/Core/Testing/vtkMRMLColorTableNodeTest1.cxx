@@ -18,8 +18,11 @@
 #include "vtkMRMLScene.h"
 
 // VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkIntArray.h>
 #include <vtkNew.h>
 #include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
 
 using namespace vtkMRMLCoreTestingUtilities;
 
@@ -106,5 +109,48 @@ int vtkMRMLColorTableNodeTest1(int argc, char * argv[])
     CHECK_STRING(colorNode->GetColorName(2), "two")
   }
 
+  // check color lookup by name
+  {
+    vtkNew<vtkMRMLColorTableNode> colorNode;
+    colorNode->SetTypeToUser();
+    colorNode->SetNumberOfColors(3);
+    colorNode->SetColor(0, "zero", 0.0, 0.0, 0.0, 1.0);
+    colorNode->SetColor(1, "one", 1.0, 0.0, 0.0, 1.0);
+    colorNode->SetColor(2, "one", 0.0, 1.0, 0.0, 1.0);
+    colorNode->NamesInitialisedOn();
+
+    CHECK_INT(colorNode->GetColorIndexByName("zero"), 0);
+    // lowest index of duplicate names
+    CHECK_INT(colorNode->GetColorIndexByName("one"), 1);
+    CHECK_INT(colorNode->GetColorIndexByName("two"), -1);
+
+    // index is updated when names change
+    CHECK_INT(colorNode->SetColorName(2, "two"), 1);
+    CHECK_INT(colorNode->GetColorIndexByName("two"), 2);
+    colorNode->SetColor(1, "uno", 1.0, 0.0, 0.0, 1.0);
+    CHECK_INT(colorNode->GetColorIndexByName("one"), -1);
+    CHECK_INT(colorNode->GetColorIndexByName("uno"), 1);
+
+    // bulk lookups
+    vtkNew<vtkStringArray> names;
+    names->InsertNextValue("two");
+    names->InsertNextValue("none");
+    names->InsertNextValue("zero");
+    vtkNew<vtkIntArray> colorIndices;
+    colorNode->GetColorIndicesByName(names, colorIndices);
+    CHECK_INT(colorIndices->GetNumberOfValues(), 3);
+    CHECK_INT(colorIndices->GetValue(0), 2);
+    CHECK_INT(colorIndices->GetValue(1), -1);
+    CHECK_INT(colorIndices->GetValue(2), 0);
+
+    vtkNew<vtkDoubleArray> colors;
+    CHECK_BOOL(colorNode->GetColors(colorIndices, colors), false);
+    CHECK_INT(colors->GetNumberOfComponents(), 4);
+    CHECK_INT(colors->GetNumberOfTuples(), 3);
+    CHECK_DOUBLE(colors->GetComponent(0, 1), 1.0);
+    CHECK_DOUBLE(colors->GetComponent(1, 3), 0.0);
+    CHECK_DOUBLE(colors->GetComponent(2, 3), 1.0);
+  }
+
   return EXIT_SUCCESS;
 }
@@ -12,10 +12,72 @@
 
 #include "vtkMRMLCoreTestingMacros.h"
 #include "vtkMRMLScalarVolumeDisplayNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
 
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkImageHistogramStatistics.h>
+#include <vtkPointData.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+int TestHistogram()
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(10, 10, 10);
+  imageData->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(imageData->GetScalarPointer());
+  for (int i = 0; i < 1000; ++i)
+    {
+    voxels[i] = static_cast<short>(i);
+    }
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(imageData);
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode;
+  CHECK_NULL(displayNode->GetHistogramStatistics());
+  displayNode->SetInputImageDataConnection(volumeNode->GetImageDataConnection());
+
+  // Exact histogram
+  vtkImageHistogramStatistics* histogramStatistics = displayNode->GetHistogramStatistics();
+  CHECK_NOT_NULL(histogramStatistics);
+  CHECK_DOUBLE(histogramStatistics->GetMinimum(), 0.0);
+  CHECK_DOUBLE(histogramStatistics->GetMaximum(), 999.0);
+  CHECK_INT(displayNode->GetHistogramScalars()->GetNumberOfTuples(), 1000);
+
+  // Histogram is not recomputed if the image is not changed
+  vtkMTimeType histogramMTime = histogramStatistics->GetOutputDataObject(0)->GetMTime();
+  displayNode->GetHistogramStatistics();
+  CHECK_BOOL(histogramStatistics->GetOutputDataObject(0)->GetMTime() == histogramMTime, true);
+
+  // Histogram is recomputed if voxels are changed
+  voxels[0] = -10;
+  imageData->Modified();
+  CHECK_DOUBLE(displayNode->GetHistogramStatistics()->GetMinimum(), -10.0);
+
+  // Sampled histogram
+  displayNode->SetHistogramSamplingStride(2);
+  CHECK_INT(displayNode->GetHistogramScalars()->GetNumberOfTuples(), 125);
+  CHECK_DOUBLE(displayNode->GetHistogramStatistics()->GetMinimum(), -10.0);
+  CHECK_DOUBLE(displayNode->GetHistogramStatistics()->GetMaximum(), 888.0);
+
+  displayNode->SetHistogramSamplingStride(1);
+  CHECK_INT(displayNode->GetHistogramScalars()->GetNumberOfTuples(), 1000);
+  CHECK_DOUBLE(displayNode->GetHistogramStatistics()->GetMaximum(), 999.0);
+
+  return EXIT_SUCCESS;
+}
+
+}
+
+//----------------------------------------------------------------------------
 int vtkMRMLScalarVolumeDisplayNodeTest1(int , char * [] )
 {
   vtkNew<vtkMRMLScalarVolumeDisplayNode> node1;
   EXERCISE_ALL_BASIC_MRML_METHODS(node1.GetPointer());
+  CHECK_EXIT_SUCCESS(TestHistogram());
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,207 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLScriptedModuleNode.h"
+#include "vtkMRMLSubjectHierarchyConstants.h"
+#include "vtkMRMLSubjectHierarchyNode.h"
+
+// VTK includes
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void ReportElapsedTime(vtkTimerLog* timer, const char* name)
+{
+  timer->StopTimer();
+  std::cout << "<DartMeasurement name=\"" << name << "\" "
+            << "type=\"numeric/double\">"
+            << timer->GetElapsedTime() << "</DartMeasurement>" << std::endl;
+  timer->StartTimer();
+}
+
+//----------------------------------------------------------------------------
+std::string GetInstanceUID(int index)
+{
+  std::stringstream uid;
+  // Terminate the UID so that it is not contained in the UID of another index
+  uid << "1.2.840.113619." << index << ".1";
+  return uid.str();
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+// Build, query and reorganize a subject hierarchy containing many items.
+// Optional argument: number of series items (5000 by default, at least 1000),
+// e.g. 100000 for timings on a hierarchy of the size of a large DICOM database.
+int vtkMRMLSubjectHierarchyNodeLargeHierarchyTest(int argc, char * argv[])
+{
+  const int numberOfSubjects = 100;
+  const int numberOfStudiesPerSubject = 10;
+  const int numberOfStudies = numberOfSubjects * numberOfStudiesPerSubject;
+  // Every tenth series has a data node
+  const int dataNodeFrequency = 10;
+  // Every hundredth series references the instance of the previous series
+  const int referenceFrequency = 100;
+  int numberOfSeries = 5000;
+  if (argc > 1)
+    {
+    numberOfSeries = atoi(argv[1]);
+    }
+  CHECK_BOOL(numberOfSeries >= numberOfStudies, true);
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSubjectHierarchyNode* shNode = scene->GetSubjectHierarchyNode();
+  CHECK_NOT_NULL(shNode);
+  const std::string uidName = vtkMRMLSubjectHierarchyConstants::GetDICOMInstanceUIDName();
+  const std::string referenceAttributeName = vtkMRMLSubjectHierarchyConstants::GetDICOMReferencedInstanceUIDsAttributeName();
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+
+  // Build
+  std::vector<vtkIdType> subjectItemIDs;
+  std::vector<vtkIdType> studyItemIDs;
+  std::vector<vtkIdType> seriesItemIDs;
+  std::vector<vtkSmartPointer<vtkMRMLNode> > dataNodes;
+  for (int subjectIndex = 0; subjectIndex < numberOfSubjects; ++subjectIndex)
+    {
+    subjectItemIDs.push_back(shNode->CreateSubjectItem(shNode->GetSceneItemID(), "Subject"));
+    }
+  for (int studyIndex = 0; studyIndex < numberOfStudies; ++studyIndex)
+    {
+    studyItemIDs.push_back(shNode->CreateStudyItem(subjectItemIDs[studyIndex % numberOfSubjects], "Study"));
+    }
+  for (int seriesIndex = 0; seriesIndex < numberOfSeries; ++seriesIndex)
+    {
+    vtkIdType studyItemID = studyItemIDs[seriesIndex % numberOfStudies];
+    vtkIdType seriesItemID = vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID;
+    if (seriesIndex % dataNodeFrequency == 0)
+      {
+      vtkSmartPointer<vtkMRMLNode> dataNode = vtkSmartPointer<vtkMRMLScriptedModuleNode>::New();
+      scene->AddNode(dataNode);
+      dataNodes.push_back(dataNode);
+      seriesItemID = shNode->CreateItem(studyItemID, dataNode);
+      }
+    else
+      {
+      seriesItemID = shNode->CreateFolderItem(studyItemID, "Series");
+      }
+    shNode->SetItemUID(seriesItemID, uidName, GetInstanceUID(seriesIndex));
+    if (seriesIndex % referenceFrequency == referenceFrequency - 1)
+      {
+      shNode->SetItemAttribute(seriesItemID, referenceAttributeName, GetInstanceUID(seriesIndex - 1));
+      }
+    seriesItemIDs.push_back(seriesItemID);
+    }
+  ReportElapsedTime(timer, "BuildHierarchy");
+  CHECK_INT(shNode->GetNumberOfItems(), numberOfSubjects + numberOfStudies + numberOfSeries);
+
+  // Query
+  for (int seriesIndex = 0; seriesIndex < numberOfSeries; ++seriesIndex)
+    {
+    CHECK_INT(shNode->GetItemByUID(uidName.c_str(), GetInstanceUID(seriesIndex).c_str()), seriesItemIDs[seriesIndex]);
+    }
+  ReportElapsedTime(timer, "GetItemByUID");
+  for (size_t dataNodeIndex = 0; dataNodeIndex < dataNodes.size(); ++dataNodeIndex)
+    {
+    CHECK_INT(shNode->GetItemByDataNode(dataNodes[dataNodeIndex]), seriesItemIDs[dataNodeIndex * dataNodeFrequency]);
+    }
+  ReportElapsedTime(timer, "GetItemByDataNode");
+  vtkNew<vtkIdList> referencingItemIDs;
+  for (int seriesIndex = referenceFrequency - 1; seriesIndex < numberOfSeries; seriesIndex += referenceFrequency)
+    {
+    shNode->GetItemsReferencingItemByDICOM(seriesItemIDs[seriesIndex - 1], referencingItemIDs);
+    CHECK_INT(referencingItemIDs->GetNumberOfIds(), 1);
+    CHECK_INT(referencingItemIDs->GetId(0), seriesItemIDs[seriesIndex]);
+    }
+  ReportElapsedTime(timer, "GetItemsReferencingItemByDICOM");
+  vtkNew<vtkIdList> foundItemIDs;
+  shNode->GetItemsByAttribute(referenceAttributeName, foundItemIDs);
+  CHECK_INT(foundItemIDs->GetNumberOfIds(), numberOfSeries / referenceFrequency);
+  shNode->GetItemsByAttribute(vtkMRMLSubjectHierarchyConstants::GetSubjectHierarchyLevelAttributeName(), foundItemIDs);
+  CHECK_INT(foundItemIDs->GetNumberOfIds(), numberOfSubjects + numberOfStudies + numberOfSeries - static_cast<int>(dataNodes.size()));
+  ReportElapsedTime(timer, "GetItemsByAttribute");
+
+  // Reorganize: move every study to the next subject and every series to the next study
+  for (int studyIndex = 0; studyIndex < numberOfStudies; ++studyIndex)
+    {
+    shNode->SetItemParent(studyItemIDs[studyIndex], subjectItemIDs[(studyIndex + 1) % numberOfSubjects]);
+    }
+  for (int seriesIndex = 0; seriesIndex < numberOfSeries; ++seriesIndex)
+    {
+    shNode->SetItemParent(seriesItemIDs[seriesIndex], studyItemIDs[(seriesIndex + 1) % numberOfStudies]);
+    }
+  ReportElapsedTime(timer, "ReparentItems");
+  CHECK_INT(shNode->GetItemParent(seriesItemIDs[0]), studyItemIDs[1 % numberOfStudies]);
+  CHECK_INT(shNode->GetItemParent(studyItemIDs[0]), subjectItemIDs[1 % numberOfSubjects]);
+
+  // Changed UIDs and attributes are found by their new value only
+  TESTING_OUTPUT_ASSERT_WARNINGS_BEGIN();
+  shNode->SetItemUID(seriesItemIDs[0], uidName, "changed");
+  TESTING_OUTPUT_ASSERT_WARNINGS_END(); // Warning about replacing the UID
+  CHECK_INT(shNode->GetItemByUID(uidName.c_str(), GetInstanceUID(0).c_str()), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+  CHECK_INT(shNode->GetItemByUID(uidName.c_str(), "changed"), seriesItemIDs[0]);
+  shNode->RemoveItemAttribute(seriesItemIDs[referenceFrequency - 1], referenceAttributeName);
+  shNode->GetItemsByAttribute(referenceAttributeName, foundItemIDs);
+  CHECK_INT(foundItemIDs->GetNumberOfIds(), numberOfSeries / referenceFrequency - 1);
+
+  // Remove a subject: its studies and series are removed from the lookups
+  vtkIdType removedSubjectItemID = subjectItemIDs[0];
+  std::vector<vtkIdType> removedItemIDs;
+  shNode->GetItemChildren(removedSubjectItemID, removedItemIDs, true);
+  std::vector<std::string> removedUIDs;
+  for (std::vector<vtkIdType>::iterator itemIt = removedItemIDs.begin(); itemIt != removedItemIDs.end(); ++itemIt)
+    {
+    std::string uid = shNode->GetItemUID(*itemIt, uidName);
+    if (!uid.empty())
+      {
+      removedUIDs.push_back(uid);
+      }
+    }
+  CHECK_BOOL(removedUIDs.empty(), false);
+  CHECK_BOOL(shNode->RemoveItem(removedSubjectItemID, false), true);
+  for (std::vector<std::string>::iterator uidIt = removedUIDs.begin(); uidIt != removedUIDs.end(); ++uidIt)
+    {
+    CHECK_INT(shNode->GetItemByUID(uidName.c_str(), uidIt->c_str()), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+    }
+  CHECK_INT(shNode->GetNumberOfItems(), numberOfSubjects + numberOfStudies + numberOfSeries - 1 - static_cast<int>(removedItemIDs.size()));
+  ReportElapsedTime(timer, "RemoveSubject");
+
+  // Items of different scenes are stored separately
+  vtkNew<vtkMRMLScene> otherScene;
+  vtkMRMLSubjectHierarchyNode* otherShNode = otherScene->GetSubjectHierarchyNode();
+  CHECK_NOT_NULL(otherShNode);
+  CHECK_INT(otherShNode->GetNumberOfItems(), 0);
+  CHECK_INT(otherShNode->GetItemByUID(uidName.c_str(), GetInstanceUID(1).c_str()), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+  CHECK_INT(otherShNode->GetItemByDataNode(dataNodes.back()), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+
+  // Remove all
+  shNode->RemoveAllItems(false);
+  CHECK_INT(shNode->GetNumberOfItems(), 0);
+  ReportElapsedTime(timer, "RemoveAllItems");
+
+  return EXIT_SUCCESS;
+}
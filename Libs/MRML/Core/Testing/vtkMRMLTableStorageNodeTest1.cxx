@@ -24,16 +24,31 @@
 #include "vtkMRMLScene.h"
 #include "vtkMRMLTableNode.h"
 #include "vtkMRMLTableStorageNode.h"
+#include "vtkBitArray.h"
 #include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
 #include "vtkStringArray.h"
 #include "vtkTable.h"
+#include "vtkUnsignedCharArray.h"
 
 #include <vtksys/SystemTools.hxx>
 
+#include <fstream>
+#include <limits>
+#include <sstream>
+
 //---------------------------------------------------------------------------
 int TestReadWriteWithoutSchema(vtkMRMLScene* scene);
 int TestReadWriteWithSchema(vtkMRMLScene* scene);
+int TestReadWriteFloatingPoint(vtkMRMLScene* scene);
+int TestReadQuotedNewlines(vtkMRMLScene* scene);
+int TestReadNullAndInvalidNumbers(vtkMRMLScene* scene);
+int TestReadRecordAcrossBlocks(vtkMRMLScene* scene);
 int TestReadWriteData(vtkMRMLScene* scene, const char *extension, vtkTable* table, bool schemaExpected);
+void WriteTextFile(const std::string& fileName, const std::string& text);
+std::string ReadTextFile(const std::string& fileName);
+vtkTable* ReadTableFile(vtkMRMLScene* scene, const std::string& fileName);
 
 int vtkMRMLTableStorageNodeTest1(int argc, char * argv[])
 {
@@ -52,6 +67,10 @@ int vtkMRMLTableStorageNodeTest1(int argc, char * argv[])
 
   CHECK_EXIT_SUCCESS(TestReadWriteWithoutSchema(scene.GetPointer()));
   CHECK_EXIT_SUCCESS(TestReadWriteWithSchema(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestReadWriteFloatingPoint(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestReadQuotedNewlines(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestReadNullAndInvalidNumbers(scene.GetPointer()));
+  CHECK_EXIT_SUCCESS(TestReadRecordAcrossBlocks(scene.GetPointer()));
 
   std::cout << "Test passed." << std::endl;
   return EXIT_SUCCESS;
@@ -65,10 +84,14 @@ int TestReadWriteWithoutSchema(vtkMRMLScene* scene)
   col1->SetName("col1");
   col1->InsertNextValue("aa");
   col1->InsertNextValue("bb");
+  // comma and backslash in value
+  col1->InsertNextValue("e,f\\g");
   vtkNew<vtkStringArray> col2;
   col2->SetName("col2");
   col2->InsertNextValue("cc");
   col2->InsertNextValue("dd");
+  // empty value
+  col2->InsertNextValue("");
   vtkNew<vtkTable> table;
   table->AddColumn(col1.GetPointer());
   table->AddColumn(col2.GetPointer());
@@ -101,10 +124,19 @@ int TestReadWriteWithSchema(vtkMRMLScene* scene)
   col3->SetComponentName(2, "A");
   col3->InsertNextTuple3(1, 2, 3);
   col3->InsertNextTuple3(9, 8, 7);
+  // multi-component bit column
+  vtkNew<vtkBitArray> col4;
+  col4->SetName("col4");
+  col4->SetNumberOfComponents(2);
+  col4->SetComponentName(0, "X");
+  col4->SetComponentName(1, "Y");
+  col4->InsertNextTuple2(1, 0);
+  col4->InsertNextTuple2(0, 1);
   vtkNew<vtkTable> table;
   table->AddColumn(col1.GetPointer());
   table->AddColumn(col2.GetPointer());
   table->AddColumn(col3.GetPointer());
+  table->AddColumn(col4.GetPointer());
 
   CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".csv", table.GetPointer(), true));
   CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".tsv", table.GetPointer(), true));
@@ -113,6 +145,179 @@ int TestReadWriteWithSchema(vtkMRMLScene* scene)
   return EXIT_SUCCESS;
 }
 
+//---------------------------------------------------------------------------
+int TestReadWriteFloatingPoint(vtkMRMLScene* scene)
+{
+  // Values that need all significant digits to be read back exactly
+  vtkNew<vtkDoubleArray> doubleColumn;
+  doubleColumn->SetName("double");
+  doubleColumn->InsertNextValue(0.1);
+  doubleColumn->InsertNextValue(1.0 / 3.0);
+  doubleColumn->InsertNextValue(-123456789.123456789);
+  doubleColumn->InsertNextValue(1e-300);
+  doubleColumn->InsertNextValue(std::numeric_limits<double>::max());
+  vtkNew<vtkFloatArray> floatColumn;
+  floatColumn->SetName("float");
+  floatColumn->InsertNextValue(0.1f);
+  floatColumn->InsertNextValue(1.0f / 3.0f);
+  floatColumn->InsertNextValue(-1234.5678f);
+  floatColumn->InsertNextValue(1e-30f);
+  floatColumn->InsertNextValue(std::numeric_limits<float>::max());
+  vtkNew<vtkTable> table;
+  table->AddColumn(doubleColumn.GetPointer());
+  table->AddColumn(floatColumn.GetPointer());
+
+  CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".csv", table.GetPointer(), true));
+  CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".tsv", table.GetPointer(), true));
+
+  // Values that can be read back exactly with fewer digits are written with fewer digits
+  std::string text = ReadTextFile(std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1.tsv");
+  std::stringstream lines(text);
+  std::string line;
+  std::getline(lines, line);
+  std::getline(lines, line);
+  CHECK_STD_STRING(line, "0.1\t0.1");
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestReadQuotedNewlines(vtkMRMLScene* scene)
+{
+  std::string fileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1QuotedNewlines.csv";
+  WriteTextFile(fileName,
+    "\"name\",\"value\"\n"
+    "\"first line\nsecond line\",\"1\"\n"
+    "\"a,b\",\"2\"\r\n"
+    "\n"
+    "\"\",3");
+
+  vtkTable* table = ReadTableFile(scene, fileName);
+  CHECK_NOT_NULL(table);
+  CHECK_INT(table->GetNumberOfColumns(), 2);
+  vtkStringArray* nameColumn = vtkStringArray::SafeDownCast(table->GetColumnByName("name"));
+  vtkStringArray* valueColumn = vtkStringArray::SafeDownCast(table->GetColumnByName("value"));
+  CHECK_NOT_NULL(nameColumn);
+  CHECK_NOT_NULL(valueColumn);
+  // empty lines are skipped, the last line has no line ending
+  CHECK_INT(table->GetNumberOfRows(), 3);
+  CHECK_STD_STRING(nameColumn->GetValue(0), "first line\nsecond line");
+  CHECK_STD_STRING(nameColumn->GetValue(1), "a,b");
+  CHECK_STD_STRING(nameColumn->GetValue(2), "");
+  CHECK_STD_STRING(valueColumn->GetValue(0), "1");
+  CHECK_STD_STRING(valueColumn->GetValue(1), "2");
+  CHECK_STD_STRING(valueColumn->GetValue(2), "3");
+
+  // Values with line endings are preserved when writing CSV files
+  CHECK_EXIT_SUCCESS(TestReadWriteData(scene, ".csv", table, false));
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestReadNullAndInvalidNumbers(vtkMRMLScene* scene)
+{
+  std::string fileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Null.csv";
+  std::string schemaFileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Null.schema.csv";
+  WriteTextFile(schemaFileName,
+    "columnName,type,componentNames,nullValue\n"
+    "int,int,,-1\n"
+    "double,double,,\n"
+    "uchar,unsigned char,,7\n"
+    "bit,bit,,1\n");
+  WriteTextFile(fileName,
+    "int,double,uchar,bit\n"
+    "1,1.5,2,0\n"
+    ",,,\n"
+    "abc,xyz,abc,abc\n"
+    "99999999999,1e999,-1,2\n"
+    "4\n");
+
+  vtkTable* table = ReadTableFile(scene, fileName);
+  CHECK_NOT_NULL(table);
+  CHECK_INT(table->GetNumberOfRows(), 5);
+  vtkIntArray* intColumn = vtkIntArray::SafeDownCast(table->GetColumnByName("int"));
+  vtkDoubleArray* doubleColumn = vtkDoubleArray::SafeDownCast(table->GetColumnByName("double"));
+  vtkUnsignedCharArray* ucharColumn = vtkUnsignedCharArray::SafeDownCast(table->GetColumnByName("uchar"));
+  vtkBitArray* bitColumn = vtkBitArray::SafeDownCast(table->GetColumnByName("bit"));
+  CHECK_NOT_NULL(intColumn);
+  CHECK_NOT_NULL(doubleColumn);
+  CHECK_NOT_NULL(ucharColumn);
+  CHECK_NOT_NULL(bitColumn);
+
+  // valid values
+  CHECK_INT(intColumn->GetValue(0), 1);
+  CHECK_DOUBLE(doubleColumn->GetValue(0), 1.5);
+  CHECK_INT(ucharColumn->GetValue(0), 2);
+  CHECK_INT(bitColumn->GetValue(0), 0);
+  // empty values are replaced by the null value (0 if not specified)
+  CHECK_INT(intColumn->GetValue(1), -1);
+  CHECK_DOUBLE(doubleColumn->GetValue(1), 0.0);
+  CHECK_INT(ucharColumn->GetValue(1), 7);
+  CHECK_INT(bitColumn->GetValue(1), 1);
+  // invalid values are replaced by the null value
+  CHECK_INT(intColumn->GetValue(2), -1);
+  CHECK_DOUBLE(doubleColumn->GetValue(2), 0.0);
+  CHECK_INT(ucharColumn->GetValue(2), 7);
+  CHECK_INT(bitColumn->GetValue(2), 1);
+  // out of range values are replaced by the null value,
+  // except for char types and bit values that are converted from int
+  CHECK_INT(intColumn->GetValue(3), -1);
+  CHECK_DOUBLE(doubleColumn->GetValue(3), 0.0);
+  CHECK_INT(ucharColumn->GetValue(3), 255);
+  CHECK_INT(bitColumn->GetValue(3), 1);
+  // missing fields are set to the null value
+  CHECK_INT(intColumn->GetValue(4), 4);
+  CHECK_DOUBLE(doubleColumn->GetValue(4), 0.0);
+  CHECK_INT(ucharColumn->GetValue(4), 7);
+  CHECK_INT(bitColumn->GetValue(4), 1);
+
+  return EXIT_SUCCESS;
+}
+
+//---------------------------------------------------------------------------
+int TestReadRecordAcrossBlocks(vtkMRMLScene* scene)
+{
+  // Size of the blocks in which the storage node reads files
+  const size_t blockSize = 16 * 1024 * 1024;
+
+  // Fill the first block, a record with a quoted line ending starts just before the end of the block
+  std::string fileName = std::string(scene->GetRootDirectory()) + "/vtkMRMLTableStorageNodeTest1Blocks.csv";
+  std::string text = "index,text\n";
+  text.reserve(blockSize + 1024);
+  const std::string filler(100, 'x');
+  int numberOfRows = 0;
+  while (text.size() < blockSize - 1000)
+    {
+    text += std::to_string(numberOfRows++) + ",\"" + filler + "\"\n";
+    }
+  const std::string paddingRowPrefix = std::to_string(numberOfRows++) + ",\"";
+  const std::string padding(blockSize - 8 - text.size() - paddingRowPrefix.size() - 2, 'y');
+  text += paddingRowPrefix + padding + "\"\n";
+  const int splitRow = numberOfRows++;
+  text += std::to_string(splitRow) + ",\"before\nafter\"\n";
+  CHECK_BOOL(text.size() > blockSize, true);
+  text += std::to_string(numberOfRows++) + ",\"last\"\n";
+  WriteTextFile(fileName, text);
+
+  vtkTable* table = ReadTableFile(scene, fileName);
+  CHECK_NOT_NULL(table);
+  vtkStringArray* indexColumn = vtkStringArray::SafeDownCast(table->GetColumnByName("index"));
+  vtkStringArray* textColumn = vtkStringArray::SafeDownCast(table->GetColumnByName("text"));
+  CHECK_NOT_NULL(indexColumn);
+  CHECK_NOT_NULL(textColumn);
+  CHECK_INT(table->GetNumberOfRows(), numberOfRows);
+  CHECK_STD_STRING(indexColumn->GetValue(splitRow - 1), std::to_string(splitRow - 1));
+  CHECK_STD_STRING(textColumn->GetValue(splitRow - 1), padding);
+  CHECK_STD_STRING(indexColumn->GetValue(splitRow), std::to_string(splitRow));
+  CHECK_STD_STRING(textColumn->GetValue(splitRow), "before\nafter");
+  CHECK_STD_STRING(indexColumn->GetValue(numberOfRows - 1), std::to_string(numberOfRows - 1));
+  CHECK_STD_STRING(textColumn->GetValue(numberOfRows - 1), "last");
+
+  vtksys::SystemTools::RemoveFile(fileName);
+  return EXIT_SUCCESS;
+}
+
 //---------------------------------------------------------------------------
 int TestReadWriteData(vtkMRMLScene* scene, const char *extension, vtkTable* table, bool schemaExpected)
 {
@@ -186,3 +391,38 @@ int TestReadWriteData(vtkMRMLScene* scene, const char *extension, vtkTable* tabl
     }
   return EXIT_SUCCESS;
 }
+
+//---------------------------------------------------------------------------
+void WriteTextFile(const std::string& fileName, const std::string& text)
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  file.write(text.data(), text.size());
+}
+
+//---------------------------------------------------------------------------
+std::string ReadTextFile(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  std::stringstream text;
+  text << file.rdbuf();
+  return text.str();
+}
+
+//---------------------------------------------------------------------------
+vtkTable* ReadTableFile(vtkMRMLScene* scene, const std::string& fileName)
+{
+  vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLTableNode"));
+  vtkMRMLTableStorageNode* storageNode = vtkMRMLTableStorageNode::SafeDownCast(
+    scene->AddNewNodeByClass("vtkMRMLTableStorageNode"));
+  if (!tableNode || !storageNode)
+    {
+    return nullptr;
+    }
+  tableNode->SetAndObserveStorageNodeID(storageNode->GetID());
+  storageNode->SetFileName(fileName.c_str());
+  if (!storageNode->ReadData(tableNode))
+    {
+    return nullptr;
+    }
+  return tableNode->GetTable();
+}
@@ -0,0 +1,124 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLTextNode.h"
+#include "vtkMRMLTextStorageNode.h"
+#include "vtkMRMLTracer.h"
+
+// VTK includes
+#include <vtkNew.h>
+
+// STD includes
+#include <fstream>
+#include <sstream>
+
+//---------------------------------------------------------------------------
+int vtkMRMLTracerTest1(int argc, char * argv[] )
+{
+  if (argc != 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string tempDir = argv[1];
+
+  vtkMRMLTracer* tracer = vtkMRMLTracer::GetInstance();
+  CHECK_NOT_NULL(tracer);
+  CHECK_BOOL(tracer->GetEnabled(), false);
+  CHECK_BOOL(vtkMRMLTracer::IsEnabled(), false);
+
+  // Zones are ignored while tracing is disabled
+  {
+  vtkMRMLTraceZoneMacro("Test", "Disabled");
+  }
+  CHECK_INT(tracer->GetNumberOfZones(), 0);
+
+  tracer->EnabledOn();
+  CHECK_BOOL(vtkMRMLTracer::IsEnabled(), true);
+  {
+  vtkMRMLTraceZoneMacro("Test", "Outer", "detail with \"quotes\"\nand new line");
+  vtkMRMLTraceZoneMacro("Test", "Inner", std::string("detail"));
+  }
+#ifdef MRML_USE_TRACING
+  CHECK_INT(tracer->GetNumberOfZones(), 2);
+#endif
+
+  // Names are copied, they don't need to outlive the zone
+  {
+  std::string name = "Temporary";
+  vtkMRMLTraceZoneMacro("Test", name.c_str());
+  name = "Overwritten";
+  }
+#ifdef MRML_USE_TRACING
+  CHECK_INT(tracer->GetNumberOfZones(), 3);
+#endif
+
+  // Storage nodes record their reads and writes
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLTextNode> textNode;
+  textNode->SetText("Hello world!");
+  scene->AddNode(textNode);
+  vtkNew<vtkMRMLTextStorageNode> storageNode;
+  scene->AddNode(storageNode);
+  textNode->SetAndObserveStorageNodeID(storageNode->GetID());
+  storageNode->SetFileName((tempDir + "/vtkMRMLTracerTest1.txt").c_str());
+  CHECK_BOOL(storageNode->WriteData(textNode), true);
+  CHECK_BOOL(storageNode->ReadData(textNode), true);
+#ifdef MRML_USE_TRACING
+  CHECK_INT(tracer->GetNumberOfZones(), 5);
+#endif
+
+  // Zones beyond the maximum are dropped
+  tracer->SetMaximumNumberOfZones(tracer->GetNumberOfZones());
+  {
+  vtkMRMLTraceZoneMacro("Test", "Dropped");
+  }
+  CHECK_INT(tracer->GetNumberOfZones(), tracer->GetMaximumNumberOfZones());
+  tracer->SetMaximumNumberOfZones(1000000);
+
+  tracer->EnabledOff();
+  CHECK_BOOL(tracer->GetEnabled(), false);
+
+  const std::string traceFileName = tempDir + "/vtkMRMLTracerTest1.json";
+  CHECK_BOOL(tracer->WriteChromeTrace(traceFileName.c_str()), true);
+  std::ifstream traceFile(traceFileName.c_str());
+  std::stringstream trace;
+  trace << traceFile.rdbuf();
+  CHECK_BOOL(trace.str().find("{\"traceEvents\":[") == 0, true);
+#ifdef MRML_USE_TRACING
+  CHECK_BOOL(trace.str().find("\"name\":\"Outer\",\"cat\":\"Test\",\"ph\":\"X\"") != std::string::npos, true);
+  CHECK_BOOL(trace.str().find("detail with \\\"quotes\\\"\\nand new line") != std::string::npos, true);
+  CHECK_BOOL(trace.str().find("\"name\":\"WriteData\",\"cat\":\"Storage\"") != std::string::npos, true);
+  CHECK_BOOL(trace.str().find("\"name\":\"ReadData\",\"cat\":\"Storage\"") != std::string::npos, true);
+  CHECK_BOOL(trace.str().find("vtkMRMLTracerTest1.txt") != std::string::npos, true);
+  CHECK_BOOL(trace.str().find("\"name\":\"Temporary\"") != std::string::npos, true);
+  CHECK_BOOL(trace.str().find("Overwritten") == std::string::npos, true);
+  CHECK_BOOL(trace.str().find("\"droppedZones\":1") != std::string::npos, true);
+#endif
+
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(tracer->WriteChromeTrace(""), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  tracer->Clear();
+  CHECK_INT(tracer->GetNumberOfZones(), 0);
+
+  return EXIT_SUCCESS;
+}
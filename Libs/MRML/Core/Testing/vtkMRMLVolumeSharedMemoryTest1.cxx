@@ -0,0 +1,93 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLVolumeSharedMemory.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <cstring>
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSharedMemoryTest1(int , char * [])
+{
+  vtkNew<vtkMRMLVolumeSharedMemory> sharedMemory;
+  EXERCISE_BASIC_OBJECT_METHODS(sharedMemory.GetPointer());
+
+  CHECK_BOOL(vtkMRMLVolumeSharedMemory::IsSharedMemoryURI("slicershm:/test"), true);
+  CHECK_BOOL(vtkMRMLVolumeSharedMemory::IsSharedMemoryURI("/tmp/test.nrrd"), false);
+
+  std::string uri = vtkMRMLVolumeSharedMemory::GenerateUniqueURI();
+  CHECK_BOOL(vtkMRMLVolumeSharedMemory::IsSharedMemoryURI(uri), true);
+  CHECK_BOOL(uri != vtkMRMLVolumeSharedMemory::GenerateUniqueURI(), true);
+
+  if (!vtkMRMLVolumeSharedMemory::IsSupported())
+    {
+    CHECK_BOOL(sharedMemory->Open(uri), false);
+    std::cout << "Shared memory is not supported on this platform" << std::endl;
+    return EXIT_SUCCESS;
+    }
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(4, 5, 6);
+  image->AllocateScalars(VTK_SHORT, 2);
+  short* scalars = static_cast<short*>(image->GetScalarPointer());
+  const int numberOfValues = 4 * 5 * 6 * 2;
+  for (int i = 0; i < numberOfValues; ++i)
+    {
+    scalars[i] = static_cast<short>(i - 100);
+    }
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  ijkToRAS->SetElement(0, 0, -0.5);
+  ijkToRAS->SetElement(1, 1, 2.0);
+  ijkToRAS->SetElement(0, 3, 10.0);
+  ijkToRAS->SetElement(2, 3, -20.0);
+
+  CHECK_BOOL(sharedMemory->Open(uri), false);
+  CHECK_BOOL(vtkMRMLVolumeSharedMemory::WriteVolume(uri, image.GetPointer(), ijkToRAS.GetPointer()), true);
+
+  CHECK_BOOL(sharedMemory->Open(uri), true);
+  CHECK_BOOL(sharedMemory->IsOpen(), true);
+  const vtkMRMLVolumeSharedMemory::VolumeHeader* header = sharedMemory->GetHeader();
+  CHECK_NOT_NULL(header);
+  CHECK_INT(header->ScalarType, VTK_SHORT);
+  CHECK_INT(header->NumberOfComponents, 2);
+  CHECK_INT(header->Dimensions[0], 4);
+  CHECK_INT(header->Dimensions[1], 5);
+  CHECK_INT(header->Dimensions[2], 6);
+  CHECK_BOOL(memcmp(sharedMemory->GetScalarPointer(), scalars, numberOfValues * sizeof(short)) == 0, true);
+
+  vtkNew<vtkMatrix4x4> readIJKToRAS;
+  CHECK_BOOL(sharedMemory->GetIJKToRASMatrix(readIJKToRAS.GetPointer()), true);
+  for (int i = 0; i < 4; ++i)
+    {
+    for (int j = 0; j < 4; ++j)
+      {
+      CHECK_DOUBLE(readIJKToRAS->GetElement(i, j), ijkToRAS->GetElement(i, j));
+      }
+    }
+
+  // Mapping remains valid after the segment is removed
+  CHECK_BOOL(vtkMRMLVolumeSharedMemory::Remove(uri), true);
+  CHECK_INT(static_cast<const short*>(sharedMemory->GetScalarPointer())[numberOfValues - 1], numberOfValues - 101);
+  sharedMemory->Close();
+  CHECK_BOOL(sharedMemory->IsOpen(), false);
+  CHECK_NULL(sharedMemory->GetHeader());
+  CHECK_BOOL(sharedMemory->Open(uri), false);
+
+  return EXIT_SUCCESS;
+}
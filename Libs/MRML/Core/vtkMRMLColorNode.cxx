@@ -18,9 +18,12 @@ Version:   $Revision: 1.0 $
 #include "vtkMRMLStorageNode.h"
 
 // VTK includes
+#include <vtkDoubleArray.h>
+#include <vtkIntArray.h>
 #include <vtkLookupTable.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
+#include <vtkStringArray.h>
 
 // STD includes
 #include <cassert>
@@ -42,6 +45,9 @@ vtkMRMLColorNode::vtkMRMLColorNode()
   this->SetNoName("(none)");
 
   this->NamesInitialised = 0;
+
+  this->ColorIndicesByNameValid = false;
+  this->ColorIndicesByNameMTime = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -149,6 +155,7 @@ void vtkMRMLColorNode::Copy(vtkMRMLNode *anode)
 
   // copy names
   this->Names = node->Names;
+  this->ColorNamesModified();
 
   this->NamesInitialised = node->NamesInitialised;
 
@@ -273,6 +280,7 @@ void vtkMRMLColorNode::SetNamesFromColors()
   const int numPoints = this->GetNumberOfColors();
   // reset the names
   this->Names.resize(numPoints);
+  this->ColorNamesModified();
 
   for (int i = 0; i < numPoints; ++i)
     {
@@ -374,20 +382,58 @@ int vtkMRMLColorNode::GetColorIndexByName(const char *name)
     return -1;
     }
 
+  this->UpdateColorIndicesByName();
+  std::unordered_map<std::string, int>::const_iterator indexIt = this->ColorIndicesByName.find(name);
+  return (indexIt != this->ColorIndicesByName.end() ? indexIt->second : -1);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLColorNode::GetColorIndicesByName(vtkStringArray* names, vtkIntArray* colorIndices)
+{
+  if (!names || !colorIndices)
+    {
+    vtkErrorMacro("GetColorIndicesByName: invalid input names or output color indices");
+    return;
+    }
+  this->UpdateColorIndicesByName();
+  colorIndices->SetNumberOfComponents(1);
+  colorIndices->SetNumberOfValues(names->GetNumberOfValues());
+  for (vtkIdType i = 0; i < names->GetNumberOfValues(); ++i)
+    {
+    std::unordered_map<std::string, int>::const_iterator indexIt = this->ColorIndicesByName.find(names->GetValue(i));
+    colorIndices->SetValue(i, indexIt != this->ColorIndicesByName.end() ? indexIt->second : -1);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLColorNode::ColorNamesModified()
+{
+  this->ColorIndicesByNameValid = false;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLColorNode::UpdateColorIndicesByName()
+{
   if (!this->GetNamesInitialised())
     {
     this->SetNamesFromColors();
     }
-
-  std::string strName = name;
-  for (int i = 0; i < this->GetNumberOfColors(); ++i)
+  // Subclasses may modify the names without calling ColorNamesModified(),
+  // also rebuild the index if the node has been modified.
+  if (this->ColorIndicesByNameValid && this->ColorIndicesByNameMTime == this->GetMTime())
     {
-    if (strName == this->GetColorName(i))
-      {
-      return i;
-      }
+    return;
     }
-  return -1;
+  this->ColorIndicesByName.clear();
+  const int numberOfColors = this->GetNumberOfColors();
+  this->ColorIndicesByName.reserve(numberOfColors);
+  for (int i = 0; i < numberOfColors; ++i)
+    {
+    // Keep the lowest index of the names used by several colors
+    this->ColorIndicesByName.insert(std::make_pair(std::string(this->GetColorName(i)), i));
+    }
+  this->ColorIndicesByNameValid = true;
+  this->ColorIndicesByNameMTime = this->GetMTime();
 }
 
 //---------------------------------------------------------------------------
@@ -442,6 +488,7 @@ int vtkMRMLColorNode::SetColorName(int ind, const char *name)
   if (this->Names[ind] != newName)
     {
     this->Names[ind] = newName;
+    this->ColorNamesModified();
     this->StorableModifiedTime.Modified();
     this->Modified();
     }
@@ -479,6 +526,30 @@ bool vtkMRMLColorNode::GetColor(int vtkNotUsed(index), double vtkNotUsed(color)[
   return false;
 }
 
+//---------------------------------------------------------------------------
+bool vtkMRMLColorNode::GetColors(vtkIntArray* colorIndices, vtkDoubleArray* colors)
+{
+  if (!colorIndices || !colors)
+    {
+    vtkErrorMacro("GetColors: invalid input color indices or output colors");
+    return false;
+    }
+  bool allFound = true;
+  colors->SetNumberOfComponents(4);
+  colors->SetNumberOfTuples(colorIndices->GetNumberOfValues());
+  for (vtkIdType i = 0; i < colorIndices->GetNumberOfValues(); ++i)
+    {
+    double color[4] = { 0.0, 0.0, 0.0, 0.0 };
+    if (!this->GetColor(colorIndices->GetValue(i), color))
+      {
+      color[0] = color[1] = color[2] = color[3] = 0.0;
+      allFound = false;
+      }
+    colors->SetTuple(i, color);
+    }
+  return allFound;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLColorNode::Reset(vtkMRMLNode* vtkNotUsed(defaultNode))
 {
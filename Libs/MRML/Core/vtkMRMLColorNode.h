@@ -19,11 +19,15 @@
 #include "vtkMRMLStorableNode.h"
 
 // VTK includes
+class vtkDoubleArray;
+class vtkIntArray;
 class vtkLookupTable;
 class vtkScalarsToColors;
+class vtkStringArray;
 
 // Std includes
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 /// \brief Abstract MRML node to represent color information.
@@ -116,9 +120,17 @@ public:
 
   /// Return the index associated with this color name, which can then be used
   /// to get the color. Returns -1 on failure.
-  /// \sa GetColorName()
+  /// If several colors have the same name, the lowest index is returned.
+  /// Colors are looked up in an index of the names that is built at the first
+  /// call and rebuilt after the names are modified.
+  /// \sa GetColorName(), GetColorIndicesByName()
   int GetColorIndexByName(const char *name);
 
+  /// Get the indices of all the \a names at once, -1 for the names that are not found.
+  /// \a colorIndices is resized to the number of names.
+  /// \sa GetColorIndexByName()
+  void GetColorIndicesByName(vtkStringArray* names, vtkIntArray* colorIndices);
+
   /// Get the 0'th based \a colorIndex'th name of this color, replacing all
   /// file name sensitive color name characters with safer character(s).
   /// Only alphanumeric characters (A-Z,a-z,0-9) and '-','_','.','(',')','$',
@@ -154,6 +166,13 @@ public:
   /// Return 1 if the color exists, 0 otherwise
   virtual bool GetColor(int ind, double color[4]);
 
+  /// Retrieve the RGBA colors of all the \a colorIndices at once.
+  /// \a colors is set to 4 components and one tuple per index, tuples of
+  /// colors that do not exist are set to 0.
+  /// Return true if all the colors exist, false otherwise.
+  /// \sa GetColor()
+  bool GetColors(vtkIntArray* colorIndices, vtkDoubleArray* colors);
+
   ///
   /// Name of the file name from which to read color information
   vtkSetStringMacro(FileName);
@@ -221,6 +240,14 @@ protected:
   /// \sa GetNoName()
   virtual bool HasNameFromColor(int index);
 
+  /// Mark the index of the colors by name as outdated.
+  /// Must be called by subclasses that modify \a Names directly.
+  /// \sa GetColorIndexByName()
+  void ColorNamesModified();
+
+  /// Build the index of the colors by name if it is outdated.
+  void UpdateColorIndicesByName();
+
   /// Which type of color information does this node hold?
   /// Valid values are in the enumerated list
   int Type;
@@ -240,6 +267,13 @@ protected:
   ///
   /// Have the color names been set? Used to do lazy copy of the Names array.
   int NamesInitialised;
+
+  ///
+  /// Lowest color index for each color name, rebuilt in UpdateColorIndicesByName()
+  /// when the names or the node have been modified since it was built.
+  std::unordered_map<std::string, int> ColorIndicesByName;
+  bool ColorIndicesByNameValid;
+  vtkMTimeType ColorIndicesByNameMTime;
 };
 
 #endif
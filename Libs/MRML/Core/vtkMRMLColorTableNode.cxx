@@ -1092,6 +1092,7 @@ void vtkMRMLColorTableNode::SetType(int type)
       this->GetLookupTable()->SetTableRange(0,255);
       this->Names.clear();
       this->Names.resize(this->GetLookupTable()->GetNumberOfTableValues());
+      this->ColorNamesModified();
 
       if (this->SetColorName(0, "Black") != 0)
         {
@@ -1273,6 +1274,7 @@ void vtkMRMLColorTableNode::SetNumberOfColors(int n)
     // elements is set). We initialize the color names to have one for each lookup table item.
     std::string noNameStr = this->GetNoName() ? this->GetNoName() : "";
     this->Names.resize(n, noNameStr);
+    this->ColorNamesModified();
     }
 }
 
@@ -1380,6 +1382,7 @@ int vtkMRMLColorTableNode::SetColors(int firstEntry, int lastEntry, const char *
     {
     std::string noNameStr = this->GetNoName() ? this->GetNoName() : "";
     this->Names.resize(numberOfValues, noNameStr);
+    this->ColorNamesModified();
     }
   if (firstEntry < 0 || firstEntry >= numberOfValues)
     {
@@ -1409,6 +1412,7 @@ int vtkMRMLColorTableNode::SetColors(int firstEntry, int lastEntry, const char *
     *(rgba++) = static_cast<unsigned char>(a * 255.0 + 0.5);
     this->Names[indx] = nameStr;
     }
+  this->ColorNamesModified();
   lut->BuildSpecialColors();
   lut->Modified();
 
@@ -1458,6 +1462,7 @@ bool vtkMRMLColorTableNode::GetColor(int entry, double color[4])
 void vtkMRMLColorTableNode::ClearNames()
 {
   this->Names.clear();
+  this->ColorNamesModified();
   this->NamesInitialisedOff();
 }
 
@@ -47,6 +47,7 @@ vtkMRMLNRRDStorageNode::vtkMRMLNRRDStorageNode()
   this->CompressionPresets.emplace_back(this->GetCompressionParameterFastest(), "Fastest");
   this->CompressionPresets.emplace_back(this->GetCompressionParameterNormal(), "Normal");
   this->CompressionPresets.emplace_back(this->GetCompressionParameterMinimumSize(), "Minimum size");
+  this->CompressionPresets.emplace_back(this->GetCompressionParameterParallel(), "Parallel");
 
   this->CompressionParameter = this->GetCompressionParameterFastest();
 }
@@ -374,6 +375,7 @@ int vtkMRMLNRRDStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
   writer->SetInputConnection(volNode->GetImageDataConnection());
   writer->SetUseCompression(this->GetUseCompression());
   writer->SetCompressionLevel(this->GetGzipCompressionLevelFromCompressionParameter(this->CompressionParameter));
+  writer->SetParallelCompression(this->CompressionParameter == this->GetCompressionParameterParallel());
 
   // set volume attributes
   writer->SetIJKToRASMatrix(ijkToRas.GetPointer());
@@ -599,6 +601,10 @@ int vtkMRMLNRRDStorageNode::GetGzipCompressionLevelFromCompressionParameter(std:
     {
     return 9;
     }
+  else if (compressionParameter == this->GetCompressionParameterParallel())
+    {
+    return 6;
+    }
   return 1;
 }
 
@@ -72,6 +72,9 @@ class VTK_MRML_EXPORT vtkMRMLNRRDStorageNode : public vtkMRMLStorageNode
   std::string GetCompressionParameterNormal() { return "gzip_normal"; };
   /// Compression parameter corresponding to maximum compression (slow)
   std::string GetCompressionParameterMinimumSize() { return "gzip_minimum_size"; };
+  /// Compression parameter corresponding to normal compression, computed on multiple threads
+  /// (fast on multi-core systems, the file can still be read by any NRRD reader)
+  std::string GetCompressionParameterParallel() { return "gzip_parallel"; };
 
 protected:
   vtkMRMLNRRDStorageNode();
@@ -23,6 +23,7 @@ Version:   $Revision: 1.2 $
 #include <vtkAlgorithmOutput.h>
 #include <vtkCallbackCommand.h>
 #include <vtkColorTransferFunction.h>
+#include <vtkExtractVOI.h>
 #include <vtkImageAppendComponents.h>
 #include <vtkImageCast.h>
 #include <vtkImageData.h>
@@ -103,6 +104,8 @@ vtkMRMLScalarVolumeDisplayNode::vtkMRMLScalarVolumeDisplayNode()
   this->AppendComponents->AddInputConnection(0, this->AlphaLogic->GetOutputPort() );
 
   this->HistogramStatistics = nullptr;
+  this->HistogramSampler = nullptr;
+  this->HistogramSamplingStride = 1;
   this->IsInCalculateAutoLevels = false;
 
   vtkEventBroker::GetInstance()->AddObservation(
@@ -128,6 +131,11 @@ vtkMRMLScalarVolumeDisplayNode::~vtkMRMLScalarVolumeDisplayNode()
     this->HistogramStatistics->Delete();
     this->HistogramStatistics = nullptr;
     }
+  if (this->HistogramSampler)
+    {
+    this->HistogramSampler->Delete();
+    this->HistogramSampler = nullptr;
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -260,6 +268,11 @@ void vtkMRMLScalarVolumeDisplayNode::WriteXML(ostream& of, int nIndent)
   ss << this->AutoThreshold;
   of << " autoThreshold=\"" << ss.str() << "\"";
   }
+  {
+  std::stringstream ss;
+  ss << this->HistogramSamplingStride;
+  of << " histogramSamplingStride=\"" << ss.str() << "\"";
+  }
   if (this->WindowLevelPresets.size() > 0)
     {
     for (int p = 0; p < this->GetNumberOfWindowLevelPresets(); p++)
@@ -342,6 +355,14 @@ void vtkMRMLScalarVolumeDisplayNode::ReadXMLAttributes(const char** atts)
       ss << attValue;
       ss >> this->AutoThreshold;
       }
+    else if (!strcmp(attName, "histogramSamplingStride"))
+      {
+      std::stringstream ss;
+      ss << attValue;
+      int stride = 1;
+      ss >> stride;
+      this->SetHistogramSamplingStride(stride);
+      }
     else if (!strncmp(attName, "windowLevelPreset", 17))
       {
       this->AddWindowLevelPresetFromString(attValue);
@@ -368,6 +389,7 @@ void vtkMRMLScalarVolumeDisplayNode::CopyContent(vtkMRMLNode* anode, bool deepCo
   this->SetApplyThreshold(node->GetApplyThreshold());
   this->SetThreshold(node->GetLowerThreshold(), node->GetUpperThreshold());
   this->SetInterpolate(node->Interpolate);
+  this->SetHistogramSamplingStride(node->HistogramSamplingStride);
   for (int p = 0; p < node->GetNumberOfWindowLevelPresets(); p++)
     {
     this->AddWindowLevelPreset(node->GetWindowPreset(p), node->GetLevelPreset(p));
@@ -394,6 +416,7 @@ void vtkMRMLScalarVolumeDisplayNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "UpperThreshold:    " << this->GetUpperThreshold() << "\n";
   os << indent << "LowerThreshold:    " << this->GetLowerThreshold() << "\n";
   os << indent << "Interpolate:       " << this->Interpolate << "\n";
+  os << indent << "HistogramSamplingStride: " << this->HistogramSamplingStride << "\n";
 }
 
 //---------------------------------------------------------------------------
@@ -715,20 +738,12 @@ void vtkMRMLScalarVolumeDisplayNode::GetDisplayScalarRange(double range[2])
 }
 
 //---------------------------------------------------------------------------
-void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
+vtkImageHistogramStatistics* vtkMRMLScalarVolumeDisplayNode::GetHistogramStatistics()
 {
-  if (!this->GetAutoWindowLevel() && !this->GetAutoThreshold())
-    {
-    vtkDebugMacro("CalculateScalarAutoLevels: " << (this->GetID() == nullptr ? "nullid" : this->GetID())
-                  << ": Auto window level not turned on, returning.");
-    return;
-    }
-
   vtkImageData *imageDataScalar = this->GetScalarImageData();
   if (!imageDataScalar)
     {
-    vtkDebugMacro("CalculateScalarAutoLevels: input image data is null");
-    return;
+    return nullptr;
     }
   // Make sure the point data is up to date.
   // Remember, the display node pipeline is not connected to a consumer (volume
@@ -742,8 +757,7 @@ void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
   if (!(imageDataScalar->GetPointData()) ||
       !(imageDataScalar->GetPointData()->GetScalars()))
     {
-    vtkDebugMacro("CalculateScalarAutoLevels: input image data is null");
-    return;
+    return nullptr;
     }
 
   if (this->HistogramStatistics == nullptr)
@@ -768,10 +782,71 @@ void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
     this->HistogramStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
     }
 
-  this->IsInCalculateAutoLevels = true;
-  this->HistogramStatistics->SetInputData(imageDataScalar);
+  // SetInputData creates a new trivial producer, which would make the filter
+  // recompute the histogram even if the image has not changed. Therefore the
+  // input is only set if it is a different image, content changes are
+  // detected by the pipeline from the image modified time.
+  if (this->HistogramSamplingStride > 1)
+    {
+    if (this->HistogramSampler == nullptr)
+      {
+      this->HistogramSampler = vtkExtractVOI::New();
+      }
+    if (this->HistogramSampler->GetNumberOfInputConnections(0) == 0
+      || this->HistogramSampler->GetInputDataObject(0, 0) != imageDataScalar)
+      {
+      this->HistogramSampler->SetInputData(imageDataScalar);
+      }
+    this->HistogramSampler->SetSampleRate(this->HistogramSamplingStride,
+      this->HistogramSamplingStride, this->HistogramSamplingStride);
+    this->HistogramStatistics->SetInputConnection(this->HistogramSampler->GetOutputPort());
+    }
+  else if (this->HistogramStatistics->GetNumberOfInputConnections(0) == 0
+    || this->HistogramStatistics->GetInputDataObject(0, 0) != imageDataScalar)
+    {
+    this->HistogramStatistics->SetInputData(imageDataScalar);
+    }
   this->HistogramStatistics->Update();
-  double* intensityRange = this->HistogramStatistics->GetAutoRange();
+  return this->HistogramStatistics;
+}
+
+//---------------------------------------------------------------------------
+vtkDataArray* vtkMRMLScalarVolumeDisplayNode::GetHistogramScalars()
+{
+  if (!this->GetHistogramStatistics())
+    {
+    return nullptr;
+    }
+  vtkImageData* histogramInput = vtkImageData::SafeDownCast(this->HistogramStatistics->GetInputDataObject(0, 0));
+  if (!histogramInput || !histogramInput->GetPointData())
+    {
+    return nullptr;
+    }
+  return histogramInput->GetPointData()->GetScalars();
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
+{
+  if (!this->GetAutoWindowLevel() && !this->GetAutoThreshold())
+    {
+    vtkDebugMacro("CalculateScalarAutoLevels: " << (this->GetID() == nullptr ? "nullid" : this->GetID())
+                  << ": Auto window level not turned on, returning.");
+    return;
+    }
+
+  // Updating the histogram may update the image data pipeline, which may
+  // modify this node, therefore it must be done inside the guard.
+  this->IsInCalculateAutoLevels = true;
+  vtkImageHistogramStatistics* histogramStatistics = this->GetHistogramStatistics();
+  if (!histogramStatistics)
+    {
+    vtkDebugMacro("CalculateScalarAutoLevels: input image data is null");
+    this->IsInCalculateAutoLevels = false;
+    return;
+    }
+
+  double* intensityRange = histogramStatistics->GetAutoRange();
   vtkDebugMacro("CalculateScalarAutoLevels:"
                 << " lower: " << intensityRange[0] << " upper: " << intensityRange[1]);
 
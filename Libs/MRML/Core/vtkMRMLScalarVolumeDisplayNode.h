@@ -23,6 +23,7 @@ class vtkImageAlgorithm;
 class vtkImageAppendComponents;
 class vtkImageHistogramStatistics;
 class vtkImageCast;
+class vtkExtractVOI;
 class vtkImageLogic;
 class vtkImageMapToColors;
 class vtkImageMapToWindowLevelColors;
@@ -141,6 +142,34 @@ class VTK_MRML_EXPORT vtkMRMLScalarVolumeDisplayNode : public vtkMRMLVolumeDispl
   vtkSetMacro(Interpolate, int);
   vtkBooleanMacro(Interpolate, int);
 
+  ///
+  /// Distance between voxels (along each axis) that are used for computing
+  /// the intensity histogram. The histogram is used for automatic
+  /// window/level and threshold and it is available to other modules
+  /// by GetHistogramStatistics().
+  /// 1 (default) means all voxels are used and the exact histogram is
+  /// computed (using multiple threads). Larger values make the computation
+  /// much faster for large or frequently changing volumes (e.g., sequence
+  /// playback or live streaming) at the cost of accuracy.
+  vtkGetMacro(HistogramSamplingStride, int);
+  vtkSetClampMacro(HistogramSamplingStride, int, 1, VTK_INT_MAX);
+
+  ///
+  /// Get intensity histogram statistics of the scalar image data.
+  /// The histogram is cached, it is only recomputed if the image data or
+  /// HistogramSamplingStride is changed. Modules that need the intensity
+  /// distribution of the volume (volume rendering transfer functions,
+  /// histogram widgets) should use this instead of scanning all voxels again.
+  /// Returns nullptr if there is no image data.
+  vtkImageHistogramStatistics* GetHistogramStatistics();
+
+  ///
+  /// Get the voxel values that the histogram is computed from: all scalars
+  /// of the scalar image data if HistogramSamplingStride is 1, the sampled
+  /// values otherwise.
+  /// Returns nullptr if there is no image data.
+  vtkDataArray* GetHistogramScalars();
+
   void SetDefaultColorMap() override;
 
   ///
@@ -250,6 +279,8 @@ protected:
   ///
   /// Used internally in CalculateScalarAutoLevels and CalculateStatisticsAutoLevels
   vtkImageHistogramStatistics *HistogramStatistics;
+  vtkExtractVOI *HistogramSampler;
+  int HistogramSamplingStride;
   bool IsInCalculateAutoLevels;
 };
 
@@ -21,6 +21,7 @@ Version:   $Revision: 1.1.1.1 $
 #include "vtkMRMLScene.h"
 #include "vtkMRMLStorableNode.h"
 #include "vtkMRMLStorageNode.h"
+#include "vtkMRMLTracer.h"
 
 // VTK includes
 #include <vtkCollection.h>
@@ -1256,6 +1257,7 @@ int vtkMRMLStorageNode::ReadData(vtkMRMLNode* refNode, bool temporary)
     <<  "URI = " << (this->GetURI() == nullptr ? "null" : this->GetURI()) << ", "
     << "filename = " << (this->GetFileName() == nullptr ? "null" : this->GetFileName()));
   vtkMRMLStorableNode* storableNode = vtkMRMLStorableNode::SafeDownCast(refNode);
+  vtkMRMLTraceZoneMacro("Storage", "ReadData", this->GetFileName());
   int success = this->ReadDataInternal(refNode);
   if (!success)
     {
@@ -1325,6 +1327,7 @@ int vtkMRMLStorageNode::WriteData(vtkMRMLNode* refNode)
     return 0;
     }
 
+  vtkMRMLTraceZoneMacro("Storage", "WriteData", this->GetFileName());
   int success = this->WriteDataInternal(refNode);
 
   // If there were error messages, then do not return that we were successful
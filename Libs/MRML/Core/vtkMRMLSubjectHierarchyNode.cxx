@@ -42,6 +42,9 @@
 #include <set>
 #include <map>
 #include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
 
 //----------------------------------------------------------------------------
 const vtkIdType vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID = 0;
@@ -52,6 +55,8 @@ const std::string vtkMRMLSubjectHierarchyNode::SUBJECTHIERARCHY_VERSION_ATTRIBUT
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLSubjectHierarchyNode);
 
+class vtkSubjectHierarchyItemIndex;
+
 //----------------------------------------------------------------------------
 class vtkSubjectHierarchyItem : public vtkObject
 {
@@ -103,10 +108,12 @@ public:
   /// The ID is resolved to pointer after import ends, and this member is set to INVALID_ITEM_ID.
   vtkIdType TemporaryParentItemID;
 
-  /// Item and data node cache to speed up lookups that are needed many times.
-  /// It can be static as the item IDs are unique in one application session.
-  static std::map<vtkIdType, vtkSubjectHierarchyItem*> ItemCache;
-  static std::map<vtkMRMLNode*, vtkSubjectHierarchyItem*> DataNodeCache;
+  /// Lookup index of the subject hierarchy that contains the item.
+  /// nullptr if the item is not in a subject hierarchy tree (e.g. unresolved items).
+  vtkSubjectHierarchyItemIndex* Index{nullptr};
+  /// Data node the item is registered with in the index. It is stored separately from
+  /// DataNode because that is reset when the data node is deleted.
+  vtkMRMLNode* IndexedDataNode{nullptr};
 
 // Get/set functions
 public:
@@ -183,6 +190,8 @@ public:
   /// \return Item if found, nullptr otherwise
   void FindChildrenByName( std::string name, std::vector<vtkIdType> &foundItemIDs,
                            bool contains=false, bool recursive=true );
+  /// Determine whether the item is in the branch of the given item (and is not the given item itself)
+  bool IsDescendantOf(vtkSubjectHierarchyItem* ancestor);
   /// Get data nodes (of a certain type) associated to items in the branch of this item
   void GetDataNodesInBranch(vtkCollection *children, const char* childClass=nullptr);
   /// Get IDs of all children in the branch recursively
@@ -247,8 +256,216 @@ vtkStandardNewMacro(vtkSubjectHierarchyItem);
 
 vtkIdType vtkSubjectHierarchyItem::NextSubjectHierarchyItemID = vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID + 1;
 
-std::map<vtkIdType, vtkSubjectHierarchyItem*> vtkSubjectHierarchyItem::ItemCache = std::map<vtkIdType, vtkSubjectHierarchyItem*>();
-std::map<vtkMRMLNode*, vtkSubjectHierarchyItem*> vtkSubjectHierarchyItem::DataNodeCache = std::map<vtkMRMLNode*, vtkSubjectHierarchyItem*>();
+//----------------------------------------------------------------------------
+/// Hash tables to look up the items of a subject hierarchy by ID, data node, UID and attribute name
+/// without traversing the tree. Each subject hierarchy node has its own index, which is kept
+/// up-to-date by the items when they are added to or removed from the tree, and when their data
+/// node, UIDs or attributes change.
+class vtkSubjectHierarchyItemIndex
+{
+public:
+  /// Add item with its data node, UIDs and attributes to the index
+  void AddItem(vtkSubjectHierarchyItem* item);
+  /// Remove item with its data node, UIDs and attributes from the index
+  void RemoveItem(vtkSubjectHierarchyItem* item);
+  /// Update the data node entry of the item after its data node has changed
+  void UpdateItemDataNode(vtkSubjectHierarchyItem* item);
+  void AddItemUID(vtkSubjectHierarchyItem* item, const std::string& uidName, const std::string& uidValue);
+  void RemoveItemUID(vtkSubjectHierarchyItem* item, const std::string& uidName, const std::string& uidValue);
+  void AddItemAttribute(vtkSubjectHierarchyItem* item, const std::string& attributeName);
+  void RemoveItemAttribute(vtkSubjectHierarchyItem* item, const std::string& attributeName);
+
+  /// \return Item with the given ID, nullptr if not found
+  vtkSubjectHierarchyItem* FindItemByID(vtkIdType itemID);
+  /// \return Item associated to the data node, nullptr if not found
+  vtkSubjectHierarchyItem* FindItemByDataNode(vtkMRMLNode* dataNode);
+  /// Get items that have a UID with the given name and value (exact match)
+  void FindItemsByUID(const std::string& uidName, const std::string& uidValue, std::vector<vtkSubjectHierarchyItem*>& foundItems);
+  /// Get items that have an attribute with the given name (with any value)
+  void FindItemsByAttribute(const std::string& attributeName, std::vector<vtkSubjectHierarchyItem*>& foundItems);
+  /// Get number of items in the index
+  int GetNumberOfItems() { return static_cast<int>(this->Items.size()); }
+
+protected:
+  std::unordered_map<vtkIdType, vtkSubjectHierarchyItem*> Items;
+  std::unordered_map<vtkMRMLNode*, vtkSubjectHierarchyItem*> DataNodes;
+  /// UID name -> hash of UID value -> items. Only the hash of the value is stored, because
+  /// UID values can be long (e.g. instance UID lists). Matches are verified on lookup.
+  std::unordered_map<std::string, std::unordered_multimap<size_t, vtkSubjectHierarchyItem*> > UIDs;
+  /// Attribute name -> items having the attribute
+  std::unordered_map<std::string, std::unordered_set<vtkSubjectHierarchyItem*> > Attributes;
+};
+
+//---------------------------------------------------------------------------
+// vtkSubjectHierarchyItemIndex methods
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItemIndex::AddItem(vtkSubjectHierarchyItem* item)
+{
+  item->Index = this;
+  this->Items[item->ID] = item;
+  item->IndexedDataNode = item->DataNode.GetPointer();
+  if (item->IndexedDataNode)
+    {
+    this->DataNodes[item->IndexedDataNode] = item;
+    }
+  for (std::map<std::string, std::string>::iterator uidIt = item->UIDs.begin(); uidIt != item->UIDs.end(); ++uidIt)
+    {
+    this->AddItemUID(item, uidIt->first, uidIt->second);
+    }
+  for (std::map<std::string, std::string>::iterator attIt = item->Attributes.begin(); attIt != item->Attributes.end(); ++attIt)
+    {
+    this->AddItemAttribute(item, attIt->first);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItemIndex::RemoveItem(vtkSubjectHierarchyItem* item)
+{
+  std::unordered_map<vtkIdType, vtkSubjectHierarchyItem*>::iterator itemIt = this->Items.find(item->ID);
+  if (itemIt != this->Items.end() && itemIt->second == item)
+    {
+    this->Items.erase(itemIt);
+    }
+  if (item->IndexedDataNode)
+    {
+    std::unordered_map<vtkMRMLNode*, vtkSubjectHierarchyItem*>::iterator nodeIt = this->DataNodes.find(item->IndexedDataNode);
+    if (nodeIt != this->DataNodes.end() && nodeIt->second == item)
+      {
+      this->DataNodes.erase(nodeIt);
+      }
+    }
+  for (std::map<std::string, std::string>::iterator uidIt = item->UIDs.begin(); uidIt != item->UIDs.end(); ++uidIt)
+    {
+    this->RemoveItemUID(item, uidIt->first, uidIt->second);
+    }
+  for (std::map<std::string, std::string>::iterator attIt = item->Attributes.begin(); attIt != item->Attributes.end(); ++attIt)
+    {
+    this->RemoveItemAttribute(item, attIt->first);
+    }
+  item->IndexedDataNode = nullptr;
+  item->Index = nullptr;
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItemIndex::UpdateItemDataNode(vtkSubjectHierarchyItem* item)
+{
+  if (item->IndexedDataNode)
+    {
+    std::unordered_map<vtkMRMLNode*, vtkSubjectHierarchyItem*>::iterator nodeIt = this->DataNodes.find(item->IndexedDataNode);
+    if (nodeIt != this->DataNodes.end() && nodeIt->second == item)
+      {
+      this->DataNodes.erase(nodeIt);
+      }
+    }
+  item->IndexedDataNode = item->DataNode.GetPointer();
+  if (item->IndexedDataNode)
+    {
+    this->DataNodes[item->IndexedDataNode] = item;
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItemIndex::AddItemUID(vtkSubjectHierarchyItem* item, const std::string& uidName, const std::string& uidValue)
+{
+  this->UIDs[uidName].insert(std::make_pair(std::hash<std::string>()(uidValue), item));
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItemIndex::RemoveItemUID(vtkSubjectHierarchyItem* item, const std::string& uidName, const std::string& uidValue)
+{
+  auto uidNameIt = this->UIDs.find(uidName);
+  if (uidNameIt == this->UIDs.end())
+    {
+    return;
+    }
+  auto range = uidNameIt->second.equal_range(std::hash<std::string>()(uidValue));
+  for (auto uidIt = range.first; uidIt != range.second; ++uidIt)
+    {
+    if (uidIt->second == item)
+      {
+      uidNameIt->second.erase(uidIt);
+      break;
+      }
+    }
+  if (uidNameIt->second.empty())
+    {
+    this->UIDs.erase(uidNameIt);
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItemIndex::AddItemAttribute(vtkSubjectHierarchyItem* item, const std::string& attributeName)
+{
+  this->Attributes[attributeName].insert(item);
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItemIndex::RemoveItemAttribute(vtkSubjectHierarchyItem* item, const std::string& attributeName)
+{
+  auto attributeIt = this->Attributes.find(attributeName);
+  if (attributeIt == this->Attributes.end())
+    {
+    return;
+    }
+  attributeIt->second.erase(item);
+  if (attributeIt->second.empty())
+    {
+    this->Attributes.erase(attributeIt);
+    }
+}
+
+//---------------------------------------------------------------------------
+vtkSubjectHierarchyItem* vtkSubjectHierarchyItemIndex::FindItemByID(vtkIdType itemID)
+{
+  std::unordered_map<vtkIdType, vtkSubjectHierarchyItem*>::iterator itemIt = this->Items.find(itemID);
+  return (itemIt != this->Items.end() ? itemIt->second : nullptr);
+}
+
+//---------------------------------------------------------------------------
+vtkSubjectHierarchyItem* vtkSubjectHierarchyItemIndex::FindItemByDataNode(vtkMRMLNode* dataNode)
+{
+  std::unordered_map<vtkMRMLNode*, vtkSubjectHierarchyItem*>::iterator nodeIt = this->DataNodes.find(dataNode);
+  if (nodeIt == this->DataNodes.end())
+    {
+    return nullptr;
+    }
+  // The entry is outdated if the data node was deleted and a new node was created at the same address
+  return (nodeIt->second->DataNode.GetPointer() == dataNode ? nodeIt->second : nullptr);
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItemIndex::FindItemsByUID(const std::string& uidName, const std::string& uidValue,
+  std::vector<vtkSubjectHierarchyItem*>& foundItems)
+{
+  foundItems.clear();
+  auto uidNameIt = this->UIDs.find(uidName);
+  if (uidNameIt == this->UIDs.end())
+    {
+    return;
+    }
+  auto range = uidNameIt->second.equal_range(std::hash<std::string>()(uidValue));
+  for (auto uidIt = range.first; uidIt != range.second; ++uidIt)
+    {
+    std::map<std::string, std::string>::iterator itemUidIt = uidIt->second->UIDs.find(uidName);
+    if (itemUidIt != uidIt->second->UIDs.end() && itemUidIt->second == uidValue)
+      {
+      foundItems.push_back(uidIt->second);
+      }
+    }
+}
+
+//---------------------------------------------------------------------------
+void vtkSubjectHierarchyItemIndex::FindItemsByAttribute(const std::string& attributeName,
+  std::vector<vtkSubjectHierarchyItem*>& foundItems)
+{
+  foundItems.clear();
+  auto attributeIt = this->Attributes.find(attributeName);
+  if (attributeIt != this->Attributes.end())
+    {
+    foundItems.assign(attributeIt->second.begin(), attributeIt->second.end());
+    }
+}
 
 //---------------------------------------------------------------------------
 // vtkSubjectHierarchyItem methods
@@ -273,6 +490,11 @@ vtkSubjectHierarchyItem::~vtkSubjectHierarchyItem()
 {
   this->RemoveAllChildren();
 
+  if (this->Index)
+    {
+    this->Index->RemoveItem(this);
+    }
+
   this->Attributes.clear();
   this->UIDs.clear();
 }
@@ -300,11 +522,10 @@ vtkIdType vtkSubjectHierarchyItem::AddToTree(vtkSubjectHierarchyItem* parent, vt
     vtkSmartPointer<vtkSubjectHierarchyItem> childPointer(this);
     this->Parent->Children.push_back(childPointer);
 
-    // Add to cache
-    vtkSubjectHierarchyItem::ItemCache[this->ID] = this;
-    if (dataNode)
+    // Add to the index of the hierarchy
+    if (parent->Index)
       {
-      vtkSubjectHierarchyItem::DataNodeCache[dataNode] = this;
+      parent->Index->AddItem(this);
       }
     }
   else
@@ -348,8 +569,11 @@ vtkIdType vtkSubjectHierarchyItem::AddToTree(vtkSubjectHierarchyItem* parent, st
       this->Parent->Children.insert(this->Parent->Children.begin() + positionUnderParent, childPointer);
       }
 
-    // Add to cache (DataNode is nullptr, so no need to add to node cache)
-    vtkSubjectHierarchyItem::ItemCache[this->ID] = this;
+    // Add to the index of the hierarchy
+    if (parent->Index)
+      {
+      parent->Index->AddItem(this);
+      }
     }
   else if (! ( (!name.compare("Scene") && !level.compare("Scene"))
             || (!name.compare("UnresolvedItems") && !level.compare("UnresolvedItems")) ) )
@@ -357,6 +581,11 @@ vtkIdType vtkSubjectHierarchyItem::AddToTree(vtkSubjectHierarchyItem* parent, st
     // Only the scene item or the unresolved items parent can have nullptr parent
     vtkErrorMacro("AddToTree: Invalid parent of non-scene item to add");
     }
+  else if (this->Index)
+    {
+    // Scene item, the index of the hierarchy is set by the subject hierarchy node
+    this->Index->AddItem(this);
+    }
 
   this->InvokeEvent(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemAddedEvent, this);
 
@@ -717,16 +946,16 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByID(vtkIdType itemID
     return nullptr;
     }
 
-  // Try to find item in cache
-  std::map<vtkIdType, vtkSubjectHierarchyItem*>::iterator itemIt = vtkSubjectHierarchyItem::ItemCache.find(itemID);
-  if (itemIt != vtkSubjectHierarchyItem::ItemCache.end())
+  // Look up item in the index of the hierarchy.
+  // It is not an error if item is not found. It happens normally when scene has just been
+  // closed and widgets are updating themselves and trying to look up their selected item.
+  if (this->Index)
     {
-    return itemIt->second;
+    vtkSubjectHierarchyItem* foundItem = this->Index->FindItemByID(itemID);
+    return (foundItem != this ? foundItem : nullptr);
     }
-  // It is not an error if item is not found in cache. It happens normally when
-  // scene has just been closed and widgets are updating themselves and trying to look up their selected item.
 
-  // On failure to look up in cache (should not happen), traverse tree to find item
+  // Items that are not in a hierarchy (e.g. unresolved items) are found by traversing the tree
   ChildVector::iterator childIt;
   vtkSubjectHierarchyItem* foundItem = nullptr;
   for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
@@ -747,10 +976,6 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByID(vtkIdType itemID
         }
       }
     }
-  if (foundItem)
-    {
-    vtkSubjectHierarchyItem::ItemCache[itemID] = this;
-    }
 
   return foundItem;
 }
@@ -763,6 +988,17 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByDataNode(vtkMRMLNod
     return nullptr;
     }
 
+  // Look up item in the index of the hierarchy
+  if (this->Index)
+    {
+    vtkSubjectHierarchyItem* foundItem = this->Index->FindItemByDataNode(dataNode);
+    if (foundItem && (recursive ? foundItem->IsDescendantOf(this) : foundItem->Parent == this))
+      {
+      return foundItem;
+      }
+    return nullptr;
+    }
+
   ChildVector::iterator childIt;
   for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
     {
@@ -790,6 +1026,27 @@ vtkSubjectHierarchyItem* vtkSubjectHierarchyItem::FindChildByUID(std::string uid
     {
     return nullptr;
     }
+
+  // Look up candidate items in the index of the hierarchy
+  if (this->Index)
+    {
+    std::vector<vtkSubjectHierarchyItem*> foundItems;
+    this->Index->FindItemsByUID(uidName, uidValue, foundItems);
+    std::vector<vtkSubjectHierarchyItem*> foundItemsInBranch;
+    for (std::vector<vtkSubjectHierarchyItem*>::iterator itemIt = foundItems.begin(); itemIt != foundItems.end(); ++itemIt)
+      {
+      if (recursive ? (*itemIt)->IsDescendantOf(this) : (*itemIt)->Parent == this)
+        {
+        foundItemsInBranch.push_back(*itemIt);
+        }
+      }
+    if (foundItemsInBranch.size() < 2)
+      {
+      return (foundItemsInBranch.empty() ? nullptr : foundItemsInBranch[0]);
+      }
+    // Traverse the tree to return the first one if multiple items have the same UID
+    }
+
   ChildVector::iterator childIt;
   for (childIt=this->Children.begin(); childIt!=this->Children.end(); ++childIt)
     {
@@ -874,6 +1131,19 @@ void vtkSubjectHierarchyItem::FindChildrenByName(std::string name, std::vector<v
     }
 }
 
+//---------------------------------------------------------------------------
+bool vtkSubjectHierarchyItem::IsDescendantOf(vtkSubjectHierarchyItem* ancestor)
+{
+  for (vtkSubjectHierarchyItem* currentItem = this->Parent; currentItem; currentItem = currentItem->Parent)
+    {
+    if (currentItem == ancestor)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
 //---------------------------------------------------------------------------
 void vtkSubjectHierarchyItem::GetDataNodesInBranch(vtkCollection* dataNodeCollection, const char* childClass/*=nullptr*/)
 {
@@ -1124,11 +1394,10 @@ bool vtkSubjectHierarchyItem::RemoveChild(vtkSubjectHierarchyItem* item)
   // Reparent children to parent node (to avoid them becoming orphans and thus lost to the hierarchy)
   removedItem->ReparentChildrenToParent();
 
-  // Remove from cache
-  vtkSubjectHierarchyItem::ItemCache.erase(removedItem->ID);
-  if (removedItem->DataNode)
+  // Remove from the index of the hierarchy
+  if (removedItem->Index)
     {
-    vtkSubjectHierarchyItem::DataNodeCache.erase(removedItem->DataNode);
+    removedItem->Index->RemoveItem(removedItem);
     }
 
   // Invoke events
@@ -1186,11 +1455,10 @@ bool vtkSubjectHierarchyItem::RemoveChild(vtkIdType itemID)
   // Reparent children to parent node (to avoid them becoming orphans and thus lost to the hierarchy)
   removedItem->ReparentChildrenToParent();
 
-  // Remove from cache
-  vtkSubjectHierarchyItem::ItemCache.erase(removedItem->ID);
-  if (removedItem->DataNode)
+  // Remove from the index of the hierarchy
+  if (removedItem->Index)
     {
-    vtkSubjectHierarchyItem::DataNodeCache.erase(removedItem->DataNode);
+    removedItem->Index->RemoveItem(removedItem);
     }
 
   // Invoke events
@@ -1242,29 +1510,23 @@ void vtkSubjectHierarchyItem::RemoveAllChildren()
 {
   std::vector<vtkIdType> childIDs;
   this->GetAllChildren(childIDs);
-  while (childIDs.size())
+  // The children of an item always come after the item in the list, so removing the items in
+  // reverse order removes every item when it has become a leaf
+  std::vector<vtkIdType>::reverse_iterator childIt;
+  for (childIt=childIDs.rbegin(); childIt!=childIDs.rend(); ++childIt)
     {
-    // Remove first leaf item found
-    std::vector<vtkIdType>::iterator childIt;
-    for (childIt=childIDs.begin(); childIt!=childIDs.end(); ++childIt)
+    if ((*childIt) == vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID)
       {
-      if ((*childIt) == vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID)
-        {
-        // This can happen when UnresolvedItems are deleted. In that case the items will automatically deconstruct
-        childIDs.erase(childIt);
-        break;
-        }
-      vtkSubjectHierarchyItem* currentItem = this->FindChildByID(*childIt);
-      if (currentItem && !currentItem->HasChildren())
-        {
-        // Remove leaf item
-        currentItem->Parent->RemoveChild(*childIt);
-        // Remove ID of deleted item from list and keep deleting until empty
-        childIDs.erase(childIt);
-        break;
-        }
+      // This can happen when UnresolvedItems are deleted. In that case the items will automatically deconstruct
+      continue;
+      }
+    // The item may have been removed already by an observer of a previous removal
+    vtkSubjectHierarchyItem* currentItem = this->FindChildByID(*childIt);
+    if (currentItem && currentItem->Parent)
+      {
+      currentItem->Parent->RemoveChild(*childIt);
       }
-    } // While there are children to delete
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -1278,6 +1540,10 @@ void vtkSubjectHierarchyItem::SetUID(std::string uidName, std::string uidValue)
       {
       vtkWarningMacro( "SetUID: UID with name '" << uidName << "' already exists in subject hierarchy item '" << this->GetName()
         << "' with value '" << this->UIDs[uidName] << "'. Replacing it with value '" << uidValue << "'" );
+      if (this->Index)
+        {
+        this->Index->RemoveItemUID(this, uidName, this->UIDs[uidName]);
+        }
       }
     else
       {
@@ -1285,6 +1551,10 @@ void vtkSubjectHierarchyItem::SetUID(std::string uidName, std::string uidValue)
       }
     }
   this->UIDs[uidName] = uidValue;
+  if (this->Index)
+    {
+    this->Index->AddItemUID(this, uidName, uidValue);
+    }
   this->InvokeEvent(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemUIDAddedEvent, this);
   this->Modified();
 }
@@ -1315,6 +1585,10 @@ void vtkSubjectHierarchyItem::SetAttribute(std::string attributeName, std::strin
     return; // Attribute to set is same as original value, nothing to do
     }
   this->Attributes[attributeName] = attributeValue;
+  if (this->Index)
+    {
+    this->Index->AddItemAttribute(this, attributeName);
+    }
   this->InvokeEvent(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemOwnerPluginSearchRequested, this);
   this->Modified();
 }
@@ -1331,6 +1605,10 @@ bool vtkSubjectHierarchyItem::RemoveAttribute(std::string attributeName)
   if (this->Attributes.find(attributeName) != this->Attributes.end())
     {
     this->Attributes.erase(attributeName);
+    if (this->Index)
+      {
+      this->Index->RemoveItemAttribute(this, attributeName);
+      }
     this->InvokeEvent(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemOwnerPluginSearchRequested, this);
     this->Modified();
     return true;
@@ -1454,6 +1732,9 @@ public:
   void AddItemObservers(vtkSubjectHierarchyItem* item);
 
 public:
+  /// Lookup index of the items in the tree under the scene item (including the scene item)
+  vtkSubjectHierarchyItemIndex ItemIndex;
+
   /// Scene subject hierarchy item. This is the ancestor of all subject hierarchy items in the tree
   vtkSubjectHierarchyItem* SceneItem;
   /// ID of the scene subject hierarchy item. It is used to access the item from outside the node
@@ -1486,6 +1767,7 @@ vtkMRMLSubjectHierarchyNode::vtkInternal::vtkInternal(vtkMRMLSubjectHierarchyNod
 {
   // Create scene item
   this->SceneItem = vtkSubjectHierarchyItem::New();
+  this->SceneItem->Index = &this->ItemIndex;
   this->SceneItemID = this->SceneItem->AddToTree(nullptr, "Scene", "Scene");
 
   // Create mock item containing unresolved items
@@ -1518,7 +1800,7 @@ vtkSubjectHierarchyItem* vtkMRMLSubjectHierarchyNode::vtkInternal::FindItemByID(
     }
 
   // Find item under the scene item
-  return this->SceneItem->FindChildByID(itemID);
+  return this->ItemIndex.FindItemByID(itemID);
 }
 
 //---------------------------------------------------------------------------
@@ -2071,22 +2353,12 @@ void vtkMRMLSubjectHierarchyNode::SetItemDataNode(vtkIdType itemID, vtkMRMLNode*
     return;
     }
 
-  // Remove old cached node
-  if (item->DataNode)
-    {
-    auto itemIt = vtkSubjectHierarchyItem::DataNodeCache.find(item->DataNode);
-    if (itemIt != vtkSubjectHierarchyItem::DataNodeCache.end())
-      {
-      vtkSubjectHierarchyItem::DataNodeCache.erase(itemIt);
-      }
-    }
-
   item->DataNode = dataNode;
 
-  // Add new node to cache
-  if (item->DataNode)
+  // Update data node in the index
+  if (item->Index)
     {
-    vtkSubjectHierarchyItem::DataNodeCache[item->DataNode] = item;
+    item->Index->UpdateItemDataNode(item);
     }
 
   // Add observers for data node
@@ -2640,61 +2912,57 @@ bool vtkMRMLSubjectHierarchyNode::RemoveItem(vtkIdType itemID, bool removeDataNo
   // Start with the leaf nodes so that triggered updates are faster (no reparenting done after deleting intermediate items)
   if (recursive || item->IsVirtualBranchParent())
     {
-    std::vector<vtkIdType> virtualItemIDs; // List of virtual item IDs that do not need to be explicitly deleted
     std::vector<vtkIdType> childIDs;
     item->GetAllChildren(childIDs);
-    while (childIDs.size())
+
+    // Collect virtual item IDs that do not need to be explicitly deleted, because they are
+    // automatically removed when the parent of their virtual branch is removed
+    std::set<vtkIdType> virtualItemIDs;
+    std::vector<vtkIdType>::iterator childIt;
+    for (childIt=childIDs.begin(); childIt!=childIDs.end(); ++childIt)
       {
-      // Remove first leaf node found
-      // (or if the parent of a virtual branch, in which the items are automatically removed when their parent is removed)
-      std::vector<vtkIdType>::iterator childIt;
-      for (childIt=childIDs.begin(); childIt!=childIDs.end(); ++childIt)
+      vtkSubjectHierarchyItem* currentItem = this->Internal->FindItemByID(*childIt);
+      if (currentItem && currentItem->IsVirtualBranchParent())
         {
-        // Skip if virtual item, because its data node and subject hierarchy item was already deleted
-        if (std::find(virtualItemIDs.begin(), virtualItemIDs.end(), (*childIt)) != virtualItemIDs.end())
-          {
-          childIDs.erase(childIt);
-          break;
-          }
+        std::vector<vtkIdType> currentVirtualItemIDs;
+        currentItem->GetDirectChildren(currentVirtualItemIDs);
+        virtualItemIDs.insert(currentVirtualItemIDs.begin(), currentVirtualItemIDs.end());
+        }
+      }
 
-        // Get item by ID and delete it if leaf or virtual branch parent
-        vtkSubjectHierarchyItem* currentItem = this->Internal->SceneItem->FindChildByID(*childIt);
-        if (!currentItem)
-          {
-          // Already deleted item ID was in the list
-          vtkErrorMacro("RemoveItem: Failed to find subject hierarchy item by ID " << (*childIt));
-          childIDs.erase(childIt);
-          break;
-          }
-        if ( !currentItem->HasChildren() || currentItem->IsVirtualBranchParent() )
-          {
-          // Mark child item IDs in case it is a virtual branch parent, because those items do not need to be explicitly deleted
-          if (currentItem->IsVirtualBranchParent())
-            {
-            std::vector<vtkIdType> currentVirtualItemIDs;
-            currentItem->GetDirectChildren(currentVirtualItemIDs);
-            virtualItemIDs.insert(virtualItemIDs.end(), currentVirtualItemIDs.begin(), currentVirtualItemIDs.end());
-            }
-
-          // Remove data node from scene if requested.. In that case removing the item explicitly
-          // is not necessary because removing the node triggers removing the item automatically
-          if (removeDataNode && currentItem->DataNode && this->Scene)
-            {
-            this->Scene->RemoveNode(currentItem->DataNode.GetPointer());
-            }
-          // Remove leaf item from its parent if not in virtual branch (if in virtual branch, then they will be removed
-          // automatically when their parent is removed)
-          else if (!currentItem->Parent->IsVirtualBranchParent())
-            {
-            currentItem->Parent->RemoveChild(*childIt);
-            }
-
-          // Remove ID of deleted item (or virtual branch leaf) from list and keep deleting until empty
-          childIDs.erase(childIt);
-          break;
-          }
+    // The children of an item always come after the item in the list, so removing the items in
+    // reverse order removes every item when it has become a leaf (or is the parent of a virtual branch)
+    std::vector<vtkIdType>::reverse_iterator removedIt;
+    for (removedIt=childIDs.rbegin(); removedIt!=childIDs.rend(); ++removedIt)
+      {
+      // Skip if virtual item, because its data node and subject hierarchy item was already deleted
+      if (virtualItemIDs.find(*removedIt) != virtualItemIDs.end())
+        {
+        continue;
+        }
+
+      // Get item by ID and delete it
+      vtkSubjectHierarchyItem* currentItem = this->Internal->FindItemByID(*removedIt);
+      if (!currentItem)
+        {
+        // Already deleted item ID was in the list
+        vtkErrorMacro("RemoveItem: Failed to find subject hierarchy item by ID " << (*removedIt));
+        continue;
+        }
+
+      // Remove data node from scene if requested.. In that case removing the item explicitly
+      // is not necessary because removing the node triggers removing the item automatically
+      if (removeDataNode && currentItem->DataNode && this->Scene)
+        {
+        this->Scene->RemoveNode(currentItem->DataNode.GetPointer());
         }
-      } // While there are children to delete
+      // Remove leaf item from its parent if not in virtual branch (if in virtual branch, then they will be removed
+      // automatically when their parent is removed)
+      else if (!currentItem->Parent->IsVirtualBranchParent())
+        {
+        currentItem->Parent->RemoveChild(*removedIt);
+        }
+      }
     }
 
   // Remove data node of given item from scene if requested. In that case removing the item explicitly
@@ -2806,6 +3074,12 @@ void vtkMRMLSubjectHierarchyNode::SetItemParent(vtkIdType itemID, vtkIdType pare
   item->Reparent(parentItem);
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLSubjectHierarchyNode::HasItem(vtkIdType itemID)
+{
+  return itemID && this->Internal->FindItemByID(itemID) != nullptr;
+}
+
 //----------------------------------------------------------------------------
 vtkIdType vtkMRMLSubjectHierarchyNode::GetItemParent(vtkIdType itemID)
 {
@@ -2959,31 +3233,7 @@ vtkIdType vtkMRMLSubjectHierarchyNode::GetItemByDataNode(vtkMRMLNode* dataNode)
     return INVALID_ITEM_ID;
     }
 
-  auto itemIt = vtkSubjectHierarchyItem::DataNodeCache.find(dataNode);
-  if (itemIt != vtkSubjectHierarchyItem::DataNodeCache.end())
-    {
-    if (itemIt->second)
-      {
-      if (itemIt->second->DataNode == dataNode)
-        {
-        // found it in cache
-        return itemIt->second->ID;
-        }
-      else
-        {
-        vtkErrorMacro("vtkSubjectHierarchyItem::DataNodeCache inconsistency found");
-        vtkSubjectHierarchyItem::DataNodeCache.erase(itemIt);
-        }
-      }
-    }
-
-  vtkSubjectHierarchyItem* item = this->Internal->SceneItem->FindChildByDataNode(dataNode);
-  if (item)
-    {
-    // item was not in the cache, add it now
-    vtkErrorMacro("vtkSubjectHierarchyItem::DataNodeCache item was missing");
-    vtkSubjectHierarchyItem::DataNodeCache[dataNode] = item;
-    }
+  vtkSubjectHierarchyItem* item = this->Internal->ItemIndex.FindItemByDataNode(dataNode);
   return (item ? item->ID : INVALID_ITEM_ID);
 }
 
@@ -3035,6 +3285,49 @@ void vtkMRMLSubjectHierarchyNode::GetItemsByName(std::string name, vtkIdList* fo
     }
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLSubjectHierarchyNode::GetItemsByAttribute(std::string attributeName, std::vector<vtkIdType>& foundItemIDs)
+{
+  foundItemIDs.clear();
+  if (attributeName.empty())
+    {
+    vtkErrorMacro("GetItemsByAttribute: Empty attribute name given");
+    return;
+    }
+
+  std::vector<vtkSubjectHierarchyItem*> foundItems;
+  this->Internal->ItemIndex.FindItemsByAttribute(attributeName, foundItems);
+  for (std::vector<vtkSubjectHierarchyItem*>::iterator itemIt=foundItems.begin(); itemIt!=foundItems.end(); ++itemIt)
+    {
+    if ((*itemIt) != this->Internal->SceneItem)
+      {
+      foundItemIDs.push_back((*itemIt)->ID);
+      }
+    }
+  // Return the items in a deterministic order
+  std::sort(foundItemIDs.begin(), foundItemIDs.end());
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLSubjectHierarchyNode::GetItemsByAttribute(std::string attributeName, vtkIdList* foundItemIds)
+{
+  if (!foundItemIds)
+    {
+    vtkErrorMacro("GetItemsByAttribute: Invalid output ID list");
+    return;
+    }
+  foundItemIds->Reset();
+
+  std::vector<vtkIdType> foundItemsVector;
+  this->GetItemsByAttribute(attributeName, foundItemsVector);
+
+  std::vector<vtkIdType>::iterator itemIt;
+  for (itemIt=foundItemsVector.begin(); itemIt!=foundItemsVector.end(); ++itemIt)
+    {
+    foundItemIds->InsertNextId(*itemIt);
+    }
+}
+
 //---------------------------------------------------------------------------
 vtkIdType vtkMRMLSubjectHierarchyNode::GetItemChildWithName(vtkIdType parentItemID, std::string name, bool recursive/*=false*/)
 {
@@ -3439,11 +3732,12 @@ std::vector<vtkIdType> vtkMRMLSubjectHierarchyNode::GetItemsReferencingItemByDIC
   this->DeserializeUIDList(uidsString, uidVector);
 
   // Find subject hierarchy items containing first SOP instance UID in referenced UIDs attribute
+  // (only the items that have the attribute need to be checked)
   std::vector<vtkIdType> allItemIDs;
-  this->Internal->SceneItem->GetAllChildren(allItemIDs);
+  this->GetItemsByAttribute(vtkMRMLSubjectHierarchyConstants::GetDICOMReferencedInstanceUIDsAttributeName(), allItemIDs);
   for (std::vector<vtkIdType>::iterator itemIt=allItemIDs.begin(); itemIt!=allItemIDs.end(); ++itemIt)
     {
-    vtkSubjectHierarchyItem* currentItem =this->Internal->SceneItem->FindChildByID(*itemIt);
+    vtkSubjectHierarchyItem* currentItem = this->Internal->ItemIndex.FindItemByID(*itemIt);
     std::string referencedUids = currentItem->GetAttribute(vtkMRMLSubjectHierarchyConstants::GetDICOMReferencedInstanceUIDsAttributeName());
     bool referencesUid = false;
     for (std::vector<std::string>::iterator uidIt=uidVector.begin(); uidIt!=uidVector.end(); ++uidIt)
@@ -3535,9 +3829,8 @@ std::string vtkMRMLSubjectHierarchyNode::GenerateUniqueItemName(std::string name
 //---------------------------------------------------------------------------
 int vtkMRMLSubjectHierarchyNode::GetNumberOfItems()
 {
-  std::vector<vtkIdType> allItems;
-  this->Internal->SceneItem->GetAllChildren(allItems);
-  return allItems.size();
+  // All items in the index are under the scene item, except the scene item itself
+  return this->Internal->ItemIndex.GetNumberOfItems() - 1;
 }
 
 //---------------------------------------------------------------------------
@@ -3555,15 +3848,13 @@ int vtkMRMLSubjectHierarchyNode::GetNumberOfItemChildren(vtkIdType itemID, bool
     return -1;
     }
 
-  std::vector<vtkIdType> childIDs;
-  if (recursive)
+  if (!recursive)
     {
-    item->GetAllChildren(childIDs);
-    }
-  else
-    {
-    item->GetDirectChildren(childIDs);
+    // Called for every row when item views check whether an item has children, so avoid copying the IDs
+    return static_cast<int>(item->Children.size());
     }
+  std::vector<vtkIdType> childIDs;
+  item->GetAllChildren(childIDs);
   return childIDs.size();
 }
 
@@ -245,6 +245,9 @@ public:
   /// Set the parent of a subject hierarchy item
   /// \param enableCircularCheck Option to do a safety check for circular parenthood in performance-critical cases. On by default.
   void SetItemParent(vtkIdType itemID, vtkIdType parentItemID, bool enableCircularCheck=true);
+  /// Determine whether an item with the given ID is in the hierarchy (the scene item included).
+  /// Unlike the item getters, it does not log an error if the item is not found.
+  bool HasItem(vtkIdType itemID);
   /// Get ID of the parent of a subject hierarchy item
   /// \return Parent item ID, INVALID_ITEM_ID if there is no parent
   vtkIdType GetItemParent(vtkIdType itemID);
@@ -304,6 +307,13 @@ public:
   /// \return Item ID of the first item found by name using exact match. Warning is logged if more than one found
   void GetItemsByName(std::string name, vtkIdList* foundItemIds, bool contains=false);
 
+  /// Get items in whole subject hierarchy that have a given attribute (with any value)
+  /// \param attributeName Name of the attribute to find
+  /// \param foundItemIDs List of found item IDs, in ascending order
+  void GetItemsByAttribute(std::string attributeName, std::vector<vtkIdType>& foundItemIDs);
+  /// Python accessibility function to get items in whole subject hierarchy that have a given attribute
+  void GetItemsByAttribute(std::string attributeName, vtkIdList* foundItemIds);
+
   /// Get child subject hierarchy item with specific name
   /// \param parent Parent subject hierarchy item to start from
   /// \param name Name to find
@@ -28,48 +28,753 @@
 
 // VTK includes
 #include <vtkObjectFactory.h>
-#include <vtkDelimitedTextReader.h>
-#include <vtkDelimitedTextWriter.h>
-#include <vtkErrorSink.h>
 #include <vtkTable.h>
 #include <vtkStringArray.h>
 #include <vtkBitArray.h>
 #include <vtkNew.h>
+#include <vtkSMPTools.h>
+#include <vtkUnsignedCharArray.h>
 #include <vtksys/SystemTools.hxx>
 
 // STL includes
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
 #include <set>
+#include <type_traits>
+
+namespace
+{
+
+//------------------------------------------------------------------------------
+// Delimited text files are read and written in blocks of this size, so that
+// large tables are never held in memory as text all at once.
+const size_t DELIMITED_TEXT_BLOCK_SIZE = 16 * 1024 * 1024;
+
+// Number of rows that are formatted together by a single thread when writing.
+const vtkIdType DELIMITED_TEXT_ROWS_PER_CHUNK = 4096;
+
+const char STRING_DELIMITER = '"';
+
+//------------------------------------------------------------------------------
+// Parse a number from the text [begin, end). Leading and trailing white spaces
+// are ignored. Returns false if the text is not a valid number for type T.
+template <typename T>
+bool ParseDelimitedTextNumber(const char* begin, const char* end, T& value)
+{
+  // strto... functions require a null-terminated string
+  char buffer[64];
+  std::string longText;
+  const char* text = buffer;
+  size_t length = static_cast<size_t>(end - begin);
+  if (length < sizeof(buffer))
+    {
+    memcpy(buffer, begin, length);
+    buffer[length] = '\0';
+    }
+  else
+    {
+    longText.assign(begin, end);
+    text = longText.c_str();
+    }
+
+  char* parsedEnd = nullptr;
+  errno = 0;
+  if (std::is_floating_point<T>::value)
+    {
+    double parsedValue = strtod(text, &parsedEnd);
+    if (errno == ERANGE && std::isinf(parsedValue))
+      {
+      // overflow ("inf" text is accepted)
+      return false;
+      }
+    // Values that are rounded to the largest float value are in range
+    if (std::fabs(parsedValue) > static_cast<double>(std::numeric_limits<T>::max())
+      * (1.0 + std::numeric_limits<T>::epsilon() / 2.0) && std::isfinite(parsedValue))
+      {
+      return false;
+      }
+    value = static_cast<T>(parsedValue);
+    }
+  else if (sizeof(T) == 1)
+    {
+    // Char types are read as integer numbers (not as characters) and
+    // are converted the same way as vtkVariant::ToInt() values are.
+    long long parsedValue = strtoll(text, &parsedEnd, 10);
+    if (errno == ERANGE || parsedValue < std::numeric_limits<int>::min() || parsedValue > std::numeric_limits<int>::max())
+      {
+      return false;
+      }
+    value = static_cast<T>(parsedValue);
+    }
+  else if (std::is_signed<T>::value)
+    {
+    long long parsedValue = strtoll(text, &parsedEnd, 10);
+    if (errno == ERANGE
+      || parsedValue < static_cast<long long>(std::numeric_limits<T>::min())
+      || parsedValue > static_cast<long long>(std::numeric_limits<T>::max()))
+      {
+      return false;
+      }
+    value = static_cast<T>(parsedValue);
+    }
+  else
+    {
+    const char* firstCharacter = text;
+    while (isspace(static_cast<unsigned char>(*firstCharacter)))
+      {
+      ++firstCharacter;
+      }
+    if (*firstCharacter == '-')
+      {
+      return false;
+      }
+    unsigned long long parsedValue = strtoull(text, &parsedEnd, 10);
+    if (errno == ERANGE || parsedValue > static_cast<unsigned long long>(std::numeric_limits<T>::max()))
+      {
+      return false;
+      }
+    value = static_cast<T>(parsedValue);
+    }
+
+  if (parsedEnd == text)
+    {
+    // no number found
+    return false;
+    }
+  while (isspace(static_cast<unsigned char>(*parsedEnd)))
+    {
+    ++parsedEnd;
+    }
+  return *parsedEnd == '\0';
+}
 
 //------------------------------------------------------------------------------
-// Helper class to be able to read tables that have "\" characters in them.
+// Stores the values of a field of a delimited text file in a column.
+// SetValue() and SetNullValue() are called concurrently for different rows.
+class DelimitedTextFieldTarget
+{
+public:
+  virtual ~DelimitedTextFieldTarget() = default;
+  /// Called each time the output arrays have been resized, before values are set.
+  virtual void Update() = 0;
+  /// Set value from the text [begin, end), which does not contain string delimiters anymore.
+  virtual void SetValue(vtkIdType row, const char* begin, const char* end) = 0;
+  /// Set value of a row that does not have this field.
+  virtual void SetNullValue(vtkIdType row) = 0;
+};
+
+//------------------------------------------------------------------------------
+class DelimitedTextStringFieldTarget : public DelimitedTextFieldTarget
+{
+public:
+  DelimitedTextStringFieldTarget(vtkStringArray* array)
+    : Array(array)
+    {
+    }
+  void Update() override
+    {
+    this->Values = this->Array->GetNumberOfValues() > 0 ? this->Array->GetPointer(0) : nullptr;
+    }
+  void SetValue(vtkIdType row, const char* begin, const char* end) override
+    {
+    this->Values[row].assign(begin, end);
+    }
+  void SetNullValue(vtkIdType row) override
+    {
+    this->Values[row].clear();
+    }
+protected:
+  vtkStringArray* Array;
+  vtkStdString* Values{ nullptr };
+};
+
+//------------------------------------------------------------------------------
+// Stores values in a component of a numeric array. Empty or invalid values
+// are replaced by the null value.
+template <typename T>
+class DelimitedTextNumericFieldTarget : public DelimitedTextFieldTarget
+{
+public:
+  DelimitedTextNumericFieldTarget(vtkDataArray* array, int component, double nullValue)
+    : Array(array)
+    , Component(component)
+    , NullValue(static_cast<T>(nullValue))
+    {
+    }
+  void Update() override
+    {
+    this->NumberOfComponents = this->Array->GetNumberOfComponents();
+    this->Values = static_cast<T*>(this->Array->GetVoidPointer(0));
+    }
+  void SetValue(vtkIdType row, const char* begin, const char* end) override
+    {
+    T value;
+    this->Values[row * this->NumberOfComponents + this->Component] =
+      (begin != end && ParseDelimitedTextNumber(begin, end, value)) ? value : this->NullValue;
+    }
+  void SetNullValue(vtkIdType row) override
+    {
+    this->Values[row * this->NumberOfComponents + this->Component] = this->NullValue;
+    }
+protected:
+  vtkDataArray* Array;
+  int Component;
+  T NullValue;
+  int NumberOfComponents{ 1 };
+  T* Values{ nullptr };
+};
+
+//------------------------------------------------------------------------------
+// Stores bit values in an unsigned char array (bit arrays cannot be written
+// concurrently), any non-zero number is stored as 1.
+class DelimitedTextBitFieldTarget : public DelimitedTextNumericFieldTarget<unsigned char>
+{
+public:
+  DelimitedTextBitFieldTarget(vtkDataArray* array, int component, double nullValue)
+    : DelimitedTextNumericFieldTarget<unsigned char>(array, component, nullValue != 0.0 ? 1.0 : 0.0)
+    {
+    }
+  void SetValue(vtkIdType row, const char* begin, const char* end) override
+    {
+    int value;
+    this->Values[row * this->NumberOfComponents + this->Component] =
+      (begin != end && ParseDelimitedTextNumber(begin, end, value)) ? (value != 0) : this->NullValue;
+    }
+};
+
+//------------------------------------------------------------------------------
+// Reader of delimited text (CSV, TSV) files.
 //
-// vtkDelimitedTextReader uses "\" as escape character therefore "\" is always
-// processed together with the subsequent character(s) as an escape sequence,
-// which prevents loading tables that use backslash characters in the text.
-// Since there is no API to change the escape character we use this modified class
-// to read tables.
-// Using "\" as escape character does not even survive a roundtrip with
-// vtkDelimitedTextWriter and vtkDelimitedTextReader because the writer does not
-// convert "\" to escaped "\\", so we simply not use escape characters.
+// The file is read block by block. Records (lines) of each block are split into
+// fields and the fields are converted to their column type in parallel, directly
+// into the output arrays.
+//
+// String delimiters (double-quotes) are removed but no escape characters are used:
+// "\" is a regular character. vtkDelimitedTextReader uses "\" as escape character,
+// which prevents loading tables that use backslash characters in the text and does
+// not survive a roundtrip with vtkDelimitedTextWriter, which does not escape "\".
 // Since we assume UTF-8 everywhere, not using a special escape character
 // should not be an issue.
-class vtkNoEscapeDelimitedTextReader : public vtkDelimitedTextReader
+class DelimitedTextReader
 {
 public:
-  static vtkNoEscapeDelimitedTextReader* New();
-  vtkTypeMacro(vtkNoEscapeDelimitedTextReader, vtkDelimitedTextReader);
+  DelimitedTextReader(const std::string& fieldDelimiterCharacters)
+    {
+    std::fill(this->IsFieldDelimiter, this->IsFieldDelimiter + 256, false);
+    for (char delimiter : fieldDelimiterCharacters)
+      {
+      this->IsFieldDelimiter[static_cast<unsigned char>(delimiter)] = true;
+      }
+    }
+
+  /// Open the file and read the field names from the first (non-empty) line.
+  bool ReadHeader(const std::string& fileName, std::vector<std::string>& fieldNames)
+    {
+    fieldNames.clear();
+    this->File.open(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!this->File.is_open())
+      {
+      return false;
+      }
+    if (!this->ReadBlock())
+      {
+      return false;
+      }
+    // Skip UTF-8 byte order mark
+    if (this->Buffer.compare(0, 3, "\xEF\xBB\xBF") == 0)
+      {
+      this->Buffer.erase(0, 3);
+      }
+    std::vector<std::pair<size_t, size_t>> records;
+    size_t consumed = this->FindRecords(records, 1);
+    while (records.empty() && !this->EndOfFile)
+      {
+      if (!this->ReadBlock())
+        {
+        return false;
+        }
+      consumed = this->FindRecords(records, 1);
+      }
+    if (records.empty())
+      {
+      // empty file
+      return true;
+      }
+    std::string unquotedField;
+    const char* text = this->Buffer.data();
+    this->SplitRecord(text + records[0].first, text + records[0].second, unquotedField,
+      [&fieldNames](int, const char* begin, const char* end) { fieldNames.emplace_back(begin, end); });
+    this->Buffer.erase(0, consumed);
+    return true;
+    }
+
+  /// Array that receives values, resized as records are read.
+  void AddArray(vtkAbstractArray* array)
+    {
+    this->Arrays.push_back(array);
+    }
+
+  /// Use \a target to store the values of the field at \a fieldIndex (takes ownership).
+  void SetFieldTarget(int fieldIndex, DelimitedTextFieldTarget* target)
+    {
+    if (fieldIndex >= static_cast<int>(this->FieldTargets.size()))
+      {
+      this->FieldTargets.resize(fieldIndex + 1);
+      }
+    this->FieldTargets[fieldIndex].reset(target);
+    }
+
+  /// Read all the records after the header into the arrays.
+  bool ReadRecords()
+    {
+    std::vector<std::pair<size_t, size_t>> records;
+    while (true)
+      {
+      records.clear();
+      size_t consumed = this->FindRecords(records, 0);
+      if (!records.empty())
+        {
+        this->ParseRecords(records);
+        }
+      this->Buffer.erase(0, consumed);
+      if (this->EndOfFile)
+        {
+        break;
+        }
+      if (!this->ReadBlock())
+        {
+        return false;
+        }
+      }
+    for (vtkAbstractArray* array : this->Arrays)
+      {
+      array->Squeeze();
+      array->DataChanged();
+      }
+    return true;
+    }
 
 protected:
-  vtkNoEscapeDelimitedTextReader()
+  /// Append the next block of the file to the buffer.
+  bool ReadBlock()
     {
-    this->UnicodeEscapeCharacter.clear();
+    size_t previousSize = this->Buffer.size();
+    this->Buffer.resize(previousSize + DELIMITED_TEXT_BLOCK_SIZE);
+    this->File.read(&this->Buffer[previousSize], DELIMITED_TEXT_BLOCK_SIZE);
+    this->Buffer.resize(previousSize + static_cast<size_t>(this->File.gcount()));
+    if (this->File.eof())
+      {
+      this->EndOfFile = true;
+      return true;
+      }
+    return !this->File.fail();
+    }
+
+  /// Find the complete non-empty records in the buffer (at most maximumNumberOfRecords, if not 0).
+  /// Records are returned as [begin, end) positions, without line ending characters.
+  /// Returns the position in the buffer after the last complete record.
+  size_t FindRecords(std::vector<std::pair<size_t, size_t>>& records, size_t maximumNumberOfRecords)
+    {
+    const char* text = this->Buffer.data();
+    const size_t size = this->Buffer.size();
+    size_t recordBegin = 0;
+    bool inString = false;
+    for (size_t position = 0; position < size; ++position)
+      {
+      const char c = text[position];
+      if (c == STRING_DELIMITER)
+        {
+        inString = !inString;
+        }
+      else if (c == '\n' && !inString)
+        {
+        this->AddRecord(records, recordBegin, position);
+        recordBegin = position + 1;
+        if (maximumNumberOfRecords > 0 && records.size() >= maximumNumberOfRecords)
+          {
+          return recordBegin;
+          }
+        }
+      }
+    if (this->EndOfFile)
+      {
+      // last line may not be terminated by a line ending
+      this->AddRecord(records, recordBegin, size);
+      return size;
+      }
+    return recordBegin;
+    }
+
+  void AddRecord(std::vector<std::pair<size_t, size_t>>& records, size_t begin, size_t end)
+    {
+    if (end > begin && this->Buffer[end - 1] == '\r')
+      {
+      --end;
+      }
+    if (end > begin)
+      {
+      records.emplace_back(begin, end);
+      }
+    }
+
+  /// Call fieldFunction(fieldIndex, fieldBegin, fieldEnd) for each field of the record [begin, end).
+  /// Returns the number of fields.
+  template <typename FieldFunction>
+  int SplitRecord(const char* begin, const char* end, std::string& unquotedField, FieldFunction fieldFunction)
+    {
+    int fieldIndex = 0;
+    const char* fieldBegin = begin;
+    bool inString = false;
+    bool quoted = false;
+    for (const char* c = begin; ; ++c)
+      {
+      if (c == end || (!inString && this->IsFieldDelimiter[static_cast<unsigned char>(*c)]))
+        {
+        if (quoted)
+          {
+          unquotedField.clear();
+          std::remove_copy(fieldBegin, c, std::back_inserter(unquotedField), STRING_DELIMITER);
+          fieldFunction(fieldIndex, unquotedField.data(), unquotedField.data() + unquotedField.size());
+          }
+        else
+          {
+          fieldFunction(fieldIndex, fieldBegin, c);
+          }
+        ++fieldIndex;
+        if (c == end)
+          {
+          break;
+          }
+        fieldBegin = c + 1;
+        quoted = false;
+        }
+      else if (*c == STRING_DELIMITER)
+        {
+        inString = !inString;
+        quoted = true;
+        }
+      }
+    return fieldIndex;
+    }
+
+  /// Grow the arrays and store the values of the records in them.
+  void ParseRecords(const std::vector<std::pair<size_t, size_t>>& records)
+    {
+    const vtkIdType firstRow = this->NumberOfRecords;
+    this->NumberOfRecords += static_cast<vtkIdType>(records.size());
+    for (vtkAbstractArray* array : this->Arrays)
+      {
+      // Grow capacity geometrically, as SetNumberOfTuples does not preserve existing values
+      vtkIdType capacity = array->GetSize() / std::max(1, array->GetNumberOfComponents());
+      if (this->NumberOfRecords > capacity)
+        {
+        array->Resize(std::max(this->NumberOfRecords, 2 * capacity));
+        }
+      array->SetNumberOfTuples(this->NumberOfRecords);
+      }
+    const int numberOfFieldTargets = static_cast<int>(this->FieldTargets.size());
+    for (std::unique_ptr<DelimitedTextFieldTarget>& target : this->FieldTargets)
+      {
+      if (target)
+        {
+        target->Update();
+        }
+      }
+
+    const char* text = this->Buffer.data();
+    vtkSMPTools::For(0, static_cast<vtkIdType>(records.size()),
+      [&](vtkIdType beginRecord, vtkIdType endRecord)
+      {
+      std::string unquotedField;
+      for (vtkIdType recordIndex = beginRecord; recordIndex < endRecord; ++recordIndex)
+        {
+        const vtkIdType row = firstRow + recordIndex;
+        const std::pair<size_t, size_t>& record = records[recordIndex];
+        int numberOfFields = this->SplitRecord(text + record.first, text + record.second, unquotedField,
+          [this, row, numberOfFieldTargets](int fieldIndex, const char* begin, const char* end)
+          {
+          if (fieldIndex < numberOfFieldTargets && this->FieldTargets[fieldIndex])
+            {
+            this->FieldTargets[fieldIndex]->SetValue(row, begin, end);
+            }
+          });
+        for (int fieldIndex = numberOfFields; fieldIndex < numberOfFieldTargets; ++fieldIndex)
+          {
+          if (this->FieldTargets[fieldIndex])
+            {
+            this->FieldTargets[fieldIndex]->SetNullValue(row);
+            }
+          }
+        }
+      });
     }
-  ~vtkNoEscapeDelimitedTextReader() = default;
-  vtkNoEscapeDelimitedTextReader(const vtkNoEscapeDelimitedTextReader&);
-  void operator=(const vtkNoEscapeDelimitedTextReader&);
+
+  bool IsFieldDelimiter[256];
+  std::ifstream File;
+  bool EndOfFile{ false };
+  std::string Buffer;
+  vtkIdType NumberOfRecords{ 0 };
+  std::vector<vtkAbstractArray*> Arrays;
+  std::vector<std::unique_ptr<DelimitedTextFieldTarget>> FieldTargets;
 };
 
-vtkStandardNewMacro(vtkNoEscapeDelimitedTextReader);
+//------------------------------------------------------------------------------
+// Append a floating-point value using the shortest of the two precisions that
+// allows reading back the exact same value.
+template <typename T>
+void AppendDelimitedTextFloatingPoint(std::string& text, T value, int shortPrecision, int roundTripPrecision)
+{
+  char buffer[64];
+  int length = snprintf(buffer, sizeof(buffer), "%.*g", shortPrecision, static_cast<double>(value));
+  if (std::isfinite(value) && static_cast<T>(strtod(buffer, nullptr)) != value)
+    {
+    length = snprintf(buffer, sizeof(buffer), "%.*g", roundTripPrecision, static_cast<double>(value));
+    }
+  text.append(buffer, length);
+}
+
+//------------------------------------------------------------------------------
+template <typename T>
+void AppendDelimitedTextNumber(std::string& text, T value)
+{
+  char buffer[32];
+  int length = 0;
+  if (std::is_signed<T>::value)
+    {
+    length = snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+    }
+  else
+    {
+    length = snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value));
+    }
+  text.append(buffer, length);
+}
+template <>
+void AppendDelimitedTextNumber(std::string& text, float value)
+{
+  AppendDelimitedTextFloatingPoint(text, value, std::numeric_limits<float>::digits10, std::numeric_limits<float>::max_digits10);
+}
+template <>
+void AppendDelimitedTextNumber(std::string& text, double value)
+{
+  AppendDelimitedTextFloatingPoint(text, value, std::numeric_limits<double>::digits10, std::numeric_limits<double>::max_digits10);
+}
+
+//------------------------------------------------------------------------------
+// Appends values of a column to delimited text. AppendValue() is called concurrently.
+class DelimitedTextColumnSource
+{
+public:
+  DelimitedTextColumnSource(vtkAbstractArray* array)
+    : Array(array)
+    , NumberOfComponents(array->GetNumberOfComponents())
+    , NumberOfTuples(array->GetNumberOfTuples())
+    {
+    }
+  virtual ~DelimitedTextColumnSource() = default;
+  virtual void AppendValue(std::string& text, vtkIdType valueIndex) = 0;
+
+  vtkAbstractArray* Array;
+  int NumberOfComponents;
+  vtkIdType NumberOfTuples;
+};
+
+//------------------------------------------------------------------------------
+class DelimitedTextStringColumnSource : public DelimitedTextColumnSource
+{
+public:
+  DelimitedTextStringColumnSource(vtkAbstractArray* array, bool useStringDelimiter)
+    : DelimitedTextColumnSource(array)
+    , StringArray(vtkStringArray::SafeDownCast(array))
+    , UseStringDelimiter(useStringDelimiter)
+    {
+    }
+  void AppendValue(std::string& text, vtkIdType valueIndex) override
+    {
+    if (this->UseStringDelimiter)
+      {
+      text += STRING_DELIMITER;
+      }
+    if (this->StringArray)
+      {
+      text += this->StringArray->GetValue(valueIndex);
+      }
+    else
+      {
+      text += this->Array->GetVariantValue(valueIndex).ToString();
+      }
+    if (this->UseStringDelimiter)
+      {
+      text += STRING_DELIMITER;
+      }
+    }
+protected:
+  vtkStringArray* StringArray;
+  bool UseStringDelimiter;
+};
+
+//------------------------------------------------------------------------------
+template <typename T>
+class DelimitedTextNumericColumnSource : public DelimitedTextColumnSource
+{
+public:
+  DelimitedTextNumericColumnSource(vtkDataArray* array)
+    : DelimitedTextColumnSource(array)
+    , Values(static_cast<T*>(array->GetVoidPointer(0)))
+    {
+    }
+  void AppendValue(std::string& text, vtkIdType valueIndex) override
+    {
+    AppendDelimitedTextNumber(text, this->Values[valueIndex]);
+    }
+protected:
+  const T* Values;
+};
+
+//------------------------------------------------------------------------------
+// Used for data arrays that are not stored as a contiguous array of values (e.g., bit arrays)
+class DelimitedTextDataArrayColumnSource : public DelimitedTextColumnSource
+{
+public:
+  DelimitedTextDataArrayColumnSource(vtkDataArray* array)
+    : DelimitedTextColumnSource(array)
+    , DataArray(array)
+    , IntegerValues(array->GetDataType() != VTK_FLOAT && array->GetDataType() != VTK_DOUBLE)
+    {
+    }
+  void AppendValue(std::string& text, vtkIdType valueIndex) override
+    {
+    double value = this->DataArray->GetComponent(valueIndex / this->NumberOfComponents, valueIndex % this->NumberOfComponents);
+    if (this->IntegerValues)
+      {
+      AppendDelimitedTextNumber(text, static_cast<long long>(value));
+      }
+    else
+      {
+      AppendDelimitedTextNumber(text, value);
+      }
+    }
+protected:
+  vtkDataArray* DataArray;
+  bool IntegerValues;
+};
+
+//------------------------------------------------------------------------------
+// Write a table as delimited text. Rows are formatted in parallel, in chunks,
+// and the formatted chunks are written to the file in order.
+bool WriteDelimitedText(const std::string& fileName, vtkTable* table, const std::string& fieldDelimiter, bool useStringDelimiter)
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file.is_open())
+    {
+    return false;
+    }
+
+  std::vector<std::unique_ptr<DelimitedTextColumnSource>> columns;
+  std::string header;
+  vtkIdType numberOfRows = 0;
+  for (vtkIdType columnIndex = 0; columnIndex < table->GetNumberOfColumns(); ++columnIndex)
+    {
+    vtkAbstractArray* column = table->GetColumn(columnIndex);
+    if (!column)
+      {
+      continue;
+      }
+    DelimitedTextColumnSource* source = nullptr;
+    vtkDataArray* dataArray = vtkDataArray::SafeDownCast(column);
+    if (dataArray && dataArray->GetDataType() != VTK_BIT && dataArray->HasStandardMemoryLayout())
+      {
+      switch (dataArray->GetDataType())
+        {
+        vtkTemplateMacro(source = new DelimitedTextNumericColumnSource<VTK_TT>(dataArray));
+        }
+      }
+    if (!source && dataArray)
+      {
+      source = new DelimitedTextDataArrayColumnSource(dataArray);
+      }
+    if (!source)
+      {
+      source = new DelimitedTextStringColumnSource(column, useStringDelimiter);
+      }
+    columns.emplace_back(source);
+    numberOfRows = std::max(numberOfRows, source->NumberOfTuples);
+
+    if (columns.size() > 1)
+      {
+      header += fieldDelimiter;
+      }
+    if (useStringDelimiter)
+      {
+      header += STRING_DELIMITER;
+      }
+    header += (column->GetName() ? column->GetName() : "");
+    if (useStringDelimiter)
+      {
+      header += STRING_DELIMITER;
+      }
+    }
+  header += '\n';
+  file.write(header.data(), header.size());
+
+  const vtkIdType numberOfChunks = (numberOfRows + DELIMITED_TEXT_ROWS_PER_CHUNK - 1) / DELIMITED_TEXT_ROWS_PER_CHUNK;
+  // Number of chunks that are formatted before writing them, limits the memory usage
+  const vtkIdType chunksPerBatch = std::max<vtkIdType>(1,
+    static_cast<vtkIdType>(DELIMITED_TEXT_BLOCK_SIZE) / (DELIMITED_TEXT_ROWS_PER_CHUNK * 16));
+  std::vector<std::string> chunks(static_cast<size_t>(std::min(numberOfChunks, chunksPerBatch)));
+  for (vtkIdType firstChunk = 0; firstChunk < numberOfChunks && file.good(); firstChunk += chunksPerBatch)
+    {
+    const vtkIdType numberOfBatchChunks = std::min(chunksPerBatch, numberOfChunks - firstChunk);
+    vtkSMPTools::For(0, numberOfBatchChunks, 1, [&](vtkIdType beginChunk, vtkIdType endChunk)
+      {
+      for (vtkIdType chunkIndex = beginChunk; chunkIndex < endChunk; ++chunkIndex)
+        {
+        std::string& text = chunks[chunkIndex];
+        text.clear();
+        const vtkIdType beginRow = (firstChunk + chunkIndex) * DELIMITED_TEXT_ROWS_PER_CHUNK;
+        const vtkIdType endRow = std::min(numberOfRows, beginRow + DELIMITED_TEXT_ROWS_PER_CHUNK);
+        for (vtkIdType row = beginRow; row < endRow; ++row)
+          {
+          bool firstField = true;
+          for (const std::unique_ptr<DelimitedTextColumnSource>& column : columns)
+            {
+            for (int component = 0; component < column->NumberOfComponents; ++component)
+              {
+              if (!firstField)
+                {
+                text += fieldDelimiter;
+                }
+              firstField = false;
+              if (row < column->NumberOfTuples)
+                {
+                column->AppendValue(text, row * column->NumberOfComponents + component);
+                }
+              }
+            }
+          text += '\n';
+          }
+        }
+      });
+    for (vtkIdType chunkIndex = 0; chunkIndex < numberOfBatchChunks; ++chunkIndex)
+      {
+      file.write(chunks[chunkIndex].data(), chunks[chunkIndex].size());
+      }
+    }
+
+  file.close();
+  return !file.fail();
+}
+
+} // end of anonymous namespace
 
 //------------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTableStorageNode);
@@ -462,254 +1167,193 @@ std::vector<vtkMRMLTableStorageNode::ColumnInfo> vtkMRMLTableStorageNode::GetCol
 }
 
 //----------------------------------------------------------------------------
-void vtkMRMLTableStorageNode::FillDataFromStringArray(vtkStringArray* stringComponentArray, vtkDataArray* typedComponentArray, std::string nullValueString)
+bool vtkMRMLTableStorageNode::ReadSchema(std::string filename, vtkMRMLTableNode* tableNode)
 {
-  if (!stringComponentArray || !typedComponentArray)
+  if (filename.empty())
     {
-    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::FillTypedComponentArray",
-      "Invalid input.");
-    return;
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadSchema",
+      "Read failed: filename not specified.");
+    return false;
     }
 
-  if (stringComponentArray->GetNumberOfValues() != typedComponentArray->GetNumberOfValues())
+  if (vtksys::SystemTools::FileExists(filename) == false)
     {
-    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::FillTypedComponentArray",
-      "Mismatched number of tuples in string ("<< stringComponentArray->GetNumberOfValues() << ")"
-      << " and typed (" << stringComponentArray->GetNumberOfValues() << ") arrays.");
-    return;
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadSchema",
+      "Read failed: schema file '" << filename << "' was not found.");
+    return false;
     }
 
-  int numberOfTuples = stringComponentArray->GetNumberOfTuples();
-
-  // Initialize with null value
-  if (typedComponentArray->IsNumeric())
+  // Read table, all values are kept as strings
+  DelimitedTextReader reader(this->GetFieldDelimiterCharacters(filename));
+  std::vector<std::string> fieldNames;
+  vtkNew<vtkTable> schemaTable;
+  bool success = reader.ReadHeader(filename, fieldNames);
+  if (success)
     {
-    // numeric arrays can be initialized in one batch
-    double nullValue = 0.0;
-    if (!nullValueString.empty())
+    for (int fieldIndex = 0; fieldIndex < static_cast<int>(fieldNames.size()); ++fieldIndex)
       {
-      nullValue = vtkVariant(nullValueString).ToDouble();
+      vtkNew<vtkStringArray> column;
+      column->SetName(fieldNames[fieldIndex].c_str());
+      reader.AddArray(column);
+      reader.SetFieldTarget(fieldIndex, new DelimitedTextStringFieldTarget(column));
+      schemaTable->AddColumn(column);
       }
-    typedComponentArray->FillComponent(0, nullValue);
+    success = reader.ReadRecords();
     }
-  else
+  if (!success)
     {
-    vtkVariant nullValue(nullValueString);
-    for (vtkIdType row = 0; row < numberOfTuples; ++row)
-      {
-      typedComponentArray->SetVariantValue(row, nullValue);
-      }
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadSchema",
+      "Read failed: schema file '" << filename << "' reading failed.");
+    return false;
     }
 
-  // Set values
-  vtkIdType scalarTypeId = typedComponentArray->GetDataType();
-  if (scalarTypeId == VTK_CHAR || scalarTypeId == VTK_SIGNED_CHAR || scalarTypeId == VTK_UNSIGNED_CHAR)
-    {
-    bool valid = false;
-    for (vtkIdType row = 0; row < numberOfTuples; ++row)
-      {
-      if (stringComponentArray->GetValue(row).empty())
-        {
-        // empty cell, leave the null value
-        continue;
-        }
-      int value = stringComponentArray->GetVariantValue(row).ToInt(&valid);
-      if (!valid)
-        {
-        continue;
-        }
-      typedComponentArray->SetVariantValue(row, vtkVariant(value));
-      }
-    }
-  else
+  vtkStringArray* columnNameArray = vtkStringArray::SafeDownCast(schemaTable->GetColumnByName("columnName"));
+  if (columnNameArray == nullptr)
     {
-    for (vtkIdType row = 0; row < numberOfTuples; ++row)
-      {
-      if (stringComponentArray->GetValue(row).empty())
-        {
-        // empty cell, leave the null value
-        continue;
-        }
-      typedComponentArray->SetVariantValue(row, stringComponentArray->GetVariantValue(row));
-      }
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadSchema",
+      "Failed to read table schema from file: " << filename <<". Required 'columnName' column is not found in schema.");
+    return false;
     }
+
+  tableNode->SetAndObserveSchema(schemaTable);
+
+  return true;
 }
 
 //----------------------------------------------------------------------------
-void vtkMRMLTableStorageNode::AddColumnToTable(vtkTable* table, vtkMRMLTableStorageNode::ColumnInfo columnInfo)
+bool vtkMRMLTableStorageNode::ReadTable(std::string filename, vtkMRMLTableNode* tableNode)
 {
-  std::string columnName = columnInfo.ColumnName;
-  int valueTypeId = columnInfo.ScalarType;
-  std::vector<vtkAbstractArray*> rawComponentArrays = columnInfo.RawComponentArrays;
-  std::string nullValueString = columnInfo.NullValueString;
+  DelimitedTextReader reader(this->GetFieldDelimiterCharacters(filename));
+  std::vector<std::string> fieldNames;
+  if (!reader.ReadHeader(filename, fieldNames))
+    {
+    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadTable",
+      "Failed to read table file: '" << filename << "'.");
+    return false;
+    }
 
-  if (valueTypeId == VTK_VOID)
+  // Only the header is needed for determining the columns: values are parsed directly into
+  // the output columns, so the raw table just contains an empty string column for each field.
+  vtkNew<vtkTable> rawTable;
+  std::map<vtkAbstractArray*, int> rawColumnFieldIndices;
+  for (int fieldIndex = 0; fieldIndex < static_cast<int>(fieldNames.size()); ++fieldIndex)
     {
-    // schema is not defined or no valid column type is defined for column
-    valueTypeId = VTK_STRING;
+    vtkNew<vtkStringArray> rawColumn;
+    rawColumn->SetName(fieldNames[fieldIndex].c_str());
+    rawTable->AddColumn(rawColumn);
+    rawColumnFieldIndices[rawColumn] = fieldIndex;
     }
-  if (valueTypeId == VTK_STRING)
+
+  /// Get the info for the columns defined in the schema (Column name, component arrays, component names, scalar type)
+  /// If the schema does not exist, then the raw table is used to generate the table info.
+  std::vector<vtkMRMLTableStorageNode::ColumnInfo> columnDetails = this->GetColumnInfo(tableNode, rawTable);
+
+  vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
+  // Components that are not found in the file are filled with the null value after reading
+  std::vector<std::pair<vtkDataArray*, std::pair<int, double>>> missingComponents;
+  // Bit arrays cannot be filled concurrently, their values are read into unsigned char arrays first
+  std::vector<std::pair<vtkSmartPointer<vtkUnsignedCharArray>, vtkBitArray*>> bitColumns;
+  for (const vtkMRMLTableStorageNode::ColumnInfo& columnInfo : columnDetails)
     {
-    if (rawComponentArrays.size() > 0)
+    int valueTypeId = columnInfo.ScalarType;
+    if (valueTypeId == VTK_VOID)
       {
-      vtkAbstractArray* columnArray = rawComponentArrays[0];
-      if (columnArray)
+      // schema is not defined or no valid column type is defined for column
+      valueTypeId = VTK_STRING;
+      }
+    if (valueTypeId == VTK_STRING)
+      {
+      if (columnInfo.RawComponentArrays.empty() || !columnInfo.RawComponentArrays[0])
         {
-        columnArray->SetName(columnName.c_str());
-        table->AddColumn(columnArray);
+        continue;
         }
+      vtkNew<vtkStringArray> column;
+      column->SetName(columnInfo.ColumnName.c_str());
+      reader.AddArray(column);
+      reader.SetFieldTarget(rawColumnFieldIndices[columnInfo.RawComponentArrays[0]],
+        new DelimitedTextStringFieldTarget(column));
+      table->AddColumn(column);
+      continue;
       }
-    }
-  else
-    {
+
     // Output column. Can be multi-component
     vtkSmartPointer<vtkDataArray> typedColumn = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(valueTypeId));
-    typedColumn->SetName(columnName.c_str());
-    typedColumn->SetNumberOfComponents(rawComponentArrays.size());
-    vtkIdType numberOfTuples = 0;
-    for (vtkAbstractArray* rawComponentArray : rawComponentArrays)
+    if (!typedColumn)
       {
-      if (rawComponentArray == nullptr)
-        {
-        continue;
-        }
-      numberOfTuples = std::max(numberOfTuples, rawComponentArray->GetNumberOfTuples());
+      vtkWarningToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadTable",
+        "Unsupported value type for column '" << columnInfo.ColumnName << "', the column is skipped.");
+      continue;
+      }
+    typedColumn->SetName(columnInfo.ColumnName.c_str());
+    typedColumn->SetNumberOfComponents(static_cast<int>(columnInfo.RawComponentArrays.size()));
+    for (int componentIndex = 0; componentIndex < static_cast<int>(columnInfo.ComponentNames.size())
+      && componentIndex < typedColumn->GetNumberOfComponents(); ++componentIndex)
+      {
+      typedColumn->SetComponentName(componentIndex, columnInfo.ComponentNames[componentIndex].c_str());
       }
-    typedColumn->SetNumberOfTuples(numberOfTuples);
 
-    vtkIdType componentIndex = 0;
-    for (vtkAbstractArray* componentArray : rawComponentArrays)
+    vtkDataArray* parsedColumn = typedColumn;
+    vtkBitArray* bitColumn = vtkBitArray::SafeDownCast(typedColumn);
+    if (bitColumn)
       {
-      vtkSmartPointer<vtkStringArray> rawComponentArray = vtkStringArray::SafeDownCast(componentArray);
-      if (rawComponentArray == nullptr)
+      vtkNew<vtkUnsignedCharArray> bitValues;
+      bitValues->SetNumberOfComponents(typedColumn->GetNumberOfComponents());
+      bitColumns.emplace_back(bitValues.GetPointer(), bitColumn);
+      parsedColumn = bitValues;
+      }
+    reader.AddArray(parsedColumn);
+
+    double nullValue = 0.0;
+    if (!columnInfo.NullValueString.empty())
+      {
+      nullValue = vtkVariant(columnInfo.NullValueString).ToDouble();
+      }
+    for (int componentIndex = 0; componentIndex < typedColumn->GetNumberOfComponents(); ++componentIndex)
+      {
+      vtkAbstractArray* rawComponentArray = columnInfo.RawComponentArrays[componentIndex];
+      if (!rawComponentArray)
         {
         vtkWarningToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadTable",
-          "Failed to read component for column '" << columnName << "'.");
-        // Add an empty default array for components that are not found
-        rawComponentArray = vtkSmartPointer<vtkStringArray>::New();
-        rawComponentArray->SetName(columnName.c_str());
-        rawComponentArray->SetNumberOfComponents(1);
-        rawComponentArray->SetNumberOfTuples(numberOfTuples);
+          "Failed to read component for column '" << columnInfo.ColumnName << "'.");
+        missingComponents.emplace_back(parsedColumn, std::make_pair(componentIndex, bitColumn ? (nullValue != 0.0 ? 1.0 : 0.0) : nullValue));
+        continue;
         }
-
-      // Single-component array for a potentially multi-component column
-      vtkSmartPointer<vtkDataArray> typedComponentArray = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(valueTypeId));
-      typedComponentArray->SetName(rawComponentArray->GetName());
-      typedComponentArray->SetNumberOfComponents(1);
-      typedComponentArray->SetNumberOfTuples(numberOfTuples);
-
-      /// Fill the component array with the correct values of the correct type
-      this->FillDataFromStringArray(rawComponentArray, typedComponentArray, nullValueString);
-
-      if (rawComponentArrays.size() > 1)
+      DelimitedTextFieldTarget* target = nullptr;
+      if (bitColumn)
         {
-        // Multi-component column. Copy the contents of the single component column into the output.
-        typedColumn->CopyComponent(componentIndex, typedComponentArray, 0);
+        target = new DelimitedTextBitFieldTarget(parsedColumn, componentIndex, nullValue);
         }
       else
         {
-        // Single-component column. Add the column directly to the output.
-        typedColumn = typedComponentArray;
-        }
-
-      if (componentIndex < static_cast<vtkIdType>(columnInfo.ComponentNames.size()))
-        {
-        std::string componentName = columnInfo.ComponentNames[componentIndex];
-        typedColumn->SetComponentName(componentIndex, componentName.c_str());
+        switch (valueTypeId)
+          {
+          vtkTemplateMacro(target = new DelimitedTextNumericFieldTarget<VTK_TT>(parsedColumn, componentIndex, nullValue));
+          }
         }
-      ++componentIndex;
+      reader.SetFieldTarget(rawColumnFieldIndices[rawComponentArray], target);
       }
     table->AddColumn(typedColumn);
-  }
-}
-
-//----------------------------------------------------------------------------
-bool vtkMRMLTableStorageNode::ReadSchema(std::string filename, vtkMRMLTableNode* tableNode)
-{
-  if (filename.empty())
-    {
-    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadSchema",
-      "Read failed: filename not specified.");
-    return false;
-    }
-
-  if (vtksys::SystemTools::FileExists(filename) == false)
-    {
-    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadSchema",
-      "Read failed: schema file '" << filename << "' was not found.");
-    return false;
     }
 
-  vtkNew<vtkNoEscapeDelimitedTextReader> reader;
-  reader->SetFileName(filename.c_str());
-  reader->SetHaveHeaders(true);
-  reader->SetFieldDelimiterCharacters(this->GetFieldDelimiterCharacters(filename).c_str());
-  // Make sure string delimiter characters are removed (somebody may have written a tsv with string delimiters)
-  reader->SetUseStringDelimiter(true);
-  // File contents is preserved better if we don't try to detect numeric columns
-  reader->DetectNumericColumnsOff();
-
-  // Read table
-  vtkTable* schemaTable = nullptr;
-  try
-    {
-    reader->Update();
-    schemaTable = reader->GetOutput();
-    }
-  catch (...)
-    {
-    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadSchema",
-      "Read failed: schema file '" << filename << "' reading failed.");
-    return false;
-    }
-
-  vtkStringArray* columnNameArray = vtkStringArray::SafeDownCast(schemaTable->GetColumnByName("columnName"));
-  if (columnNameArray == nullptr)
-    {
-    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadSchema",
-      "Failed to read table schema from file: " << filename <<". Required 'columnName' column is not found in schema.");
-    return false;
-    }
-
-  tableNode->SetAndObserveSchema(schemaTable);
-
-  return true;
-}
-
-//----------------------------------------------------------------------------
-bool vtkMRMLTableStorageNode::ReadTable(std::string filename, vtkMRMLTableNode* tableNode)
-{
-  vtkNew<vtkNoEscapeDelimitedTextReader> reader;
-  reader->SetFileName(filename.c_str());
-  reader->SetHaveHeaders(true);
-  reader->SetFieldDelimiterCharacters(this->GetFieldDelimiterCharacters(filename).c_str());
-  // Make sure string delimiter characters are removed (somebody may have written a tsv with string delimiters)
-  reader->SetUseStringDelimiter(true);
-  // File contents is preserved better if we don't try to detect numeric columns
-  reader->DetectNumericColumnsOff();
-
-  // Read table
-  vtkTable* rawTable = nullptr;
-  try
-    {
-    reader->Update();
-    rawTable = reader->GetOutput();
-    }
-  catch (...)
+  if (!reader.ReadRecords())
     {
     vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::ReadTable",
       "Failed to read table file: '" << filename << "'.");
     return false;
     }
 
-  /// Get the info for the columns defined in the schema (Column name, component arrays, component names, scalar type)
-  /// If the schema does not exist, then the raw table is used to generate the table info.
-  std::vector<vtkMRMLTableStorageNode::ColumnInfo> columnDetails = this->GetColumnInfo(tableNode, rawTable);
-
-  vtkSmartPointer<vtkTable> table = vtkSmartPointer<vtkTable>::New();
-  for (vtkMRMLTableStorageNode::ColumnInfo columnInfo : columnDetails)
+  for (const std::pair<vtkDataArray*, std::pair<int, double>>& missingComponent : missingComponents)
+    {
+    missingComponent.first->FillComponent(missingComponent.second.first, missingComponent.second.second);
+    }
+  for (const std::pair<vtkSmartPointer<vtkUnsignedCharArray>, vtkBitArray*>& bitColumn : bitColumns)
     {
-    this->AddColumnToTable(table, columnInfo);
+    vtkIdType numberOfValues = bitColumn.first->GetNumberOfValues();
+    bitColumn.second->SetNumberOfTuples(bitColumn.first->GetNumberOfTuples());
+    for (vtkIdType valueIndex = 0; valueIndex < numberOfValues; ++valueIndex)
+      {
+      bitColumn.second->SetValue(valueIndex, bitColumn.first->GetValue(valueIndex));
+      }
     }
 
   tableNode->SetAndObserveTable(table);
@@ -763,32 +1407,12 @@ bool vtkMRMLTableStorageNode::WriteTable(std::string filename, vtkMRMLTableNode*
       }
     }
 
-  vtkNew<vtkDelimitedTextWriter> writer;
-  writer->SetFileName(filename.c_str());
-  writer->SetInputData(newTable);
-
   std::string delimiter = this->GetFieldDelimiterCharacters(filename);
-  writer->SetFieldDelimiter(delimiter.c_str());
 
-  // SetUseStringDelimiter(true) causes writing each value in double-quotes, which is not very nice,
+  // Using string delimiters causes writing each value in double-quotes, which is not very nice,
   // but if the delimiter character is the comma then we have to use this mode, as commas occur in
   // string values quite often.
-  writer->SetUseStringDelimiter(delimiter==",");
-
-  vtkNew<vtkErrorSink> errorWarningObserver;
-  errorWarningObserver->SetObservedObject(writer);
-  try
-    {
-    writer->Write();
-    }
-  catch (...)
-    {
-    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::WriteTable",
-      "Failed to write file: '" << filename << "'.");
-    return false;
-    }
-  errorWarningObserver->DisplayMessages();
-  if (errorWarningObserver->HasErrors())
+  if (!WriteDelimitedText(filename, newTable, delimiter, delimiter == ","))
     {
     vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::WriteTable",
       "Failed to write file: '" << filename << "'.");
@@ -898,39 +1522,17 @@ bool vtkMRMLTableStorageNode::WriteSchema(std::string filename, vtkMRMLTableNode
       }
     }
 
-  vtkNew<vtkDelimitedTextWriter> writer;
-  vtkNew<vtkErrorSink> errorWarningObserver;
-  errorWarningObserver->SetObservedObject(writer);
-
-  writer->SetFileName(filename.c_str());
-  writer->SetInputData(schemaTable);
-
   std::string delimiter = this->GetFieldDelimiterCharacters(filename);
-  writer->SetFieldDelimiter(delimiter.c_str());
 
-  // SetUseStringDelimiter(true) causes writing each value in double-quotes, which is not very nice,
+  // Using string delimiters causes writing each value in double-quotes, which is not very nice,
   // but if the delimiter character is the comma then we have to use this mode, as commas occur in
   // string values quite often.
-  writer->SetUseStringDelimiter(delimiter == ",");
-
-  try
-    {
-    writer->Write();
-    }
-  catch (...)
+  if (!WriteDelimitedText(filename, schemaTable, delimiter, delimiter == ","))
     {
     vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::WriteSchema",
       "Failed to write table schema file: '" << filename << "'.");
     return false;
     }
 
-  errorWarningObserver->DisplayMessages();
-  if (errorWarningObserver->HasErrors())
-    {
-    vtkErrorToMessageCollectionMacro(this->GetUserMessages(), "vtkMRMLTableStorageNode::WriteTable",
-      "Failed to write table file: '" << filename << "'.");
-    return false;
-    }
-
   return true;
 }
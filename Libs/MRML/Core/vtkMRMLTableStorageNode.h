@@ -107,13 +107,6 @@ protected:
   /// and the names of the components.
   std::vector<ColumnInfo> GetColumnInfo(vtkMRMLTableNode* tableNode, vtkTable* rawTable);
 
-  /// Casts the data in the string array to the correct type and stores it in the data array
-  void FillDataFromStringArray(vtkStringArray* stringComponentArray, vtkDataArray* dataArray, std::string nullValueString="");
-
-  /// Adds the column specified by the given columnInfo to the table.
-  /// Handles both single and multi-component columns
-  void AddColumnToTable(vtkTable* table, ColumnInfo columnInfo);
-
   bool ReadSchema(std::string filename, vtkMRMLTableNode* tableNode);
   bool ReadTable(std::string filename, vtkMRMLTableNode* tableNode);
 
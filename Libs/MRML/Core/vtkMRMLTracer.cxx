@@ -0,0 +1,353 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLTracer.h"
+
+// VTK includes
+#include <vtkObjectFactory.h>
+#include <vtksys/FStream.hxx>
+
+// STD includes
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+/// Enabled state of the singleton, readable from any thread without locking.
+std::atomic<bool> TracingEnabled(false);
+
+/// Reference of the timestamps.
+const std::chrono::steady_clock::time_point TracingStartTime = std::chrono::steady_clock::now();
+
+//----------------------------------------------------------------------------
+void WriteJSONString(std::ostream& os, const std::string& text)
+{
+  os << '"';
+  for (unsigned char c : text)
+    {
+    switch (c)
+      {
+      case '"': os << "\\\""; break;
+      case '\\': os << "\\\\"; break;
+      case '\n': os << "\\n"; break;
+      case '\r': os << "\\r"; break;
+      case '\t': os << "\\t"; break;
+      default:
+        if (c < 0x20)
+          {
+          char escaped[8];
+          snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          os << escaped;
+          }
+        else
+          {
+          os << c;
+          }
+      }
+    }
+  os << '"';
+}
+}
+
+//----------------------------------------------------------------------------
+class vtkMRMLTracer::vtkInternal
+{
+public:
+  struct Zone
+  {
+    std::string Category;
+    std::string Name;
+    std::string Detail;
+    long long StartTimestamp;
+    long long Duration;
+    int ThreadId;
+  };
+
+  /// Return a small number identifying the calling thread, in the order
+  /// threads recorded their first zone.
+  static int CurrentThreadId()
+  {
+    static std::atomic<int> NumberOfThreads(0);
+    thread_local int threadId = ++NumberOfThreads;
+    return threadId;
+  }
+
+  std::mutex Mutex;
+  std::vector<Zone> Zones;
+  long long NumberOfDroppedZones = 0;
+};
+
+//----------------------------------------------------------------------------
+// The tracer singleton.
+// This MUST be default initialized to zero by the compiler and is
+// therefore not initialized here. The ClassInitialize and
+// ClassFinalize methods handle this instance.
+static vtkMRMLTracer* vtkMRMLTracerInstance;
+
+//----------------------------------------------------------------------------
+// Must NOT be initialized. Default initialization to zero is necessary.
+unsigned int vtkMRMLTracerInitialize::Count;
+
+//----------------------------------------------------------------------------
+// Implementation of vtkMRMLTracerInitialize class.
+//----------------------------------------------------------------------------
+vtkMRMLTracerInitialize::vtkMRMLTracerInitialize()
+{
+  if (++Self::Count == 1)
+    {
+    vtkMRMLTracer::classInitialize();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLTracerInitialize::~vtkMRMLTracerInitialize()
+{
+  if (--Self::Count == 0)
+    {
+    vtkMRMLTracer::classFinalize();
+    }
+}
+
+//----------------------------------------------------------------------------
+// Up the reference count so it behaves like New
+vtkMRMLTracer* vtkMRMLTracer::New()
+{
+  vtkMRMLTracer* ret = vtkMRMLTracer::GetInstance();
+  ret->Register(nullptr);
+  return ret;
+}
+
+//----------------------------------------------------------------------------
+// Return the single instance of the vtkMRMLTracer
+vtkMRMLTracer* vtkMRMLTracer::GetInstance()
+{
+  if (!vtkMRMLTracerInstance)
+    {
+    // Try the factory first
+    vtkMRMLTracerInstance = (vtkMRMLTracer*)vtkObjectFactory::CreateInstance("vtkMRMLTracer");
+    // if the factory did not provide one, then create it here
+    if (!vtkMRMLTracerInstance)
+      {
+      vtkMRMLTracerInstance = new vtkMRMLTracer;
+#ifdef VTK_HAS_INITIALIZE_OBJECT_BASE
+      vtkMRMLTracerInstance->InitializeObjectBase();
+#endif
+      }
+    }
+  // return the instance
+  return vtkMRMLTracerInstance;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::classInitialize()
+{
+  // Allocate the singleton
+  vtkMRMLTracerInstance = vtkMRMLTracer::GetInstance();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::classFinalize()
+{
+  TracingEnabled = false;
+  vtkMRMLTracerInstance->Delete();
+  vtkMRMLTracerInstance = nullptr;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLTracer::vtkMRMLTracer()
+{
+  this->MaximumNumberOfZones = 1000000;
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLTracer::~vtkMRMLTracer()
+{
+  delete this->Internal;
+  this->Internal = nullptr;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "Enabled: " << (this->GetEnabled() ? "true" : "false") << "\n";
+  os << indent << "MaximumNumberOfZones: " << this->MaximumNumberOfZones << "\n";
+  os << indent << "NumberOfZones: " << this->GetNumberOfZones() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::SetEnabled(bool enabled)
+{
+  if (TracingEnabled == enabled)
+    {
+    return;
+    }
+  TracingEnabled = enabled;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTracer::GetEnabled()
+{
+  return TracingEnabled;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTracer::IsEnabled()
+{
+  return TracingEnabled.load(std::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLTracer::GetNumberOfZones()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return static_cast<int>(this->Internal->Zones.size());
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::Clear()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  this->Internal->Zones.clear();
+  this->Internal->NumberOfDroppedZones = 0;
+}
+
+//----------------------------------------------------------------------------
+long long vtkMRMLTracer::GetTimestamp()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - TracingStartTime).count();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTracer::AddZone(const char* category, const char* name, const char* detail,
+                            long long startTimestamp, long long duration)
+{
+  if (!vtkMRMLTracer::IsEnabled())
+    {
+    return;
+    }
+  vtkInternal::Zone zone;
+  zone.Category = category ? category : "";
+  zone.Name = name ? name : "";
+  zone.Detail = detail ? detail : "";
+  zone.StartTimestamp = startTimestamp;
+  zone.Duration = duration;
+  zone.ThreadId = vtkInternal::CurrentThreadId();
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  if (static_cast<int>(this->Internal->Zones.size()) >= this->MaximumNumberOfZones)
+    {
+    ++this->Internal->NumberOfDroppedZones;
+    return;
+    }
+  this->Internal->Zones.push_back(std::move(zone));
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLTracer::WriteChromeTrace(const char* fileName)
+{
+  if (!fileName || fileName[0] == '\0')
+    {
+    vtkErrorMacro("WriteChromeTrace failed: invalid file name");
+    return false;
+    }
+  // File name is UTF-8 encoded, vtksys opens it with the wide API on Windows
+  vtksys::ofstream output(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!output.is_open())
+    {
+    vtkErrorMacro("WriteChromeTrace failed: unable to open file " << fileName << " for writing");
+    return false;
+    }
+
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  // "Complete" events (ph: X) are self-contained, zones of a thread that are
+  // nested in time are displayed as a stack.
+  output << "{\"traceEvents\":[\n";
+  bool first = true;
+  for (const vtkInternal::Zone& zone : this->Internal->Zones)
+    {
+    output << (first ? "" : ",\n") << "{\"name\":";
+    first = false;
+    WriteJSONString(output, zone.Name);
+    output << ",\"cat\":";
+    WriteJSONString(output, zone.Category);
+    output << ",\"ph\":\"X\",\"ts\":" << zone.StartTimestamp
+           << ",\"dur\":" << zone.Duration
+           << ",\"pid\":1,\"tid\":" << zone.ThreadId;
+    if (!zone.Detail.empty())
+      {
+      output << ",\"args\":{\"detail\":";
+      WriteJSONString(output, zone.Detail);
+      output << "}";
+      }
+    output << "}";
+    }
+  output << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedZones\":"
+         << this->Internal->NumberOfDroppedZones << "}}\n";
+  output.close();
+  if (output.fail())
+    {
+    vtkErrorMacro("WriteChromeTrace failed: error while writing file " << fileName);
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// vtkMRMLTraceZone methods
+
+//----------------------------------------------------------------------------
+vtkMRMLTraceZone::vtkMRMLTraceZone(const char* category, const char* name, const char* detail)
+  : StartTimestamp(-1)
+{
+  if (!vtkMRMLTracer::IsEnabled())
+    {
+    return;
+    }
+  // Names such as GetClassName() may not outlive the zone, copy them.
+  this->Category = category ? category : "";
+  this->Name = name ? name : "";
+  if (detail)
+    {
+    this->Detail = detail;
+    }
+  this->StartTimestamp = vtkMRMLTracer::GetTimestamp();
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLTraceZone::vtkMRMLTraceZone(const char* category, const char* name, const std::string& detail)
+  : vtkMRMLTraceZone(category, name, detail.c_str())
+{
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLTraceZone::~vtkMRMLTraceZone()
+{
+  if (this->StartTimestamp < 0 || !vtkMRMLTracer::IsEnabled())
+    {
+    return;
+    }
+  long long duration = vtkMRMLTracer::GetTimestamp() - this->StartTimestamp;
+  vtkMRMLTracer::GetInstance()->AddZone(this->Category.c_str(), this->Name.c_str(),
+    this->Detail.empty() ? nullptr : this->Detail.c_str(), this->StartTimestamp, duration);
+}
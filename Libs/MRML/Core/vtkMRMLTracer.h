@@ -0,0 +1,187 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkMRMLTracer_h
+#define __vtkMRMLTracer_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <string>
+
+/// \brief Records where the application spends its time.
+///
+/// The tracer records "zones": named intervals of time (module loading,
+/// scene import, storage node read/write, displayable manager update, CLI
+/// run...) with the thread they ran in. Zones are created with
+/// vtkMRMLTraceZoneMacro(), they are recorded only while tracing is
+/// enabled, otherwise they cost a single test.
+///
+/// Recorded zones can be written with WriteChromeTrace() in the Chrome trace
+/// event format, that can be opened in chrome://tracing or
+/// https://ui.perfetto.dev.
+///
+/// \code{.py}
+/// tracer = slicer.vtkMRMLTracer.GetInstance()
+/// tracer.EnabledOn()
+/// slicer.util.loadScene("/path/to/scene.mrml")
+/// tracer.WriteChromeTrace("/path/to/trace.json")
+/// \endcode
+///
+/// Tracing can be removed at compile time by turning off the
+/// MRML_USE_TRACING CMake option, vtkMRMLTraceZoneMacro() is then empty.
+class VTK_MRML_EXPORT vtkMRMLTracer : public vtkObject
+{
+public:
+  vtkTypeMacro(vtkMRMLTracer, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Return the singleton instance with no reference counting.
+  static vtkMRMLTracer* GetInstance();
+
+  /// This is a singleton pattern New. There will only be ONE
+  /// reference to a vtkMRMLTracer object per process. Clients that
+  /// call this must call Delete on the object so that the reference
+  /// counting will work. The single instance will be unreferenced when
+  /// the program exits.
+  static vtkMRMLTracer* New();
+
+  /// Enable or disable the recording of the zones. Disabled by default.
+  /// Recorded zones are kept when tracing is disabled.
+  void SetEnabled(bool enabled);
+  bool GetEnabled();
+  vtkBooleanMacro(Enabled, bool);
+
+  /// Return true if the zones are recorded. Faster than
+  /// GetInstance()->GetEnabled(), it can be called from any thread.
+  static bool IsEnabled();
+
+  /// Maximum number of recorded zones, the next zones are dropped.
+  /// It bounds the memory used by a trace left enabled. 1 million by default.
+  vtkSetMacro(MaximumNumberOfZones, int);
+  vtkGetMacro(MaximumNumberOfZones, int);
+
+  /// Number of recorded zones.
+  int GetNumberOfZones();
+
+  /// Remove all the recorded zones.
+  void Clear();
+
+  /// Write the recorded zones in the Chrome trace event format (JSON).
+  /// \a fileName is UTF-8 encoded.
+  /// Return false if the file can't be written.
+  bool WriteChromeTrace(const char* fileName);
+
+  /// Time in microseconds since the tracer has been created.
+  static long long GetTimestamp();
+
+  /// Record a zone of \a category that started at \a startTimestamp and
+  /// lasted \a duration (in microseconds) in the calling thread.
+  /// Does nothing if tracing is disabled.
+  /// \sa vtkMRMLTraceZone, GetTimestamp()
+  void AddZone(const char* category, const char* name, const char* detail,
+               long long startTimestamp, long long duration);
+
+protected:
+  vtkMRMLTracer();
+  ~vtkMRMLTracer() override;
+  vtkMRMLTracer(const vtkMRMLTracer&);
+  void operator=(const vtkMRMLTracer&);
+
+  /// Singleton management functions.
+  static void classInitialize();
+  static void classFinalize();
+
+  friend class vtkMRMLTracerInitialize;
+  typedef vtkMRMLTracer Self;
+
+  int MaximumNumberOfZones;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+/// Utility class to make sure vtkMRMLTracer is initialized before it is used.
+class VTK_MRML_EXPORT vtkMRMLTracerInitialize
+{
+public:
+  typedef vtkMRMLTracerInitialize Self;
+
+  vtkMRMLTracerInitialize();
+  ~vtkMRMLTracerInitialize();
+private:
+  static unsigned int Count;
+};
+
+/// This instance will show up in any translation unit that uses
+/// vtkMRMLTracer. It will make sure vtkMRMLTracer is initialized
+/// before it is used.
+static vtkMRMLTracerInitialize vtkMRMLTracerInitializer;
+
+#ifndef __VTK_WRAP__
+/// \brief Record the time spent in a scope.
+///
+/// The zone starts when the object is created and is recorded in
+/// vtkMRMLTracer when the object is destroyed. \a category, \a name and
+/// \a detail (e.g. a class or file name) are copied, \a detail can be null.
+/// By convention, \a category is the subsystem (e.g. "Storage"), \a name
+/// the action (e.g. "ReadData") and \a detail what the action is applied to.
+/// Use vtkMRMLTraceZoneMacro() instead of this class directly so that the
+/// zone is removed when MRML_USE_TRACING is off.
+/// A detail that must be computed (e.g. converted from a QString) should be
+/// computed only if vtkMRMLTracer::IsEnabled(), as the zone ignores it otherwise.
+class VTK_MRML_EXPORT vtkMRMLTraceZone
+{
+public:
+  vtkMRMLTraceZone(const char* category, const char* name, const char* detail = nullptr);
+  vtkMRMLTraceZone(const char* category, const char* name, const std::string& detail);
+  ~vtkMRMLTraceZone();
+
+private:
+  vtkMRMLTraceZone(const vtkMRMLTraceZone&) = delete;
+  void operator=(const vtkMRMLTraceZone&) = delete;
+
+  std::string Category;
+  std::string Name;
+  std::string Detail;
+  /// -1 if tracing was disabled when the zone started.
+  long long StartTimestamp;
+};
+
+#define vtkMRMLTraceZoneConcatMacro2(a, b) a##b
+#define vtkMRMLTraceZoneConcatMacro(a, b) vtkMRMLTraceZoneConcatMacro2(a, b)
+
+/// Record the time spent until the end of the current scope.
+/// Examples:
+/// \code
+/// vtkMRMLTraceZoneMacro("Scene", "Import");
+/// vtkMRMLTraceZoneMacro("Storage", "ReadData", this->GetFileName());
+/// \endcode
+/// \sa vtkMRMLTraceZone
+#ifdef MRML_USE_TRACING
+# define vtkMRMLTraceZoneMacro(category, ...) \
+  vtkMRMLTraceZone vtkMRMLTraceZoneConcatMacro(vtkMRMLTraceZone, __LINE__)(category, __VA_ARGS__)
+#else
+# define vtkMRMLTraceZoneMacro(category, ...)
+#endif
+#endif // __VTK_WRAP__
+
+#endif
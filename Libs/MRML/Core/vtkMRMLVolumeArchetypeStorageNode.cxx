@@ -13,6 +13,7 @@ Version:   $Revision: 1.6 $
 =========================================================================auto=*/
 
 // MRML includes
+#include "vtkCacheManager.h"
 #include "vtkDataFileFormatHelper.h"
 #include "vtkDataIOManager.h"
 #include "vtkMRMLMessageCollection.h"
@@ -48,7 +49,12 @@ Version:   $Revision: 1.6 $
 
 // STD includes
 #include <algorithm>
+#include <ctime>
+#include <functional>
 #include <iterator>
+#include <sstream>
+#include <utility>
+#include <vector>
 
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLVolumeArchetypeStorageNode);
@@ -201,6 +207,7 @@ vtkMRMLVolumeArchetypeStorageNode::InstantiateVectorVolumeReader(const std::stri
   reader->SetArchetype(fullName.c_str());
   reader->SetSingleFile( this->GetSingleFile() );
   reader->SetUseOrientationFromFile( this->GetUseOrientationFromFile() );
+  this->ConfigureReader(reader, fullName);
   try
     {
     reader->UpdateInformation();
@@ -218,6 +225,7 @@ vtkMRMLVolumeArchetypeStorageNode::InstantiateVectorVolumeReader(const std::stri
     reader->SetArchetype(fullName.c_str());
     reader->SetSingleFile( this->GetSingleFile() );
     reader->SetUseOrientationFromFile( this->GetUseOrientationFromFile() );
+    this->ConfigureReader(reader, fullName);
     try
       {
       reader->UpdateInformation();
@@ -242,6 +250,85 @@ vtkMRMLVolumeArchetypeStorageNode::InstantiateVectorVolumeReader(const std::stri
 #endif
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+
+/// DICOM header caches that are not used for this long are removed (in seconds)
+const long int DicomHeaderCacheMaximumAge = 30 * 24 * 60 * 60;
+/// Temporary files of DICOM header caches are removed after this delay (in seconds)
+const long int DicomHeaderCacheTemporaryFileMaximumAge = 60 * 60;
+/// Only the most recently used DICOM header caches are kept
+const size_t DicomHeaderCacheMaximumCount = 200;
+
+//----------------------------------------------------------------------------
+void PruneDicomHeaderCaches(const std::string& cacheDirectory)
+{
+  vtksys::Directory directory;
+  if (!directory.Load(cacheDirectory))
+    {
+    return;
+    }
+  // Collect cache files and temporary files left behind by interrupted writes
+  std::vector<std::pair<long int, std::string> > cacheFiles;
+  for (unsigned long i = 0; i < directory.GetNumberOfFiles(); ++i)
+    {
+    std::string fileName = directory.GetFile(i);
+    if (fileName.compare(0, 17, "DICOMHeaderCache_") != 0)
+      {
+      continue;
+      }
+    std::string filePath = cacheDirectory + "/" + fileName;
+    cacheFiles.emplace_back(vtksys::SystemTools::ModifiedTime(filePath), filePath);
+    }
+  // Most recently used first
+  std::sort(cacheFiles.begin(), cacheFiles.end(), std::greater<std::pair<long int, std::string> >());
+  const long int now = static_cast<long int>(time(nullptr));
+  for (size_t i = 0; i < cacheFiles.size(); ++i)
+    {
+    // Temporary files are renamed right after they are written, an old one is
+    // left over from an interrupted write.
+    const bool isTemporaryFile = vtksys::SystemTools::StringEndsWith(cacheFiles[i].second, ".tmp");
+    const long int maximumAge = isTemporaryFile ? DicomHeaderCacheTemporaryFileMaximumAge : DicomHeaderCacheMaximumAge;
+    if (i >= DicomHeaderCacheMaximumCount || cacheFiles[i].first < now - maximumAge)
+      {
+      vtksys::SystemTools::RemoveFile(cacheFiles[i].second);
+      }
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeArchetypeStorageNode::ConfigureReader(vtkITKArchetypeImageSeriesReader* reader,
+                                                        const std::string& fullName)
+{
+  if (!reader)
+    {
+    return;
+    }
+  // DICOM headers are analyzed to group the files of a series. Their cache
+  // makes loading again a series much faster. There is one cache file per
+  // directory so that each cache remains small.
+  vtkCacheManager* cacheManager = this->GetScene() ? this->GetScene()->GetCacheManager() : nullptr;
+  const char* cacheDirectory = cacheManager ? cacheManager->GetRemoteCacheDirectory() : nullptr;
+  if (this->GetSingleFile() || !cacheDirectory || !vtksys::SystemTools::FileIsDirectory(cacheDirectory))
+    {
+    return;
+    }
+  std::string seriesDirectory = vtksys::SystemTools::GetFilenamePath(vtksys::SystemTools::CollapseFullPath(fullName));
+  std::ostringstream cacheFileName;
+  cacheFileName << cacheDirectory << "/DICOMHeaderCache_" << std::hex << std::hash<std::string>()(seriesDirectory) << ".txt";
+  // Mark the cache of this series as recently used and remove the stale ones
+  // so that the cache directory does not grow without bound.
+  if (vtksys::SystemTools::FileExists(cacheFileName.str(), true))
+    {
+    vtksys::SystemTools::Touch(cacheFileName.str(), false);
+    }
+  PruneDicomHeaderCaches(cacheDirectory);
+  reader->SetHeaderCacheFileName(cacheFileName.str());
+}
+
 
 //----------------------------------------------------------------------------
 namespace
@@ -354,6 +441,7 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     }
 
   reader->AddObserver( vtkCommand::ProgressEvent,  this->MRMLCallbackCommand);
+  this->ConfigureReader(reader, fullName);
 
   if (volNode->GetImageData())
     {
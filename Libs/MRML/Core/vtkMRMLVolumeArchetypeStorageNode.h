@@ -103,6 +103,11 @@ protected:
 
   vtkITKArchetypeImageSeriesReader* InstantiateVectorVolumeReader(const std::string &fullName);
 
+  /// Set up the reader options that depend on the scene, such as the cache
+  /// of the DICOM headers of series in the remote cache directory.
+  /// Caches that have not been used for a long time are removed.
+  void ConfigureReader(vtkITKArchetypeImageSeriesReader* reader, const std::string& fullName);
+
   void ConvertSpatialVectorVoxelsBetweenRasLps(vtkImageData* imageData);
 
   /// Read data and set it in the referenced node
@@ -0,0 +1,292 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLVolumeSharedMemory.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkObjectFactory.h>
+
+// STD includes
+#include <atomic>
+#include <cstring>
+#include <sstream>
+
+#ifndef _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace
+{
+const char VolumeSharedMemoryMagic[8] = "SLSHMVL";
+const std::uint32_t VolumeSharedMemoryVersion = 1;
+
+// Keep the voxel buffer aligned for any scalar type
+const std::uint64_t VolumeSharedMemoryDataOffset =
+  ((sizeof(vtkMRMLVolumeSharedMemory::VolumeHeader) + 63) / 64) * 64;
+}
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkMRMLVolumeSharedMemory);
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeSharedMemory::vtkMRMLVolumeSharedMemory()
+{
+  this->MappedAddress = nullptr;
+  this->MappedSize = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeSharedMemory::~vtkMRMLVolumeSharedMemory()
+{
+  this->Close();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSharedMemory::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MappedSize: " << this->MappedSize << "\n";
+}
+
+//----------------------------------------------------------------------------
+const char* vtkMRMLVolumeSharedMemory::GetURIPrefix()
+{
+  return "slicershm:";
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemory::IsSharedMemoryURI(const std::string& uri)
+{
+  return uri.compare(0, strlen(vtkMRMLVolumeSharedMemory::GetURIPrefix()),
+    vtkMRMLVolumeSharedMemory::GetURIPrefix()) == 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemory::IsSupported()
+{
+#ifdef _WIN32
+  return false;
+#else
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLVolumeSharedMemory::GenerateUniqueURI()
+{
+  static std::atomic<unsigned int> segmentCounter(0);
+  std::ostringstream uri;
+  // Keep the name short: some systems limit shared memory object names to 31 characters
+  uri << vtkMRMLVolumeSharedMemory::GetURIPrefix() << "/slicer_";
+#ifndef _WIN32
+  uri << std::hex << getpid() << "_";
+#endif
+  uri << std::hex << segmentCounter++;
+  return uri.str();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLVolumeSharedMemory::GetSegmentName(const std::string& uri)
+{
+  if (!vtkMRMLVolumeSharedMemory::IsSharedMemoryURI(uri))
+    {
+    return std::string();
+    }
+  std::string name = uri.substr(strlen(vtkMRMLVolumeSharedMemory::GetURIPrefix()));
+  if (name.empty() || name.find('/', 1) != std::string::npos)
+    {
+    return std::string();
+    }
+  if (name[0] != '/')
+    {
+    name = "/" + name;
+    }
+  return name;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemory::WriteVolume(const std::string& uri, vtkImageData* image, vtkMatrix4x4* ijkToRAS)
+{
+#ifdef _WIN32
+  (void)uri;
+  (void)image;
+  (void)ijkToRAS;
+  vtkGenericWarningMacro("vtkMRMLVolumeSharedMemory::WriteVolume: shared memory is not supported on this platform");
+  return false;
+#else
+  std::string name = vtkMRMLVolumeSharedMemory::GetSegmentName(uri);
+  if (name.empty() || !image || !image->GetScalarPointer())
+    {
+    vtkGenericWarningMacro("vtkMRMLVolumeSharedMemory::WriteVolume: invalid input for " << uri);
+    return false;
+    }
+
+  VolumeHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.Magic, VolumeSharedMemoryMagic, sizeof(header.Magic));
+  header.Version = VolumeSharedMemoryVersion;
+  header.ScalarType = image->GetScalarType();
+  header.NumberOfComponents = image->GetNumberOfScalarComponents();
+  image->GetDimensions(header.Dimensions);
+  for (int i = 0; i < 16; ++i)
+    {
+    header.IJKToRASMatrix[i] = ijkToRAS ? ijkToRAS->GetElement(i / 4, i % 4) : (i % 5 == 0 ? 1.0 : 0.0);
+    }
+  header.DataOffset = VolumeSharedMemoryDataOffset;
+  header.DataSize = static_cast<std::uint64_t>(image->GetScalarSize())
+    * header.NumberOfComponents
+    * header.Dimensions[0] * header.Dimensions[1] * header.Dimensions[2];
+  const size_t segmentSize = static_cast<size_t>(header.DataOffset + header.DataSize);
+
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  if (fd < 0)
+    {
+    vtkGenericWarningMacro("vtkMRMLVolumeSharedMemory::WriteVolume: failed to create shared memory " << name);
+    return false;
+    }
+  if (ftruncate(fd, static_cast<off_t>(segmentSize)) != 0)
+    {
+    vtkGenericWarningMacro("vtkMRMLVolumeSharedMemory::WriteVolume: failed to allocate "
+      << segmentSize << " bytes of shared memory for " << name);
+    close(fd);
+    shm_unlink(name.c_str());
+    return false;
+    }
+  void* address = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED)
+    {
+    vtkGenericWarningMacro("vtkMRMLVolumeSharedMemory::WriteVolume: failed to map shared memory " << name);
+    shm_unlink(name.c_str());
+    return false;
+    }
+  // The image buffer is private to this process, the voxels must be copied into the segment
+  memcpy(static_cast<char*>(address) + header.DataOffset, image->GetScalarPointer(), header.DataSize);
+  // the header is written last, readers only see a valid magic once the data is complete
+  memcpy(address, &header, sizeof(header));
+  munmap(address, segmentSize);
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemory::Remove(const std::string& uri)
+{
+#ifdef _WIN32
+  (void)uri;
+  return false;
+#else
+  std::string name = vtkMRMLVolumeSharedMemory::GetSegmentName(uri);
+  return !name.empty() && shm_unlink(name.c_str()) == 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemory::Open(const std::string& uri)
+{
+  this->Close();
+#ifdef _WIN32
+  (void)uri;
+  return false;
+#else
+  std::string name = vtkMRMLVolumeSharedMemory::GetSegmentName(uri);
+  if (name.empty())
+    {
+    return false;
+    }
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0)
+    {
+    return false;
+    }
+  struct stat segmentStat;
+  if (fstat(fd, &segmentStat) != 0 || static_cast<size_t>(segmentStat.st_size) < sizeof(VolumeHeader))
+    {
+    close(fd);
+    return false;
+    }
+  const size_t segmentSize = static_cast<size_t>(segmentStat.st_size);
+  void* address = mmap(nullptr, segmentSize, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED)
+    {
+    return false;
+    }
+  const VolumeHeader* header = static_cast<const VolumeHeader*>(address);
+  if (memcmp(header->Magic, VolumeSharedMemoryMagic, sizeof(header->Magic)) != 0
+    || header->Version != VolumeSharedMemoryVersion
+    || header->DataOffset + header->DataSize > segmentSize)
+    {
+    vtkWarningMacro("Open: " << uri << " is not a valid shared memory volume");
+    munmap(address, segmentSize);
+    return false;
+    }
+  this->MappedAddress = address;
+  this->MappedSize = segmentSize;
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSharedMemory::Close()
+{
+#ifndef _WIN32
+  if (this->MappedAddress)
+    {
+    munmap(this->MappedAddress, this->MappedSize);
+    }
+#endif
+  this->MappedAddress = nullptr;
+  this->MappedSize = 0;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemory::IsOpen() const
+{
+  return this->MappedAddress != nullptr;
+}
+
+//----------------------------------------------------------------------------
+const vtkMRMLVolumeSharedMemory::VolumeHeader* vtkMRMLVolumeSharedMemory::GetHeader() const
+{
+  return static_cast<const VolumeHeader*>(this->MappedAddress);
+}
+
+//----------------------------------------------------------------------------
+const void* vtkMRMLVolumeSharedMemory::GetScalarPointer() const
+{
+  const VolumeHeader* header = this->GetHeader();
+  if (!header)
+    {
+    return nullptr;
+    }
+  return static_cast<const char*>(this->MappedAddress) + header->DataOffset;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSharedMemory::GetIJKToRASMatrix(vtkMatrix4x4* ijkToRAS) const
+{
+  const VolumeHeader* header = this->GetHeader();
+  if (!header || !ijkToRAS)
+    {
+    return false;
+    }
+  for (int i = 0; i < 16; ++i)
+    {
+    ijkToRAS->SetElement(i / 4, i % 4, header->IJKToRASMatrix[i]);
+    }
+  return true;
+}
@@ -0,0 +1,121 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLVolumeSharedMemory_h
+#define __vtkMRMLVolumeSharedMemory_h
+
+// MRML includes
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <cstdint>
+#include <string>
+
+class vtkImageData;
+class vtkMatrix4x4;
+
+/// \brief Exchange volumes with other processes through named shared memory.
+///
+/// A volume is stored in a named shared memory segment that contains a small
+/// header (scalar type, number of components, dimensions, IJK to RAS matrix)
+/// followed by the voxel buffer. Segments are referred to by a URI that starts
+/// with GetURIPrefix() (GenerateUniqueURI() returns "slicershm:/slicer_<pid>_<n>",
+/// with the process id and a counter in hexadecimal), which can be passed on the
+/// command line of an executable instead of a file name.
+///
+/// The voxels are copied twice: once into the segment by WriteVolume(), because
+/// the image buffer is private memory of the writing process, and once out of the
+/// segment by the reader (e.g., itk::MRMLSharedMemoryImageIO), because readers
+/// fill a buffer that they allocate. Both copies are memory to memory, compared
+/// to writing and parsing a temporary file.
+///
+/// The process that creates a segment with WriteVolume() owns it and must call
+/// Remove() when the segment is not needed anymore. Other processes map the
+/// segment read-only using Open().
+///
+/// Shared memory exchange is only available on POSIX systems, IsSupported()
+/// returns false on other platforms (files should be used instead).
+class VTK_MRML_EXPORT vtkMRMLVolumeSharedMemory : public vtkObject
+{
+public:
+  static vtkMRMLVolumeSharedMemory *New();
+  vtkTypeMacro(vtkMRMLVolumeSharedMemory, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Layout of the header stored at the beginning of the segment.
+  struct VolumeHeader
+    {
+    char Magic[8];
+    std::uint32_t Version;
+    std::int32_t ScalarType;
+    std::int32_t NumberOfComponents;
+    std::int32_t Dimensions[3];
+    double IJKToRASMatrix[16];
+    std::uint64_t DataOffset;
+    std::uint64_t DataSize;
+    };
+
+  /// Prefix of the URIs that refer to shared memory volumes.
+  static const char* GetURIPrefix();
+
+  /// Returns true if \a uri refers to a shared memory volume.
+  static bool IsSharedMemoryURI(const std::string& uri);
+
+  /// Returns true if shared memory exchange is available on this platform.
+  static bool IsSupported();
+
+  /// Returns a URI that is unique in the system as long as the calling
+  /// process is running.
+  static std::string GenerateUniqueURI();
+
+  /// Create the segment referred by \a uri and copy the voxels and geometry of
+  /// \a image and \a ijkToRAS into it. An existing segment with the same name is replaced.
+  /// The segment remains available until Remove() is called.
+  static bool WriteVolume(const std::string& uri, vtkImageData* image, vtkMatrix4x4* ijkToRAS);
+
+  /// Remove the segment referred by \a uri. Processes that have mapped the
+  /// segment can keep using it until they close it.
+  static bool Remove(const std::string& uri);
+
+  /// Map the segment referred by \a uri read-only.
+  /// Returns false if the segment does not exist or is not a valid volume.
+  bool Open(const std::string& uri);
+
+  /// Unmap the segment. Called automatically on destruction.
+  void Close();
+
+  /// Returns true if a segment is currently mapped.
+  bool IsOpen() const;
+
+  /// Header of the mapped segment, nullptr if no segment is mapped.
+  const VolumeHeader* GetHeader() const;
+
+  /// Voxel buffer of the mapped segment, nullptr if no segment is mapped.
+  const void* GetScalarPointer() const;
+
+  /// Copy the IJK to RAS matrix of the mapped segment into \a ijkToRAS.
+  bool GetIJKToRASMatrix(vtkMatrix4x4* ijkToRAS) const;
+
+protected:
+  vtkMRMLVolumeSharedMemory();
+  ~vtkMRMLVolumeSharedMemory() override;
+  vtkMRMLVolumeSharedMemory(const vtkMRMLVolumeSharedMemory&);
+  void operator=(const vtkMRMLVolumeSharedMemory&);
+
+  /// Name of the shared memory object referred by \a uri.
+  static std::string GetSegmentName(const std::string& uri);
+
+  void* MappedAddress;
+  size_t MappedSize;
+};
+
+#endif
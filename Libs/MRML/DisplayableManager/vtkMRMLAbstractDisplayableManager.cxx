@@ -31,6 +31,7 @@
 #include <vtkMRMLInteractionNode.h>
 #include <vtkMRMLScene.h>
 #include <vtkMRMLSelectionNode.h>
+#include <vtkMRMLTracer.h>
 
 // VTK includes
 #include <vtkCallbackCommand.h>
@@ -556,6 +557,7 @@ void vtkMRMLAbstractDisplayableManager::CreateIfPossible()
       vtkWarningMacro( << "CreateIfPossible - MRMLScene does NOT contain any InteractionNode");
       }
 
+    vtkMRMLTraceZoneMacro("DisplayableManager", "Create", this->GetClassName());
     this->Create();
     this->Internal->Created = true;
     }
@@ -831,6 +833,7 @@ void vtkMRMLAbstractDisplayableManager::RequestRender()
 
   if (this->Internal->UpdateFromMRMLRequested)
     {
+    vtkMRMLTraceZoneMacro("DisplayableManager", "UpdateFromMRML", this->GetClassName());
     this->UpdateFromMRML();
     }
 
@@ -16,6 +16,7 @@
  *
  *=========================================================================*/
 #include "itkMRMLIDImageIOFactory.h"
+#include "itkMRMLSharedMemoryImageIO.h"
 #include "itkVersion.h"
 
 
@@ -28,6 +29,11 @@ MRMLIDImageIOFactory::MRMLIDImageIOFactory()
                          "ImageIO to communicate directly with a MRML scene.",
                          true,
                          CreateObjectFunction<MRMLIDImageIO>::New());
+  this->RegisterOverride("itkImageIOBase",
+                         "itkMRMLSharedMemoryImageIO",
+                         "ImageIO to read volumes that Slicer placed in shared memory.",
+                         true,
+                         CreateObjectFunction<MRMLSharedMemoryImageIO>::New());
 }
 
 MRMLIDImageIOFactory::~MRMLIDImageIOFactory() = default;
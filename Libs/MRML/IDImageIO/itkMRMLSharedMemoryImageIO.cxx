@@ -0,0 +1,195 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#include "itkMRMLSharedMemoryImageIO.h"
+
+// MRML includes
+#include "vtkMRMLVolumeSharedMemory.h"
+
+// VTK includes
+#include <vtkType.h>
+
+// STD includes
+#include <cmath>
+#include <cstring>
+
+namespace itk {
+//----------------------------------------------------------------------------
+MRMLSharedMemoryImageIO
+::MRMLSharedMemoryImageIO()
+{
+  this->m_SharedMemory = vtkMRMLVolumeSharedMemory::New();
+}
+
+//----------------------------------------------------------------------------
+MRMLSharedMemoryImageIO
+::~MRMLSharedMemoryImageIO()
+{
+  this->m_SharedMemory->Delete();
+}
+
+//----------------------------------------------------------------------------
+void
+MRMLSharedMemoryImageIO
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "OpenedFileName: " << this->m_OpenedFileName << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool
+MRMLSharedMemoryImageIO
+::OpenSegment()
+{
+  if (this->m_SharedMemory->IsOpen() && this->m_OpenedFileName == this->m_FileName)
+    {
+    return true;
+    }
+  this->m_OpenedFileName.clear();
+  if (!this->m_SharedMemory->Open(this->m_FileName))
+    {
+    return false;
+    }
+  this->m_OpenedFileName = this->m_FileName;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool
+MRMLSharedMemoryImageIO
+::CanReadFile(const char* filename)
+{
+  if (!filename || !vtkMRMLVolumeSharedMemory::IsSharedMemoryURI(filename))
+    {
+    return false;
+    }
+  vtkMRMLVolumeSharedMemory* sharedMemory = vtkMRMLVolumeSharedMemory::New();
+  bool canRead = sharedMemory->Open(filename);
+  sharedMemory->Delete();
+  return canRead;
+}
+
+//----------------------------------------------------------------------------
+void
+MRMLSharedMemoryImageIO
+::ReadImageInformation()
+{
+  if (!this->OpenSegment())
+    {
+    itkExceptionMacro("Cannot map shared memory volume " << this->m_FileName);
+    }
+  const vtkMRMLVolumeSharedMemory::VolumeHeader* header = this->m_SharedMemory->GetHeader();
+
+  // VTK is only 3D
+  this->SetNumberOfDimensions(3);
+  for (unsigned int i = 0; i < 3; i++)
+    {
+    this->SetDimensions(i, header->Dimensions[i]);
+    }
+
+  // The segment stores the IJK to RAS matrix, ITK needs LPS.
+  const double* ijkToRas = header->IJKToRASMatrix;
+  for (unsigned int i = 0; i < 3; i++)
+    {
+    // column i is the RAS direction of the i axis scaled by the spacing
+    double spacing = 0.0;
+    for (unsigned int j = 0; j < 3; j++)
+      {
+      spacing += ijkToRas[j * 4 + i] * ijkToRas[j * 4 + i];
+      }
+    spacing = std::sqrt(spacing);
+    if (spacing == 0.0)
+      {
+      spacing = 1.0;
+      }
+    this->SetSpacing(i, spacing);
+
+    std::vector<double> direction(3);
+    direction[0] = -ijkToRas[0 * 4 + i] / spacing;
+    direction[1] = -ijkToRas[1 * 4 + i] / spacing;
+    direction[2] = ijkToRas[2 * 4 + i] / spacing;
+    this->SetDirection(i, direction);
+    }
+  this->SetOrigin(0, -ijkToRas[0 * 4 + 3]);
+  this->SetOrigin(1, -ijkToRas[1 * 4 + 3]);
+  this->SetOrigin(2, ijkToRas[2 * 4 + 3]);
+
+  this->SetNumberOfComponents(header->NumberOfComponents);
+  this->SetPixelType(header->NumberOfComponents == 1 ? SCALAR : VECTOR);
+
+  IOComponentType componentType = UCHAR;
+  switch (header->ScalarType)
+    {
+    case VTK_FLOAT: componentType = FLOAT; break;
+    case VTK_DOUBLE: componentType = DOUBLE; break;
+    case VTK_INT: componentType = INT; break;
+    case VTK_UNSIGNED_INT: componentType = UINT; break;
+    case VTK_SHORT: componentType = SHORT; break;
+    case VTK_UNSIGNED_SHORT: componentType = USHORT; break;
+    case VTK_LONG: componentType = LONG; break;
+    case VTK_UNSIGNED_LONG: componentType = ULONG; break;
+    case VTK_LONG_LONG: componentType = LONGLONG; break;
+    case VTK_UNSIGNED_LONG_LONG: componentType = ULONGLONG; break;
+    case VTK_CHAR: componentType = CHAR; break;
+    case VTK_SIGNED_CHAR: componentType = CHAR; break;
+    case VTK_UNSIGNED_CHAR: componentType = UCHAR; break;
+    default:
+      itkExceptionMacro("Unknown scalar type in shared memory volume " << this->m_FileName);
+    }
+  this->SetComponentType(componentType);
+
+  if (static_cast<SizeType>(header->DataSize) != this->GetImageSizeInBytes())
+    {
+    itkExceptionMacro("Inconsistent size of shared memory volume " << this->m_FileName);
+    }
+}
+
+//----------------------------------------------------------------------------
+void
+MRMLSharedMemoryImageIO
+::Read(void *buffer)
+{
+  if (!this->OpenSegment())
+    {
+    itkExceptionMacro("Cannot map shared memory volume " << this->m_FileName);
+    }
+  const vtkMRMLVolumeSharedMemory::VolumeHeader* header = this->m_SharedMemory->GetHeader();
+  // The image file reader allocates the buffer of its output image and asks the
+  // ImageIO to fill it, therefore the mapped voxels cannot be used in place.
+  memcpy(buffer, this->m_SharedMemory->GetScalarPointer(), static_cast<size_t>(header->DataSize));
+  // the data is not needed anymore, release the mapping
+  this->m_SharedMemory->Close();
+  this->m_OpenedFileName.clear();
+}
+
+//----------------------------------------------------------------------------
+bool
+MRMLSharedMemoryImageIO
+::CanWriteFile(const char*)
+{
+  return false;
+}
+
+//----------------------------------------------------------------------------
+void
+MRMLSharedMemoryImageIO
+::WriteImageInformation()
+{
+}
+
+//----------------------------------------------------------------------------
+void
+MRMLSharedMemoryImageIO
+::Write(const void*)
+{
+  itkExceptionMacro("Writing to shared memory is not supported: " << this->m_FileName);
+}
+
+} // end namespace itk
@@ -0,0 +1,85 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef itkMRMLSharedMemoryImageIO_h
+#define itkMRMLSharedMemoryImageIO_h
+
+#include "itkMRMLIDIOExport.h"
+
+#include "itkImageIOBase.h"
+
+class vtkMRMLVolumeSharedMemory;
+
+namespace itk
+{
+/** \class MRMLSharedMemoryImageIO
+ * \brief ImageIO object for reading images that Slicer placed in shared memory
+ *
+ * When a command line module is executed out of process, Slicer may
+ * place its input volumes in named shared memory segments instead of
+ * writing them to temporary files (see vtkMRMLVolumeSharedMemory). The
+ * module is then given a "filename" that looks like:
+ *     <code>slicershm:/\<segment name\></code>
+ *
+ * MRMLSharedMemoryImageIO maps the segment read-only, which allows a
+ * standard ITK ImageFileReader to read the volume without parsing or
+ * decompressing a file. Outputs are always written to files.
+ */
+class MRMLIDImageIO_EXPORT MRMLSharedMemoryImageIO : public ImageIOBase
+{
+public:
+  /** Standard class typedefs. */
+  typedef MRMLSharedMemoryImageIO Self;
+  typedef ImageIOBase             Superclass;
+  typedef SmartPointer<Self>      Pointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MRMLSharedMemoryImageIO, ImageIOBase);
+
+  /** Determine the file type. Returns true if this ImageIO can read the
+   * file specified. */
+  bool CanReadFile(const char*) override;
+
+  /** Set the spacing and dimension information for the set filename. */
+  void ReadImageInformation() override;
+
+  /** Reads the data from shared memory into the memory buffer provided. */
+  void Read(void* buffer) override;
+
+  /*-------- This part of the interfaces deals with writing data. ----- */
+
+  /** Writing to shared memory is not supported, always returns false. */
+  bool CanWriteFile(const char*) override;
+
+  void WriteImageInformation() override;
+
+  void Write(const void* buffer) override;
+
+protected:
+  MRMLSharedMemoryImageIO();
+  ~MRMLSharedMemoryImageIO() override;
+  void PrintSelf(std::ostream& os, Indent indent) const override;
+
+  /** Map the segment specified by the filename if it is not mapped yet. */
+  bool OpenSegment();
+
+private:
+  MRMLSharedMemoryImageIO(const Self&) = delete;
+  void operator=(const Self&) = delete;
+
+  vtkMRMLVolumeSharedMemory* m_SharedMemory;
+  std::string m_OpenedFileName;
+};
+
+
+} /// end namespace itk
+#endif /// itkMRMLSharedMemoryImageIO_h
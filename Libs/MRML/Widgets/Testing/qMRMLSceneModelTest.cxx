@@ -28,6 +28,7 @@
 // MRML includes
 #include "qMRMLSceneFactoryWidget.h"
 #include "qMRMLSceneModel.h"
+#include <vtkMRMLModelNode.h>
 #include <vtkMRMLScene.h>
 #include <vtkMRMLViewNode.h>
 
@@ -47,6 +48,7 @@ private slots:
   void testSetColumns_data();
   void testSetColumnsWithScene();
   void testSetColumnsWithScene_data();
+  void testIncludedNodeTypes();
 };
 
 // ----------------------------------------------------------------------------
@@ -192,6 +194,55 @@ void qMRMLSceneModelTester::testSetColumnsWithScene_data()
   this->testSetColumns_data();
 }
 
+// ----------------------------------------------------------------------------
+void qMRMLSceneModelTester::testIncludedNodeTypes()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLViewNode> viewNode;
+  scene->AddNode(viewNode.GetPointer());
+  vtkNew<vtkMRMLModelNode> modelNode;
+  scene->AddNode(modelNode.GetPointer());
+
+  qMRMLSceneModel sceneModel;
+  sceneModel.setIncludedNodeTypes(QStringList() << "vtkMRMLViewNode");
+  QCOMPARE(sceneModel.includedNodeTypes(), QStringList() << "vtkMRMLViewNode");
+  sceneModel.setMRMLScene(scene.GetPointer());
+  QCOMPARE(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), 1);
+  QVERIFY(sceneModel.indexFromNode(viewNode.GetPointer()).isValid());
+  QVERIFY(!sceneModel.indexFromNode(modelNode.GetPointer()).isValid());
+
+  // Added nodes are appended only if they are included
+  vtkNew<vtkMRMLModelNode> modelNode2;
+  scene->AddNode(modelNode2.GetPointer());
+  vtkNew<vtkMRMLViewNode> viewNode2;
+  scene->AddNode(viewNode2.GetPointer());
+  QCOMPARE(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), 2);
+  QCOMPARE(sceneModel.indexFromNode(viewNode2.GetPointer()).row(), 1);
+  QVERIFY(!sceneModel.indexFromNode(modelNode2.GetPointer()).isValid());
+
+  // Models of the same scene share the node index
+  qMRMLSceneModel modelSceneModel;
+  modelSceneModel.setIncludedNodeTypes(QStringList() << "vtkMRMLModelNode");
+  modelSceneModel.setMRMLScene(scene.GetPointer());
+  QCOMPARE(modelSceneModel.rowCount(modelSceneModel.mrmlSceneIndex()), 2);
+  QCOMPARE(modelSceneModel.indexFromNode(modelNode.GetPointer()).row(), 0);
+  QCOMPARE(modelSceneModel.indexFromNode(modelNode2.GetPointer()).row(), 1);
+
+  // Removed nodes
+  scene->RemoveNode(viewNode.GetPointer());
+  QCOMPARE(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), 1);
+  QCOMPARE(modelSceneModel.rowCount(modelSceneModel.mrmlSceneIndex()), 2);
+
+  // Changing the included node types updates the model
+  sceneModel.setIncludedNodeTypes(QStringList());
+  QCOMPARE(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), scene->GetNumberOfNodes());
+  QVERIFY(sceneModel.indexFromNode(modelNode.GetPointer()).isValid());
+  modelSceneModel.setIncludedNodeTypes(QStringList() << "vtkMRMLViewNode");
+  QCOMPARE(modelSceneModel.rowCount(modelSceneModel.mrmlSceneIndex()), 1);
+  QVERIFY(modelSceneModel.indexFromNode(viewNode2.GetPointer()).isValid());
+  QVERIFY(!modelSceneModel.indexFromNode(modelNode.GetPointer()).isValid());
+}
+
 // ----------------------------------------------------------------------------
 CTK_TEST_MAIN(qMRMLSceneModelTest)
 #include "moc_qMRMLSceneModelTest.cxx"
@@ -50,6 +50,7 @@ qMRMLNodeComboBoxPrivate::qMRMLNodeComboBoxPrivate(qMRMLNodeComboBox& object)
   this->ComboBox = nullptr;
   this->MRMLNodeFactory = nullptr;
   this->MRMLSceneModel = nullptr;
+  this->RestrictSceneModelToNodeTypes = false;
   this->NoneEnabled = false;
   this->AddEnabled = true;
   this->RemoveEnabled = true;
@@ -396,6 +397,7 @@ qMRMLNodeComboBox::qMRMLNodeComboBox(QWidget* parentWidget)
   , d_ptr(new qMRMLNodeComboBoxPrivate(*this))
 {
   Q_D(qMRMLNodeComboBox);
+  d->RestrictSceneModelToNodeTypes = true;
   d->init(new qMRMLSceneModel(this));
 }
 
@@ -414,6 +416,7 @@ qMRMLNodeComboBox::qMRMLNodeComboBox(qMRMLNodeComboBoxPrivate* pimpl, QWidget* p
   , d_ptr(pimpl)
 {
   Q_D(qMRMLNodeComboBox);
+  d->RestrictSceneModelToNodeTypes = true;
   d->init(new qMRMLSceneModel(this));
 }
 
@@ -956,6 +959,12 @@ void qMRMLNodeComboBox::setNodeTypes(const QStringList& _nodeTypes)
   QStringList nodeTypesFiltered = _nodeTypes;
   nodeTypesFiltered.removeAll("");
 
+  if (d->RestrictSceneModelToNodeTypes)
+    {
+    // Nodes of other types would be filtered out by the proxy model anyway,
+    // don't let the scene model create and update items for them.
+    d->MRMLSceneModel->setIncludedNodeTypes(nodeTypesFiltered);
+    }
   this->sortFilterProxyModel()->setNodeTypes(nodeTypesFiltered);
   d->updateDefaultText();
   d->updateActionItems();
@@ -52,6 +52,11 @@ class vtkMRMLScene;
 /// In addition to the populated nodes, qMRMLNodeComboBox contains menu
 /// items to add, delete, edit or rename the currently selected node. Each item
 /// can be hidden.
+/// Unless a custom model is given at construction, the internal scene model
+/// only contains the nodes of type \a nodeTypes, retrieved from the node
+/// index shared by all the combo boxes of the scene (see qMRMLSceneNodeIndex),
+/// so that the cost of a combobox does not grow with the number of nodes of
+/// other types in the scene.
 class QMRML_WIDGETS_EXPORT qMRMLNodeComboBox
   : public QWidget
 {
@@ -73,6 +73,11 @@ public:
   QComboBox*        ComboBox;
   qMRMLNodeFactory* MRMLNodeFactory;
   qMRMLSceneModel*  MRMLSceneModel;
+  /// True if the scene model has been created by the combobox and is not
+  /// used by other views: nodes that are not of the node types are then not
+  /// even added to the scene model.
+  /// \sa qMRMLSceneModel::includedNodeTypes
+  bool              RestrictSceneModelToNodeTypes;
   bool              NoneEnabled;
   bool              AddEnabled;
   bool              RemoveEnabled;
@@ -27,6 +27,7 @@
 
 // qMRML includes
 #include "qMRMLSceneModel_p.h"
+#include "qMRMLSceneNodeIndex.h"
 
 // MRML includes
 #include <vtkMRMLDisplayableHierarchyNode.h>
@@ -137,6 +138,100 @@ void qMRMLSceneModelPrivate::listenNodeModifiedEvent()
     }
 }
 
+//------------------------------------------------------------------------------
+bool qMRMLSceneModelPrivate::isNodeIncluded(vtkMRMLNode* node)const
+{
+  if (this->IncludedNodeTypes.isEmpty() || !node)
+    {
+    return true;
+    }
+  const QString className(node->GetClassName());
+  QHash<QString, bool>::const_iterator classIt = this->IncludedClasses.constFind(className);
+  if (classIt != this->IncludedClasses.constEnd())
+    {
+    return classIt.value();
+    }
+  bool included = false;
+  foreach(const QString& nodeType, this->IncludedNodeTypes)
+    {
+    if (node->IsA(nodeType.toUtf8()))
+      {
+      included = true;
+      break;
+      }
+    }
+  this->IncludedClasses[className] = included;
+  return included;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneModelPrivate::updateNodeIndex()
+{
+  if (this->MRMLScene && !this->IncludedNodeTypes.isEmpty())
+    {
+    this->NodeIndex = qMRMLSceneNodeIndex::sharedIndex(this->MRMLScene);
+    }
+  else
+    {
+    this->NodeIndex.clear();
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneModelPrivate::updateIncludedNodes()
+{
+  Q_Q(qMRMLSceneModel);
+  QStandardItem* sceneItem = q->mrmlSceneItem();
+  if (!sceneItem || !this->MRMLScene || this->MRMLScene->IsImporting())
+    {
+    // The model is updated when the scene is set or imported
+    return;
+    }
+  // Remove the nodes that are not included anymore
+  const int preItemCount = q->preItems(sceneItem).count();
+  for (int row = sceneItem->rowCount() - q->postItems(sceneItem).count() - 1;
+       row >= preItemCount; --row)
+    {
+    vtkMRMLNode* node = q->mrmlNodeFromItem(sceneItem->child(row, 0));
+    if (node && !this->isNodeIncluded(node))
+      {
+      q->qvtkDisconnect(node, vtkCommand::NoEvent, q, nullptr);
+      this->RowCache.remove(node);
+      sceneItem->removeRow(row);
+      }
+    }
+  // Add the nodes that are newly included
+  QList<vtkMRMLNode*> nodes;
+  if (this->NodeIndex)
+    {
+    nodes = this->NodeIndex->nodes(this->IncludedNodeTypes);
+    }
+  else
+    {
+    vtkMRMLNode* node = nullptr;
+    vtkCollectionSimpleIterator it;
+    for (this->MRMLScene->GetNodes()->InitTraversal(it);
+         (node = (vtkMRMLNode*)this->MRMLScene->GetNodes()->GetNextItemAsObject(it)) ;)
+      {
+      nodes << node;
+      }
+    }
+  this->MisplacedNodes.clear();
+  int index = -1;
+  foreach(vtkMRMLNode* node, nodes)
+    {
+    index++;
+    if (!q->itemFromNode(node))
+      {
+      this->insertNode(node, index);
+      }
+    }
+  foreach(vtkMRMLNode* misplacedNode, this->MisplacedNodes)
+    {
+    q->onMRMLNodeModified(misplacedNode);
+    }
+}
+
 //------------------------------------------------------------------------------
 void qMRMLSceneModelPrivate::insertExtraItem(int row, QStandardItem* parent,
                                              const QString& text,
@@ -358,6 +453,7 @@ void qMRMLSceneModel::setMRMLScene(vtkMRMLScene* scene)
     d->MRMLScene->RemoveObserver(d->CallBack);
     }
   d->MRMLScene = scene;
+  d->updateNodeIndex();
   this->updateScene();
   if (scene)
     {
@@ -539,6 +635,29 @@ int qMRMLSceneModel::nodeIndex(vtkMRMLNode* node)const
     return -1;
     }
 
+  if (d->NodeIndex)
+    {
+    // Only the included nodes are in the model: count the sibling items
+    // that are before the node in the scene instead of browsing the scene.
+    vtkMRMLNode* parent = this->parentNode(node);
+    QStandardItem* parentItem = parent ? this->itemFromNode(parent) : this->mrmlSceneItem();
+    if (!parentItem)
+      {
+      return 0;
+      }
+    int index = 0;
+    const int nodeRowCount = parentItem->rowCount() - this->postItems(parentItem).count();
+    for (int row = this->preItems(parentItem).count(); row < nodeRowCount; ++row)
+      {
+      vtkMRMLNode* sibling = this->mrmlNodeFromItem(parentItem->child(row, 0));
+      if (sibling && sibling != node && d->NodeIndex->isNodeBefore(sibling, node))
+        {
+        ++index;
+        }
+      }
+    return index;
+    }
+
   const char* nId = nullptr;
   int index = -1;
   vtkMRMLNode* parent = this->parentNode(node);
@@ -662,6 +781,27 @@ bool qMRMLSceneModel::lazyUpdate()const
   return d->LazyUpdate;
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSceneModel::setIncludedNodeTypes(const QStringList& nodeTypes)
+{
+  Q_D(qMRMLSceneModel);
+  if (d->IncludedNodeTypes == nodeTypes)
+    {
+    return;
+    }
+  d->IncludedNodeTypes = nodeTypes;
+  d->IncludedClasses.clear();
+  d->updateNodeIndex();
+  d->updateIncludedNodes();
+}
+
+//------------------------------------------------------------------------------
+QStringList qMRMLSceneModel::includedNodeTypes()const
+{
+  Q_D(const qMRMLSceneModel);
+  return d->IncludedNodeTypes;
+}
+
 //------------------------------------------------------------------------------
 QMimeData* qMRMLSceneModel::mimeData(const QModelIndexList& indexes)const
 {
@@ -794,11 +934,23 @@ void qMRMLSceneModel::populateScene()
     {
     return;
     }
-  for (d->MRMLScene->GetNodes()->InitTraversal(it);
-       (node = (vtkMRMLNode*)d->MRMLScene->GetNodes()->GetNextItemAsObject(it)) ;)
+  if (d->NodeIndex)
     {
-    index++;
-    d->insertNode(node, index);
+    // Only browse the included nodes
+    foreach(vtkMRMLNode* includedNode, d->NodeIndex->nodes(d->IncludedNodeTypes))
+      {
+      index++;
+      d->insertNode(includedNode, index);
+      }
+    }
+  else
+    {
+    for (d->MRMLScene->GetNodes()->InitTraversal(it);
+         (node = (vtkMRMLNode*)d->MRMLScene->GetNodes()->GetNextItemAsObject(it)) ;)
+      {
+      index++;
+      d->insertNode(node, index);
+      }
     }
   foreach(vtkMRMLNode* misplacedNode, d->MisplacedNodes)
     {
@@ -1215,6 +1367,10 @@ void qMRMLSceneModel::onMRMLSceneNodeAdded(vtkMRMLScene* scene, vtkMRMLNode* nod
     // to add a node during importing (see https://issues.slicer.org/view.php?id=4080).
     return;
     }
+  if (!d->isNodeIncluded(node))
+    {
+    return;
+    }
   this->insertNode(node);
 }
 
@@ -1230,6 +1386,11 @@ void qMRMLSceneModel::onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMR
     {
     return;
     }
+  if (!d->isNodeIncluded(node) && !this->indexFromNode(node).isValid())
+    {
+    // The node is not in the model
+    return;
+    }
 
   int connectionsRemoved =
     qvtkDisconnect(node, vtkCommand::ModifiedEvent,
@@ -74,6 +74,17 @@ class QMRML_WIDGETS_EXPORT qMRMLSceneModel : public QStandardItemModel
   /// imported/restored.
   Q_PROPERTY (bool lazyUpdate READ lazyUpdate WRITE setLazyUpdate)
 
+  /// Class names of the nodes added to the model. Nodes of other classes
+  /// (that are not derived from any of the included types) are not added
+  /// to the model nor observed, except the parents (see parentNode()) of
+  /// included nodes: populateScene() only retrieves the included nodes, but
+  /// inserting a node inserts its parent first.
+  /// When set, the nodes are retrieved from the index shared by all the
+  /// models of the scene (see qMRMLSceneNodeIndex), so that populating and
+  /// updating the model only costs in proportion to the included nodes.
+  /// All the nodes are included if empty (default).
+  Q_PROPERTY (QStringList includedNodeTypes READ includedNodeTypes WRITE setIncludedNodeTypes)
+
   /// Control in which column vtkMRMLNode names are displayed (Qt::DisplayRole).
   /// A value of -1 hides it. First column (0) by default.
   /// If no property is set in a column, nothing is displayed.
@@ -151,6 +162,10 @@ public:
   bool lazyUpdate()const;
   void setLazyUpdate(bool lazy);
 
+  /// \sa includedNodeTypes
+  QStringList includedNodeTypes()const;
+  void setIncludedNodeTypes(const QStringList& nodeTypes);
+
   int nameColumn()const;
   void setNameColumn(int column);
 
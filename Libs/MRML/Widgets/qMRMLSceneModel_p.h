@@ -35,10 +35,13 @@
 // Qt includes
 class QStandardItemModel;
 #include <QFlags>
+#include <QHash>
 #include <QMap>
+#include <QSharedPointer>
 
 // qMRML includes
 #include "qMRMLSceneModel.h"
+class qMRMLSceneNodeIndex;
 
 // MRML includes
 class vtkMRMLScene;
@@ -70,6 +73,16 @@ public:
   void removeAllExtraItems(QStandardItem* parent, const QString extraType);
   bool isExtraItem(const QStandardItem* item)const;
   void listenNodeModifiedEvent();
+
+  /// Return true if the node is of one of the included node types.
+  /// \sa qMRMLSceneModel::includedNodeTypes
+  bool isNodeIncluded(vtkMRMLNode* node)const;
+  /// Get the shared node index of the scene if only some node types are
+  /// included, release it otherwise.
+  void updateNodeIndex();
+  /// Remove the nodes that are not included anymore and add the nodes that
+  /// are newly included, without resetting the model.
+  void updateIncludedNodes();
   void reparentItems(QList<QStandardItem*>& children, int newIndex, QStandardItem* newParent);
 
   /// This method is called by qMRMLSceneModel::populateScene() to speed up
@@ -81,6 +94,10 @@ public:
   vtkSmartPointer<vtkCallbackCommand> CallBack;
   qMRMLSceneModel::NodeTypes ListenNodeModifiedEvent;
   bool LazyUpdate;
+  QStringList IncludedNodeTypes;
+  /// Cache of isNodeIncluded() by node class name
+  mutable QHash<QString, bool> IncludedClasses;
+  QSharedPointer<qMRMLSceneNodeIndex> NodeIndex;
   int PendingItemModified;
 
   int NameColumn;
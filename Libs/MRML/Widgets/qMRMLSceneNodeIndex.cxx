@@ -0,0 +1,295 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QHash>
+#include <QSet>
+#include <QWeakPointer>
+
+// qMRML includes
+#include "qMRMLSceneNodeIndex.h"
+
+// MRML includes
+#include <vtkMRMLNode.h>
+#include <vtkMRMLScene.h>
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkCollection.h>
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <algorithm>
+
+namespace
+{
+// Indexes of the scenes, there is at most one index per scene.
+typedef QHash<vtkMRMLScene*, QWeakPointer<qMRMLSceneNodeIndex> > SceneNodeIndexes;
+Q_GLOBAL_STATIC(SceneNodeIndexes, sharedSceneNodeIndexes);
+}
+
+//------------------------------------------------------------------------------
+class qMRMLSceneNodeIndexPrivate
+{
+public:
+  qMRMLSceneNodeIndexPrivate();
+
+  void addNode(vtkMRMLNode* node);
+  void removeNode(vtkMRMLNode* node);
+  /// Index all the nodes of the scene again, in the scene order.
+  void rebuild();
+  void clear();
+
+  static void onMRMLSceneEvent(vtkObject* vtk_obj, unsigned long event,
+                               void* client_data, void* call_data);
+
+  vtkWeakPointer<vtkMRMLScene> MRMLScene;
+  /// Key of the index in the shared indexes, kept as the scene may be
+  /// deleted before the index.
+  vtkMRMLScene* SceneKey;
+  vtkSmartPointer<vtkCallbackCommand> CallBack;
+
+  /// Nodes by class name
+  QHash<QString, QSet<vtkMRMLNode*> > NodesByClass;
+  /// Position of the nodes in the scene. Positions are increasing but not
+  /// contiguous, they are only meant to sort the nodes.
+  QHash<vtkMRMLNode*, qint64> NodeOrders;
+  qint64 NextOrder;
+};
+
+//------------------------------------------------------------------------------
+qMRMLSceneNodeIndexPrivate::qMRMLSceneNodeIndexPrivate()
+{
+  this->SceneKey = nullptr;
+  this->CallBack = vtkSmartPointer<vtkCallbackCommand>::New();
+  this->NextOrder = 0;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneNodeIndexPrivate::addNode(vtkMRMLNode* node)
+{
+  if (!node || this->NodeOrders.contains(node))
+    {
+    return;
+    }
+  this->NodeOrders[node] = this->NextOrder++;
+  this->NodesByClass[QString(node->GetClassName())].insert(node);
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneNodeIndexPrivate::removeNode(vtkMRMLNode* node)
+{
+  if (!node || !this->NodeOrders.remove(node))
+    {
+    return;
+    }
+  const QString className(node->GetClassName());
+  QHash<QString, QSet<vtkMRMLNode*> >::iterator classIt = this->NodesByClass.find(className);
+  if (classIt != this->NodesByClass.end())
+    {
+    classIt->remove(node);
+    if (classIt->isEmpty())
+      {
+      this->NodesByClass.erase(classIt);
+      }
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneNodeIndexPrivate::rebuild()
+{
+  this->clear();
+  if (!this->MRMLScene)
+    {
+    return;
+    }
+  vtkMRMLNode* node = nullptr;
+  vtkCollectionSimpleIterator it;
+  vtkCollection* nodes = this->MRMLScene->GetNodes();
+  this->NodeOrders.reserve(nodes->GetNumberOfItems());
+  for (nodes->InitTraversal(it);
+       (node = vtkMRMLNode::SafeDownCast(nodes->GetNextItemAsObject(it))) ;)
+    {
+    this->addNode(node);
+    }
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneNodeIndexPrivate::clear()
+{
+  this->NodesByClass.clear();
+  this->NodeOrders.clear();
+  this->NextOrder = 0;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneNodeIndexPrivate::onMRMLSceneEvent(vtkObject* vtk_obj, unsigned long event,
+                                                  void* client_data, void* call_data)
+{
+  vtkMRMLScene* scene = reinterpret_cast<vtkMRMLScene*>(vtk_obj);
+  qMRMLSceneNodeIndexPrivate* d = reinterpret_cast<qMRMLSceneNodeIndexPrivate*>(client_data);
+  vtkMRMLNode* node = reinterpret_cast<vtkMRMLNode*>(call_data);
+  Q_ASSERT(scene);
+  Q_ASSERT(d);
+  Q_UNUSED(scene);
+  switch (event)
+    {
+    case vtkMRMLScene::NodeAddedEvent:
+      d->addNode(node);
+      break;
+    case vtkMRMLScene::NodeRemovedEvent:
+      d->removeNode(node);
+      break;
+    case vtkMRMLScene::EndCloseEvent:
+    case vtkMRMLScene::EndImportEvent:
+    case vtkMRMLScene::EndRestoreEvent:
+      // Nodes may be added or removed without notification while the scene
+      // is closed, imported or restored (undo/redo).
+      d->rebuild();
+      break;
+    case vtkCommand::DeleteEvent:
+      // The scene address may be reused by a new scene, don't share this index anymore.
+      sharedSceneNodeIndexes()->remove(d->SceneKey);
+      d->clear();
+      break;
+    }
+}
+
+//------------------------------------------------------------------------------
+qMRMLSceneNodeIndex::qMRMLSceneNodeIndex(vtkMRMLScene* scene)
+  : d_ptr(new qMRMLSceneNodeIndexPrivate)
+{
+  Q_D(qMRMLSceneNodeIndex);
+  d->MRMLScene = scene;
+  d->SceneKey = scene;
+  d->CallBack->SetClientData(d);
+  d->CallBack->SetCallback(qMRMLSceneNodeIndexPrivate::onMRMLSceneEvent);
+  // The index must be up-to-date before the scene models are notified,
+  // observe the scene with a higher priority than qMRMLSceneModel.
+  scene->AddObserver(vtkMRMLScene::NodeAddedEvent, d->CallBack, 100.);
+  scene->AddObserver(vtkMRMLScene::NodeRemovedEvent, d->CallBack, 100.);
+  scene->AddObserver(vtkMRMLScene::EndCloseEvent, d->CallBack, 100.);
+  scene->AddObserver(vtkMRMLScene::EndImportEvent, d->CallBack, 100.);
+  scene->AddObserver(vtkMRMLScene::EndRestoreEvent, d->CallBack, 100.);
+  scene->AddObserver(vtkCommand::DeleteEvent, d->CallBack, 100.);
+  d->rebuild();
+}
+
+//------------------------------------------------------------------------------
+qMRMLSceneNodeIndex::~qMRMLSceneNodeIndex()
+{
+  Q_D(qMRMLSceneNodeIndex);
+  if (d->MRMLScene)
+    {
+    d->MRMLScene->RemoveObserver(d->CallBack);
+    }
+  // The shared pointer stored for the scene is already invalid, unless the
+  // scene has been deleted and a new index created for a new scene at the
+  // same address.
+  SceneNodeIndexes::iterator indexIt = sharedSceneNodeIndexes()->find(d->SceneKey);
+  if (indexIt != sharedSceneNodeIndexes()->end() && indexIt->isNull())
+    {
+    sharedSceneNodeIndexes()->erase(indexIt);
+    }
+}
+
+//------------------------------------------------------------------------------
+QSharedPointer<qMRMLSceneNodeIndex> qMRMLSceneNodeIndex::sharedIndex(vtkMRMLScene* scene)
+{
+  if (!scene)
+    {
+    return QSharedPointer<qMRMLSceneNodeIndex>();
+    }
+  QSharedPointer<qMRMLSceneNodeIndex> index = sharedSceneNodeIndexes()->value(scene).toStrongRef();
+  if (index.isNull())
+    {
+    index = QSharedPointer<qMRMLSceneNodeIndex>(new qMRMLSceneNodeIndex(scene));
+    sharedSceneNodeIndexes()->insert(scene, index.toWeakRef());
+    }
+  return index;
+}
+
+//------------------------------------------------------------------------------
+vtkMRMLScene* qMRMLSceneNodeIndex::mrmlScene()const
+{
+  Q_D(const qMRMLSceneNodeIndex);
+  return d->MRMLScene;
+}
+
+//------------------------------------------------------------------------------
+QList<vtkMRMLNode*> qMRMLSceneNodeIndex::nodes(const QStringList& nodeTypes)const
+{
+  Q_D(const qMRMLSceneNodeIndex);
+  QList<vtkMRMLNode*> nodes;
+  QHash<QString, QSet<vtkMRMLNode*> >::const_iterator classIt;
+  for (classIt = d->NodesByClass.constBegin(); classIt != d->NodesByClass.constEnd(); ++classIt)
+    {
+    if (classIt->isEmpty())
+      {
+      continue;
+      }
+    // All the nodes of a class have the same base classes, check only one of them.
+    vtkMRMLNode* classNode = *classIt->constBegin();
+    bool matching = nodeTypes.isEmpty();
+    foreach(const QString& nodeType, nodeTypes)
+      {
+      if (classNode->IsA(nodeType.toUtf8()))
+        {
+        matching = true;
+        break;
+        }
+      }
+    if (!matching)
+      {
+      continue;
+      }
+    foreach(vtkMRMLNode* node, *classIt)
+      {
+      nodes << node;
+      }
+    }
+  std::sort(nodes.begin(), nodes.end(), [d](vtkMRMLNode* node1, vtkMRMLNode* node2)
+    {
+    return d->NodeOrders.value(node1) < d->NodeOrders.value(node2);
+    });
+  return nodes;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLSceneNodeIndex::isNodeBefore(vtkMRMLNode* node, vtkMRMLNode* otherNode)const
+{
+  Q_D(const qMRMLSceneNodeIndex);
+  QHash<vtkMRMLNode*, qint64>::const_iterator nodeIt = d->NodeOrders.constFind(node);
+  QHash<vtkMRMLNode*, qint64>::const_iterator otherNodeIt = d->NodeOrders.constFind(otherNode);
+  if (nodeIt == d->NodeOrders.constEnd())
+    {
+    return false;
+    }
+  if (otherNodeIt == d->NodeOrders.constEnd())
+    {
+    return true;
+    }
+  return nodeIt.value() < otherNodeIt.value();
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSceneNodeIndex::nodeCount()const
+{
+  Q_D(const qMRMLSceneNodeIndex);
+  return d->NodeOrders.count();
+}
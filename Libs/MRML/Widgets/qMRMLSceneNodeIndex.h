@@ -0,0 +1,79 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qMRMLSceneNodeIndex_h
+#define __qMRMLSceneNodeIndex_h
+
+// Qt includes
+#include <QList>
+#include <QScopedPointer>
+#include <QSharedPointer>
+#include <QStringList>
+
+// qMRML includes
+#include "qMRMLWidgetsExport.h"
+
+class vtkMRMLNode;
+class vtkMRMLScene;
+
+class qMRMLSceneNodeIndexPrivate;
+
+/// \brief Index of the nodes of a scene by class.
+///
+/// There is at most one index per scene, shared by all its users (see
+/// sharedIndex()). It observes the scene once and is updated incrementally
+/// when nodes are added or removed, which allows models that only display a
+/// few node types (e.g. the scene models of the node combo boxes) to retrieve
+/// their nodes without browsing the whole scene.
+/// The index is deleted when the last shared pointer to it is released.
+/// \sa qMRMLSceneModel::setIncludedNodeTypes()
+class QMRML_WIDGETS_EXPORT qMRMLSceneNodeIndex
+{
+public:
+  ~qMRMLSceneNodeIndex();
+
+  /// Return the index of \a scene, create it if it does not exist yet.
+  /// Return a null pointer if \a scene is null.
+  static QSharedPointer<qMRMLSceneNodeIndex> sharedIndex(vtkMRMLScene* scene);
+
+  /// Scene of the index, null if the scene has been deleted.
+  vtkMRMLScene* mrmlScene()const;
+
+  /// Return the nodes of the scene that are of any of the \a nodeTypes class
+  /// names (or of a derived class). All the nodes are returned if
+  /// \a nodeTypes is empty. Nodes are sorted in the order of the scene,
+  /// except nodes inserted with vtkMRMLScene::InsertBeforeNode() or
+  /// InsertAfterNode() that are sorted as if they had been added last.
+  QList<vtkMRMLNode*> nodes(const QStringList& nodeTypes = QStringList())const;
+
+  /// Return true if \a node is before \a otherNode in the scene.
+  /// Nodes that are not indexed (yet) are considered after all the indexed nodes.
+  bool isNodeBefore(vtkMRMLNode* node, vtkMRMLNode* otherNode)const;
+
+  /// Number of indexed nodes.
+  int nodeCount()const;
+
+protected:
+  qMRMLSceneNodeIndex(vtkMRMLScene* scene);
+  QScopedPointer<qMRMLSceneNodeIndexPrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qMRMLSceneNodeIndex);
+  Q_DISABLE_COPY(qMRMLSceneNodeIndex);
+};
+
+#endif
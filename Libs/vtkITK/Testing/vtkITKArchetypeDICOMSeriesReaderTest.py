@@ -0,0 +1,170 @@
+import glob
+import os
+import sys
+import time
+
+import numpy
+import vtk
+from vtk.util import numpy_support as ns
+
+import slicer
+import vtkITK
+
+"""
+Test reading a DICOM series with vtkITKArchetypeImageSeriesReader.
+
+Usage:
+
+  Slicer --no-main-window --python-script vtkITKArchetypeDICOMSeriesReaderTest.py /path/to/CTHeadAxialDicom /path/to/temp
+"""
+
+
+def read_series(archetype, headerCacheFileName="", parallelSliceReading=True, numberOfThreads=0):
+    reader = vtkITK.vtkITKArchetypeImageSeriesScalarReader()
+    reader.SetArchetype(archetype)
+    reader.SetSingleFile(False)
+    reader.SetOutputScalarTypeToNative()
+    reader.SetHeaderCacheFileName(headerCacheFileName)
+    reader.SetParallelSliceReading(parallelSliceReading)
+    reader.SetNumberOfThreads(numberOfThreads)
+    progressValues = []
+    reader.AddObserver(vtk.vtkCommand.ProgressEvent, lambda caller, event: progressValues.append(caller.GetProgress()))
+    reader.Update()
+    reader.progressValues = progressValues
+    return reader
+
+
+def scalars(reader):
+    return ns.vtk_to_numpy(reader.GetOutput().GetPointData().GetScalars())
+
+
+def test_header_cache(archetype, numberOfFiles, tmp_dir):
+    cacheFileName = os.path.join(tmp_dir, "vtkITKArchetypeDICOMSeriesReaderTestHeaderCache.txt")
+    if os.path.exists(cacheFileName):
+        os.remove(cacheFileName)
+
+    referenceReader = read_series(archetype)
+    assert referenceReader.GetNumberOfFileNames() == numberOfFiles
+
+    # First read creates the cache
+    firstReader = read_series(archetype, cacheFileName)
+    assert os.path.exists(cacheFileName)
+    assert firstReader.GetNumberOfFileNames() == numberOfFiles
+    assert numpy.array_equal(scalars(firstReader), scalars(referenceReader))
+
+    with open(cacheFileName) as cacheFile:
+        lines = cacheFile.read().splitlines()
+    assert lines[0] == "# vtkITKArchetypeImageSeriesReader DICOM header cache v1"
+    assert len(lines) == 1 + numberOfFiles
+
+    # Second read gets the same result from the cache
+    secondReader = read_series(archetype, cacheFileName)
+    assert secondReader.GetNumberOfFileNames() == numberOfFiles
+    assert numpy.array_equal(scalars(secondReader), scalars(referenceReader))
+    for fileIndex in range(numberOfFiles):
+        assert secondReader.GetFileName(fileIndex) == firstReader.GetFileName(fileIndex)
+
+    # Prove that the cache is used: assign another SeriesInstanceUID to a file
+    # that is not the archetype in the cache only, that file must then be
+    # excluded from the series. Columns are path, modified time, size and
+    # tag values, starting with SeriesInstanceUID.
+    archetypeFullPath = os.path.normcase(os.path.realpath(archetype))
+    for lineIndex in range(1, len(lines)):
+        fields = lines[lineIndex].split("\t")
+        if os.path.normcase(os.path.realpath(fields[0])) != archetypeFullPath:
+            fields[3] = fields[3] + ".1"
+            lines[lineIndex] = "\t".join(fields)
+            break
+    with open(cacheFileName, "w") as cacheFile:
+        cacheFile.write("\n".join(lines) + "\n")
+    tamperedReader = read_series(archetype, cacheFileName)
+    assert tamperedReader.GetNumberOfFileNames() == numberOfFiles - 1
+
+    os.remove(cacheFileName)
+
+
+def compare_readers(reader1, reader2):
+    image1 = reader1.GetOutput()
+    image2 = reader2.GetOutput()
+    assert image1.GetDimensions() == image2.GetDimensions()
+    assert image1.GetSpacing() == image2.GetSpacing()
+    assert image1.GetOrigin() == image2.GetOrigin()
+    assert image1.GetScalarType() == image2.GetScalarType()
+    assert image1.GetNumberOfScalarComponents() == image2.GetNumberOfScalarComponents()
+    assert numpy.array_equal(scalars(reader1), scalars(reader2))
+    for row in range(4):
+        for column in range(4):
+            assert reader1.GetRasToIjkMatrix().GetElement(row, column) == reader2.GetRasToIjkMatrix().GetElement(row, column)
+
+
+def test_parallel_slice_reading(archetype, numberOfFiles):
+    serialReader = read_series(archetype, parallelSliceReading=False)
+    assert serialReader.GetOutput().GetDimensions()[2] == numberOfFiles
+    for numberOfThreads in [1, 4, 0]:
+        parallelReader = read_series(archetype, parallelSliceReading=True, numberOfThreads=numberOfThreads)
+        compare_readers(serialReader, parallelReader)
+        if numberOfThreads in [1, 4]:
+            # Slices are read in several batches, progress is reported after each batch
+            assert any(0.0 < progress < 1.0 for progress in parallelReader.progressValues)
+
+
+def test_storage_node_header_cache(archetype, numberOfFiles, tmp_dir):
+    cacheDirectory = os.path.join(tmp_dir, "vtkITKArchetypeDICOMSeriesReaderTestCache")
+    if not os.path.exists(cacheDirectory):
+        os.makedirs(cacheDirectory)
+    for fileName in glob.glob(os.path.join(cacheDirectory, "DICOMHeaderCache_*")):
+        os.remove(fileName)
+
+    # Stale caches and temporary files left over by interrupted writes are removed
+    staleFileNames = [
+        os.path.join(cacheDirectory, "DICOMHeaderCache_stale.txt"),
+        os.path.join(cacheDirectory, "DICOMHeaderCache_stale.txt.1234.0.tmp")]
+    staleTime = time.time() - 60 * 24 * 60 * 60
+    for fileName in staleFileNames:
+        with open(fileName, "w") as cacheFile:
+            cacheFile.write("\n")
+        os.utime(fileName, (staleTime, staleTime))
+
+    scene = slicer.vtkMRMLScene()
+    cacheManager = slicer.vtkCacheManager()
+    cacheManager.SetRemoteCacheDirectory(cacheDirectory)
+    scene.SetCacheManager(cacheManager)
+
+    for readIndex in range(2):
+        volumeNode = scene.AddNewNodeByClass("vtkMRMLScalarVolumeNode")
+        storageNode = scene.AddNewNodeByClass("vtkMRMLVolumeArchetypeStorageNode")
+        storageNode.SetFileName(archetype)
+        storageNode.SetSingleFile(False)
+        assert storageNode.ReadData(volumeNode)
+        assert volumeNode.GetImageData().GetDimensions()[2] == numberOfFiles
+        # The storage node stores one cache file per series directory
+        assert len(glob.glob(os.path.join(cacheDirectory, "DICOMHeaderCache_*.txt"))) == 1
+        assert len(glob.glob(os.path.join(cacheDirectory, "DICOMHeaderCache_*.tmp"))) == 0
+        for fileName in staleFileNames:
+            assert not os.path.exists(fileName)
+
+    # No cache when loading a single file
+    for fileName in glob.glob(os.path.join(cacheDirectory, "DICOMHeaderCache_*.txt")):
+        os.remove(fileName)
+    volumeNode = scene.AddNewNodeByClass("vtkMRMLScalarVolumeNode")
+    storageNode = scene.AddNewNodeByClass("vtkMRMLVolumeArchetypeStorageNode")
+    storageNode.SetFileName(archetype)
+    storageNode.SetSingleFile(True)
+    assert storageNode.ReadData(volumeNode)
+    assert len(glob.glob(os.path.join(cacheDirectory, "DICOMHeaderCache_*.txt"))) == 0
+
+
+def run_tests(data_dir, tmp_dir):
+    fileNames = glob.glob(os.path.join(data_dir, "*.dcm"))
+    archetype = os.path.join(data_dir, "CTHead1.dcm")
+    test_header_cache(archetype, len(fileNames), tmp_dir)
+    test_parallel_slice_reading(archetype, len(fileNames))
+    test_storage_node_header_cache(archetype, len(fileNames), tmp_dir)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) != 3:
+        print(os.path.basename(sys.argv[0]) + " /path/to/CTHeadAxialDicom /path/to/temp")
+        exit(slicer.util.EXIT_FAILURE)
+    run_tests(sys.argv[1], sys.argv[2])
+    exit(slicer.util.EXIT_SUCCESS)
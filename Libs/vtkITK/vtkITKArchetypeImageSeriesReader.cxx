@@ -36,10 +36,20 @@
 #include <itkMetaDataObjectBase.h>
 #include <itkMetaDataObject.h>
 #include <itkMetaImageIO.h>
+#include <itkMultiThreaderBase.h>
 #include <itkTimeProbe.h>
+#include <itksys/SystemTools.hxx>
 
 // STD includes
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
 #include <vector>
 
 #include "itkArchetypeSeriesFileNames.h"
@@ -53,6 +63,131 @@
 
 vtkStandardNewMacro(vtkITKArchetypeImageSeriesReader);
 
+namespace
+{
+/// DICOM tags that are used for grouping files.
+/// Order must match the *TagIndex enum values.
+const char* const AnalyzedDicomTags[] =
+{
+  "0020|000e", // SeriesInstanceUID
+  "0008|0033", // ContentTime
+  "0018|1060", // TriggerTime
+  "0018|0086", // EchoNumbers
+  "0010|9089", // DiffusionGradientOrientation
+  "0020|1041", // SliceLocation
+  "0020|0037", // ImageOrientationPatient
+  "0020|0032"  // ImagePositionPatient
+};
+enum
+{
+  SeriesInstanceUIDTagIndex = 0,
+  ContentTimeTagIndex,
+  TriggerTimeTagIndex,
+  EchoNumbersTagIndex,
+  DiffusionGradientOrientationTagIndex,
+  SliceLocationTagIndex,
+  ImageOrientationPatientTagIndex,
+  ImagePositionPatientTagIndex,
+  NumberOfAnalyzedDicomTags
+};
+
+const char* const DicomHeaderCacheSignature = "# vtkITKArchetypeImageSeriesReader DICOM header cache v1";
+
+/// Cached tag values of a file. The entry is valid as long as
+/// the modification time and size of the file are unchanged.
+struct DicomHeaderCacheEntry
+{
+  long int ModifiedTime{0};
+  unsigned long FileSize{0};
+  std::vector<std::string> TagValues;
+};
+typedef std::map<std::string, DicomHeaderCacheEntry> DicomHeaderCacheType;
+
+//----------------------------------------------------------------------------
+void SplitCacheLine(const std::string& line, std::vector<std::string>& fields)
+{
+  fields.clear();
+  std::string::size_type start = 0;
+  std::string::size_type end = 0;
+  while ((end = line.find('\t', start)) != std::string::npos)
+    {
+    fields.push_back(line.substr(start, end - start));
+    start = end + 1;
+    }
+  fields.push_back(line.substr(start));
+}
+
+//----------------------------------------------------------------------------
+void ReadDicomHeaderCache(const std::string& cacheFileName, DicomHeaderCacheType& cache)
+{
+  std::ifstream cacheStream(cacheFileName.c_str());
+  std::string line;
+  if (!cacheStream.is_open() || !std::getline(cacheStream, line) || line != DicomHeaderCacheSignature)
+    {
+    // no cache yet or incompatible format
+    return;
+    }
+  std::vector<std::string> fields;
+  while (std::getline(cacheStream, line))
+    {
+    SplitCacheLine(line, fields);
+    if (fields.size() != 3 + NumberOfAnalyzedDicomTags)
+      {
+      continue;
+      }
+    DicomHeaderCacheEntry entry;
+    entry.ModifiedTime = atol(fields[1].c_str());
+    entry.FileSize = strtoul(fields[2].c_str(), nullptr, 10);
+    entry.TagValues.assign(fields.begin() + 3, fields.end());
+    cache[fields[0]] = entry;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool WriteDicomHeaderCache(const std::string& cacheFileName, const DicomHeaderCacheType& cache)
+{
+  // Write to a temporary file first so that concurrent readers of the cache
+  // never see a partially written file. The temporary file name is unique so
+  // that concurrent writers (threads or processes) don't write the same file.
+  static std::atomic<unsigned int> tempFileCounter(0);
+  std::ostringstream tempFileNameStream;
+  tempFileNameStream << cacheFileName << "." << std::hex << std::random_device()()
+                     << "." << tempFileCounter++ << ".tmp";
+  const std::string tempFileName = tempFileNameStream.str();
+    {
+    std::ofstream cacheStream(tempFileName.c_str(), std::ios::out | std::ios::trunc);
+    if (!cacheStream.is_open())
+      {
+      return false;
+      }
+    cacheStream << DicomHeaderCacheSignature << "\n";
+    for (const auto& fileEntry : cache)
+      {
+      cacheStream << fileEntry.first << "\t" << fileEntry.second.ModifiedTime << "\t" << fileEntry.second.FileSize;
+      for (const std::string& tagValue : fileEntry.second.TagValues)
+        {
+        cacheStream << "\t" << tagValue;
+        }
+      cacheStream << "\n";
+      }
+    cacheStream.close();
+    if (cacheStream.fail())
+      {
+      itksys::SystemTools::RemoveFile(tempFileName);
+      return false;
+      }
+    }
+  // The last writer wins, the caches of all the writers are valid
+  if (!itksys::SystemTools::RenameFile(tempFileName, cacheFileName))
+    {
+    itksys::SystemTools::RemoveFile(tempFileName);
+    return false;
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 vtkITKArchetypeImageSeriesReader::vtkITKArchetypeImageSeriesReader()
 {
@@ -92,6 +227,8 @@ vtkITKArchetypeImageSeriesReader::vtkITKArchetypeImageSeriesReader()
   this->ImageOrientationPatient.resize( 0 );
 
   this->AnalyzeHeader = true;
+  this->NumberOfThreads = 0;
+  this->ParallelSliceReading = true;
 
   this->GroupingByTags = false;
   this->IsOnlyFile = false;
@@ -184,6 +321,9 @@ void vtkITKArchetypeImageSeriesReader::PrintSelf(ostream& os, vtkIndent indent)
 #else
   os << indent << "DICOMImageIOApproach: " << "NA";
 #endif
+  os << indent << "HeaderCacheFileName: " << this->HeaderCacheFileName << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "ParallelSliceReading: " << this->ParallelSliceReading << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -1335,20 +1475,19 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
   // if Archetype is a Dicom File
-  gdcmIO->SetFileName( this->Archetype );
+  // Read the tags of all files (from the cache or concurrently from the files)
+  // then index them in file order, so that the result does not depend on the
+  // number of threads.
+  std::vector<std::vector<std::string> > fileTagValues;
+  this->ReadDicomTagValues(fileTagValues);
+
   for (int f = 0; f < nFiles; f++)
     {
-    gdcmIO->SetFileName( this->AllFileNames[f] );
-    gdcmIO->ReadImageInformation();
-    itk::MetaDataDictionary &dict = gdcmIO->GetMetaDataDictionary();
+    const std::vector<std::string>& tagValues = fileTagValues[f];
     std::string tagValue;
 
-    // Use vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces to remove extra spaces
-    // from the DICOM tag, because extra spaces were found in some DICOM file before/after the
-    // multi-value separator backslashes.
-
     // series instance UID
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|000e");
+    tagValue = tagValues[SeriesInstanceUIDTagIndex];
     if (!tagValue.empty())
       {
       int idx = InsertSeriesInstanceUIDs( tagValue.c_str() );
@@ -1360,7 +1499,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // content time
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0008|0033");
+    tagValue = tagValues[ContentTimeTagIndex];
     if (!tagValue.empty())
       {
       int idx = InsertContentTime( tagValue.c_str() );
@@ -1372,7 +1511,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // trigger time
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|1060");
+    tagValue = tagValues[TriggerTimeTagIndex];
     if (!tagValue.empty())
       {
       int idx = InsertTriggerTime( tagValue.c_str() );
@@ -1384,7 +1523,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // echo numbers
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|0086");
+    tagValue = tagValues[EchoNumbersTagIndex];
     if (!tagValue.empty())
       {
       int idx = InsertEchoNumbers( tagValue.c_str() );
@@ -1396,7 +1535,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // diffision gradient orientation
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0010|9089");
+    tagValue = tagValues[DiffusionGradientOrientationTagIndex];
     if (!tagValue.empty())
       {
       float a[3] = { -1 };
@@ -1410,7 +1549,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // slice location
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|1041");
+    tagValue = tagValues[SliceLocationTagIndex];
     if (!tagValue.empty())
       {
       float a = -1;
@@ -1424,7 +1563,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // image orientation patient
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0037");
+    tagValue = tagValues[ImageOrientationPatientTagIndex];
     if (!tagValue.empty())
       {
       float a[6] = { -1 };
@@ -1437,7 +1576,7 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       this->IndexImageOrientationPatient[f] = -1;
       }
     // image position patient
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0032");
+    tagValue = tagValues[ImagePositionPatientTagIndex];
     if (!tagValue.empty())
       {
       float a[3] = { -1 };
@@ -1458,6 +1597,123 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
 #endif
 }
 
+//----------------------------------------------------------------------------
+void vtkITKArchetypeImageSeriesReader::ReadDicomTagValues(std::vector<std::vector<std::string> >& fileTagValues)
+{
+  int nFiles = this->AllFileNames.size();
+  fileTagValues.assign(nFiles, std::vector<std::string>(NumberOfAnalyzedDicomTags));
+
+#ifdef VTKITK_BUILD_DICOM_SUPPORT
+  // Get tag values of unchanged files from the cache
+  DicomHeaderCacheType cache;
+  std::vector<long int> modifiedTimes(nFiles, 0);
+  std::vector<unsigned long> fileSizes(nFiles, 0);
+  std::vector<int> filesToRead;
+  const bool useCache = !this->HeaderCacheFileName.empty();
+  if (useCache)
+    {
+    ReadDicomHeaderCache(this->HeaderCacheFileName, cache);
+    }
+  for (int f = 0; f < nFiles; f++)
+    {
+    if (!useCache)
+      {
+      filesToRead.push_back(f);
+      continue;
+      }
+    const std::string& fileName = this->AllFileNames[f];
+    modifiedTimes[f] = itksys::SystemTools::ModifiedTime(fileName);
+    fileSizes[f] = itksys::SystemTools::FileLength(fileName);
+    DicomHeaderCacheType::const_iterator cacheIt = cache.find(fileName);
+    if (cacheIt != cache.end()
+      && cacheIt->second.ModifiedTime == modifiedTimes[f]
+      && cacheIt->second.FileSize == fileSizes[f])
+      {
+      fileTagValues[f] = cacheIt->second.TagValues;
+      }
+    else
+      {
+      filesToRead.push_back(f);
+      }
+    }
+
+  // Parse headers of the remaining files concurrently. Each work unit uses its own ImageIO.
+  std::exception_ptr readException;
+  std::mutex readExceptionMutex;
+  itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+  if (this->NumberOfThreads > 0)
+    {
+    threader->SetMaximumNumberOfThreads(this->NumberOfThreads);
+    threader->SetNumberOfWorkUnits(this->NumberOfThreads);
+    }
+  threader->ParallelizeArray(0, filesToRead.size(), [&](itk::SizeValueType i)
+    {
+    int f = filesToRead[i];
+    try
+      {
+      itk::GDCMImageIO::Pointer gdcmIO = itk::GDCMImageIO::New();
+      gdcmIO->SetFileName(this->AllFileNames[f]);
+      gdcmIO->ReadImageInformation();
+      const itk::MetaDataDictionary& dict = gdcmIO->GetMetaDataDictionary();
+      for (int tagIndex = 0; tagIndex < NumberOfAnalyzedDicomTags; ++tagIndex)
+        {
+        // Use vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces to remove extra spaces
+        // from the DICOM tag, because extra spaces were found in some DICOM file before/after the
+        // multi-value separator backslashes.
+        fileTagValues[f][tagIndex] = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, AnalyzedDicomTags[tagIndex]);
+        }
+      }
+    catch (...)
+      {
+      std::lock_guard<std::mutex> lock(readExceptionMutex);
+      if (!readException)
+        {
+        readException = std::current_exception();
+        }
+      }
+    }, nullptr);
+  if (readException)
+    {
+    std::rethrow_exception(readException);
+    }
+
+  // Drop cache entries of files that are no longer in the series
+  bool cacheModified = !filesToRead.empty();
+  if (useCache && cache.size() > static_cast<size_t>(nFiles - filesToRead.size()))
+    {
+    std::set<std::string> currentFileNames(this->AllFileNames.begin(), this->AllFileNames.end());
+    for (DicomHeaderCacheType::iterator cacheIt = cache.begin(); cacheIt != cache.end();)
+      {
+      if (currentFileNames.find(cacheIt->first) == currentFileNames.end())
+        {
+        cacheIt = cache.erase(cacheIt);
+        cacheModified = true;
+        }
+      else
+        {
+        ++cacheIt;
+        }
+      }
+    }
+
+  // Store newly parsed headers in the cache
+  if (useCache && cacheModified)
+    {
+    for (int f : filesToRead)
+      {
+      DicomHeaderCacheEntry& entry = cache[this->AllFileNames[f]];
+      entry.ModifiedTime = modifiedTimes[f];
+      entry.FileSize = fileSizes[f];
+      entry.TagValues = fileTagValues[f];
+      }
+    if (!WriteDicomHeaderCache(this->HeaderCacheFileName, cache))
+      {
+      vtkWarningMacro("ReadDicomTagValues: Failed to write DICOM header cache " << this->HeaderCacheFileName);
+      }
+    }
+#endif
+}
+
 //----------------------------------------------------------------------------
 const itk::MetaDataDictionary&
 vtkITKArchetypeImageSeriesReader
@@ -246,6 +246,31 @@ public:
   vtkSetMacro(AnalyzeHeader, bool);
   vtkGetMacro(AnalyzeHeader, bool);
 
+  ///
+  /// Full path of a file that caches the DICOM tags used for grouping files.
+  /// Entries are keyed by file path and are reused as long as the modification
+  /// time and size of the file are unchanged, which makes analyzing the headers
+  /// of a series that has been loaded before much faster.
+  /// If empty (default) then no cache is used.
+  vtkSetMacro(HeaderCacheFileName, std::string);
+  vtkGetMacro(HeaderCacheFileName, std::string);
+
+  ///
+  /// Maximum number of threads used for reading files.
+  /// If 0 (default) then the ITK default number of threads is used.
+  vtkSetMacro(NumberOfThreads, int);
+  vtkGetMacro(NumberOfThreads, int);
+
+  ///
+  /// If enabled then the files of a series are decoded concurrently
+  /// (using up to NumberOfThreads threads), each directly into its slice
+  /// of the output volume. Only used if each file contains a single slice,
+  /// other series are read serially.
+  /// Enabled by default.
+  vtkSetMacro(ParallelSliceReading, bool);
+  vtkGetMacro(ParallelSliceReading, bool);
+  vtkBooleanMacro(ParallelSliceReading, bool);
+
   ///
   /// Whether to use orientation from file
   vtkSetMacro(UseOrientationFromFile, int);
@@ -810,6 +835,11 @@ protected:
   /// Get MetaData from dictionary, removing all whitespaces from the string.
   static std::string GetMetaDataWithoutSpaces(const itk::MetaDataDictionary &dict, const std::string& tag);
 
+  /// Get the values of the DICOM tags used for grouping (see AnalyzeDicomHeaders)
+  /// for each file in AllFileNames. Values are taken from the header cache
+  /// if possible, the remaining files are read concurrently.
+  void ReadDicomTagValues(std::vector<std::vector<std::string> >& fileTagValues);
+
   /// Get the image IO for the specified filename
   itk::ImageIOBase::Pointer GetImageIO(const char* filename);
 
@@ -879,6 +909,9 @@ protected:
 
   std::vector<std::string> AllFileNames;
   bool AnalyzeHeader;
+  std::string HeaderCacheFileName;
+  int NumberOfThreads;
+  bool ParallelSliceReading;
   bool IsOnlyFile;
   bool ArchetypeIsDICOM;
 
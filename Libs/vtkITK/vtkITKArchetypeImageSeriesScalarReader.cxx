@@ -30,6 +30,9 @@
 // ITK includes
 #include <itkOrientImageFilter.h>
 #include <itkImageSeriesReader.h>
+
+// vtkITK includes
+#include "vtkITKParallelSeriesReading.h"
 #ifdef VTKITK_BUILD_DICOM_SUPPORT
 #include <itkDCMTKImageIO.h>
 #include <itkGDCMImageIO.h>
@@ -132,23 +135,44 @@ int vtkITKArchetypeImageSeriesScalarReader::RequestData(
       reader##typeN->AddObserver(itk::ProgressEvent(),pcl); \
       reader##typeN->SetFileNames(this->FileNames); \
       reader##typeN->ReleaseDataFlagOn(); \
+      image##typeN::Pointer parallelImage##typeN; \
+      if (this->ParallelSliceReading) \
+        { \
+        parallelImage##typeN = vtkITKReadSeriesInParallel<image##typeN>(reader##typeN, this->NumberOfThreads); \
+        } \
+      image##typeN::Pointer outputImage##typeN; \
       if (this->UseNativeCoordinateOrientation) \
         { \
         filter = reader##typeN; \
+        if (parallelImage##typeN) \
+          { \
+          outputImage##typeN = parallelImage##typeN; \
+          } \
         } \
       else \
         { \
         itk::OrientImageFilter<image##typeN,image##typeN>::Pointer orient##typeN = \
             itk::OrientImageFilter<image##typeN,image##typeN>::New(); \
         if (this->Debug) {orient##typeN->DebugOn();} \
-        orient##typeN->SetInput(reader##typeN->GetOutput()); \
+        if (parallelImage##typeN) \
+          { \
+          orient##typeN->SetInput(parallelImage##typeN); \
+          } \
+        else \
+          { \
+          orient##typeN->SetInput(reader##typeN->GetOutput()); \
+          } \
         orient##typeN->UseImageDirectionOn(); \
         orient##typeN->SetDesiredCoordinateOrientation(this->DesiredCoordinateOrientation); \
         filter = orient##typeN; \
         }\
-      filter->UpdateLargestPossibleRegion(); \
+      if (!outputImage##typeN) \
+        { \
+        filter->UpdateLargestPossibleRegion(); \
+        outputImage##typeN = filter->GetOutput(); \
+        } \
       itk::ImportImageContainer<itk::SizeValueType, type>::Pointer PixelContainer##typeN;\
-      PixelContainer##typeN = filter->GetOutput()->GetPixelContainer();\
+      PixelContainer##typeN = outputImage##typeN->GetPixelContainer();\
       void *ptr = static_cast<void *> (PixelContainer##typeN->GetBufferPointer());\
       DownCast<type>(data->GetPointData()->GetScalars())                \
         ->SetVoidArray(ptr, PixelContainer##typeN->Size(), 0,\
@@ -9,6 +9,7 @@
 
 // VTKITK includes
 #include "vtkITKArchetypeImageSeriesVectorReaderSeries.h"
+#include "vtkITKParallelSeriesReading.h"
 
 // VTK includes
 #include <vtkAOSDataArrayTemplate.h>
@@ -72,6 +73,7 @@ void vtkITKExecuteDataFromSeriesVector(
   itk::CStyleCommand::Pointer pcl=itk::CStyleCommand::New();
   pcl->SetCallback((itk::CStyleCommand::FunctionPointer)&self->ReadProgressCallback);
   pcl->SetClientData(self);
+  reader->AddObserver(itk::ProgressEvent(),pcl);
   reader->SetFileNames(self->GetFileNames());
   reader->ReleaseDataFlagOn();
   reader->GetOutput()->SetVectorLength(3);
@@ -92,24 +94,42 @@ void vtkITKExecuteDataFromSeriesVector(
     vtkErrorWithObjectMacro(self, <<"vtkITKArchetypeImageSeriesVectorReaderSeries: Unsupported DICOMImageIOApproach: " << self->GetDICOMImageIOApproach());
     itkGenericExceptionMacro("UnrecognizedFileTypeError");
     }
+  typename image::Pointer parallelImage;
+  if (self->GetParallelSliceReading())
+    {
+    parallelImage = vtkITKReadSeriesInParallel<image>(reader, self->GetNumberOfThreads());
+    }
+  typename image::Pointer outputImage;
   if (self->GetUseNativeCoordinateOrientation())
     {
     filter = reader;
+    outputImage = parallelImage;
     }
   else
     {
     typename itk::OrientImageFilter<image,image>::Pointer orient =
         itk::OrientImageFilter<image,image>::New();
     orient->SetDebug(self->GetDebug());
-    orient->SetInput(reader->GetOutput());
+    if (parallelImage)
+      {
+      orient->SetInput(parallelImage);
+      }
+    else
+      {
+      orient->SetInput(reader->GetOutput());
+      }
     orient->UseImageDirectionOn();
     orient->SetDesiredCoordinateOrientation(
       self->GetDesiredCoordinateOrientation());
     filter = orient;
     }
-  filter->UpdateLargestPossibleRegion();
+  if (!outputImage)
+    {
+    filter->UpdateLargestPossibleRegion();
+    outputImage = filter->GetOutput();
+    }
   typename itk::ImportImageContainer<itk::SizeValueType, VectorPixelType>::Pointer PixelContainer;
-  PixelContainer = filter->GetOutput()->GetPixelContainer();
+  PixelContainer = outputImage->GetPixelContainer();
   void *ptr = static_cast<void *> (PixelContainer->GetBufferPointer());
   DownCast<T>(data->GetPointData()->GetScalars())
     ->SetVoidArray(ptr, PixelContainer->Size(), 0,
@@ -0,0 +1,155 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   vtkITK
+
+==========================================================================*/
+
+#ifndef __vtkITKParallelSeriesReading_h
+#define __vtkITKParallelSeriesReading_h
+
+// ITK includes
+#include <itkImageFileReader.h>
+#include <itkImageIOBase.h>
+#include <itkImageIOFactory.h>
+#include <itkImageSeriesReader.h>
+#include <itkMultiThreaderBase.h>
+
+// STD includes
+#include <algorithm>
+#include <exception>
+#include <mutex>
+
+/// \brief Read the files of an image series concurrently.
+///
+/// Each file must contain a single slice. Slices are decoded on the ITK thread pool
+/// directly into their z-offset in the output buffer if the pixel type of the file
+/// matches the output pixel type, otherwise the slice is read with an image file
+/// reader (that converts the pixel type) and copied into place.
+///
+/// Geometry (origin, spacing, direction) is computed by \a seriesReader the same
+/// way as for serial reading. If no ImageIO is set in \a seriesReader then the
+/// ImageIO is selected automatically from the first file, as the series reader does.
+/// Returns nullptr if the series cannot be read this way (e.g., files contain
+/// multiple slices), in this case \a seriesReader can be used for reading the
+/// series serially.
+///
+/// Files are read in batches and progress events of \a seriesReader are invoked
+/// from the calling thread after each batch, so that observers of the series reader
+/// report progress the same way as for serial reading.
+///
+/// \a numberOfThreads limits the number of concurrently decoded files,
+/// 0 means ITK default.
+template <class TImage>
+typename TImage::Pointer vtkITKReadSeriesInParallel(itk::ImageSeriesReader<TImage>* seriesReader, int numberOfThreads)
+{
+  typedef typename TImage::InternalPixelType ComponentType;
+
+  seriesReader->UpdateOutputInformation();
+  TImage* outputInformation = seriesReader->GetOutput();
+  const typename TImage::RegionType region = outputInformation->GetLargestPossibleRegion();
+  const std::vector<std::string>& fileNames = seriesReader->GetFileNames();
+  if (fileNames.size() < 2 || region.GetSize()[2] != fileNames.size()
+    || seriesReader->GetReverseOrder())
+    {
+    return nullptr;
+    }
+  itk::ImageIOBase::Pointer prototypeImageIO = seriesReader->GetImageIO();
+  if (!prototypeImageIO)
+    {
+    prototypeImageIO = itk::ImageIOFactory::CreateImageIO(fileNames[0].c_str(), itk::ImageIOFactory::ReadMode);
+    if (!prototypeImageIO)
+      {
+      return nullptr;
+      }
+    }
+
+  typename TImage::Pointer image = TImage::New();
+  image->CopyInformation(outputInformation);
+  image->SetNumberOfComponentsPerPixel(outputInformation->GetNumberOfComponentsPerPixel());
+  image->SetRegions(region);
+  image->Allocate();
+
+  const itk::SizeValueType numberOfComponents = image->GetNumberOfComponentsPerPixel();
+  const itk::SizeValueType slicePixelCount = region.GetSize()[0] * region.GetSize()[1];
+  const itk::SizeValueType sliceValueCount = slicePixelCount * numberOfComponents;
+  ComponentType* buffer = reinterpret_cast<ComponentType*>(image->GetBufferPointer());
+
+  std::exception_ptr readException;
+  std::mutex readExceptionMutex;
+  itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+  if (numberOfThreads > 0)
+    {
+    threader->SetMaximumNumberOfThreads(numberOfThreads);
+    threader->SetNumberOfWorkUnits(numberOfThreads);
+    }
+  const itk::SizeValueType numberOfSlices = fileNames.size();
+  const itk::SizeValueType batchSize = std::max<itk::SizeValueType>(
+    numberOfSlices / 10, 4 * threader->GetNumberOfWorkUnits());
+  seriesReader->UpdateProgress(0.0f);
+  for (itk::SizeValueType batchStart = 0; batchStart < numberOfSlices && !readException; batchStart += batchSize)
+    {
+    const itk::SizeValueType batchEnd = std::min(batchStart + batchSize, numberOfSlices);
+    threader->ParallelizeArray(batchStart, batchEnd, [&](itk::SizeValueType sliceIndex)
+      {
+      try
+        {
+        ComponentType* sliceBuffer = buffer + sliceIndex * sliceValueCount;
+        itk::ImageIOBase::Pointer imageIO = dynamic_cast<itk::ImageIOBase*>(prototypeImageIO->CreateAnother().GetPointer());
+        imageIO->SetFileName(fileNames[sliceIndex]);
+        imageIO->ReadImageInformation();
+        if (imageIO->GetComponentType() == itk::ImageIOBase::MapPixelType<ComponentType>::CType
+          && imageIO->GetNumberOfComponents() == numberOfComponents
+          && imageIO->GetImageSizeInPixels() == slicePixelCount)
+          {
+          // decode straight into the output buffer
+          itk::ImageIORegion ioRegion(imageIO->GetNumberOfDimensions());
+          for (unsigned int dim = 0; dim < imageIO->GetNumberOfDimensions(); ++dim)
+            {
+            ioRegion.SetIndex(dim, 0);
+            ioRegion.SetSize(dim, imageIO->GetDimensions(dim));
+            }
+          imageIO->SetIORegion(ioRegion);
+          imageIO->Read(sliceBuffer);
+          return;
+          }
+
+        // pixel type conversion is needed
+        typename itk::ImageFileReader<TImage>::Pointer sliceReader = itk::ImageFileReader<TImage>::New();
+        sliceReader->SetImageIO(imageIO);
+        sliceReader->SetFileName(fileNames[sliceIndex]);
+        sliceReader->Update();
+        TImage* slice = sliceReader->GetOutput();
+        if (slice->GetLargestPossibleRegion().GetNumberOfPixels() != slicePixelCount
+          || slice->GetNumberOfComponentsPerPixel() != numberOfComponents)
+          {
+          itkGenericExceptionMacro("Size of " << fileNames[sliceIndex] << " does not match the size of the first slice");
+          }
+        const ComponentType* sliceData = reinterpret_cast<const ComponentType*>(slice->GetBufferPointer());
+        std::copy(sliceData, sliceData + sliceValueCount, sliceBuffer);
+        }
+      catch (...)
+        {
+        std::lock_guard<std::mutex> lock(readExceptionMutex);
+        if (!readException)
+          {
+          readException = std::current_exception();
+          }
+        }
+      }, nullptr);
+    seriesReader->UpdateProgress(static_cast<float>(batchEnd) / numberOfSlices);
+    }
+  if (readException)
+    {
+    std::rethrow_exception(readException);
+    }
+
+  image->SetMetaDataDictionary(outputInformation->GetMetaDataDictionary());
+  return image;
+}
+
+#endif
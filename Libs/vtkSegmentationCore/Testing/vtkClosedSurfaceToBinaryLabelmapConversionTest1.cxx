@@ -0,0 +1,97 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkImageStencil.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataNormals.h>
+#include <vtkPolyDataToImageStencil.h>
+#include <vtkSphereSource.h>
+#include <vtkStripper.h>
+#include <vtkTriangleFilter.h>
+
+// vtkSegmentationCore includes
+#include "vtkClosedSurfaceToBinaryLabelmapConversionRule.h"
+
+//----------------------------------------------------------------------------
+int vtkClosedSurfaceToBinaryLabelmapConversionTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  // Surface in IJK coordinates of the labelmap
+  vtkNew<vtkSphereSource> sphereSource;
+  sphereSource->SetCenter(30.0, 28.5, 31.0);
+  sphereSource->SetRadius(22.0);
+  sphereSource->SetPhiResolution(60);
+  sphereSource->SetThetaResolution(60);
+  sphereSource->Update();
+
+  vtkNew<vtkImageData> labelmap;
+  labelmap->SetExtent(0, 59, 0, 59, 0, 60);
+  labelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  labelmap->GetPointData()->GetScalars()->Fill(0);
+
+  // Reference: serial image stencil
+  vtkNew<vtkPolyDataNormals> normalFilter;
+  normalFilter->SetInputConnection(sphereSource->GetOutputPort());
+  normalFilter->ConsistencyOn();
+  vtkNew<vtkTriangleFilter> triangle;
+  triangle->SetInputConnection(normalFilter->GetOutputPort());
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputConnection(triangle->GetOutputPort());
+  vtkNew<vtkPolyDataToImageStencil> polyDataToImageStencil;
+  polyDataToImageStencil->SetInputConnection(stripper->GetOutputPort());
+  polyDataToImageStencil->SetOutputSpacing(labelmap->GetSpacing());
+  polyDataToImageStencil->SetOutputOrigin(labelmap->GetOrigin());
+  polyDataToImageStencil->SetOutputWholeExtent(labelmap->GetExtent());
+  vtkNew<vtkImageStencil> stencil;
+  stencil->SetInputData(labelmap);
+  stencil->SetStencilConnection(polyDataToImageStencil->GetOutputPort());
+  stencil->ReverseStencilOn();
+  stencil->SetBackgroundValue(5);
+  stencil->Update();
+  vtkImageData* expectedLabelmap = stencil->GetOutput();
+
+  if (!vtkClosedSurfaceToBinaryLabelmapConversionRule::RasterizeClosedSurface(sphereSource->GetOutput(), labelmap, 5))
+    {
+    std::cerr << __LINE__ << ": RasterizeClosedSurface failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const unsigned char* expectedVoxels = static_cast<const unsigned char*>(expectedLabelmap->GetScalarPointer());
+  const unsigned char* voxels = static_cast<const unsigned char*>(labelmap->GetScalarPointer());
+  vtkIdType numberOfFilledVoxels = 0;
+  for (vtkIdType voxelIndex = 0; voxelIndex < labelmap->GetNumberOfPoints(); ++voxelIndex)
+    {
+    if (voxels[voxelIndex] != expectedVoxels[voxelIndex])
+      {
+      std::cerr << __LINE__ << ": Voxel " << voxelIndex << " mismatch: " << static_cast<int>(voxels[voxelIndex])
+                << " (expected " << static_cast<int>(expectedVoxels[voxelIndex]) << ")" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (voxels[voxelIndex] != 0)
+      {
+      ++numberOfFilledVoxels;
+      }
+    }
+  if (numberOfFilledVoxels == 0)
+    {
+    std::cerr << __LINE__ << ": Labelmap is empty" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -36,15 +36,22 @@
 #include <vtkPolyData.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
-#include <vtkImageCast.h>
-#include <vtkImageStencil.h>
+#include <vtkCellArray.h>
+#include <vtkCellArrayIterator.h>
+#include <vtkIdList.h>
+#include <vtkImageStencilData.h>
+#include <vtkPointData.h>
 #include <vtkPolyDataNormals.h>
+#include <vtkSMPTools.h>
 #include <vtkStripper.h>
 #include <vtkTriangleFilter.h>
 #include <vtkPolyDataToImageStencil.h>
 
 // STD includes
+#include <algorithm>
+#include <cmath>
 #include <sstream>
+#include <vector>
 
 int DEFAULT_LABEL_VALUE = 1;
 
@@ -206,9 +213,80 @@ bool vtkClosedSurfaceToBinaryLabelmapConversionRule::Convert(vtkSegment* segment
   transformPolyDataFilter->SetInputData(closedSurfacePolyData);
   transformPolyDataFilter->SetTransform(inverseOutputLabelmapGeometryTransform);
 
+  transformPolyDataFilter->Update();
+  if (!vtkClosedSurfaceToBinaryLabelmapConversionRule::RasterizeClosedSurface(
+    transformPolyDataFilter->GetOutput(), binaryLabelmap, DEFAULT_LABEL_VALUE))
+    {
+    vtkErrorMacro("Convert: Failed to rasterize closed surface!");
+    binaryLabelmap->SetGeometryFromImageToWorldMatrix(outputLabelmapImageToWorldMatrix);
+    return false;
+    }
+
+  // Restore geometry of the labelmap that we set to identity before conversion
+  // (so that we can perform the stencil operations in IJK space)
+  binaryLabelmap->SetGeometryFromImageToWorldMatrix(outputLabelmapImageToWorldMatrix);
+
+  // Set segment value to 1
+  segment->SetLabelValue(DEFAULT_LABEL_VALUE);
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+void FillStencilGeneric(vtkImageStencilData* stencilData, const int extent[6], const int labelmapExtent[6],
+  int numberOfComponents, T* labelmapVoxels, T labelValue)
+{
+  const vtkIdType increments[3] =
+    {
+    numberOfComponents,
+    numberOfComponents * static_cast<vtkIdType>(labelmapExtent[1] - labelmapExtent[0] + 1),
+    numberOfComponents * static_cast<vtkIdType>(labelmapExtent[1] - labelmapExtent[0] + 1)
+      * (labelmapExtent[3] - labelmapExtent[2] + 1)
+    };
+  for (int z = extent[4]; z <= extent[5]; ++z)
+    {
+    for (int y = extent[2]; y <= extent[3]; ++y)
+      {
+      int r1 = 0;
+      int r2 = 0;
+      int iter = 0;
+      while (stencilData->GetNextExtent(r1, r2, extent[0], extent[1], y, z, iter))
+        {
+        T* voxels = labelmapVoxels
+          + (r1 - labelmapExtent[0]) * increments[0]
+          + (y - labelmapExtent[2]) * increments[1]
+          + (z - labelmapExtent[4]) * increments[2];
+        std::fill(voxels, voxels + (r2 - r1 + 1) * increments[0], labelValue);
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkClosedSurfaceToBinaryLabelmapConversionRule::RasterizeClosedSurface(
+  vtkPolyData* closedSurfacePolyData, vtkImageData* labelmap, double labelValue)
+{
+  if (!closedSurfacePolyData || !labelmap || !labelmap->GetPointData()->GetScalars())
+    {
+    vtkGenericWarningMacro("vtkClosedSurfaceToBinaryLabelmapConversionRule::RasterizeClosedSurface: Invalid input");
+    return false;
+    }
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  labelmap->GetExtent(extent);
+  if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+    {
+    // nothing to fill
+    return true;
+    }
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  double spacing[3] = { 1.0, 1.0, 1.0 };
+  labelmap->GetOrigin(origin);
+  labelmap->GetSpacing(spacing);
+
   // Compute polydata normals
   vtkNew<vtkPolyDataNormals> normalFilter;
-  normalFilter->SetInputConnection(transformPolyDataFilter->GetOutputPort());
+  normalFilter->SetInputData(closedSurfacePolyData);
   normalFilter->ConsistencyOn();
 
   // Make sure that we have a clean triangle polydata
@@ -216,38 +294,131 @@ bool vtkClosedSurfaceToBinaryLabelmapConversionRule::Convert(vtkSegment* segment
   triangle->SetInputConnection(normalFilter->GetOutputPort());
 
   // Convert to triangle strip
-  vtkSmartPointer<vtkStripper> stripper=vtkSmartPointer<vtkStripper>::New();
+  vtkNew<vtkStripper> stripper;
   stripper->SetInputConnection(triangle->GetOutputPort());
+  stripper->Update();
+  vtkPolyData* strippedPolyData = stripper->GetOutput();
+  vtkPoints* points = strippedPolyData->GetPoints();
+  if (!points || points->GetNumberOfPoints() == 0)
+    {
+    return true;
+    }
+  // bounds are cached in the points, compute them before the points are shared between threads
+  points->GetBounds();
+
+  // The stencil is computed by cutting polygons and strips, or by selecting lines if there are
+  // no polygons and strips. Cell arrays are listed in cell id order.
+  const bool hasPolygons = (strippedPolyData->GetNumberOfPolys() > 0 || strippedPolyData->GetNumberOfStrips() > 0);
+  std::vector<vtkCellArray*> cellArrays;
+  cellArrays.push_back(strippedPolyData->GetLines());
+  if (hasPolygons)
+    {
+    cellArrays.push_back(strippedPolyData->GetPolys());
+    cellArrays.push_back(strippedPolyData->GetStrips());
+    }
 
-  // Convert polydata to stencil
-  vtkNew<vtkPolyDataToImageStencil> polyDataToImageStencil;
-  polyDataToImageStencil->SetInputConnection(stripper->GetOutputPort());
-  polyDataToImageStencil->SetOutputSpacing(binaryLabelmap->GetSpacing());
-  polyDataToImageStencil->SetOutputOrigin(binaryLabelmap->GetOrigin());
-  polyDataToImageStencil->SetOutputWholeExtent(binaryLabelmap->GetExtent());
-
-  // Convert stencil to image
-  vtkNew<vtkImageStencil> stencil;
-  stencil->SetInputData(binaryLabelmap);
-  stencil->SetStencilConnection(polyDataToImageStencil->GetOutputPort());
-  stencil->ReverseStencilOn();
-  // If the output labelmap was to required to be unsigned char, we could use the segment label value.
-  // To ensure that the label value is < 255, we set it to 1. Collapsing the labelmaps during post-conversion may assign new a value regardless.
-  stencil->SetBackgroundValue(DEFAULT_LABEL_VALUE); // General foreground value is 1 (background value because of reverse stencil)
-
-  // Save result to output
-  vtkNew<vtkImageCast> imageCast;
-  imageCast->SetInputConnection(stencil->GetOutputPort());
-  imageCast->SetOutputScalarTypeToUnsignedChar();
-  imageCast->Update();
-  binaryLabelmap->ShallowCopy(imageCast->GetOutput());
-
-  // Restore geometry of the labelmap that we set to identity before conversion
-  // (so that we can perform the stencil operations in IJK space)
-  binaryLabelmap->SetGeometryFromImageToWorldMatrix(outputLabelmapImageToWorldMatrix);
+  // Each slice of the stencil only depends on the cells that intersect it, therefore
+  // a slab of slices can be computed from the cells that intersect the slab (with a margin
+  // of one slice) and the result is the same as for the whole volume.
+  // Assigning the cells to slabs also avoids cutting every cell with every slice.
+  const int numberOfSlices = extent[5] - extent[4] + 1;
+  const int slicesPerSlab = std::max(1, std::min(8, numberOfSlices / (4 * vtkSMPTools::GetEstimatedNumberOfThreads())));
+  const int numberOfSlabs = (numberOfSlices + slicesPerSlab - 1) / slicesPerSlab;
+  std::vector<std::vector<std::vector<vtkIdType> > > slabCellIds(numberOfSlabs,
+    std::vector<std::vector<vtkIdType> >(cellArrays.size()));
+  for (size_t cellArrayIndex = 0; cellArrayIndex < cellArrays.size(); ++cellArrayIndex)
+    {
+    vtkSmartPointer<vtkCellArrayIterator> cellIterator = vtk::TakeSmartPointer(cellArrays[cellArrayIndex]->NewIterator());
+    for (cellIterator->GoToFirstCell(); !cellIterator->IsDoneWithTraversal(); cellIterator->GoToNextCell())
+      {
+      vtkIdType numberOfCellPoints = 0;
+      const vtkIdType* cellPointIds = nullptr;
+      cellIterator->GetCurrentCell(numberOfCellPoints, cellPointIds);
+      if (numberOfCellPoints == 0)
+        {
+        continue;
+        }
+      double point[3] = { 0.0, 0.0, 0.0 };
+      points->GetPoint(cellPointIds[0], point);
+      double zMin = point[2];
+      double zMax = point[2];
+      for (vtkIdType i = 1; i < numberOfCellPoints; ++i)
+        {
+        points->GetPoint(cellPointIds[i], point);
+        zMin = std::min(zMin, point[2]);
+        zMax = std::max(zMax, point[2]);
+        }
+      const int firstSlice = std::max(extent[4], static_cast<int>(std::floor((zMin - origin[2]) / spacing[2])) - 1);
+      const int lastSlice = std::min(extent[5], static_cast<int>(std::ceil((zMax - origin[2]) / spacing[2])) + 1);
+      if (firstSlice > lastSlice)
+        {
+        continue;
+        }
+      for (int slab = (firstSlice - extent[4]) / slicesPerSlab; slab <= (lastSlice - extent[4]) / slicesPerSlab; ++slab)
+        {
+        slabCellIds[slab][cellArrayIndex].push_back(cellIterator->GetCurrentCellId());
+        }
+      }
+    }
 
-  // Set segment value to 1
-  segment->SetLabelValue(DEFAULT_LABEL_VALUE);
+  void* labelmapVoxels = labelmap->GetScalarPointerForExtent(extent);
+  const int numberOfComponents = labelmap->GetNumberOfScalarComponents();
+  const int scalarType = labelmap->GetScalarType();
+  vtkSMPTools::For(0, numberOfSlabs, [&](vtkIdType firstSlab, vtkIdType lastSlab)
+    {
+    vtkNew<vtkIdList> cellPointIds;
+    for (vtkIdType slab = firstSlab; slab < lastSlab; ++slab)
+      {
+      int slabExtent[6] = { extent[0], extent[1], extent[2], extent[3],
+        extent[4] + static_cast<int>(slab) * slicesPerSlab, 0 };
+      slabExtent[5] = std::min(extent[5], slabExtent[4] + slicesPerSlab - 1);
+
+      size_t numberOfSlabPolygons = 0;
+      for (size_t cellArrayIndex = 1; cellArrayIndex < cellArrays.size(); ++cellArrayIndex)
+        {
+        numberOfSlabPolygons += slabCellIds[slab][cellArrayIndex].size();
+        }
+      if (hasPolygons && numberOfSlabPolygons == 0)
+        {
+        // no surface in this slab
+        continue;
+        }
+
+      // cells are copied in their original order, so that the cut of each slice is the same as
+      // for the whole surface, points are shared
+      vtkNew<vtkPolyData> slabPolyData;
+      slabPolyData->SetPoints(points);
+      for (size_t cellArrayIndex = 0; cellArrayIndex < cellArrays.size(); ++cellArrayIndex)
+        {
+        vtkNew<vtkCellArray> slabCells;
+        for (vtkIdType cellId : slabCellIds[slab][cellArrayIndex])
+          {
+          cellArrays[cellArrayIndex]->GetCellAtId(cellId, cellPointIds);
+          slabCells->InsertNextCell(cellPointIds);
+          }
+        switch (cellArrayIndex)
+          {
+          case 0: slabPolyData->SetLines(slabCells); break;
+          case 1: slabPolyData->SetPolys(slabCells); break;
+          default: slabPolyData->SetStrips(slabCells); break;
+          }
+        }
+
+      // Convert polydata to stencil
+      vtkNew<vtkPolyDataToImageStencil> polyDataToImageStencil;
+      polyDataToImageStencil->SetInputData(slabPolyData);
+      polyDataToImageStencil->SetOutputSpacing(spacing);
+      polyDataToImageStencil->SetOutputOrigin(origin);
+      polyDataToImageStencil->SetOutputWholeExtent(slabExtent);
+      polyDataToImageStencil->Update();
+
+      switch (scalarType)
+        {
+        vtkTemplateMacro(FillStencilGeneric<VTK_TT>(polyDataToImageStencil->GetOutput(), slabExtent, extent,
+          numberOfComponents, static_cast<VTK_TT*>(labelmapVoxels), static_cast<VTK_TT>(labelValue)));
+        }
+      }
+    });
 
   return true;
 }
@@ -27,6 +27,7 @@
 
 #include "vtkSegmentationCoreConfigure.h"
 
+class vtkImageData;
 class vtkPolyData;
 
 /// \ingroup SegmentationCore
@@ -83,6 +84,14 @@ public:
 
   vtkSetMacro(UseOutputImageDataGeometry, bool);
 
+  /// Set the voxels of \a labelmap that are inside \a closedSurfacePolyData to \a labelValue.
+  /// Other voxels are not changed. Directions of the labelmap are ignored, therefore the surface
+  /// is typically transformed into the IJK coordinate system of the labelmap first.
+  /// Slabs of slices are rasterized concurrently (using vtkSMPTools) with the same image stencil
+  /// scanline algorithm as the serial conversion, therefore the result does not depend on the
+  /// number of threads. This is used by the conversion rule and by the ModelToLabelMap CLI module.
+  static bool RasterizeClosedSurface(vtkPolyData* closedSurfacePolyData, vtkImageData* labelmap, double labelValue);
+
 protected:
   /// Calculate actual geometry of the output labelmap volume by verifying that the reference image geometry
   /// encompasses the input surface model, and extending it to the proper directions if necessary.
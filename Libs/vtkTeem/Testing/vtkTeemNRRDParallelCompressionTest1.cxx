@@ -0,0 +1,158 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkTeemNRRDGzipBlocks.h>
+#include <vtkTeemNRRDReader.h>
+#include <vtkTeemNRRDWriter.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkShortArray.h>
+
+// Teem includes
+#include <teem/nrrd.h>
+
+// STD includes
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool TestRoundTrip(const std::string& fileName, bool parallelCompression)
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(64, 48, 40);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  vtkIdType numberOfVoxels = image->GetNumberOfPoints();
+  for (vtkIdType i = 0; i < numberOfVoxels; ++i)
+    {
+    voxels[i] = static_cast<short>((i * 7) % 1000 - 500);
+    }
+
+  vtkNew<vtkTeemNRRDWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetInputData(image);
+  writer->SetUseCompression(true);
+  writer->SetParallelCompression(parallelCompression);
+  // small blocks to make sure the image is split into many blocks
+  writer->SetCompressionBlockSize(65536);
+  writer->Write();
+  if (writer->GetWriteError())
+    {
+    std::cerr << "Failed to write " << fileName << std::endl;
+    return false;
+    }
+
+  if (parallelCompression)
+    {
+    // Any NRRD reader decodes the blocks as a regular multi-member gzip stream
+    Nrrd* nrrd = nrrdNew();
+    bool valid = nrrdLoad(nrrd, fileName.c_str(), nullptr) == 0
+      && static_cast<vtkIdType>(nrrdElementNumber(nrrd)) == numberOfVoxels
+      && memcmp(nrrd->data, voxels, numberOfVoxels * sizeof(short)) == 0;
+    nrrd = nrrdNuke(nrrd);
+    if (!valid)
+      {
+      std::cerr << "Teem failed to read " << fileName << std::endl;
+      return false;
+      }
+
+    // Blocks are read from the data file located by Teem
+    Nrrd* header = nrrdNew();
+    NrrdIoState* nio = nrrdIoStateNew();
+    nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
+    valid = nrrdLoad(header, fileName.c_str(), nio) == 0 && nio->dataFile != nullptr;
+    char* layout = valid ? nrrdKeyValueGet(header, vtkTeemNRRDGzipBlocks::GetLayoutKey()) : nullptr;
+    size_t blockSize = 0;
+    std::vector<size_t> compressedBlockSizes;
+    valid = layout && vtkTeemNRRDGzipBlocks::DecodeLayout(layout, blockSize, compressedBlockSizes)
+      && blockSize == 65536 && compressedBlockSizes.size() > 1;
+    free(layout);
+    std::vector<short> blockVoxels(numberOfVoxels);
+    valid = valid && vtkTeemNRRDGzipBlocks::Decompress(nio->dataFile, compressedBlockSizes, blockSize,
+      blockVoxels.data(), numberOfVoxels * sizeof(short));
+    valid = valid && memcmp(blockVoxels.data(), voxels, numberOfVoxels * sizeof(short)) == 0;
+    if (nio->dataFile)
+      {
+      nio->dataFile = airFclose(nio->dataFile);
+      }
+    nio = nrrdIoStateNix(nio);
+    header = nrrdNuke(header);
+    if (!valid)
+      {
+      std::cerr << "Failed to decompress the blocks of " << fileName << std::endl;
+      return false;
+      }
+    }
+
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  vtkImageData* readImage = reader->GetOutput();
+  if (!readImage || readImage->GetNumberOfPoints() != numberOfVoxels
+    || readImage->GetScalarType() != VTK_SHORT)
+    {
+    std::cerr << "Unexpected image read from " << fileName << std::endl;
+    return false;
+    }
+  short* readVoxels = static_cast<short*>(readImage->GetScalarPointer());
+  for (vtkIdType i = 0; i < numberOfVoxels; ++i)
+    {
+    if (readVoxels[i] != voxels[i])
+      {
+      std::cerr << "Voxel mismatch in " << fileName << " at " << i << ": "
+        << readVoxels[i] << " != " << voxels[i] << std::endl;
+      return false;
+      }
+    }
+  if (reader->GetHeaderValue("SlicerGzipBlocks") != nullptr)
+    {
+    std::cerr << "Block layout must not be exposed as header key" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkTeemNRRDParallelCompressionTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = argv[1];
+
+  if (!TestRoundTrip(tempDir + "/vtkTeemNRRDParallelCompressionTest1.nrrd", true)
+    || !TestRoundTrip(tempDir + "/vtkTeemNRRDParallelCompressionTest1.nhdr", true)
+    || !TestRoundTrip(tempDir + "/vtkTeemNRRDParallelCompressionTest1_serial.nrrd", false))
+    {
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
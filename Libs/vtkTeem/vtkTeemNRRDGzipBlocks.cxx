@@ -0,0 +1,189 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include "vtkTeemNRRDGzipBlocks.h"
+
+// VTK includes
+#include <vtkSMPTools.h>
+#include <vtk_zlib.h>
+
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+
+//----------------------------------------------------------------------------
+const char* vtkTeemNRRDGzipBlocks::GetLayoutKey()
+{
+  return "SlicerGzipBlocks";
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDGzipBlocks::Compress(const void* data, size_t dataSize, size_t blockSize, int level,
+  std::vector<std::string>& compressedBlocks)
+{
+  compressedBlocks.clear();
+  if (!data || blockSize == 0)
+    {
+    return false;
+    }
+  const size_t numberOfBlocks = (dataSize + blockSize - 1) / blockSize;
+  compressedBlocks.resize(numberOfBlocks);
+
+  std::atomic<bool> success(true);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(numberOfBlocks), [&](vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType blockIndex = begin; blockIndex < end && success; ++blockIndex)
+      {
+      const size_t blockOffset = static_cast<size_t>(blockIndex) * blockSize;
+      const size_t currentBlockSize = std::min(blockSize, dataSize - blockOffset);
+
+      z_stream stream = {};
+      // windowBits + 16 writes a gzip header and trailer instead of a zlib wrapper
+      if (deflateInit2(&stream, level, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+        success = false;
+        return;
+        }
+      std::string& compressedBlock = compressedBlocks[blockIndex];
+      compressedBlock.resize(deflateBound(&stream, static_cast<uLong>(currentBlockSize)));
+      stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(static_cast<const char*>(data) + blockOffset));
+      stream.avail_in = static_cast<uInt>(currentBlockSize);
+      stream.next_out = reinterpret_cast<Bytef*>(&compressedBlock[0]);
+      stream.avail_out = static_cast<uInt>(compressedBlock.size());
+      if (deflate(&stream, Z_FINISH) != Z_STREAM_END)
+        {
+        success = false;
+        }
+      compressedBlock.resize(stream.total_out);
+      deflateEnd(&stream);
+      }
+    });
+  return success;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDGzipBlocks::Decompress(FILE* file, const std::vector<size_t>& compressedBlockSizes,
+  size_t blockSize, void* data, size_t dataSize)
+{
+  if (!file || !data || blockSize == 0)
+    {
+    return false;
+    }
+  const size_t numberOfBlocks = (dataSize + blockSize - 1) / blockSize;
+  if (compressedBlockSizes.size() != numberOfBlocks)
+    {
+    return false;
+    }
+
+  // Only a batch of compressed blocks is held in memory at a time. A batch
+  // is large enough to keep all the threads busy.
+  const size_t maximumBatchSize = 64 * 1024 * 1024;
+  std::vector<char> batch;
+  std::vector<size_t> batchBlockOffsets;
+  size_t firstBlockIndex = 0;
+  while (firstBlockIndex < numberOfBlocks)
+    {
+    size_t batchSize = 0;
+    size_t endBlockIndex = firstBlockIndex;
+    batchBlockOffsets.clear();
+    while (endBlockIndex < numberOfBlocks
+      && (endBlockIndex == firstBlockIndex || batchSize + compressedBlockSizes[endBlockIndex] <= maximumBatchSize))
+      {
+      batchBlockOffsets.push_back(batchSize);
+      batchSize += compressedBlockSizes[endBlockIndex];
+      ++endBlockIndex;
+      }
+    batch.resize(batchSize);
+    if (fread(batch.data(), 1, batchSize, file) != batchSize)
+      {
+      return false;
+      }
+
+    std::atomic<bool> success(true);
+    vtkSMPTools::For(static_cast<vtkIdType>(firstBlockIndex), static_cast<vtkIdType>(endBlockIndex),
+      [&](vtkIdType begin, vtkIdType end)
+      {
+      for (vtkIdType blockIndex = begin; blockIndex < end && success; ++blockIndex)
+        {
+        const size_t blockOffset = static_cast<size_t>(blockIndex) * blockSize;
+        const size_t currentBlockSize = std::min(blockSize, dataSize - blockOffset);
+
+        z_stream stream = {};
+        if (inflateInit2(&stream, MAX_WBITS + 16) != Z_OK)
+          {
+          success = false;
+          return;
+          }
+        stream.next_in = reinterpret_cast<Bytef*>(batch.data() + batchBlockOffsets[blockIndex - firstBlockIndex]);
+        stream.avail_in = static_cast<uInt>(compressedBlockSizes[blockIndex]);
+        stream.next_out = reinterpret_cast<Bytef*>(static_cast<char*>(data) + blockOffset);
+        stream.avail_out = static_cast<uInt>(currentBlockSize);
+        if (inflate(&stream, Z_FINISH) != Z_STREAM_END || stream.total_out != currentBlockSize)
+          {
+          success = false;
+          }
+        inflateEnd(&stream);
+        }
+      });
+    if (!success)
+      {
+      return false;
+      }
+    firstBlockIndex = endBlockIndex;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDGzipBlocks::Write(FILE* file, const std::vector<std::string>& compressedBlocks)
+{
+  if (!file)
+    {
+    return false;
+    }
+  for (const std::string& compressedBlock : compressedBlocks)
+    {
+    if (fwrite(compressedBlock.data(), 1, compressedBlock.size(), file) != compressedBlock.size())
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkTeemNRRDGzipBlocks::EncodeLayout(size_t blockSize, const std::vector<std::string>& compressedBlocks)
+{
+  std::ostringstream layout;
+  layout << blockSize;
+  for (const std::string& compressedBlock : compressedBlocks)
+    {
+    layout << " " << compressedBlock.size();
+    }
+  return layout.str();
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDGzipBlocks::DecodeLayout(const std::string& layout, size_t& blockSize, std::vector<size_t>& compressedBlockSizes)
+{
+  compressedBlockSizes.clear();
+  std::istringstream layoutStream(layout);
+  if (!(layoutStream >> blockSize) || blockSize == 0)
+    {
+    return false;
+    }
+  size_t compressedBlockSize = 0;
+  while (layoutStream >> compressedBlockSize)
+    {
+    compressedBlockSizes.push_back(compressedBlockSize);
+    }
+  return layoutStream.eof() && !compressedBlockSizes.empty();
+}
@@ -0,0 +1,62 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+==============================================================================*/
+
+#ifndef __vtkTeemNRRDGzipBlocks_h
+#define __vtkTeemNRRDGzipBlocks_h
+
+#include "vtkTeemConfigure.h"
+
+// STD includes
+#include <cstdio>
+#include <string>
+#include <vector>
+
+/// \brief Utility functions for reading and writing block-compressed NRRD data.
+///
+/// The voxel data is split into fixed size blocks that are compressed
+/// independently (and concurrently). Each block is a complete gzip member,
+/// therefore the concatenated blocks form a valid multi-member gzip stream
+/// that any NRRD reader can decompress with "encoding: gzip".
+///
+/// The block layout (uncompressed block size and compressed size of each block)
+/// is stored in the NRRD header in the key/value field named by GetLayoutKey(),
+/// which allows readers to decompress the blocks concurrently as well.
+///
+/// \sa vtkTeemNRRDWriter, vtkTeemNRRDReader
+class VTK_Teem_EXPORT vtkTeemNRRDGzipBlocks
+{
+public:
+  /// Name of the NRRD key/value field that stores the block layout.
+  static const char* GetLayoutKey();
+
+  /// Compress \a data into independent gzip members of \a blockSize bytes
+  /// of uncompressed data each (last block may be shorter).
+  /// Blocks are compressed concurrently using vtkSMPTools.
+  /// \a level is the zlib compression level (-1 for zlib default).
+  static bool Compress(const void* data, size_t dataSize, size_t blockSize, int level,
+    std::vector<std::string>& compressedBlocks);
+
+  /// Decompress the concatenated gzip members described by \a compressedBlockSizes
+  /// read from \a file, from its current position, into \a data.
+  /// Blocks are read in batches of bounded size and the blocks of a batch are
+  /// decompressed concurrently using vtkSMPTools.
+  static bool Decompress(FILE* file, const std::vector<size_t>& compressedBlockSizes,
+    size_t blockSize, void* data, size_t dataSize);
+
+  /// Write the compressed blocks to \a file.
+  static bool Write(FILE* file, const std::vector<std::string>& compressedBlocks);
+
+  /// Get the layout string that is stored in the NRRD header.
+  static std::string EncodeLayout(size_t blockSize, const std::vector<std::string>& compressedBlocks);
+
+  /// Parse a layout string that was created by EncodeLayout.
+  static bool DecodeLayout(const std::string& layout, size_t& blockSize, std::vector<size_t>& compressedBlockSizes);
+};
+
+#endif
@@ -27,6 +27,7 @@
 =========================================================================*/
 // vtkTeem includes
 #include "vtkTeemNRRDReader.h"
+#include "vtkTeemNRRDGzipBlocks.h"
 
 // VTK includes
 #include "vtkBitArray.h"
@@ -595,7 +596,11 @@ void vtkTeemNRRDReader::ExecuteInformation()
     char *key = nullptr;
     char *val = nullptr;
     nrrdKeyValueIndex(this->nrrd, &key, &val, i);
-    HeaderKeyValue[std::string(key)] = std::string(val);
+    // block layout describes the file, not the image
+    if (strcmp(key, vtkTeemNRRDGzipBlocks::GetLayoutKey()) != 0)
+      {
+      HeaderKeyValue[std::string(key)] = std::string(val);
+      }
     free(key);  // key and val point to malloc'd data!!
     free(val);
     }
@@ -893,6 +898,101 @@ int vtkTeemNRRDReader::tenSpaceDirectionReduce(Nrrd *nout, const Nrrd *nin, doub
 }
 
 
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::CanLoadDirectly(void* buffer, size_t bufferSize)
+{
+  if (!buffer || !this->GetFileName())
+    {
+    return false;
+    }
+
+  // Re-read the header so that the decision is based on the current
+  // content of the file, not on a possibly stale cached header.
+  nrrdEmpty(this->nrrd);
+  NrrdIoState *nio = nrrdIoStateNew();
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  int loadStatus = nrrdLoad(this->nrrd, this->GetFileName(), nio);
+  nio = nrrdIoStateNix(nio);
+  if (loadStatus != 0)
+    {
+    char *err = biffGetDone(NRRD);
+    free(err);
+    return false;
+    }
+
+  if (this->nrrd->data != nullptr
+    || nrrdElementSize(this->nrrd) * nrrdElementNumber(this->nrrd) != bufferSize)
+    {
+    return false;
+    }
+
+  // The range axis has to be the fastest axis already, otherwise it needs
+  // to be permuted after reading.
+  unsigned int rangeAxisIdx[NRRD_DIM_MAX] = { 0 };
+  unsigned int rangeAxisNum = nrrdRangeAxesGet(this->nrrd, rangeAxisIdx);
+  if (rangeAxisNum > 1 || (rangeAxisNum == 1 && rangeAxisIdx[0] != 0))
+    {
+    return false;
+    }
+
+  // Tensors are padded and expanded after reading
+  if (nrrdKind3DMaskedSymMatrix == this->nrrd->axis[0].kind
+    || nrrdKind3DSymMatrix == this->nrrd->axis[0].kind)
+    {
+    return false;
+    }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::ReadGzipBlocks(void* buffer, size_t bufferSize)
+{
+  // Block layout is only available in files written with parallel compression
+  char* layout = nrrdKeyValueGet(this->nrrd, vtkTeemNRRDGzipBlocks::GetLayoutKey());
+  if (!layout)
+    {
+    return false;
+    }
+  size_t blockSize = 0;
+  std::vector<size_t> compressedBlockSizes;
+  bool validLayout = vtkTeemNRRDGzipBlocks::DecodeLayout(layout, blockSize, compressedBlockSizes);
+  free(layout); // layout points to malloc'd data!!
+  if (!validLayout || this->GetSwapBytes())
+    {
+    return false;
+    }
+
+  // Let Teem parse the header and open the data file (the header file itself
+  // if attached), positioned at the beginning of the data.
+  Nrrd* header = nrrdNew();
+  NrrdIoState *nio = nrrdIoStateNew();
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
+  bool success = false;
+  if (nrrdLoad(header, this->GetFileName(), nio) != 0)
+    {
+    char *err = biffGetDone(NRRD);
+    free(err);
+    }
+  else if (nio->dataFile && nio->encoding == nrrdEncodingGzip
+    && nio->lineSkip == 0 && nio->byteSkip == 0)
+    {
+    success = vtkTeemNRRDGzipBlocks::Decompress(nio->dataFile, compressedBlockSizes, blockSize, buffer, bufferSize);
+    if (!success)
+      {
+      vtkWarningMacro("Read: Failed to read block-compressed data of " << this->GetFileName());
+      }
+    }
+  if (nio->dataFile)
+    {
+    nio->dataFile = airFclose(nio->dataFile);
+    }
+  nio = nrrdIoStateNix(nio);
+  header = nrrdNuke(header);
+  return success;
+}
+
 //----------------------------------------------------------------------------
 // This function reads a data from a file.  The data extent/axes
 // are assumed to be the same as the file extent/order.
@@ -914,12 +1014,59 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInf
     return;
     }
 
+  vtkDataArray* outputArray = nullptr;
+  switch(this->PointDataType)
+    {
+    case vtkDataSetAttributes::SCALARS:
+      outputArray = imageData->GetPointData()->GetScalars();
+      break;
+    case vtkDataSetAttributes::VECTORS:
+      outputArray = imageData->GetPointData()->GetVectors();
+      break;
+    case vtkDataSetAttributes::NORMALS:
+      outputArray = imageData->GetPointData()->GetNormals();
+      break;
+    case vtkDataSetAttributes::TENSORS:
+      outputArray = imageData->GetPointData()->GetTensors();
+      break;
+    }
+  void *ptr = nullptr;
+  size_t outputSize = 0;
+  if (outputArray)
+    {
+    outputArray->SetName(this->DataArrayName.c_str());
+    //get pointer
+    ptr = outputArray->GetVoidPointer(0);
+    outputSize = static_cast<size_t>(outputArray->GetNumberOfValues()) * outputArray->GetDataTypeSize();
+    }
+  this->ComputeDataIncrements();
+
+  // If the voxels can be used as they are stored in the file then let Teem
+  // decode them straight into the output array (nrrdLoad re-uses an already
+  // allocated data buffer of matching size). This avoids a second full-size
+  // buffer and a full-volume memcpy.
+  bool directLoad = this->CanLoadDirectly(ptr, outputSize);
+  if (directLoad && this->ReadGzipBlocks(ptr, outputSize))
+    {
+    nrrdEmpty(this->nrrd);
+    return;
+    }
+  if (directLoad)
+    {
+    this->nrrd->data = ptr;
+    }
+
   // Read in the this->nrrd.  Yes, this means that the header is being read
   // twice: once by ExecuteInformation, and once here
   if ( nrrdLoad(this->nrrd, this->GetFileName(), nullptr) != 0 )
     {
     char *err =  biffGetDone(NRRD); // would be nice to free(err)
     vtkErrorMacro("Read: Error reading " << this->GetFileName() << ":\n" << err);
+    if (directLoad)
+      {
+      // the buffer is owned by the output array
+      this->nrrd->data = nullptr;
+      }
     return;
     }
 
@@ -929,29 +1076,14 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInf
     return;
     }
 
-  void *ptr = nullptr;
-  switch(this->PointDataType)
+  if (directLoad)
     {
-    case vtkDataSetAttributes::SCALARS:
-      imageData->GetPointData()->GetScalars()->SetName(this->DataArrayName.c_str());
-      //get pointer
-      ptr = imageData->GetPointData()->GetScalars()->GetVoidPointer(0);
-      break;
-    case vtkDataSetAttributes::VECTORS:
-      imageData->GetPointData()->GetVectors()->SetName(this->DataArrayName.c_str());
-      //get pointer
-      ptr = imageData->GetPointData()->GetVectors()->GetVoidPointer(0);
-      break;
-    case vtkDataSetAttributes::NORMALS:
-      imageData->GetPointData()->GetNormals()->SetName(this->DataArrayName.c_str());
-      ptr = imageData->GetPointData()->GetNormals()->GetVoidPointer(0);
-      break;
-    case vtkDataSetAttributes::TENSORS:
-      imageData->GetPointData()->GetTensors()->SetName(this->DataArrayName.c_str());
-      ptr = imageData->GetPointData()->GetTensors()->GetVoidPointer(0);
-      break;
+    // voxels are already in place, release the buffer back to the output array
+    // while keeping the struct
+    this->nrrd->data = nullptr;
+    nrrdEmpty(this->nrrd);
+    return;
     }
-  this->ComputeDataIncrements();
 
   unsigned int rangeAxisIdx[NRRD_DIM_MAX] = { 0 };
   unsigned int rangeAxisNum = nrrdRangeAxesGet(this->nrrd, rangeAxisIdx);
@@ -277,6 +277,19 @@ protected:
 
   int tenSpaceDirectionReduce(Nrrd *nout, const Nrrd *nin, double SD[9]);
 
+  /// Returns true if the voxels stored in the file can be decoded directly
+  /// into the provided buffer (no axis permutation or tensor expansion is
+  /// needed and the buffer size matches the data size in the file).
+  /// Reloads the header into this->nrrd.
+  bool CanLoadDirectly(void* buffer, size_t bufferSize);
+
+  /// Decompress voxel data written with parallel block compression
+  /// concurrently into the provided buffer. Returns false if the file
+  /// was not written with block compression or reading failed.
+  /// Requires the header loaded into this->nrrd by CanLoadDirectly.
+  /// \sa vtkTeemNRRDGzipBlocks
+  bool ReadGzipBlocks(void* buffer, size_t bufferSize);
+
 private:
   vtkTeemNRRDReader(const vtkTeemNRRDReader&) = delete;
   void operator=(const vtkTeemNRRDReader&) = delete;
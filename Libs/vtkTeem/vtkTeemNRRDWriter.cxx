@@ -1,6 +1,7 @@
 #include <map>
 
 #include "vtkTeemNRRDWriter.h"
+#include "vtkTeemNRRDGzipBlocks.h"
 
 
 #include "vtkImageData.h"
@@ -31,6 +32,8 @@ vtkTeemNRRDWriter::vtkTeemNRRDWriter()
   this->UseCompression = 1;
   // use default CompressionLevel
   this->CompressionLevel = -1;
+  this->ParallelCompression = false;
+  this->CompressionBlockSize = 8 * 1024 * 1024;
   this->DiffusionWeightedData = 0;
   this->FileType = VTK_BINARY;
   this->WriteErrorOff();
@@ -323,6 +326,8 @@ void* vtkTeemNRRDWriter::MakeNRRD()
     {
     // Don't set `space` as k-v. it is handled above, and needs to be a nrrd *field*.
     if (ait->first == "space") { continue; }
+    // Block layout is only valid for the file it was read from
+    if (ait->first == vtkTeemNRRDGzipBlocks::GetLayoutKey()) { continue; }
 
     nrrdKeyValueAdd(nrrd, ait->first.c_str(), ait->second.c_str());
     }
@@ -412,6 +417,19 @@ void vtkTeemNRRDWriter::WriteData()
     return;
     }
 
+  if (this->GetUseCompression() && this->GetParallelCompression() && nrrdEncodingGzip->available())
+    {
+    if (this->WriteParallelCompressed(nrrd))
+      {
+      // Free the nrrd struct but don't touch nrrd->data
+      nrrd = nrrdNix(nrrd);
+      return;
+      }
+    vtkWarningMacro("Write: Parallel compression failed for " << this->GetFileName()
+      << ", retry with single-threaded compression");
+    nrrdKeyValueErase(nrrd, vtkTeemNRRDGzipBlocks::GetLayoutKey());
+    }
+
   NrrdIoState *nio = nrrdIoStateNew();
 
   // set encoding for data: compressed (raw), (uncompressed) raw, or ascii
@@ -452,6 +470,67 @@ void vtkTeemNRRDWriter::WriteData()
   nio = nrrdIoStateNix(nio);
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+/// Blocks written by GzipBlocksWrite(), set during nrrdSave().
+thread_local const std::vector<std::string>* GzipBlocksToWrite = nullptr;
+
+//----------------------------------------------------------------------------
+/// Write callback of the "gzip" encoding used for parallel compression:
+/// the data is already compressed, Teem writes the header and the data file
+/// (if detached) and this function only writes the compressed blocks.
+int GzipBlocksWrite(FILE* file, const void* vtkNotUsed(data), size_t vtkNotUsed(elementNum),
+                    const Nrrd* vtkNotUsed(nrrd), NrrdIoState* vtkNotUsed(nio))
+{
+  if (!GzipBlocksToWrite || !vtkTeemNRRDGzipBlocks::Write(file, *GzipBlocksToWrite))
+    {
+    biffAddf(NRRD, "GzipBlocksWrite: failed to write compressed blocks");
+    return 1;
+    }
+  return 0;
+}
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDWriter::WriteParallelCompressed(Nrrd* nrrd)
+{
+  const size_t dataSize = nrrdElementNumber(nrrd) * nrrdElementSize(nrrd);
+  const size_t blockSize = static_cast<size_t>(this->CompressionBlockSize);
+  std::vector<std::string> compressedBlocks;
+  if (!vtkTeemNRRDGzipBlocks::Compress(nrrd->data, dataSize, blockSize, this->CompressionLevel, compressedBlocks))
+    {
+    return false;
+    }
+  // The layout has to be in the header, written before the data, therefore
+  // all the blocks are compressed before writing.
+  nrrdKeyValueAdd(nrrd, vtkTeemNRRDGzipBlocks::GetLayoutKey(),
+    vtkTeemNRRDGzipBlocks::EncodeLayout(blockSize, compressedBlocks).c_str());
+
+  // Same as the gzip encoding (name, suffix, decoding) except that the data
+  // is written as is: Teem writes the header, attached or detached, then
+  // the compressed blocks.
+  NrrdEncoding gzipBlocksEncoding = *nrrdEncodingGzip;
+  gzipBlocksEncoding.write = GzipBlocksWrite;
+
+  NrrdIoState *nio = nrrdIoStateNew();
+  nio->encoding = &gzipBlocksEncoding;
+  nio->endian = airEndianUnknown;
+  GzipBlocksToWrite = &compressedBlocks;
+  int saveStatus = nrrdSave(this->GetFileName(), nrrd, nio);
+  GzipBlocksToWrite = nullptr;
+  nio = nrrdIoStateNix(nio);
+  if (saveStatus)
+    {
+    char *err = biffGetDone(NRRD); // would be nice to free(err)
+    vtkErrorMacro("Write: Error writing "
+                      << this->GetFileName() << ":\n" << err);
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
 void vtkTeemNRRDWriter::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
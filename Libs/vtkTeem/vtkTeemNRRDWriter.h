@@ -58,6 +58,19 @@ public:
   vtkSetClampMacro(CompressionLevel, int, 0, 9);
   vtkGetMacro(CompressionLevel, int);
 
+  /// If enabled (and UseCompression is on) then the voxel data is split into
+  /// blocks of CompressionBlockSize bytes that are compressed concurrently.
+  /// The output is still a valid gzip-encoded NRRD file.
+  /// Off by default.
+  /// \sa vtkTeemNRRDGzipBlocks
+  vtkSetMacro(ParallelCompression, bool);
+  vtkGetMacro(ParallelCompression, bool);
+  vtkBooleanMacro(ParallelCompression, bool);
+
+  /// Size of uncompressed data in each block, in bytes, if ParallelCompression is enabled.
+  vtkSetClampMacro(CompressionBlockSize, vtkIdType, 65536, VTK_INT_MAX);
+  vtkGetMacro(CompressionBlockSize, vtkIdType);
+
   vtkSetClampMacro(FileType,int,VTK_ASCII,VTK_BINARY);
   vtkGetMacro(FileType,int);
   void SetFileTypeToASCII() {this->SetFileType(VTK_ASCII);};
@@ -127,8 +140,14 @@ protected:
   vtkMatrix4x4* IJKToRASMatrix;
   vtkMatrix4x4* MeasurementFrameMatrix;
 
+  /// Write the nrrd using parallel block compression.
+  /// Teem writes the file with an encoding that writes the compressed blocks.
+  bool WriteParallelCompressed(Nrrd* nrrd);
+
   int UseCompression;
   int CompressionLevel;
+  bool ParallelCompression;
+  vtkIdType CompressionBlockSize;
   int FileType;
 
   AttributeMapType *Attributes;
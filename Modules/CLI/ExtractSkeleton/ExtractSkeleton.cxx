@@ -106,7 +106,8 @@ int main(int argc, char * *argv)
       extract2DSheet = 1;
       }
     tilg_iso_3D(dim[0], dim[1], dim[2],
-                inputImageBuffer, outputImageBuffer, extract2DSheet);
+                inputImageBuffer, outputImageBuffer, extract2DSheet,
+                NumberOfThreads);
     std::cout << "Extracted skeleton." << std::endl;
 
     SkelGraph graph;
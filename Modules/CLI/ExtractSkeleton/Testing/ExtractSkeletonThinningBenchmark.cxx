@@ -0,0 +1,176 @@
+/*=========================================================================
+
+  Program:   Extract Skeleton
+  Language:  C++
+
+  Copyright (c) Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See License.txt or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+#include "tilg_iso_3D.h"
+
+// ITK includes
+#include <itkMultiThreaderBase.h>
+#include <itkTimeProbe.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Draw a tube of the given radius between two points.
+void DrawVessel(std::vector<unsigned char>& image, const int dim[3],
+                const double start[3], const double end[3], double radius)
+{
+  double direction[3] = { end[0] - start[0], end[1] - start[1], end[2] - start[2] };
+  const double length = std::sqrt(direction[0] * direction[0]
+    + direction[1] * direction[1] + direction[2] * direction[2]);
+  const int numberOfSteps = static_cast<int>(length / 0.5) + 1;
+  const int r = static_cast<int>(std::ceil(radius));
+  for (int step = 0; step <= numberOfSteps; ++step)
+    {
+    const double t = static_cast<double>(step) / numberOfSteps;
+    const double center[3] = { start[0] + t * direction[0], start[1] + t * direction[1], start[2] + t * direction[2] };
+    for (int z = static_cast<int>(center[2]) - r; z <= static_cast<int>(center[2]) + r; ++z)
+      {
+      for (int y = static_cast<int>(center[1]) - r; y <= static_cast<int>(center[1]) + r; ++y)
+        {
+        for (int x = static_cast<int>(center[0]) - r; x <= static_cast<int>(center[0]) + r; ++x)
+          {
+          if (x < 0 || y < 0 || z < 0 || x >= dim[0] || y >= dim[1] || z >= dim[2])
+            {
+            continue;
+            }
+          const double d2 = (x - center[0]) * (x - center[0])
+            + (y - center[1]) * (y - center[1]) + (z - center[2]) * (z - center[2]);
+          if (d2 <= radius * radius)
+            {
+            image[x + dim[0] * (y + dim[1] * z)] = 1;
+            }
+          }
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Recursively draw a binary vessel tree, similar to a segmented angiography.
+void DrawVesselTree(std::vector<unsigned char>& image, const int dim[3],
+                    const double start[3], const double direction[3],
+                    double length, double radius, int depth)
+{
+  const double end[3] = { start[0] + length * direction[0],
+                          start[1] + length * direction[1],
+                          start[2] + length * direction[2] };
+  DrawVessel(image, dim, start, end, radius);
+  if (depth == 0)
+    {
+    return;
+    }
+  // branch in a plane that rotates with the depth
+  const double angle = 0.5;
+  const double rotation = depth * 1.3;
+  for (int side = -1; side <= 1; side += 2)
+    {
+    double branch[3] =
+      {
+      direction[0] + side * std::sin(angle) * std::cos(rotation),
+      direction[1] + side * std::sin(angle) * std::sin(rotation),
+      direction[2]
+      };
+    const double norm = std::sqrt(branch[0] * branch[0] + branch[1] * branch[1] + branch[2] * branch[2]);
+    branch[0] /= norm;
+    branch[1] /= norm;
+    branch[2] /= norm;
+    DrawVesselTree(image, dim, end, branch, length * 0.75, std::max(1.0, radius * 0.75), depth - 1);
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+// Usage: ExtractSkeletonThinningBenchmark [dimX dimY dimZ]
+// Thins a synthetic vessel tree labelmap (512x512x400 by default, the size
+// of a typical angiography) with one thread and with all threads, reports
+// the timings and checks that the skeletons are identical.
+int main(int argc, char* argv[])
+{
+  int dim[3] = { 512, 512, 400 };
+  if (argc == 4)
+    {
+    for (int i = 0; i < 3; ++i)
+      {
+      dim[i] = std::atoi(argv[i + 1]);
+      }
+    }
+  else if (argc != 1)
+    {
+    std::cerr << "Usage: " << argv[0] << " [dimX dimY dimZ]" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (dim[0] < 16 || dim[1] < 16 || dim[2] < 16)
+    {
+    std::cerr << "Image dimensions must be at least 16" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const size_t numberOfVoxels = static_cast<size_t>(dim[0]) * dim[1] * dim[2];
+  std::vector<unsigned char> labelmap(numberOfVoxels, 0);
+  const double root[3] = { dim[0] / 2.0, dim[1] / 2.0, 2.0 };
+  const double up[3] = { 0.0, 0.0, 1.0 };
+  DrawVesselTree(labelmap, dim, root, up, dim[2] * 0.3, std::max(2.0, dim[0] / 64.0), 6);
+
+  size_t numberOfObjectVoxels = 0;
+  for (unsigned char value : labelmap)
+    {
+    numberOfObjectVoxels += value;
+    }
+  std::cout << "Labelmap: " << dim[0] << "x" << dim[1] << "x" << dim[2]
+            << ", " << numberOfObjectVoxels << " vessel voxels" << std::endl;
+
+  const int numberOfThreads = itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
+  for (int type = 0; type < 2; ++type)
+    {
+    std::vector<unsigned char> serialSkeleton(numberOfVoxels);
+    std::vector<unsigned char> parallelSkeleton(numberOfVoxels);
+
+    itk::TimeProbe serialProbe;
+    serialProbe.Start();
+    tilg_iso_3D(dim[0], dim[1], dim[2], labelmap.data(), serialSkeleton.data(), type, 1);
+    serialProbe.Stop();
+
+    itk::TimeProbe parallelProbe;
+    parallelProbe.Start();
+    tilg_iso_3D(dim[0], dim[1], dim[2], labelmap.data(), parallelSkeleton.data(), type, numberOfThreads);
+    parallelProbe.Stop();
+
+    size_t numberOfSkeletonVoxels = 0;
+    for (unsigned char value : serialSkeleton)
+      {
+      numberOfSkeletonVoxels += value;
+      }
+    std::cout << (type ? "2D" : "1D") << " skeleton: " << numberOfSkeletonVoxels << " voxels, "
+              << "1 thread: " << serialProbe.GetTotal() << "s, "
+              << numberOfThreads << " threads: " << parallelProbe.GetTotal() << "s" << std::endl;
+
+    if (serialSkeleton != parallelSkeleton)
+      {
+      std::cerr << "Skeletons computed with 1 and " << numberOfThreads << " threads differ" << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (numberOfSkeletonVoxels == 0)
+      {
+      std::cerr << "Empty skeleton" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
@@ -20,9 +20,19 @@
 /* Autor:       Patrick Drozz  IIIC/9   ETHZ                          */
 // adapted to C++: Martin Styner 20.July.2000
 // integrated into slicer: Stephen Aylward, 20, Aug, 2007
+// reentrant and multi-threaded: the state is kept on the stack, voxels of
+// a directional subcycle are tested concurrently (they are all tested
+// against the image of the previous subcycle, so the result does not
+// depend on the number of threads)
 /*****************************************************************************/
-#include <cstdio>
-#include <cstdlib>
+#include "tilg_iso_3D.h"
+
+// ITK includes
+#include <itkMultiThreaderBase.h>
+
+// STD includes
+#include <algorithm>
+#include <vector>
 
 /********************************  Konstanten  *******************************/
 #define LIM  1 /* Voxelwert >= LIM => Objekt (Input-Bild) */
@@ -33,11 +43,53 @@
 #define Q(i, v)  ( (pos[(i)] == OBJ) ? (v) : 0 )
 #define P(n, x, y, z) n[(x) + nx * ( (y) + (z) * ny)]
 
-/**************************** globale Variablen  *****************************/
-static int            nx, ny, nz, nzz;
-static unsigned char *workbuf, *result;
-static int            f_tab[26];
-static unsigned char  p[5][5][5];
+/*****************************  Konstante Tabellen  **************************/
+/* Richtungstabelle: Nachbarn die fuer die Subzyklen Hintergrund sein muessen */
+static const int dir_tab[18] =
+{
+  1024,        /* 10 */
+  65536,       /* 16 */
+  16384,       /* 14 */
+  4096,        /* 12 */
+  4194304,     /* 22 */
+  16,          /*  4 */
+  4198400,     /* 12 22 */
+  16400,       /*  4 14 */
+  4210688,     /* 14 22 */
+  4112,        /*  4 12 */
+  65552,       /*  4 16 */
+  4195328,     /* 10 22 */
+  1040,        /*  4 10 */
+  4259840,     /* 16 22 */
+  69632,       /* 12 16 */
+  17408,       /* 10 14 */
+  5120,        /* 10 12 */
+  81920        /* 14 16 */
+};
+
+/* Freie Nachbarn fuer den Zusatztest bei paralleler Tilgung */
+static const int f_tab[19] =
+{
+  65536,       /* 16 */
+  1024,        /* 10 */
+  4096,        /* 12 */
+  16384,       /* 14 */
+  16,          /*  4 */
+  4194304,     /* 22 */
+  32,          /*  5 */
+  2097152,     /* 21 */
+  8,           /*  3 */
+  8388608,     /* 23 */
+  524288,      /* 19 */
+  128,         /*  7 */
+  33554432,    /* 25 */
+  2,           /*  1 */
+  2048,        /* 11 */
+  32768,       /* 15 */
+  131072,      /* 17 */
+  512,         /*  9 */
+  0            /* sequentielle Tilgung */
+};
 
 /*******************************  Hilfsprozeduren ****************************/
 int bitcount(int i)
@@ -56,7 +108,7 @@ int bitcount(int i)
   return c;
 }
 
-void init_data()
+static void init_data(unsigned char p[5][5][5])
 /* initialisiert p */
 {
   int x, y, z;
@@ -73,7 +125,7 @@ void init_data()
     }
 }
 
-void mark(int x, int y, int z)
+static void mark(unsigned char p[5][5][5], int x, int y, int z)
 /* markiert alles was von x,y,z aus erreichbar ist */
 /* einfache rekursive Version                      */
 {
@@ -90,18 +142,21 @@ void mark(int x, int y, int z)
         {
         if( p[i][j][k] == OBJ )
           {
-          mark(i, j, k);
+          mark(p, i, j, k);
           }
         }
       }
     }
 }
 
-int count_components(int nc)
+static int count_components(int nc)
 /* zaehlt die Komponenten im 26-Sinn des nc's */
 /* einfache rekursive Version                 */
 {
   int x, y, z, count;
+  unsigned char p[5][5][5];
+
+  init_data(p);
 
   for( z = 1; z < 4; z++ )
     {
@@ -124,7 +179,7 @@ int count_components(int nc)
         if( p[x][y][z] != BG )
           {
           count++;
-          mark(x, y, z);
+          mark(p, x, y, z);
           }
         }
       }
@@ -154,11 +209,11 @@ int Env_Code_3_img(int loc[3], unsigned char *img, int dim[3])
   return nc;
 }
 
-int Env_Code_3(int i)
+static int Env_Code_3(const unsigned char *result, int i, int nx, int nzz)
 /* berechnet den Nachbarschaftscode der 3x3x3-Umgebung von P{i} */
 {
-  int            nc;
-  unsigned char *pos;
+  int                  nc;
+  const unsigned char *pos;
 
   pos = &result[i - nzz];
   nc = Q(-1 - nx, 1) + Q(-nx, 2) + Q(1 - nx, 4) + Q(-1, 8) + Q(0, 16)
@@ -594,43 +649,36 @@ int Tilg_Test_3(int c, int d, int type)
   return OBJ;
 }
 
+static bool Is_Tilgbar(const unsigned char *result, int i, int nx, int nzz,
+                       int dir, int dir_mask, int type)
+/* Tilgbarkeit des Objektvoxels i im Subzyklus dir */
+{
+  const int nc = Env_Code_3(result, i, nx, nzz);
+  return ( ( (~ nc) & dir_mask) == dir_mask )
+    && ( bitcount(nc) > 2 )
+    && ( Tilg_Test_3(nc, dir, type) == BG );
+}
+
 void tilg_iso_3D(int dx, int dy, int dz,
                  unsigned char *data,
                  unsigned char *res,
-                 int type)
+                 int type,
+                 int numberOfThreads)
 // dx,dy,dz  are the dimensions of the input (data) and output (res) image
 // output image has to be allocated
 // if type == 1 -> sheet preserving tilg
 // if type == 0 -> full tilg
 {
+  const int      nx = dx, ny = dy, nz = dz;
+  const int      nzz = nx * ny;
+  unsigned char *result = res;
+  int            x, y, z, i, end;
 
-  int cnt = 0, cnt1 = 0;
-  int nc, x, y, z;
-  int end, i, dir, dir_mask;
-  // int free_mask;
-  int *list;
-  int  dir_tab[26];
-
-  // int b[3][3][3];
-
-  nx = dx; ny = dy; nz = dz;
-  init_data();
-  /* Speicher allozieren */
-  result = res;
-
-  workbuf = data;
-  nzz = nx * ny;
-  /* Speicher allozieren */
-  if( (list = (int *) malloc(nzz * nz * sizeof(int) / 4) ) == nullptr )
-    {
-    printf("out of memory\n");
-    return;
-    }
   /* Arbeitskopie des Bildes erstellen und binaerisieren */
   end = nx * ny * nz;
   for( i = 0; i < end; i++ )
     {
-    result[i] = ( (workbuf[i] >= LIM) ? OBJ : BG  );
+    result[i] = ( (data[i] >= LIM) ? OBJ : BG  );
     }
   /* Rand von 1-Voxel-Breite auf 0 setzen */
   for( y = 0; y < ny; y++ )
@@ -654,78 +702,65 @@ void tilg_iso_3D(int dx, int dy, int dz,
       P(result, x, 0, z) = (P(result, x, ny - 1, z) = BG);
       }
     }
-  /* Richtungstabelle initialisieren */
-  dir_tab[0] = 1024;        /* 10 */
-  dir_tab[1] = 65536;       /* 16 */
-  dir_tab[2] = 16384;       /* 14 */
-  dir_tab[3] = 4096;        /* 12 */
-  dir_tab[4] = 4194304;     /* 22 */
-  dir_tab[5] = 16;          /*  4 */
-
-  f_tab[0] =  dir_tab[1];
-  f_tab[1] =  dir_tab[0];
-  f_tab[2] =  dir_tab[3];
-  f_tab[3] =  dir_tab[2];
-  f_tab[4] =  dir_tab[5];
-  f_tab[5] =  dir_tab[4];
-
-  dir_tab[6]  = 4198400;    /* 12 22 */
-  dir_tab[7]  = 16400;      /*  4 14 */
-  dir_tab[8]  = 4210688;    /* 14 22 */
-  dir_tab[9]  = 4112;       /*  4 12 */
-  dir_tab[10] =  65552;     /*  4 16 */
-  dir_tab[11] =  4195328;   /* 10 22 */
-  dir_tab[12] =  1040;      /*  4 10 */
-  dir_tab[13] =  4259840;   /* 16 22 */
-  dir_tab[14] =  69632;     /* 12 16 */
-  dir_tab[15] =  17408;     /* 10 14 */
-  dir_tab[16] =  5120;      /* 10 12 */
-  dir_tab[17] =  81920;     /* 14 16 */
-
-  f_tab[6]  =       32;    /*  5 */
-  f_tab[7]  =  2097152;    /* 21 */
-  f_tab[8]  =        8;    /*  3 */
-  f_tab[9]  =  8388608;    /* 23 */
-  f_tab[10] =   524288;    /* 19 */
-  f_tab[11] =      128;    /*  7 */
-  f_tab[12] = 33554432;    /* 25 */
-  f_tab[13] =        2;    /*  1 */
-  f_tab[14] =     2048;    /* 11 */
-  f_tab[15] =    32768;    /* 15 */
-  f_tab[16] =   131072;    /* 17 */
-  f_tab[17] =      512;    /*  9 */
 
-  /* eigentliches Bildparsing */
+  /* Liste der Objektvoxel (aufsteigend), nur diese muessen getestet werden */
   end = end - nzz - nx - 1;
-  cnt = 1;
+  std::vector<int> objects;
+  for( i = nzz + nx + 1; i < end; i++ )
+    {
+    if( result[i] == OBJ )
+      {
+      objects.push_back(i);
+      }
+    }
+
+  itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+  if( numberOfThreads > 0 )
+    {
+    threader->SetMaximumNumberOfThreads(numberOfThreads);
+    threader->SetNumberOfWorkUnits(numberOfThreads);
+    }
+  // more chunks than threads for load balancing, object voxels are not evenly distributed
+  const itk::SizeValueType numberOfChunks = 4 * threader->GetNumberOfWorkUnits();
+  std::vector<std::vector<int> > chunkLists(numberOfChunks);
+
+  /* eigentliches Bildparsing */
+  int cnt = 1;
   while( cnt )
     {
     cnt = 0;
-    for( dir = 0; dir < 18; dir++ )
+    for( int dir = 0; dir < 18; dir++ )
       {
-      cnt1 = 0;
-      dir_mask = dir_tab[dir];
-      for( i = nzz + nx + 1; i < end; i++ )
+      const int dir_mask = dir_tab[dir];
+      const itk::SizeValueType numberOfObjects = objects.size();
+      threader->ParallelizeArray(0, numberOfChunks, [&](itk::SizeValueType chunk)
         {
-        if( result[i] == OBJ )
+        std::vector<int>& list = chunkLists[chunk];
+        list.clear();
+        const itk::SizeValueType first = numberOfObjects * chunk / numberOfChunks;
+        const itk::SizeValueType last = numberOfObjects * (chunk + 1) / numberOfChunks;
+        for( itk::SizeValueType k = first; k < last; k++ )
           {
-          nc = Env_Code_3(i);
-          if( ( (~ nc) & dir_mask) == dir_mask )
+          if( Is_Tilgbar(result, objects[k], nx, nzz, dir, dir_mask, type) )
             {
-            if( bitcount(nc) > 2 )
-              {
-              if( Tilg_Test_3(nc, dir, type) == BG )
-                {
-                list[cnt1++] = i;
-                }
-              }
+            list.push_back(objects[k]);
             }
           }
-        }
+        }, nullptr);
       /* Voxel der Liste loeschen */
-      for( i = 0; i < cnt1; i++ )
+      int cnt1 = 0;
+      for( const std::vector<int>& list : chunkLists )
         {
-        result[list[i]] = BG;
+        for( int index : list )
+          {
+          result[index] = BG;
+          }
+        cnt1 += static_cast<int>(list.size());
+        }
+      if( cnt1 > 0 )
+        {
+        objects.erase(std::remove_if(objects.begin(), objects.end(),
+          [result](int index) { return result[index] != OBJ; }), objects.end());
         }
       cnt += cnt1;
       }
@@ -736,22 +771,19 @@ void tilg_iso_3D(int dx, int dy, int dz,
   while( cnt )
     {
     cnt = 0;
-    for( i = nzz + nx + 1; i < end; i++ )
+    for( int index : objects )
       {
-      if( result[i] == OBJ )
+      if( result[index] == OBJ
+          && Is_Tilgbar(result, index, nx, nzz, 18, 0, type) )
         {
-        nc = Env_Code_3(i);
-        if( bitcount(nc) > 2 )
-          {
-          if( Tilg_Test_3(nc, 18, type) == BG )
-            {
-            cnt++;
-            result[i] = BG;
-            }
-          }
+        cnt++;
+        result[index] = BG;
         }
       }
+    if( cnt > 0 )
+      {
+      objects.erase(std::remove_if(objects.begin(), objects.end(),
+        [result](int index) { return result[index] != OBJ; }), objects.end());
+      }
     }
-
-  free(list);
 }
@@ -29,12 +29,16 @@ int Tilg_Test_3(int c, int d, int type);
 // if type == 0 -> full tilg
 // d = for parrel tilg -> 0,1,2,3,4,5   N,S,E,W,T,D
 
-void tilg_iso_3D(int dx, int dy, int dz, unsigned char *data, unsigned char *res, int type);
+void tilg_iso_3D(int dx, int dy, int dz, unsigned char *data, unsigned char *res, int type,
+                 int numberOfThreads = 0);
 
 // 3D isotropic tilg-procedure that does a 3D thinning
 // dx,dy,dz  are the dimensions of the input (data) and output (res) image
 // output image has to be allocated
 // if type == 1 -> sheet preserving tilg
 // if type == 0 -> full tilg
+// numberOfThreads is the number of threads used for the directional
+// subcycles, 0 means ITK default. The result does not depend on it.
+// The function is reentrant, several images can be thinned concurrently.
 
 #endif
@@ -32,6 +32,7 @@ Version:   $Revision$
 // VTK includes
 #include <vtkVersion.h> // must precede reference to VTK_MAJOR_VERSION
 #include <vtkDebugLeaks.h>
+#include <vtkCellArray.h>
 #include <vtkDecimatePro.h>
 #include <vtkDiscreteFlyingEdges3D.h>
 #include <vtkFlyingEdges3D.h>
@@ -46,6 +47,8 @@ Version:   $Revision$
 #include <vtkLookupTable.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkPolyDataWriter.h>
 #include <vtkReverseSense.h>
@@ -62,6 +65,479 @@ Version:   $Revision$
 // VTKsys includes
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Model of a single label, processed by a worker thread in parallel mode
+struct LabelModel
+{
+  int Label;
+  std::string Name;
+  std::string FileName;
+  vtkSmartPointer<vtkPolyData> Surface;
+  bool Empty;
+  bool Success;
+};
+
+//----------------------------------------------------------------------------
+// Per-label processing parameters in parallel mode
+struct LabelModelParameters
+{
+  bool JointSmoothing;
+  int Smooth;
+  std::string FilterType;
+  double Decimate;
+  bool SplitNormals;
+  bool PointNormals;
+  bool SaveIntermediateModels;
+  std::string RootDir;
+  vtkMatrix4x4* IJKToLPSMatrix;
+  const char* FileHeader;
+  /// Label image (padded if requested) that label surfaces are extracted from
+  /// if there is no joint smoothing
+  vtkImageData* LabelImage;
+};
+
+//----------------------------------------------------------------------------
+bool WriteLabelModelFile(vtkPolyData* polyData, const std::string& fileName, const char* fileHeader)
+{
+  vtkNew<vtkPolyDataWriter> writer;
+  // version 5.1 is not compatible with earlier Slicer versions (VTK < 9) and most other software
+  writer->SetFileVersion(42);
+  writer->SetInputData(polyData);
+  writer->SetHeader(fileHeader);
+  writer->SetFileType(2);
+  writer->SetFileName(fileName.c_str());
+  if (!writer->Write())
+    {
+    std::cerr << "ERROR: Failed to write model file " << fileName.c_str() << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+std::string GetLabelModelFileName(const std::string& rootDir, const std::string& labelName, const std::string& suffix)
+{
+  if (rootDir != "")
+    {
+    return rootDir + std::string("/") + labelName + suffix + std::string(".vtk");
+    }
+  return labelName + suffix + std::string(".vtk");
+}
+
+//----------------------------------------------------------------------------
+// Split the surface of all labels (point scalars contain the label value)
+// into one surface per label model in a single pass over the points and cells.
+// Discrete flying edges creates separate points for each label, therefore
+// every point belongs to exactly one label.
+void SplitSurfaceByLabel(vtkPolyData* surface, std::vector<LabelModel>& labelModels)
+{
+  std::map<int, LabelModel*> labelModelMap;
+  for (LabelModel& labelModel : labelModels)
+    {
+    labelModel.Surface = vtkSmartPointer<vtkPolyData>::New();
+    vtkNew<vtkPoints> points;
+    labelModel.Surface->SetPoints(points);
+    vtkNew<vtkCellArray> polys;
+    labelModel.Surface->SetPolys(polys);
+    labelModelMap[labelModel.Label] = &labelModel;
+    }
+  vtkDataArray* labels = surface->GetPointData() ? surface->GetPointData()->GetScalars() : nullptr;
+  if (!labels || !surface->GetPoints() || !surface->GetPolys())
+    {
+    return;
+    }
+
+  const vtkIdType numberOfPoints = surface->GetNumberOfPoints();
+  std::vector<LabelModel*> pointLabelModels(numberOfPoints, nullptr);
+  std::vector<vtkIdType> pointIds(numberOfPoints, -1);
+  for (vtkIdType pointId = 0; pointId < numberOfPoints; ++pointId)
+    {
+    std::map<int, LabelModel*>::iterator labelModelIt =
+      labelModelMap.find(static_cast<int>(labels->GetTuple1(pointId)));
+    if (labelModelIt == labelModelMap.end())
+      {
+      continue;
+      }
+    pointLabelModels[pointId] = labelModelIt->second;
+    pointIds[pointId] = labelModelIt->second->Surface->GetPoints()->InsertNextPoint(surface->GetPoint(pointId));
+    }
+
+  vtkCellArray* polys = surface->GetPolys();
+  vtkIdType numberOfCellPoints = 0;
+  const vtkIdType* cellPoints = nullptr;
+  std::vector<vtkIdType> labelCellPoints;
+  for (polys->InitTraversal(); polys->GetNextCell(numberOfCellPoints, cellPoints);)
+    {
+    if (numberOfCellPoints < 1)
+      {
+      continue;
+      }
+    LabelModel* labelModel = pointLabelModels[cellPoints[0]];
+    if (!labelModel)
+      {
+      continue;
+      }
+    labelCellPoints.resize(numberOfCellPoints);
+    bool validCell = true;
+    for (vtkIdType cellPointIndex = 0; cellPointIndex < numberOfCellPoints; ++cellPointIndex)
+      {
+      if (pointLabelModels[cellPoints[cellPointIndex]] != labelModel)
+        {
+        validCell = false;
+        break;
+        }
+      labelCellPoints[cellPointIndex] = pointIds[cellPoints[cellPointIndex]];
+      }
+    if (validCell)
+      {
+      labelModel->Surface->GetPolys()->InsertNextCell(numberOfCellPoints, labelCellPoints.data());
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+// Extract the surface of a label the same way as the serial pipeline does
+// without joint smoothing: threshold the label then run marching cubes.
+vtkSmartPointer<vtkPolyData> ExtractLabelSurface(vtkImageData* labelImage, int label)
+{
+  // each thread uses its own shallow copy of the image, as a data object
+  // cannot be connected to multiple pipelines concurrently
+  vtkNew<vtkImageData> image;
+  image->ShallowCopy(labelImage);
+
+  vtkNew<vtkImageThreshold> imageThreshold;
+  imageThreshold->SetInputData(image);
+  imageThreshold->SetReplaceIn(1);
+  imageThreshold->SetReplaceOut(1);
+  imageThreshold->SetInValue(200);
+  imageThreshold->SetOutValue(0);
+  imageThreshold->ThresholdBetween(label, label);
+
+  vtkNew<vtkFlyingEdges3D> mcubes;
+  mcubes->SetInputConnection(imageThreshold->GetOutputPort());
+  mcubes->SetValue(0, 100.5);
+  mcubes->ComputeScalarsOff();
+  mcubes->ComputeGradientsOff();
+  mcubes->ComputeNormalsOff();
+  mcubes->Update();
+  return mcubes->GetOutput();
+}
+
+//----------------------------------------------------------------------------
+// Decimate, smooth, transform to LPS, compute normals and write the surface of a label.
+// Only uses filters that are owned by this function, so that it can run
+// concurrently for different labels.
+bool ProcessLabelModel(LabelModel& labelModel, const LabelModelParameters& parameters)
+{
+  if (!parameters.JointSmoothing)
+    {
+    labelModel.Surface = ExtractLabelSurface(parameters.LabelImage, labelModel.Label);
+    }
+  if (!labelModel.Surface || labelModel.Surface->GetNumberOfPolys() == 0)
+    {
+    labelModel.Empty = true;
+    return false;
+    }
+
+  if (parameters.SaveIntermediateModels && !parameters.JointSmoothing)
+    {
+    WriteLabelModelFile(labelModel.Surface,
+      GetLabelModelFileName(parameters.RootDir, labelModel.Name, "-MarchingCubes"), parameters.FileHeader);
+    }
+
+  vtkNew<vtkDecimatePro> decimator;
+  decimator->SetInputData(labelModel.Surface);
+  decimator->SetFeatureAngle(60);
+  decimator->SplittingOff();
+  decimator->PreserveTopologyOn();
+  decimator->SetMaximumError(1);
+  decimator->SetTargetReduction(parameters.Decimate);
+  decimator->Update();
+  vtkSmartPointer<vtkPolyData> polyData = decimator->GetOutput();
+  if (parameters.SaveIntermediateModels)
+    {
+    WriteLabelModelFile(polyData,
+      GetLabelModelFileName(parameters.RootDir, labelModel.Name, "-Decimated"), parameters.FileHeader);
+    }
+
+  if (parameters.IJKToLPSMatrix->Determinant() < 0)
+    {
+    vtkNew<vtkReverseSense> reverser;
+    reverser->SetInputData(polyData);
+    reverser->ReverseNormalsOn();
+    reverser->Update();
+    polyData = reverser->GetOutput();
+    }
+
+  if (!parameters.JointSmoothing)
+    {
+    if (parameters.FilterType == "Sinc")
+      {
+      vtkNew<vtkWindowedSincPolyDataFilter> smootherSinc;
+      smootherSinc->SetInputData(polyData);
+      smootherSinc->SetPassBand(0.1);
+      smootherSinc->SetNumberOfIterations(parameters.Smooth);
+      smootherSinc->FeatureEdgeSmoothingOff();
+      smootherSinc->BoundarySmoothingOff();
+      smootherSinc->Update();
+      polyData = smootherSinc->GetOutput();
+      }
+    else
+      {
+      vtkNew<vtkSmoothPolyDataFilter> smootherPoly;
+      smootherPoly->SetInputData(polyData);
+      smootherPoly->SetRelaxationFactor(0.33);
+      smootherPoly->SetFeatureAngle(60);
+      smootherPoly->SetConvergence(0);
+      smootherPoly->SetNumberOfIterations(parameters.Smooth);
+      smootherPoly->FeatureEdgeSmoothingOff();
+      smootherPoly->BoundarySmoothingOff();
+      smootherPoly->Update();
+      polyData = smootherPoly->GetOutput();
+      }
+    if (parameters.SaveIntermediateModels)
+      {
+      WriteLabelModelFile(polyData,
+        GetLabelModelFileName(parameters.RootDir, labelModel.Name, "-Smoothed"), parameters.FileHeader);
+      }
+    }
+
+  // each thread uses its own transform, as transform update is not thread-safe
+  vtkNew<vtkTransform> transformIJKtoLPS;
+  transformIJKtoLPS->SetMatrix(parameters.IJKToLPSMatrix);
+  vtkNew<vtkTransformPolyDataFilter> transformer;
+  transformer->SetInputData(polyData);
+  transformer->SetTransform(transformIJKtoLPS);
+
+  vtkNew<vtkPolyDataNormals> normals;
+  normals->SetInputConnection(transformer->GetOutputPort());
+  normals->SetComputePointNormals(parameters.PointNormals);
+  normals->SetFeatureAngle(60);
+  normals->SetSplitting(parameters.SplitNormals);
+
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputConnection(normals->GetOutputPort());
+  stripper->Update();
+
+  return WriteLabelModelFile(stripper->GetOutput(), labelModel.FileName, parameters.FileHeader);
+}
+
+//----------------------------------------------------------------------------
+void ReportProgress(ModuleProcessInformation* processInformation, const std::string& comment, double progress)
+{
+  if (processInformation)
+    {
+    processInformation->Progress = progress;
+    processInformation->StageProgress = 0;
+    strncpy(processInformation->ProgressMessage, comment.c_str(), 1023);
+    if (processInformation->ProgressCallbackFunction
+        && processInformation->ProgressCallbackClientData)
+      {
+      (*(processInformation->ProgressCallbackFunction))(processInformation->ProgressCallbackClientData);
+      }
+    }
+  else
+    {
+    std::cout << "<filter-progress>" << progress << "</filter-progress>" << std::endl << std::flush;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Process label models on a pool of worker threads. Progress is reported
+// from the calling thread, as progress reporting is not thread-safe.
+// Returns false if processing was aborted.
+bool ProcessLabelModelsInParallel(std::vector<LabelModel>& labelModels, const LabelModelParameters& parameters,
+  int numberOfThreads, ModuleProcessInformation* processInformation, double progressStart)
+{
+  if (labelModels.empty())
+    {
+    return true;
+    }
+  if (numberOfThreads <= 0)
+    {
+    numberOfThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+  numberOfThreads = std::min(numberOfThreads, static_cast<int>(labelModels.size()));
+
+  std::atomic<size_t> nextLabelModelIndex(0);
+  std::atomic<bool> abort(false);
+  size_t numberOfProcessedLabelModels = 0;
+  std::mutex processedMutex;
+  std::condition_variable processedCondition;
+
+  std::vector<std::thread> workers;
+  for (int threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
+    {
+    workers.emplace_back([&]()
+      {
+      for (size_t labelModelIndex = nextLabelModelIndex++; labelModelIndex < labelModels.size() && !abort;
+        labelModelIndex = nextLabelModelIndex++)
+        {
+        LabelModel& labelModel = labelModels[labelModelIndex];
+        try
+          {
+          labelModel.Success = ProcessLabelModel(labelModel, parameters);
+          }
+        catch(...)
+          {
+          std::cerr << "ERROR while processing model for label " << labelModel.Label << std::endl;
+          labelModel.Success = false;
+          }
+        // free memory early, surfaces of all labels may be large
+        labelModel.Surface = nullptr;
+        std::lock_guard<std::mutex> lock(processedMutex);
+        ++numberOfProcessedLabelModels;
+        processedCondition.notify_one();
+        }
+      });
+    }
+
+  size_t numberOfReportedLabelModels = 0;
+  while (numberOfReportedLabelModels < labelModels.size() && !abort)
+    {
+    std::unique_lock<std::mutex> lock(processedMutex);
+    processedCondition.wait(lock, [&]{ return numberOfProcessedLabelModels > numberOfReportedLabelModels; });
+    numberOfReportedLabelModels = numberOfProcessedLabelModels;
+    lock.unlock();
+    std::stringstream comment;
+    comment << "Made " << numberOfReportedLabelModels << " of " << labelModels.size() << " models";
+    ReportProgress(processInformation, comment.str(), progressStart
+      + (1.0 - progressStart) * numberOfReportedLabelModels / labelModels.size());
+    if (processInformation && processInformation->Abort)
+      {
+      abort = true;
+      }
+    }
+  for (std::thread& worker : workers)
+    {
+    worker.join();
+    }
+  return !abort;
+}
+
+//----------------------------------------------------------------------------
+// Add model, storage and display nodes of a label model to the output scene
+// and put the model in the flat or the color based model hierarchy.
+void AddLabelModelToScene(vtkMRMLScene* modelScene, const std::string& labelName, const std::string& fileName,
+  int label, vtkMRMLColorTableNode* colorNode, vtkMRMLModelHierarchyNode* topColorHierarchyNode,
+  vtkMRMLNode* rnd, bool debug)
+{
+  // each model needs a mrml node, a storage node and a display node
+  vtkNew<vtkMRMLModelNode> mnode;
+  mnode->SetScene(modelScene);
+  mnode->SetName(labelName.c_str());
+
+  vtkNew<vtkMRMLModelStorageNode> snode;
+  snode->SetFileName(fileName.c_str());
+  if (modelScene->AddNode(snode.GetPointer()) == nullptr)
+    {
+    std::cerr << "ERROR: unable to add the storage node to the model scene" << endl;
+    }
+  vtkNew<vtkMRMLModelDisplayNode> dnode;
+  dnode->SetColor(0.5, 0.5, 0.5);
+  double *rgba;
+  if (colorNode != nullptr)
+    {
+    rgba = colorNode->GetLookupTable()->GetTableValue(label);
+    if (rgba != nullptr)
+      {
+      if (debug)
+        {
+        std::cout << "Got color: " << rgba[0] << " " << rgba[1] << " " << rgba[2] << " " << rgba[3] << endl;
+        }
+      dnode->SetColor(rgba[0], rgba[1], rgba[2]);
+      }
+    else
+      {
+      std::cerr << "Couldn't get look up table value for " << label << ", display node color is not set (grey)"
+                << endl;
+      }
+    }
+
+  dnode->SetVisibility(1);
+  modelScene->AddNode(dnode.GetPointer());
+  if (debug)
+    {
+    std::cout << "Added display node: id = " << (dnode->GetID() == nullptr ? "(null)" : dnode->GetID()) << endl;
+    std::cout << "Setting model's storage node: id = "
+              << (snode->GetID() == nullptr ? "(null)" : snode->GetID()) << endl;
+    }
+  mnode->SetAndObserveStorageNodeID(snode->GetID());
+  mnode->SetAndObserveDisplayNodeID(dnode->GetID());
+  modelScene->AddNode(mnode.GetPointer());
+
+  // put it in the hierarchy, either the flat one by default or
+  // try to find the matching color hierarchy node to make this an
+  // associated node
+  std::string colorName;
+  if (colorNode != nullptr)
+    {
+    colorName = std::string(colorNode->GetColorNameAsFileName(label));
+    }
+  else
+    {
+    // might be in a testing case where the hierarchy nodes are
+    // numbered (made from the generic colors)
+    std::stringstream ss;
+    ss << label;
+    colorName = ss.str();
+    if (debug)
+      {
+      std::cout << "No color node, guessing at color name being same as label number " << colorName.c_str() << std::endl;
+      }
+    }
+  vtkMRMLNode *mrmlNode = nullptr;
+  if (colorName.compare("") != 0)
+    {
+    mrmlNode = modelScene->GetFirstNodeByName(colorName.c_str());
+    }
+  // if there's no color hierarchy, or no color name or the mrml node
+  // named for the color isn't a model hierarchy node, use a flat hierarchy
+  if (topColorHierarchyNode == nullptr ||
+      colorName.compare("") == 0 ||
+      mrmlNode == nullptr ||
+      strcmp(mrmlNode->GetClassName(),"vtkMRMLModelHierarchyNode") != 0)
+    {
+    vtkNew<vtkMRMLModelHierarchyNode> mhnd;
+    mhnd->SetHideFromEditors(1);
+    modelScene->AddNode(mhnd.GetPointer());
+    mhnd->SetParentNodeID(rnd->GetID());
+    mhnd->SetModelNodeID(mnode->GetID());
+    }
+  else
+    {
+    // use the template color hierarchy
+    vtkMRMLModelHierarchyNode *colorHierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(mrmlNode);
+    if (colorHierarchyNode)
+      {
+      colorHierarchyNode->SetAssociatedNodeID(mnode->GetID());
+      // and hide it so that it doesn't clutter up the tree
+      colorHierarchyNode->SetHideFromEditors(1);
+      if (debug)
+        {
+        std::cout << "Found a color hierarchy node with name " << colorHierarchyNode->GetName() << ", set it's associated node to this model id: " << mnode->GetID() << std::endl;
+        }
+      }
+    }
+  if (debug)
+    {
+    std::cout << "...done adding model to output scene" << endl;
+    }
+}
+
+} // end of anonymous namespace
+
 int main(int argc, char * argv[])
 {
   PARSE_ARGS;
@@ -80,6 +556,8 @@ int main(int argc, char * argv[])
     std::cout << "The ending label is: " << EndLabel << std::endl;
     std::cout << "The model name is: " << Name << std::endl;
     std::cout << "Do joint smoothing flag is: " << JointSmoothing << std::endl;
+    std::cout << "Parallel flag is: " << Parallel << std::endl;
+    std::cout << "Number of threads: " << NumberOfThreads << std::endl;
     std::cout << "Generate all flag is: " << GenerateAll << std::endl;
     std::cout << "Number of smoothing iterations: " << Smooth << std::endl;
     std::cout << "Number of decimate iterations: " << Decimate << std::endl;
@@ -351,6 +829,11 @@ int main(int argc, char * argv[])
     useStartEnd = true;
     }
 
+  // in parallel mode labels are collected first and then their surfaces
+  // are extracted and processed concurrently
+  bool parallelMode = (Parallel && makeMultiple);
+  std::vector<LabelModel> parallelLabelModels;
+
   if (makeMultiple)
     {
     numSingletonFilterSteps = 4;
@@ -655,6 +1138,8 @@ int main(int argc, char * argv[])
       }
 
     cubes = vtkSmartPointer<vtkDiscreteFlyingEdges3D>::New();
+    // label values are needed for splitting the surface by label
+    cubes->ComputeScalarsOn();
     std::string            comment1 = "Discrete Marching Cubes";
     vtkPluginFilterWatcher watchDMCubes(cubes,
                                         comment1.c_str(),
@@ -981,6 +1466,20 @@ int main(int argc, char * argv[])
       */
       }
 
+    if (parallelMode)
+      {
+      // surface of this label is extracted and processed after all the
+      // labels are collected
+      LabelModel labelModel;
+      labelModel.Label = i;
+      labelModel.Name = labelName;
+      labelModel.FileName = GetLabelModelFileName(rootDir, labelName, "");
+      labelModel.Empty = false;
+      labelModel.Success = false;
+      parallelLabelModels.push_back(labelModel);
+      continue;
+      }
+
     // threshold
     if (JointSmoothing == 0)
       {
@@ -1624,107 +2123,7 @@ int main(int argc, char * argv[])
           std::cout << "Adding model " << labelName << " to the output scene, with filename " << fileName.c_str()
                     << endl;
           }
-        // each model needs a mrml node, a storage node and a display node
-        vtkNew<vtkMRMLModelNode> mnode;
-        mnode->SetScene(modelScene.GetPointer());
-        mnode->SetName(labelName.c_str());
-
-        vtkNew<vtkMRMLModelStorageNode> snode;
-        snode->SetFileName(fileName.c_str());
-        if (modelScene->AddNode(snode.GetPointer()) == nullptr)
-          {
-          std::cerr << "ERROR: unable to add the storage node to the model scene" << endl;
-          }
-        vtkNew<vtkMRMLModelDisplayNode> dnode;
-        dnode->SetColor(0.5, 0.5, 0.5);
-        double *rgba;
-        if (colorNode != nullptr)
-          {
-          rgba = colorNode->GetLookupTable()->GetTableValue(i);
-          if (rgba != nullptr)
-            {
-            if (debug)
-              {
-              std::cout << "Got color: " << rgba[0] << " " << rgba[1] << " " << rgba[2] << " " << rgba[3] << endl;
-              }
-            dnode->SetColor(rgba[0], rgba[1], rgba[2]);
-            }
-          else
-            {
-            std::cerr << "Couldn't get look up table value for " << i << ", display node color is not set (grey)"
-                      << endl;
-            }
-          }
-
-        dnode->SetVisibility(1);
-        modelScene->AddNode(dnode.GetPointer());
-        if (debug)
-          {
-          std::cout << "Added display node: id = " << (dnode->GetID() == nullptr ? "(null)" : dnode->GetID()) << endl;
-          std::cout << "Setting model's storage node: id = "
-                    << (snode->GetID() == nullptr ? "(null)" : snode->GetID()) << endl;
-          }
-        mnode->SetAndObserveStorageNodeID(snode->GetID());
-        mnode->SetAndObserveDisplayNodeID(dnode->GetID());
-        modelScene->AddNode(mnode.GetPointer());
-
-        // put it in the hierarchy, either the flat one by default or
-        // try to find the matching color hierarchy node to make this an
-        // associated node
-        std::string colorName;
-        if (colorNode != nullptr)
-          {
-          colorName = std::string(colorNode->GetColorNameAsFileName(i));
-          }
-        else
-          {
-          // might be in a testing case where the hierarchy nodes are
-          // numbered (made from the generic colors)
-          std::stringstream ss;
-          ss << i;
-          colorName = ss.str();
-          if (debug)
-            {
-            std::cout << "No color node, guessing at color name being same as label number " << colorName.c_str() << std::endl;
-            }
-          }
-        vtkMRMLNode *mrmlNode = nullptr;
-        if (colorName.compare("") != 0)
-          {
-          mrmlNode = modelScene->GetFirstNodeByName(colorName.c_str());
-          }
-        // if there's no color hierarchy, or no color name or the mrml node
-        // named for the color isn't a model hierarchy node, use a flat hierarchy
-        if (topColorHierarchyNode == nullptr ||
-            colorName.compare("") == 0 ||
-            mrmlNode == nullptr ||
-            strcmp(mrmlNode->GetClassName(),"vtkMRMLModelHierarchyNode") != 0)
-          {
-          vtkNew<vtkMRMLModelHierarchyNode> mhnd;
-          mhnd->SetHideFromEditors(1);
-          modelScene->AddNode(mhnd.GetPointer());
-          mhnd->SetParentNodeID(rnd->GetID());
-          mhnd->SetModelNodeID(mnode->GetID());
-          }
-        else
-          {
-          // use the template color hierarchy
-          vtkMRMLModelHierarchyNode *colorHierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(mrmlNode);
-          if (colorHierarchyNode)
-            {
-            colorHierarchyNode->SetAssociatedNodeID(mnode->GetID());
-            // and hide it so that it doesn't clutter up the tree
-            colorHierarchyNode->SetHideFromEditors(1);
-            if (debug)
-              {
-              std::cout << "Found a color hierarchy node with name " << colorHierarchyNode->GetName() << ", set it's associated node to this model id: " << mnode->GetID() << std::endl;
-              }
-            }
-          }
-        if (debug)
-          {
-          std::cout << "...done adding model to output scene" << endl;
-          }
+        AddLabelModelToScene(modelScene, labelName, fileName, i, colorNode, topColorHierarchyNode, rnd, debug);
         }
       } // end of skipping an empty label
     }   // end of loop over labels
@@ -1732,6 +2131,83 @@ int main(int argc, char * argv[])
     {
     std::cout << "End of looping over labels" << endl;
     }
+
+  if (parallelMode)
+    {
+    // With joint smoothing the surfaces of all labels are smoothed together,
+    // therefore they are split from the smoothed multi-label surface.
+    // Otherwise each worker extracts the surface of its label from the image.
+    vtkImageData* labelImage = nullptr;
+    if (JointSmoothing)
+      {
+      vtkPolyData* allLabelsSurface = smoother->GetOutput();
+      SplitSurfaceByLabel(allLabelsSurface, parallelLabelModels);
+      // the multi-label surface is not needed anymore
+      allLabelsSurface->ReleaseData();
+      }
+    else if (Pad)
+      {
+      padder->Update();
+      labelImage = padder->GetOutput();
+      }
+    else
+      {
+      labelImage = image;
+      }
+    std::vector<LabelModel> labelModels;
+    labelModels.swap(parallelLabelModels);
+
+    if (!JointSmoothing && strcmp(FilterType.c_str(), "Sinc") == 0 && Smooth == 1)
+      {
+      std::cerr << "Warning: Smoothing iterations of 1 not allowed for Sinc filter, using 2" << endl;
+      Smooth = 2;
+      }
+    LabelModelParameters parameters;
+    parameters.JointSmoothing = JointSmoothing;
+    parameters.Smooth = Smooth;
+    parameters.FilterType = FilterType;
+    parameters.Decimate = Decimate;
+    parameters.SplitNormals = SplitNormals;
+    parameters.PointNormals = PointNormals;
+    parameters.SaveIntermediateModels = SaveIntermediateModels;
+    parameters.RootDir = rootDir;
+    parameters.IJKToLPSMatrix = transformIJKtoLPS->GetMatrix();
+    parameters.FileHeader = modelFileHeader;
+    parameters.LabelImage = labelImage;
+    if (debug)
+      {
+      std::cout << "Processing " << labelModels.size() << " models in parallel" << endl;
+      }
+    if (!ProcessLabelModelsInParallel(labelModels, parameters, NumberOfThreads,
+      CLPProcessInformation, currentFilterOffset / numFilterSteps))
+      {
+      std::cerr << "Model generation was aborted" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // add models to the scene in label order, independently from the order of completion
+    for (LabelModel& labelModel : labelModels)
+      {
+      if (labelModel.Empty)
+        {
+        std::cout << "Cannot create a model from label " << labelModel.Label
+                  << "\nNo polygons can be created,\nthere may be no voxels with this label in the volume." << endl;
+        }
+      if (!labelModel.Success)
+        {
+        skippedModels.push_back(labelModel.Label);
+        madeModels.erase(std::remove(madeModels.begin(), madeModels.end(), labelModel.Label), madeModels.end());
+        continue;
+        }
+      if (debug)
+        {
+        std::cout << "Adding model " << labelModel.Name << " to the output scene, with filename "
+                  << labelModel.FileName.c_str() << endl;
+        }
+      AddLabelModelToScene(modelScene, labelModel.Name, labelModel.FileName, labelModel.Label,
+        colorNode, topColorHierarchyNode, rnd, debug);
+      }
+    }
   // Report what was done
   if (madeModels.size() > 0)
     {
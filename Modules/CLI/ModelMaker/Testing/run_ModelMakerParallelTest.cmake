@@ -0,0 +1,59 @@
+
+# test_cmd .........: command to run without args
+# test_name ........: name of the test found in the testing wrapper <test_cmd>
+# input_volume .....: label volume
+# input_scene ......: scene that contains the vtkMRMLModelHierarchyNode1 hierarchy node
+# output_dir .......: directory where the serial and parallel models are written
+
+# Sanity checks
+set(expected_defined_vars test_cmd test_name input_volume input_scene output_dir)
+foreach(var ${expected_defined_vars})
+  if(NOT ${var})
+    message(FATAL_ERROR "Variable ${var} not defined !")
+  endif()
+endforeach()
+
+# Run the test serially and in parallel, each mode writes its models next to its scene
+foreach(mode serial parallel)
+  set(mode_dir ${output_dir}/${mode})
+  file(REMOVE_RECURSE ${mode_dir})
+  file(MAKE_DIRECTORY ${mode_dir})
+  configure_file(${input_scene} ${mode_dir}/ModelMakerTest.mrml COPYONLY)
+  set(mode_args)
+  if(mode STREQUAL "parallel")
+    set(mode_args --parallel --numberOfThreads 2)
+  endif()
+  execute_process(
+    COMMAND ${test_cmd} ${test_name} --generateAll ${mode_args}
+      --modelSceneFile ${mode_dir}/ModelMakerTest.mrml\#vtkMRMLModelHierarchyNode1
+      ${input_volume}
+    RESULT_VARIABLE exec_not_successful
+    )
+  if(exec_not_successful)
+    message(FATAL_ERROR "${test_cmd} failed in ${mode} mode")
+  endif()
+endforeach()
+
+# Parallel mode must write the same models as serial mode
+file(GLOB serial_models RELATIVE ${output_dir}/serial ${output_dir}/serial/*.vtk)
+file(GLOB parallel_models RELATIVE ${output_dir}/parallel ${output_dir}/parallel/*.vtk)
+list(SORT serial_models)
+list(SORT parallel_models)
+if(NOT serial_models)
+  message(SEND_ERROR "No models were written in ${output_dir}/serial")
+endif()
+if(NOT "${serial_models}" STREQUAL "${parallel_models}")
+  message(SEND_ERROR "Serial models (${serial_models}) and parallel models (${parallel_models}) differ")
+endif()
+
+foreach(model ${serial_models})
+  execute_process(
+    COMMAND ${CMAKE_COMMAND} -E compare_files ${output_dir}/serial/${model} ${output_dir}/parallel/${model}
+    RESULT_VARIABLE test_not_successful
+    OUTPUT_QUIET
+    ERROR_QUIET
+    )
+  if(test_not_successful)
+    message(SEND_ERROR "${output_dir}/parallel/${model} does not match ${output_dir}/serial/${model}!")
+  endif()
+endforeach()
@@ -14,16 +14,12 @@
 
 // VTK includes
 #include <vtkImageData.h>
-#include <vtkImageStencil.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
-#include <vtkPolyDataNormals.h>
-#include <vtkPolyDataToImageStencil.h>
-#include <vtkStripper.h>
 #include <vtkTransform.h>
 #include <vtkTransformPolyDataFilter.h>
-#include <vtkTriangleFilter.h>
 
 // MRML includes
 #include "vtkMRMLModelNode.h"
@@ -33,25 +29,39 @@
 #include "vtkMRMLVolumeArchetypeStorageNode.h"
 #include "vtkOrientedImageData.h"
 
+// SegmentationCore includes
+#include "vtkClosedSurfaceToBinaryLabelmapConversionRule.h"
+
+// STD includes
+#include <vector>
+
 
 int main( int argc, char * argv[] )
 {
   PARSE_ARGS;
 
-  // read the poly data
-  vtkNew<vtkMRMLModelStorageNode> modelStorageNode;
-  vtkNew<vtkMRMLModelNode> modelNode;
-  modelStorageNode->SetFileName(surface.c_str());
-  if (!modelStorageNode->ReadData(modelNode))
+  // models and label values, later models overwrite earlier ones where they overlap
+  std::vector<std::string> surfaces;
+  std::vector<int> labelValues;
+  surfaces.push_back(surface);
+  labelValues.push_back(labelValue);
+  if (!additionalLabelValues.empty() && additionalLabelValues.size() != additionalSurfaces.size())
     {
-    std::cerr << "Failed to read input model file " << surface << std::endl;
+    std::cerr << "Number of additional label values (" << additionalLabelValues.size()
+              << ") does not match the number of additional models (" << additionalSurfaces.size() << ")" << std::endl;
     return EXIT_FAILURE;
     }
-  vtkSmartPointer<vtkPolyData> closedSurfacePolyData_RAS = modelNode->GetPolyData();
-  if (!closedSurfacePolyData_RAS || closedSurfacePolyData_RAS->GetNumberOfPoints() < 2 || closedSurfacePolyData_RAS->GetNumberOfCells() < 2)
+  for (size_t surfaceIndex = 0; surfaceIndex < additionalSurfaces.size(); ++surfaceIndex)
     {
-    std::cerr << "Invalid polydata in model file " << surface << std::endl;
-    return EXIT_FAILURE;
+    surfaces.push_back(additionalSurfaces[surfaceIndex]);
+    labelValues.push_back(additionalLabelValues.empty()
+      ? labelValue + static_cast<int>(surfaceIndex) + 1 : additionalLabelValues[surfaceIndex]);
+    if (labelValues.back() < 0 || labelValues.back() > 255)
+      {
+      std::cerr << "Label value " << labelValues.back() << " of model " << surfaces.back()
+                << " is out of the unsigned char range" << std::endl;
+      return EXIT_FAILURE;
+      }
     }
 
   vtkNew<vtkMRMLScalarVolumeNode> referenceVolumeNode;
@@ -89,49 +99,50 @@ int main( int argc, char * argv[] )
 
   // Now the output labelmap image data contains the right geometry.
   // We need to apply inverse of geometry matrix to the input poly data so that we can perform
-  // the conversion in IJK space, because the filters do not support oriented image data.
+  // the conversion in IJK space, because the rasterization does not support oriented image data.
   vtkNew<vtkMatrix4x4> ijkToRASMatrix;
   referenceVolumeNode->GetIJKToRASMatrix(ijkToRASMatrix);
   vtkNew<vtkTransform> rasToIJKTransform;
   rasToIJKTransform->SetMatrix(ijkToRASMatrix);
   rasToIJKTransform->Inverse();
 
-  // Leave to identity matrix in binary labelmap volume so that we can perform the stencil operation in IJK space,
-  // and now we convert the closed surface to IJK space, too.
-  vtkNew<vtkTransformPolyDataFilter> transformPolyDataFilter;
-  transformPolyDataFilter->SetInputData(closedSurfacePolyData_RAS);
-  transformPolyDataFilter->SetTransform(rasToIJKTransform);
-
-  // Compute polydata normals
-  vtkNew<vtkPolyDataNormals> normalFilter;
-  normalFilter->SetInputConnection(transformPolyDataFilter->GetOutputPort());
-  normalFilter->ConsistencyOn();
-
-  // Make sure that we have a clean triangle polydata
-  vtkNew<vtkTriangleFilter> triangle;
-  triangle->SetInputConnection(normalFilter->GetOutputPort());
-
-  // Convert to triangle strip
-  vtkNew<vtkStripper> stripper;
-  stripper->SetInputConnection(triangle->GetOutputPort());
-
-  // Convert polydata to stencil
-  vtkNew<vtkPolyDataToImageStencil> polyDataToImageStencil;
-  polyDataToImageStencil->SetInputConnection(stripper->GetOutputPort());
-  polyDataToImageStencil->SetOutputSpacing(binaryLabelmap->GetSpacing());
-  polyDataToImageStencil->SetOutputOrigin(binaryLabelmap->GetOrigin());
-  polyDataToImageStencil->SetOutputWholeExtent(binaryLabelmap->GetExtent());
-
-  // Convert stencil to image
-  vtkNew<vtkImageStencil> stencil;
-  stencil->SetInputData(binaryLabelmap);
-  stencil->SetStencilConnection(polyDataToImageStencil->GetOutputPort());
-  stencil->ReverseStencilOn();
-  stencil->SetBackgroundValue(labelValue);
-  stencil->Update();
+  for (size_t surfaceIndex = 0; surfaceIndex < surfaces.size(); ++surfaceIndex)
+    {
+    // read the poly data
+    vtkNew<vtkMRMLModelStorageNode> modelStorageNode;
+    vtkNew<vtkMRMLModelNode> modelNode;
+    modelStorageNode->SetFileName(surfaces[surfaceIndex].c_str());
+    if (!modelStorageNode->ReadData(modelNode))
+      {
+      std::cerr << "Failed to read input model file " << surfaces[surfaceIndex] << std::endl;
+      return EXIT_FAILURE;
+      }
+    vtkSmartPointer<vtkPolyData> closedSurfacePolyData_RAS = modelNode->GetPolyData();
+    if (!closedSurfacePolyData_RAS || closedSurfacePolyData_RAS->GetNumberOfPoints() < 2 || closedSurfacePolyData_RAS->GetNumberOfCells() < 2)
+      {
+      std::cerr << "Invalid polydata in model file " << surfaces[surfaceIndex] << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Leave to identity matrix in binary labelmap volume so that we can perform the rasterization in IJK space,
+    // and now we convert the closed surface to IJK space, too.
+    vtkNew<vtkTransformPolyDataFilter> transformPolyDataFilter;
+    transformPolyDataFilter->SetInputData(closedSurfacePolyData_RAS);
+    transformPolyDataFilter->SetTransform(rasToIJKTransform);
+    transformPolyDataFilter->Update();
+
+    // Same rasterization as the closed surface to binary labelmap conversion of segmentations,
+    // slabs of slices are processed concurrently
+    if (!vtkClosedSurfaceToBinaryLabelmapConversionRule::RasterizeClosedSurface(
+      transformPolyDataFilter->GetOutput(), binaryLabelmap, labelValues[surfaceIndex]))
+      {
+      std::cerr << "Failed to rasterize model " << surfaces[surfaceIndex] << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
 
   vtkNew<vtkMRMLLabelMapVolumeNode> outputVolumeNode;
-  outputVolumeNode->SetAndObserveImageData(stencil->GetOutput());
+  outputVolumeNode->SetAndObserveImageData(binaryLabelmap);
   outputVolumeNode->SetIJKToRASMatrix(ijkToRASMatrix);
 
   vtkNew<vtkMRMLVolumeArchetypeStorageNode> outputVolumeStorageNode;
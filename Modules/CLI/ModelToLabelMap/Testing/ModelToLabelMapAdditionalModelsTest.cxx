@@ -0,0 +1,166 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLLabelMapVolumeNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLModelStorageNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLVolumeArchetypeStorageNode.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkSphereSource.h>
+
+// STD includes
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifdef WIN32
+#define MODULE_IMPORT __declspec(dllimport)
+#else
+#define MODULE_IMPORT
+#endif
+
+extern "C" MODULE_IMPORT int ModuleEntryPoint(int, char * []);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool writeSphere(const std::string& fileName, double centerX)
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetCenter(centerX, 20., 20.);
+  sphere->SetRadius(8.);
+  sphere->SetThetaResolution(32);
+  sphere->SetPhiResolution(32);
+  sphere->Update();
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetAndObservePolyData(sphere->GetOutput());
+  vtkNew<vtkMRMLModelStorageNode> modelStorageNode;
+  modelStorageNode->SetFileName(fileName.c_str());
+  return modelStorageNode->WriteData(modelNode) != 0;
+}
+
+//----------------------------------------------------------------------------
+int runModule(std::vector<std::string> arguments)
+{
+  std::vector<char*> argv;
+  for (std::string& argument : arguments)
+    {
+    argv.push_back(&argument[0]);
+    }
+  argv.push_back(nullptr);
+  return ModuleEntryPoint(static_cast<int>(arguments.size()), argv.data());
+}
+
+//----------------------------------------------------------------------------
+bool checkLabel(vtkImageData* labelmap, int i, int expectedLabel)
+{
+  int label = static_cast<int>(labelmap->GetScalarComponentAsDouble(i, 20, 20, 0));
+  if (label != expectedLabel)
+    {
+    std::cerr << "Voxel (" << i << ", 20, 20): expected label " << expectedLabel
+              << ", got " << label << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool checkOutput(const std::string& fileName, int leftLabel, int rightLabel, int overlapLabel)
+{
+  vtkNew<vtkMRMLLabelMapVolumeNode> outputVolumeNode;
+  vtkNew<vtkMRMLVolumeArchetypeStorageNode> outputVolumeStorageNode;
+  outputVolumeStorageNode->SetFileName(fileName.c_str());
+  if (!outputVolumeStorageNode->ReadData(outputVolumeNode) || !outputVolumeNode->GetImageData())
+    {
+    std::cerr << "Failed to read output volume file " << fileName << std::endl;
+    return false;
+    }
+  vtkImageData* labelmap = outputVolumeNode->GetImageData();
+  // Left sphere is centered at 12, right sphere at 26, they overlap from 18 to 20
+  return checkLabel(labelmap, 2, 0)
+    && checkLabel(labelmap, 12, leftLabel)
+    && checkLabel(labelmap, 19, overlapLabel)
+    && checkLabel(labelmap, 26, rightLabel)
+    && checkLabel(labelmap, 37, 0);
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int ModelToLabelMapAdditionalModelsTest(int argc, char * argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir(argv[1]);
+  std::string referenceFileName = tempDir + "/ModelToLabelMapAdditionalModelsReference.nrrd";
+  std::string leftModelFileName = tempDir + "/ModelToLabelMapAdditionalModelsLeft.vtk";
+  std::string rightModelFileName = tempDir + "/ModelToLabelMapAdditionalModelsRight.vtk";
+  std::string outputFileName = tempDir + "/ModelToLabelMapAdditionalModelsOutput.nrrd";
+
+  // 40x40x40 reference volume, IJK and RAS coordinates are the same
+  vtkNew<vtkImageData> referenceImage;
+  referenceImage->SetDimensions(40, 40, 40);
+  referenceImage->AllocateScalars(VTK_SHORT, 1);
+  referenceImage->GetPointData()->GetScalars()->Fill(0);
+  vtkNew<vtkMRMLScalarVolumeNode> referenceVolumeNode;
+  referenceVolumeNode->SetAndObserveImageData(referenceImage);
+  vtkNew<vtkMRMLVolumeArchetypeStorageNode> referenceVolumeStorageNode;
+  referenceVolumeStorageNode->SetFileName(referenceFileName.c_str());
+  if (!referenceVolumeStorageNode->WriteData(referenceVolumeNode))
+    {
+    std::cerr << "Failed to write reference volume file " << referenceFileName << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (!writeSphere(leftModelFileName, 12.) || !writeSphere(rightModelFileName, 26.))
+    {
+    std::cerr << "Failed to write model files" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Additional model with an explicit label value, it overwrites the first model
+  if (runModule({"ModelToLabelMap", "--labelValue", "3",
+                 "--additionalModels", rightModelFileName, "--additionalLabelValues", "7",
+                 referenceFileName, leftModelFileName, outputFileName}) != EXIT_SUCCESS
+    || !checkOutput(outputFileName, 3, 7, 7))
+    {
+    std::cerr << "Additional model with explicit label value failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Models swapped, the additional model gets the next label value
+  if (runModule({"ModelToLabelMap", "--labelValue", "3",
+                 "--additionalModels", leftModelFileName,
+                 referenceFileName, rightModelFileName, outputFileName}) != EXIT_SUCCESS
+    || !checkOutput(outputFileName, 4, 3, 4))
+    {
+    std::cerr << "Additional model with default label value failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  return EXIT_SUCCESS;
+}
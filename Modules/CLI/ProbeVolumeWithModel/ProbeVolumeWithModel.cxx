@@ -5,10 +5,17 @@
 #include <vtkTeemNRRDReader.h>
 
 // VTK includes
+#include <vtkCharArray.h>
+#include <vtkDataArray.h>
 #include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPointSet.h>
 #include <vtkPolyData.h>
 #include <vtkProbeFilter.h>
+#include <vtkSMPTools.h>
+#include <vtkSmartPointer.h>
 #include <vtkTransform.h>
 #include <vtkTransformFilter.h>
 #include <vtkImageChangeInformation.h>
@@ -18,50 +25,145 @@
 
 #include <vtksys/SystemTools.hxx>
 
-int main(int argc, char* argv[])
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace
 {
-  PARSE_ARGS;
 
-  // Read the file
-  // Use vtkTeemNRRDReader because it supports both scalar and vector volumes.
-  vtkNew<vtkTeemNRRDReader> readerVol;
-  readerVol->SetFileName(InputVolume.c_str());
-  readerVol->SetDataArrayName(OutputArrayName);
-  readerVol->Update();
-  vtkImageData* volume = readerVol->GetOutput();
-  int* extent = volume->GetExtent();
-  if (extent[0]>extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+//----------------------------------------------------------------------------
+// Get the two voxels and the weight of the second one along one axis.
+// Returns false if the coordinate is outside of the [minIndex, maxIndex] range.
+bool GetAxisWeight(double x, int minIndex, int maxIndex, bool nearest,
+  int& index0, int& index1, double& weight)
+{
+  // same tolerance as the cell search of vtkProbeFilter, in voxels
+  const double tolerance = 1e-3;
+  if (x < minIndex - tolerance || x > maxIndex + tolerance)
     {
-    std::cerr << "Input image file is empty: " << InputVolume << std::endl;
-    return EXIT_FAILURE;
+    return false;
+    }
+  x = std::min(std::max(x, static_cast<double>(minIndex)), static_cast<double>(maxIndex));
+  if (nearest || minIndex == maxIndex)
+    {
+    index0 = std::min(static_cast<int>(std::floor(x + 0.5)), maxIndex);
+    index1 = index0;
+    weight = 0.0;
+    return true;
+    }
+  index0 = std::min(static_cast<int>(std::floor(x)), maxIndex - 1);
+  index1 = index0 + 1;
+  weight = x - index0;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+T CastInterpolatedValue(double value)
+{
+  if (std::numeric_limits<T>::is_integer)
+    {
+    value = std::floor(value + 0.5);
+    value = std::min(std::max(value, static_cast<double>(std::numeric_limits<T>::lowest())),
+      static_cast<double>(std::numeric_limits<T>::max()));
     }
-  std::cout << "Done reading the file " << InputVolume << endl;
+  return static_cast<T>(value);
+}
+
+//----------------------------------------------------------------------------
+// Sample the voxels at each point of ijkPoints (3 coordinates per point).
+// A point is inside if each of its coordinates is in the extent, within the
+// tolerance of GetAxisWeight(). Points outside of the volume get 0 and are
+// marked invalid in validMask, valid points are left unchanged so that the
+// mask of several volumes is the intersection of the volumes.
+template <class T>
+void ProbeScalars(const T* scalars, const int extent[6], int numberOfComponents,
+  const std::vector<double>& ijkPoints, bool nearest, T* output, char* validMask)
+{
+  const vtkIdType numberOfPoints = static_cast<vtkIdType>(ijkPoints.size() / 3);
+  const vtkIdType increments[3] =
+    {
+    numberOfComponents,
+    numberOfComponents * static_cast<vtkIdType>(extent[1] - extent[0] + 1),
+    numberOfComponents * static_cast<vtkIdType>(extent[1] - extent[0] + 1) * (extent[3] - extent[2] + 1)
+    };
 
+  vtkSMPTools::For(0, numberOfPoints, [&](vtkIdType begin, vtkIdType end)
+    {
+    for (vtkIdType pointId = begin; pointId < end; ++pointId)
+      {
+      T* value = output + pointId * numberOfComponents;
+      int index0[3] = { 0, 0, 0 };
+      int index1[3] = { 0, 0, 0 };
+      double weight[3] = { 0.0, 0.0, 0.0 };
+      bool inside = true;
+      for (int axis = 0; axis < 3 && inside; ++axis)
+        {
+        inside = GetAxisWeight(ijkPoints[3 * pointId + axis], extent[2 * axis], extent[2 * axis + 1], nearest,
+          index0[axis], index1[axis], weight[axis]);
+        }
+      if (!inside)
+        {
+        std::fill(value, value + numberOfComponents, static_cast<T>(0));
+        validMask[pointId] = 0;
+        continue;
+        }
+
+      vtkIdType offsets[2][3];
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        offsets[0][axis] = (index0[axis] - extent[2 * axis]) * increments[axis];
+        offsets[1][axis] = (index1[axis] - extent[2 * axis]) * increments[axis];
+        }
+      for (int component = 0; component < numberOfComponents; ++component)
+        {
+        double interpolatedValue = 0.0;
+        for (int corner = 0; corner < 8; ++corner)
+          {
+          const int ci = corner & 1;
+          const int cj = (corner >> 1) & 1;
+          const int ck = (corner >> 2) & 1;
+          const double cornerWeight = (ci ? weight[0] : 1.0 - weight[0])
+            * (cj ? weight[1] : 1.0 - weight[1])
+            * (ck ? weight[2] : 1.0 - weight[2]);
+          if (cornerWeight == 0.0)
+            {
+            continue;
+            }
+          interpolatedValue += cornerWeight
+            * scalars[offsets[ci][0] + offsets[cj][1] + offsets[ck][2] + component];
+          }
+        value[component] = CastInterpolatedValue<T>(interpolatedValue);
+        }
+      }
+    });
+}
+
+//----------------------------------------------------------------------------
+// Probe a vector, normal or tensor volume with vtkProbeFilter, the probed
+// values are transformed back into RAS space the same way as the points.
+vtkSmartPointer<vtkDataArray> ProbeWithFilter(vtkTeemNRRDReader* reader, vtkPointSet* mesh,
+  bool nearest, vtkCharArray* validMask, int& attributeType)
+{
   vtkNew<vtkImageChangeInformation> ici;
-  ici->SetInputConnection(readerVol->GetOutputPort());
+  ici->SetInputConnection(reader->GetOutputPort());
   ici->SetOutputSpacing(1, 1, 1);
   ici->SetOutputOrigin(0, 0, 0);
   ici->Update();
-  vtkImageData* volume_Ijk = ici->GetOutput();
-
-  vtkNew<vtkMRMLModelStorageNode> modelStorageNode;
-  vtkNew<vtkMRMLModelNode> modelNode;
-  modelStorageNode->SetFileName(InputModel.c_str());
-  if (!modelStorageNode->ReadData(modelNode))
-    {
-    std::cerr << "Failed to read input model file " << InputModel << std::endl;
-    return EXIT_FAILURE;
-    }
 
   // Transform the model into the volume's IJK space
   vtkNew<vtkTransformFilter> modelTransformerRasToIjk;
   vtkNew<vtkTransform> transformRasToIjk;
-  transformRasToIjk->SetMatrix(readerVol->GetRasToIjkMatrix());
+  transformRasToIjk->SetMatrix(reader->GetRasToIjkMatrix());
   modelTransformerRasToIjk->SetTransform(transformRasToIjk);
-  modelTransformerRasToIjk->SetInputConnection(modelNode->GetMeshConnection());
+  modelTransformerRasToIjk->SetInputData(mesh);
 
   vtkNew<vtkProbeFilter> probe;
-  probe->SetSourceData(volume_Ijk);
+  probe->SetSourceData(ici->GetOutput());
+  probe->SetCategoricalData(nearest);
   probe->SetInputConnection(modelTransformerRasToIjk->GetOutputPort());
 
   // Transform the model back into RAS space
@@ -70,8 +172,161 @@ int main(int argc, char* argv[])
   modelTransformerIjkToRas->SetInputConnection(probe->GetOutputPort());
   modelTransformerIjkToRas->Update();
 
+  vtkPointData* probedPointData = modelTransformerIjkToRas->GetOutput()->GetPointData();
+  int arrayIndex = -1;
+  vtkSmartPointer<vtkDataArray> probedArray = probedPointData->GetArray(reader->GetDataArrayName().c_str(), arrayIndex);
+  attributeType = probedArray ? probedPointData->IsArrayAnAttribute(arrayIndex) : -1;
+
+  vtkDataArray* probedValidMask = probedPointData->GetArray(probe->GetValidPointMaskArrayName());
+  if (probedValidMask)
+    {
+    for (vtkIdType pointId = 0; pointId < validMask->GetNumberOfTuples(); ++pointId)
+      {
+      if (probedValidMask->GetComponent(pointId, 0) == 0)
+        {
+        validMask->SetValue(pointId, 0);
+        }
+      }
+    }
+  return probedArray;
+}
+
+} // end of anonymous namespace
+
+int main(int argc, char* argv[])
+{
+  PARSE_ARGS;
+
+  std::vector<std::string> inputVolumes;
+  std::vector<std::string> outputArrayNames;
+  inputVolumes.push_back(InputVolume);
+  outputArrayNames.push_back(OutputArrayName);
+  if (!AdditionalOutputArrayNames.empty() && AdditionalOutputArrayNames.size() != AdditionalInputVolumes.size())
+    {
+    std::cerr << "Number of additional output array names (" << AdditionalOutputArrayNames.size()
+              << ") does not match the number of additional input volumes (" << AdditionalInputVolumes.size() << ")" << std::endl;
+    return EXIT_FAILURE;
+    }
+  for (size_t volumeIndex = 0; volumeIndex < AdditionalInputVolumes.size(); ++volumeIndex)
+    {
+    inputVolumes.push_back(AdditionalInputVolumes[volumeIndex]);
+    outputArrayNames.push_back(AdditionalOutputArrayNames.empty()
+      ? vtksys::SystemTools::GetFilenameWithoutLastExtension(AdditionalInputVolumes[volumeIndex])
+      : AdditionalOutputArrayNames[volumeIndex]);
+    }
+  const bool nearest = (Interpolation == "nearestNeighbor");
+
+  vtkNew<vtkMRMLModelStorageNode> modelStorageNode;
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelStorageNode->SetFileName(InputModel.c_str());
+  if (!modelStorageNode->ReadData(modelNode))
+    {
+    std::cerr << "Failed to read input model file " << InputModel << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkPointSet* inputMesh = modelNode->GetMesh();
+  const vtkIdType numberOfPoints = inputMesh->GetNumberOfPoints();
+
+  // The output only contains the probed arrays, as with vtkProbeFilter
+  vtkSmartPointer<vtkPointSet> outputMesh = vtkSmartPointer<vtkPointSet>::Take(inputMesh->NewInstance());
+  outputMesh->CopyStructure(inputMesh);
+
+  // Same name as the mask of vtkProbeFilter. It is 1 for the points inside
+  // all the volumes: each volume only clears the points outside of it.
+  vtkNew<vtkCharArray> validMask;
+  validMask->SetName("vtkValidPointMask");
+  validMask->SetNumberOfTuples(numberOfPoints);
+  validMask->FillValue(1);
+
+  // IJK coordinates of the model points, reused as long as
+  // the volumes have the same geometry
+  vtkNew<vtkMatrix4x4> ijkPointsRasToIjk;
+  std::vector<double> ijkPoints;
+
+  for (size_t volumeIndex = 0; volumeIndex < inputVolumes.size(); ++volumeIndex)
+    {
+    // Use vtkTeemNRRDReader because it supports both scalar and vector volumes.
+    vtkNew<vtkTeemNRRDReader> readerVol;
+    readerVol->SetFileName(inputVolumes[volumeIndex].c_str());
+    readerVol->SetDataArrayName(outputArrayNames[volumeIndex]);
+    readerVol->Update();
+    vtkImageData* volume = readerVol->GetOutput();
+    int* extent = volume->GetExtent();
+    if (extent[0]>extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+      {
+      std::cerr << "Input image file is empty: " << inputVolumes[volumeIndex] << std::endl;
+      return EXIT_FAILURE;
+      }
+    std::cout << "Done reading the file " << inputVolumes[volumeIndex] << endl;
+
+    vtkSmartPointer<vtkDataArray> probedArray;
+    int attributeType = vtkDataSetAttributes::SCALARS;
+    vtkDataArray* volumeScalars = volume->GetPointData()->GetScalars();
+    if (volumeScalars)
+      {
+      vtkMatrix4x4* rasToIjk = readerVol->GetRasToIjkMatrix();
+      bool sameGeometry = !ijkPoints.empty();
+      for (int element = 0; element < 16 && sameGeometry; ++element)
+        {
+        sameGeometry = (rasToIjk->GetElement(element / 4, element % 4)
+          == ijkPointsRasToIjk->GetElement(element / 4, element % 4));
+        }
+      if (!sameGeometry)
+        {
+        ijkPointsRasToIjk->DeepCopy(rasToIjk);
+        ijkPoints.resize(3 * numberOfPoints);
+        vtkPoints* points = inputMesh->GetPoints();
+        vtkSMPTools::For(0, numberOfPoints, [&](vtkIdType begin, vtkIdType end)
+          {
+          double ras[4] = { 0.0, 0.0, 0.0, 1.0 };
+          double ijk[4] = { 0.0, 0.0, 0.0, 1.0 };
+          for (vtkIdType pointId = begin; pointId < end; ++pointId)
+            {
+            points->GetPoint(pointId, ras);
+            ijkPointsRasToIjk->MultiplyPoint(ras, ijk);
+            std::copy(ijk, ijk + 3, ijkPoints.begin() + 3 * pointId);
+            }
+          });
+        }
+
+      probedArray = vtkSmartPointer<vtkDataArray>::Take(volumeScalars->NewInstance());
+      probedArray->SetName(outputArrayNames[volumeIndex].c_str());
+      probedArray->SetNumberOfComponents(volumeScalars->GetNumberOfComponents());
+      probedArray->SetNumberOfTuples(numberOfPoints);
+      switch (volumeScalars->GetDataType())
+        {
+        vtkTemplateMacro(ProbeScalars<VTK_TT>(static_cast<const VTK_TT*>(volumeScalars->GetVoidPointer(0)),
+          extent, volumeScalars->GetNumberOfComponents(), ijkPoints, nearest,
+          static_cast<VTK_TT*>(probedArray->GetVoidPointer(0)), validMask->GetPointer(0)));
+        default:
+          std::cerr << "Unsupported scalar type in " << inputVolumes[volumeIndex] << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    else
+      {
+      probedArray = ProbeWithFilter(readerVol, inputMesh, nearest, validMask, attributeType);
+      }
+    if (!probedArray)
+      {
+      std::cerr << "Failed to probe " << inputVolumes[volumeIndex] << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // the first volume sets the active attribute, as vtkProbeFilter does
+    if (volumeIndex == 0 && attributeType >= 0)
+      {
+      outputMesh->GetPointData()->SetAttribute(probedArray, attributeType);
+      }
+    else
+      {
+      outputMesh->GetPointData()->AddArray(probedArray);
+      }
+    }
+  outputMesh->GetPointData()->AddArray(validMask);
+
   // Save the output
-  modelNode->SetAndObserveMesh(modelTransformerIjkToRas->GetOutput());
+  modelNode->SetAndObserveMesh(outputMesh);
   modelStorageNode->SetFileName(OutputModel.c_str());
   if (!modelStorageNode->WriteData(modelNode))
     {
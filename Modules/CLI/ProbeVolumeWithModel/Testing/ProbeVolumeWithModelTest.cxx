@@ -0,0 +1,359 @@
+// Compare the output of ProbeVolumeWithModel with the output of the
+// vtkProbeFilter pipeline the module used before it sampled the voxels itself.
+//
+// Usage:
+//   ProbeVolumeWithModelTest generate <outputModel> <volume> [<volume> ...]
+//     Write a model with points inside, on the boundary and outside of
+//     each volume.
+//   ProbeVolumeWithModelTest compare <probedModel> <linear|nearestNeighbor> <volume> <arrayName> [<volume> <arrayName> ...]
+//     Probe the points of <probedModel> with vtkProbeFilter and compare the
+//     result with the arrays written by ProbeVolumeWithModel.
+
+// vtkTeem includes
+#include <vtkTeemNRRDReader.h>
+
+// MRML includes
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLModelStorageNode.h>
+
+// VTK includes
+#include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkDataSet.h>
+#include <vtkImageChangeInformation.h>
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPointSet.h>
+#include <vtkPolyData.h>
+#include <vtkProbeFilter.h>
+#include <vtkSmartPointer.h>
+#include <vtkTransform.h>
+#include <vtkTransformFilter.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+bool ReadVolume(const std::string& fileName, const std::string& arrayName, vtkTeemNRRDReader* reader)
+{
+  reader->SetFileName(fileName.c_str());
+  reader->SetDataArrayName(arrayName);
+  reader->Update();
+  int* extent = reader->GetOutput()->GetExtent();
+  if (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5])
+    {
+    std::cerr << "Failed to read volume " << fileName << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void AddIjkPoint(vtkMatrix4x4* ijkToRas, double i, double j, double k, vtkPoints* points)
+{
+  double ijk[4] = { i, j, k, 1.0 };
+  double ras[4] = { 0.0, 0.0, 0.0, 1.0 };
+  ijkToRas->MultiplyPoint(ijk, ras);
+  points->InsertNextPoint(ras);
+}
+
+//----------------------------------------------------------------------------
+// Add points inside the volume (at fractional voxel positions), at the
+// corner voxel centers, on the faces, just outside and far outside.
+void AddTestPoints(vtkTeemNRRDReader* reader, vtkPoints* points)
+{
+  vtkNew<vtkMatrix4x4> ijkToRas;
+  vtkMatrix4x4::Invert(reader->GetRasToIjkMatrix(), ijkToRas);
+  int* extent = reader->GetOutput()->GetExtent();
+  const double minIndex[3] = { double(extent[0]), double(extent[2]), double(extent[4]) };
+  const double maxIndex[3] = { double(extent[1]), double(extent[3]), double(extent[5]) };
+  double middle[3];
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    middle[axis] = 0.5 * (minIndex[axis] + maxIndex[axis]) + 0.3;
+    }
+
+  // Inside, away from voxel centers and from the half voxel ties
+  // of the nearest neighbor sampling
+  const int gridSize = 5;
+  const double fractions[3] = { 0.25, 0.7, 0.4 };
+  for (int k = 0; k < gridSize; ++k)
+    {
+    for (int j = 0; j < gridSize; ++j)
+      {
+      for (int i = 0; i < gridSize; ++i)
+        {
+        const int gridIndex[3] = { i, j, k };
+        double ijk[3];
+        for (int axis = 0; axis < 3; ++axis)
+          {
+          const double step = (maxIndex[axis] - minIndex[axis]) / gridSize;
+          ijk[axis] = std::floor(minIndex[axis] + gridIndex[axis] * step) + fractions[(axis + gridIndex[axis]) % 3];
+          ijk[axis] = std::min(ijk[axis], maxIndex[axis]);
+          }
+        AddIjkPoint(ijkToRas, ijk[0], ijk[1], ijk[2], points);
+        }
+      }
+    }
+
+  // Boundary: corner voxel centers and the middle of each face
+  for (int corner = 0; corner < 8; ++corner)
+    {
+    AddIjkPoint(ijkToRas,
+      (corner & 1) ? maxIndex[0] : minIndex[0],
+      (corner & 2) ? maxIndex[1] : minIndex[1],
+      (corner & 4) ? maxIndex[2] : minIndex[2], points);
+    }
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    double ijk[3] = { middle[0], middle[1], middle[2] };
+    ijk[axis] = minIndex[axis];
+    AddIjkPoint(ijkToRas, ijk[0], ijk[1], ijk[2], points);
+    ijk[axis] = maxIndex[axis];
+    AddIjkPoint(ijkToRas, ijk[0], ijk[1], ijk[2], points);
+    }
+
+  // Outside: a fraction of a voxel away from each face and far away
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    double ijk[3] = { middle[0], middle[1], middle[2] };
+    ijk[axis] = minIndex[axis] - 0.6;
+    AddIjkPoint(ijkToRas, ijk[0], ijk[1], ijk[2], points);
+    ijk[axis] = maxIndex[axis] + 0.6;
+    AddIjkPoint(ijkToRas, ijk[0], ijk[1], ijk[2], points);
+    }
+  AddIjkPoint(ijkToRas, maxIndex[0] + 100.0, maxIndex[1] + 100.0, maxIndex[2] + 100.0, points);
+}
+
+//----------------------------------------------------------------------------
+int Generate(int argc, char* argv[])
+{
+  if (argc < 4)
+    {
+    std::cerr << "Usage: " << argv[0] << " generate <outputModel> <volume> [<volume> ...]" << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  for (int argIndex = 3; argIndex < argc; ++argIndex)
+    {
+    vtkNew<vtkTeemNRRDReader> reader;
+    if (!ReadVolume(argv[argIndex], "Scalars", reader))
+      {
+      return EXIT_FAILURE;
+      }
+    AddTestPoints(reader, points);
+    }
+
+  vtkNew<vtkCellArray> vertices;
+  for (vtkIdType pointId = 0; pointId < points->GetNumberOfPoints(); ++pointId)
+    {
+    vertices->InsertNextCell(1, &pointId);
+    }
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(points);
+  polyData->SetVerts(vertices);
+
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetAndObservePolyData(polyData);
+  vtkNew<vtkMRMLModelStorageNode> modelStorageNode;
+  modelStorageNode->SetFileName(argv[2]);
+  if (!modelStorageNode->WriteData(modelNode))
+    {
+    std::cerr << "Failed to write model " << argv[2] << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+// The pipeline ProbeVolumeWithModel used for all the volumes: the model is
+// transformed into IJK space and probed with vtkProbeFilter.
+vtkSmartPointer<vtkDataSet> ProbeWithFilter(vtkTeemNRRDReader* reader, vtkPointSet* mesh, bool nearest)
+{
+  vtkNew<vtkImageChangeInformation> ici;
+  ici->SetInputConnection(reader->GetOutputPort());
+  ici->SetOutputSpacing(1, 1, 1);
+  ici->SetOutputOrigin(0, 0, 0);
+  ici->Update();
+
+  vtkNew<vtkTransformFilter> modelTransformerRasToIjk;
+  vtkNew<vtkTransform> transformRasToIjk;
+  transformRasToIjk->SetMatrix(reader->GetRasToIjkMatrix());
+  modelTransformerRasToIjk->SetTransform(transformRasToIjk);
+  modelTransformerRasToIjk->SetInputData(mesh);
+
+  vtkNew<vtkProbeFilter> probe;
+  probe->SetSourceData(ici->GetOutput());
+  probe->SetCategoricalData(nearest);
+  probe->SetInputConnection(modelTransformerRasToIjk->GetOutputPort());
+  probe->Update();
+  return probe->GetOutput();
+}
+
+//----------------------------------------------------------------------------
+int Compare(int argc, char* argv[])
+{
+  if (argc < 6 || (argc - 4) % 2 != 0)
+    {
+    std::cerr << "Usage: " << argv[0]
+              << " compare <probedModel> <linear|nearestNeighbor> <volume> <arrayName> [<volume> <arrayName> ...]" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string interpolation = argv[3];
+  if (interpolation != "linear" && interpolation != "nearestNeighbor")
+    {
+    std::cerr << "Unknown interpolation " << interpolation << std::endl;
+    return EXIT_FAILURE;
+    }
+  const bool nearest = (interpolation == "nearestNeighbor");
+
+  vtkNew<vtkMRMLModelNode> modelNode;
+  vtkNew<vtkMRMLModelStorageNode> modelStorageNode;
+  modelStorageNode->SetFileName(argv[2]);
+  if (!modelStorageNode->ReadData(modelNode))
+    {
+    std::cerr << "Failed to read model " << argv[2] << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkPointSet* probedMesh = modelNode->GetMesh();
+  const vtkIdType numberOfPoints = probedMesh->GetNumberOfPoints();
+
+  // Probe the same points without the arrays of ProbeVolumeWithModel
+  vtkSmartPointer<vtkPointSet> mesh = vtkSmartPointer<vtkPointSet>::Take(probedMesh->NewInstance());
+  mesh->CopyStructure(probedMesh);
+
+  int numberOfErrors = 0;
+  std::vector<bool> expectedValid(numberOfPoints, true);
+  for (int argIndex = 4; argIndex < argc; argIndex += 2)
+    {
+    const std::string arrayName = argv[argIndex + 1];
+    vtkNew<vtkTeemNRRDReader> reader;
+    if (!ReadVolume(argv[argIndex], arrayName, reader))
+      {
+      return EXIT_FAILURE;
+      }
+    vtkSmartPointer<vtkDataSet> reference = ProbeWithFilter(reader, mesh, nearest);
+    vtkDataArray* referenceArray = reference->GetPointData()->GetArray(arrayName.c_str());
+    vtkDataArray* referenceValidMask = reference->GetPointData()->GetArray("vtkValidPointMask");
+    vtkDataArray* array = probedMesh->GetPointData()->GetArray(arrayName.c_str());
+    if (!referenceArray || !referenceValidMask)
+      {
+      std::cerr << "vtkProbeFilter did not probe " << argv[argIndex] << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (!array)
+      {
+      std::cerr << "Missing array " << arrayName << " in " << argv[2] << std::endl;
+      return EXIT_FAILURE;
+      }
+    if (array->GetDataType() != referenceArray->GetDataType()
+      || array->GetNumberOfComponents() != referenceArray->GetNumberOfComponents()
+      || array->GetNumberOfTuples() != numberOfPoints)
+      {
+      std::cerr << "Array " << arrayName << " has type " << array->GetDataTypeAsString()
+                << ", " << array->GetNumberOfComponents() << " components and " << array->GetNumberOfTuples()
+                << " tuples, expected " << referenceArray->GetDataTypeAsString()
+                << ", " << referenceArray->GetNumberOfComponents() << " components and " << numberOfPoints
+                << " tuples" << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Linearly interpolated integer values may be rounded differently
+    const bool isInteger = (array->GetDataType() != VTK_FLOAT && array->GetDataType() != VTK_DOUBLE);
+    int numberOfValidPoints = 0;
+    int numberOfArrayErrors = 0;
+    for (vtkIdType pointId = 0; pointId < numberOfPoints; ++pointId)
+      {
+      const bool valid = (referenceValidMask->GetComponent(pointId, 0) != 0);
+      numberOfValidPoints += valid ? 1 : 0;
+      expectedValid[pointId] = expectedValid[pointId] && valid;
+      for (int component = 0; component < array->GetNumberOfComponents(); ++component)
+        {
+        const double value = array->GetComponent(pointId, component);
+        // Points outside of the volume are set to 0
+        const double expectedValue = valid ? referenceArray->GetComponent(pointId, component) : 0.0;
+        double tolerance = 0.0;
+        if (valid && !nearest)
+          {
+          tolerance = isInteger ? 1.0 : 1e-4 * (1.0 + std::fabs(expectedValue));
+          }
+        if (std::fabs(value - expectedValue) > tolerance)
+          {
+          if (numberOfArrayErrors < 10)
+            {
+            std::cerr << arrayName << ": point " << pointId << " component " << component << " is " << value
+                      << ", expected " << expectedValue << (valid ? "" : " (outside)") << std::endl;
+            }
+          ++numberOfArrayErrors;
+          }
+        }
+      }
+    std::cout << arrayName << ": " << numberOfValidPoints << " of " << numberOfPoints
+              << " points inside, " << numberOfArrayErrors << " differences" << std::endl;
+    if (numberOfValidPoints == 0 || numberOfValidPoints == numberOfPoints)
+      {
+      std::cerr << arrayName << ": the points must be both inside and outside of the volume" << std::endl;
+      ++numberOfErrors;
+      }
+    numberOfErrors += numberOfArrayErrors;
+    }
+
+  // A point is valid only if it is inside all the volumes
+  vtkDataArray* validMask = probedMesh->GetPointData()->GetArray("vtkValidPointMask");
+  if (!validMask || validMask->GetNumberOfTuples() != numberOfPoints)
+    {
+    std::cerr << "Missing vtkValidPointMask array in " << argv[2] << std::endl;
+    return EXIT_FAILURE;
+    }
+  int numberOfMaskErrors = 0;
+  for (vtkIdType pointId = 0; pointId < numberOfPoints; ++pointId)
+    {
+    if ((validMask->GetComponent(pointId, 0) != 0) != expectedValid[pointId])
+      {
+      if (numberOfMaskErrors < 10)
+        {
+        std::cerr << "vtkValidPointMask: point " << pointId << " is " << validMask->GetComponent(pointId, 0)
+                  << ", expected " << (expectedValid[pointId] ? 1 : 0) << std::endl;
+        }
+      ++numberOfMaskErrors;
+      }
+    }
+  numberOfErrors += numberOfMaskErrors;
+
+  if (numberOfErrors > 0)
+    {
+    std::cerr << numberOfErrors << " differences with vtkProbeFilter" << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  const std::string command = (argc > 1 ? argv[1] : "");
+  if (command == "generate")
+    {
+    return Generate(argc, argv);
+    }
+  if (command == "compare")
+    {
+    return Compare(argc, argv);
+    }
+  std::cerr << "Usage: " << argv[0] << " generate|compare ..." << std::endl;
+  return EXIT_FAILURE;
+}
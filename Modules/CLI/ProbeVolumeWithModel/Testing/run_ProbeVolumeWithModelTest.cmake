@@ -0,0 +1,53 @@
+# test_cmd .........: ProbeVolumeWithModel executable
+# compare_cmd ......: ProbeVolumeWithModelTest executable, generates the input
+#                     model and compares the output with vtkProbeFilter
+# interpolation ....: linear or nearestNeighbor
+# volume ...........: volume sampled into the "Volume" array
+# additional_volume : optional, volume sampled into the "AdditionalVolume" array
+# temp_dir .........: directory of the model files
+
+# Sanity checks
+set(expected_defined_vars test_cmd compare_cmd interpolation volume temp_dir)
+foreach(var ${expected_defined_vars})
+  if(NOT ${var})
+    message(FATAL_ERROR "Variable ${var} not defined !")
+  endif()
+endforeach()
+
+set(test_prefix ProbeVolumeWithModel_${interpolation})
+set(compare_args ${volume} Volume)
+set(cli_args --interpolation ${interpolation} --outputArrayName Volume)
+if(additional_volume)
+  set(test_prefix ${test_prefix}_multi)
+  list(APPEND compare_args ${additional_volume} AdditionalVolume)
+  list(APPEND cli_args --additionalVolumes ${additional_volume} --additionalOutputArrayNames AdditionalVolume)
+endif()
+set(input_model ${temp_dir}/${test_prefix}_input.vtk)
+set(output_model ${temp_dir}/${test_prefix}_output.vtk)
+
+# Points inside, on the boundary and outside of the volumes
+execute_process(
+  COMMAND ${compare_cmd} generate ${input_model} ${volume} ${additional_volume}
+  RESULT_VARIABLE exec_not_successful
+  )
+if(exec_not_successful)
+  message(FATAL_ERROR "${compare_cmd} failed to generate ${input_model}")
+endif()
+
+# Run the module
+execute_process(
+  COMMAND ${test_cmd} ${cli_args} ${volume} ${input_model} ${output_model}
+  RESULT_VARIABLE exec_not_successful
+  )
+if(exec_not_successful)
+  message(FATAL_ERROR "${test_cmd} failed with args ${cli_args} ${volume} ${input_model} ${output_model}")
+endif()
+
+# Compare with vtkProbeFilter
+execute_process(
+  COMMAND ${compare_cmd} compare ${output_model} ${interpolation} ${compare_args}
+  RESULT_VARIABLE test_not_successful
+  )
+if(test_not_successful)
+  message(SEND_ERROR "${output_model} does not match the output of vtkProbeFilter!")
+endif()
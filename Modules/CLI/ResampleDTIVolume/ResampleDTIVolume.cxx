@@ -29,6 +29,7 @@
 #include "dtiprocessFiles/deformationfieldio.h"
 #include "itkWarpTransform3D.h"
 #include "itkTransformDeformationFieldFilter.h"
+#include "TransformFieldCache.h"
 #include <itkVectorResampleImageFilter.h>
 #include <itkBSplineDeformableTransform.h>
 #include <itkThinPlateSplineKernelTransform.h>
@@ -74,6 +75,7 @@ struct parameters
   std::string transformsOrder;
   bool notbulk;
   bool noMeasurementFrame ;
+  std::string transformFieldCache;
   };
 
 // Verify if some input parameters are null
@@ -712,6 +714,39 @@ void RASLPS( typename itk::Image<itk::DiffusionTensor3D<PixelType>, 3>::Pointer
   image->SetDirection( m_Direction );
 }
 
+// Describes everything the displacement field computed from the transforms
+// depends on, see TransformFieldCache.h
+template <class PixelType>
+std::string TransformFieldCacheKey( const parameters & list,
+                                    const typename itk::Image<itk::DiffusionTensor3D<PixelType>, 3>::Pointer & image,
+                                    const typename itk::Image<itk::DiffusionTensor3D<PixelType>, 3>::Pointer & outputImage
+                                    )
+{
+  std::ostringstream key;
+  key.precision( 17 );
+  key << "transforms=" << TransformFieldCacheFileStamp( list.transformationFile )
+      << ";inverse=" << list.inverseITKTransformation
+      << ";transformsOrder=" << list.transformsOrder
+      << ";notbulk=" << list.notbulk
+      << ";space=" << list.space
+      << ";deffield=" << TransformFieldCacheFileStamp( list.deffield )
+      << ";typeOfField=" << list.typeOfField
+      << ";rotationPoint=";
+  for( ::size_t i = 0; i < list.rotationPoint.size(); i++ )
+    {
+    key << ( i ? "," : "" ) << list.rotationPoint[i];
+    }
+  key << ";centeredTransform=" << list.centeredTransform
+      << ";imageCenter=" << list.imageCenter
+      << ";input:" << TransformFieldCacheGridKey( image->GetOrigin(), image->GetSpacing(),
+                                                  image->GetLargestPossibleRegion().GetSize(),
+                                                  image->GetDirection() )
+      << ";output:" << TransformFieldCacheGridKey( outputImage->GetOrigin(), outputImage->GetSpacing(),
+                                                   outputImage->GetLargestPossibleRegion().GetSize(),
+                                                   outputImage->GetDirection() );
+  return key.str();
+}
+
 // resamples field to output image size; local filter so that the memory is freed once it has run
 void ResampleDeformationField( DeformationImageType::Pointer & field,
                                const itk::Point<double, 3> & origin,
@@ -867,7 +902,19 @@ int Do( parameters list )
     typedef itk::WarpTransform3D<double> WarpTransformType;
     typename WarpTransformType::Pointer warpTransform = WarpTransformType::New();
     typename DeformationImageType::Pointer field;
-    if( list.deffield.compare( "" ) )
+    // Reuse the field computed by a previous execution with the same transforms
+    std::string transformFieldCacheKey;
+    if( list.transformFieldCache.compare( "" ) )
+      {
+      transformFieldCacheKey = TransformFieldCacheKey<PixelType>( list, image, dummyOutputImage );
+      field = ReadTransformFieldCache( list.transformFieldCache, transformFieldCacheKey );
+      }
+    const bool fieldFromCache = field.IsNotNull();
+    if( fieldFromCache )
+      {
+      fieldPointer = nullptr;
+      }
+    else if( list.deffield.compare( "" ) )
       {
       field = fieldPointer;
       // Resample the deformation field so that it has the same properties as the output image we want to compute
@@ -891,7 +938,7 @@ int Do( parameters list )
       field->FillBuffer( vectorNull );
       }
     // Compute the transformation field adding all the transforms together
-    while( list.transformationFile.compare( "" ) && transformFile->GetTransformList()->size() )
+    while( !fieldFromCache && list.transformationFile.compare( "" ) && transformFile->GetTransformList()->size() )
       {
       typedef itk::TransformDeformationFieldFilter<double, double, 3> itkTransformDeformationFieldFilterType;
       typename itkTransformDeformationFieldFilterType::Pointer transformDeformationFieldFilter =
@@ -930,6 +977,10 @@ int Do( parameters list )
       field = transformDeformationFieldFilter->GetOutput();
       field->DisconnectPipeline();
       }
+    if( !fieldFromCache )
+      {
+      WriteTransformFieldCache( list.transformFieldCache, transformFieldCacheKey, field );
+      }
 
     // Create the DTI transform
     warpTransform->SetDeformationField( field );
@@ -1122,6 +1173,7 @@ int main( int argc, char * argv[] )
   list.transformsOrder = transformsOrder;
   list.notbulk = notbulk;
   list.noMeasurementFrame = noMeasurementFrame;
+  list.transformFieldCache = transformFieldCache;
   // verify if all the vector parameters have the good length
   if( list.outputImageSpacing.size() != 3 || list.outputImageSize.size() != 3
       || ( list.outputImageOrigin.size() != 3
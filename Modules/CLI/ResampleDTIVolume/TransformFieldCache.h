@@ -0,0 +1,184 @@
+/*=========================================================================
+
+  Program:   Diffusion Applications
+  Language:  C++
+
+  Copyright (c) Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See License.txt or http://www.slicer.org/copyright/copyright.txt for details.
+
+==========================================================================*/
+
+#ifndef TransformFieldCache_h
+#define TransformFieldCache_h
+
+// Evaluating the transforms at every voxel of the output image is the most
+// expensive part of resampling through non-linear transforms (or chains of
+// transforms). The functions below evaluate the transform once into a
+// displacement field defined on the output grid, and save that field in a
+// cache file so that later executions with the same transforms and output
+// grid can read it back instead of evaluating the transforms again.
+//
+// A cache file is only reused if the key stored in it matches the key of the
+// current execution. The key must describe everything the field depends on:
+// transform files (see TransformFieldCacheFileStamp()), transform parameters
+// and output grid (see TransformFieldCacheGridKey()).
+
+#include "dtiprocessFiles/dtitypes.h"
+#include "itkTransformDeformationFieldFilter.h"
+
+// ITK includes
+#include <itkImageFileReader.h>
+#include <itkImageFileWriter.h>
+#include <itkMetaDataObject.h>
+#include <itksys/SystemTools.hxx>
+
+// STD includes
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Name of the key stored in the metadata of the cache files
+#define TRANSFORM_FIELD_CACHE_KEY "ResampleTransformFieldCacheKey"
+
+// Identifies the current content of a file by its name, size and modification time
+inline std::string TransformFieldCacheFileStamp( const std::string & fileName )
+{
+  if( fileName.empty() )
+    {
+    return "none";
+    }
+  std::ostringstream stamp;
+  stamp << itksys::SystemTools::CollapseFullPath( fileName );
+  if( itksys::SystemTools::FileExists( fileName, true ) )
+    {
+    stamp << "," << itksys::SystemTools::FileLength( fileName )
+          << "," << itksys::SystemTools::ModifiedTime( fileName );
+    }
+  return stamp.str();
+}
+
+// Describes the grid the displacement field is defined on
+inline std::string TransformFieldCacheGridKey( const itk::Point<double, 3> & origin,
+                                               const itk::Vector<double, 3> & spacing,
+                                               const itk::Size<3> & size,
+                                               const itk::Matrix<double, 3, 3> & direction )
+{
+  std::ostringstream key;
+  key.precision( 17 );
+  key << "origin=" << origin[0] << "," << origin[1] << "," << origin[2]
+      << ";spacing=" << spacing[0] << "," << spacing[1] << "," << spacing[2]
+      << ";size=" << size[0] << "," << size[1] << "," << size[2]
+      << ";direction=";
+  for( int i = 0; i < 3; i++ )
+    {
+    for( int j = 0; j < 3; j++ )
+      {
+      key << ( i + j ? "," : "" ) << direction[i][j];
+      }
+    }
+  return key.str();
+}
+
+// Reads the displacement field stored in the cache file.
+// Returns nullptr if the file does not exist or was computed with a different key.
+inline DeformationImageType::Pointer ReadTransformFieldCache( const std::string & cacheFileName,
+                                                              const std::string & key )
+{
+  if( cacheFileName.empty() || !itksys::SystemTools::FileExists( cacheFileName, true ) )
+    {
+    return nullptr;
+    }
+  typedef itk::ImageFileReader<DeformationImageType> ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( cacheFileName );
+  try
+    {
+    reader->UpdateOutputInformation();
+    std::string cachedKey;
+    if( !itk::ExposeMetaData<std::string>( reader->GetOutput()->GetMetaDataDictionary(),
+                                           TRANSFORM_FIELD_CACHE_KEY, cachedKey )
+        || cachedKey != key )
+      {
+      std::cout << "Transform field cache " << cacheFileName
+                << " was computed for different transforms or output grid, it is recomputed" << std::endl;
+      return nullptr;
+      }
+    reader->Update();
+    }
+  catch( itk::ExceptionObject & exception )
+    {
+    std::cerr << "Unable to read transform field cache " << cacheFileName << ": " << exception << std::endl;
+    return nullptr;
+    }
+  std::cout << "Transform field read from cache " << cacheFileName << std::endl;
+  DeformationImageType::Pointer field = reader->GetOutput();
+  field->DisconnectPipeline();
+  return field;
+}
+
+// Writes the displacement field into the cache file along with its key.
+inline bool WriteTransformFieldCache( const std::string & cacheFileName,
+                                      const std::string & key,
+                                      DeformationImageType * field )
+{
+  if( cacheFileName.empty() || !field )
+    {
+    return false;
+    }
+  itk::MetaDataDictionary dictionary = field->GetMetaDataDictionary();
+  itk::EncapsulateMetaData<std::string>( field->GetMetaDataDictionary(), TRANSFORM_FIELD_CACHE_KEY, key );
+  typedef itk::ImageFileWriter<DeformationImageType> WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( field );
+  writer->SetFileName( cacheFileName );
+  writer->UseCompressionOn();
+  bool success = true;
+  try
+    {
+    writer->Update();
+    }
+  catch( itk::ExceptionObject & exception )
+    {
+    std::cerr << "Unable to write transform field cache " << cacheFileName << ": " << exception << std::endl;
+    success = false;
+    }
+  field->SetMetaDataDictionary( dictionary );
+  return success;
+}
+
+// Evaluates the transform at every voxel of the output grid and returns the
+// displacement field (transformed point minus voxel position)
+inline DeformationImageType::Pointer ComputeTransformField( itk::Transform<double, 3, 3> * transform,
+                                                            const itk::Point<double, 3> & origin,
+                                                            const itk::Vector<double, 3> & spacing,
+                                                            const itk::Size<3> & size,
+                                                            const itk::Matrix<double, 3, 3> & direction,
+                                                            int numberOfThreads )
+{
+  DeformationImageType::Pointer nullField = DeformationImageType::New();
+  nullField->SetSpacing( spacing );
+  nullField->SetOrigin( origin );
+  nullField->SetRegions( size );
+  nullField->SetDirection( direction );
+  nullField->Allocate();
+  DeformationPixelType vectorNull;
+  vectorNull.Fill( 0.0 );
+  nullField->FillBuffer( vectorNull );
+
+  typedef itk::TransformDeformationFieldFilter<double, double, 3> TransformDeformationFieldFilterType;
+  TransformDeformationFieldFilterType::Pointer transformDeformationFieldFilter =
+    TransformDeformationFieldFilterType::New();
+  if( numberOfThreads )
+    {
+    transformDeformationFieldFilter->SetNumberOfThreads( numberOfThreads );
+    }
+  transformDeformationFieldFilter->SetInput( nullField );
+  transformDeformationFieldFilter->SetTransform( transform );
+  transformDeformationFieldFilter->Update();
+  DeformationImageType::Pointer field = transformDeformationFieldFilter->GetOutput();
+  field->DisconnectPipeline();
+  return field;
+}
+
+#endif
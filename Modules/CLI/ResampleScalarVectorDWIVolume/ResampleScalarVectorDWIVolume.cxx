@@ -36,6 +36,7 @@
 #include "dtiprocessFiles/deformationfieldio.h"
 #include "itkTransformDeformationFieldFilter.h"
 #include "itkWarpTransform3D.h"
+#include "TransformFieldCache.h"
 
 // STD includes
 
@@ -75,6 +76,8 @@ struct parameters
   std::string imageCenter;
   std::string transformsOrder;
   bool notbulk;
+  bool cacheTransformField;
+  std::string transformFieldCache;
   };
 
 // To check the image voxel type
@@ -1131,6 +1134,44 @@ void RASLPS( typename ImageType::Pointer image )
   image->SetDirection( m_Direction );
 }
 
+// Describes everything the displacement field computed from the transforms
+// depends on, see TransformFieldCache.h
+template <class ImageType>
+std::string TransformFieldCacheKey( const parameters & list,
+                                    const typename itk::ResampleImageFilter<ImageType, ImageType>::Pointer & resampler,
+                                    const typename ImageType::Pointer & image
+                                    )
+{
+  std::ostringstream key;
+  key.precision( 17 );
+  key << "transforms=" << TransformFieldCacheFileStamp( list.transformationFile )
+      << ";inverse=" << list.inverseITKTransformation
+      << ";transformsOrder=" << list.transformsOrder
+      << ";notbulk=" << list.notbulk
+      << ";space=" << list.space
+      << ";deffield=" << TransformFieldCacheFileStamp( list.deffield )
+      << ";typeOfField=" << list.typeOfField
+      << ";transformType=" << list.transformType
+      << ";transformMatrix=";
+  for( ::size_t i = 0; i < list.transformMatrix.size(); i++ )
+    {
+    key << ( i ? "," : "" ) << list.transformMatrix[i];
+    }
+  key << ";rotationPoint=";
+  for( ::size_t i = 0; i < list.rotationPoint.size(); i++ )
+    {
+    key << ( i ? "," : "" ) << list.rotationPoint[i];
+    }
+  key << ";centeredTransform=" << list.centeredTransform
+      << ";imageCenter=" << list.imageCenter
+      << ";input:" << TransformFieldCacheGridKey( image->GetOrigin(), image->GetSpacing(),
+                                                  image->GetLargestPossibleRegion().GetSize(),
+                                                  image->GetDirection() )
+      << ";output:" << TransformFieldCacheGridKey( resampler->GetOutputOrigin(), resampler->GetOutputSpacing(),
+                                                   resampler->GetSize(), resampler->GetOutputDirection() );
+  return key.str();
+}
+
 // Check the selected interpolator. Creates and returns an object of that type
 template <class ImageType>
 typename itk::InterpolateImageFunction<ImageType, double>::Pointer
@@ -1217,12 +1258,15 @@ SetInterpolator( const parameters & list )
 template <class PixelType>
 int Rotate( parameters & list )
 {
-  typedef itk::Image<PixelType, 3>                         ImageType;
-  typedef itk::InterpolateImageFunction<ImageType, double> InterpolatorType;
-  typedef itk::ResampleImageFilter<ImageType, ImageType>   ResampleType;
-  typedef itk::Transform<double, 3, 3>                     TransformType;
-  typedef itk::VectorImage<PixelType, 3>                   VectorImageType;
-  typename ImageType::Pointer image;
+  typedef itk::Image<PixelType, 3>                                   ImageType;
+  typedef itk::InterpolateImageFunction<ImageType, double>           InterpolatorType;
+  typedef itk::ResampleImageFilter<ImageType, ImageType>             ResampleType;
+  typedef itk::Transform<double, 3, 3>                               TransformType;
+  typedef itk::VectorImage<PixelType, 3>                             VectorImageType;
+  typedef itk::InterpolateImageFunction<VectorImageType, double>     VectorInterpolatorType;
+  typedef itk::ResampleImageFilter<VectorImageType, VectorImageType> VectorResampleType;
+  typedef itk::WarpTransform3D<double>                               WarpTransformType;
+  typename VectorImageType::Pointer        inputImage;
   std::vector<typename ImageType::Pointer> vectorOfImage;
   itk::MetaDataDictionary                  dico;
   try
@@ -1238,25 +1282,76 @@ int Rotate( parameters & list )
       }
     // Save metadata dictionary
     dico = reader->GetOutput()->GetMetaDataDictionary();
-    // Separate the vector image into a vector of images
-    SeparateImages<PixelType>( reader->GetOutput(), vectorOfImage );
+    inputImage = reader->GetOutput();
     }
   catch( itk::ExceptionObject &exception )
     {
     std::cerr << exception << std::endl;
     return EXIT_FAILURE;
     }
-  // Set interpolator
-  typename InterpolatorType::Pointer interpol;
-  interpol = SetInterpolator<ImageType>( list );
+  // Linear and nearest neighbor interpolations support vector images: all the
+  // components are resampled in one pass, mapping every output voxel only once.
+  const bool resampleComponentsTogether = inputImage->GetNumberOfComponentsPerPixel() > 1
+    && ( !list.interpolationType.compare( "linear" ) || !list.interpolationType.compare( "nn" ) );
+  // Scalar image that has the geometry of the input image
+  typename ImageType::Pointer geometryImage;
+  if( resampleComponentsTogether )
+    {
+    geometryImage = ImageType::New();
+    geometryImage->CopyInformation( inputImage );
+    geometryImage->SetRegions( inputImage->GetLargestPossibleRegion() );
+    }
+  else
+    {
+    // Separate the vector image into a vector of images
+    SeparateImages<PixelType>( inputImage, vectorOfImage );
+    inputImage = nullptr;
+    geometryImage = vectorOfImage[0];
+    }
   // Create resampler and initialize its output parameters
   typename ResampleType::Pointer resample = ResampleType::New();
-  SetOutputParameters<ImageType>( list, resample, vectorOfImage[0] );
+  SetOutputParameters<ImageType>( list, resample, geometryImage );
   TransformType::Pointer transform;
   // Load transforms and compute a merged transform
   try
     {
-    transform = SetAllTransform<ImageType>(list, resample, vectorOfImage[0]);
+    std::string transformFieldCacheKey;
+    if( list.transformFieldCache.compare( "" ) )
+      {
+      transformFieldCacheKey = TransformFieldCacheKey<ImageType>( list, resample, geometryImage );
+      DeformationImageType::Pointer field = ReadTransformFieldCache( list.transformFieldCache, transformFieldCacheKey );
+      if( field )
+        {
+        typename WarpTransformType::Pointer warpTransform = WarpTransformType::New();
+        warpTransform->SetDeformationField( field );
+        transform = warpTransform;
+        }
+      }
+    if( !transform )
+      {
+      transform = SetAllTransform<ImageType>(list, resample, geometryImage);
+      // Evaluate non-linear transforms only once, into a field defined on the output grid
+      if( transform && !transform->IsLinear()
+          && ( list.cacheTransformField || list.transformFieldCache.compare( "" ) ) )
+        {
+        DeformationImageType::Pointer field;
+        WarpTransformType* mergedTransform = dynamic_cast<WarpTransformType*>( transform.GetPointer() );
+        if( mergedTransform )
+          {
+          // the transforms have already been merged into a field defined on the output grid
+          field = mergedTransform->GetDeformationField();
+          }
+        else
+          {
+          field = ComputeTransformField( transform, resample->GetOutputOrigin(), resample->GetOutputSpacing(),
+                                         resample->GetSize(), resample->GetOutputDirection(), list.numberOfThread );
+          typename WarpTransformType::Pointer warpTransform = WarpTransformType::New();
+          warpTransform->SetDeformationField( field );
+          transform = warpTransform;
+          }
+        WriteTransformFieldCache( list.transformFieldCache, transformFieldCacheKey, field );
+        }
+      }
     }
   catch (itk::ExceptionObject& exception)
     {
@@ -1267,21 +1362,59 @@ int Rotate( parameters & list )
     {
     return EXIT_FAILURE;
     }
-  resample->SetTransform( transform );
-  resample->SetInterpolator( interpol );
-  std::vector<typename ImageType::Pointer> vectorOutputImage;
-  // Resample all the images separately
-  for( ::size_t idx = 0; idx < vectorOfImage.size(); idx++ )
+  typename itk::VectorImage<PixelType, 3>::Pointer outputImage;
+  if( resampleComponentsTogether )
     {
-    resample->SetInput( vectorOfImage[idx] );
-    resample->Update();
-    vectorOutputImage.push_back( resample->GetOutput() );
-    vectorOutputImage[idx]->DisconnectPipeline();
+    typename VectorInterpolatorType::Pointer vectorInterpol;
+    if( !list.interpolationType.compare( "linear" ) )
+      {
+      vectorInterpol = itk::LinearInterpolateImageFunction<VectorImageType, double>::New();
+      }
+    else
+      {
+      vectorInterpol = itk::NearestNeighborInterpolateImageFunction<VectorImageType, double>::New();
+      }
+    typename VectorResampleType::Pointer vectorResample = VectorResampleType::New();
+    vectorResample->SetInput( inputImage );
+    vectorResample->SetTransform( transform );
+    vectorResample->SetInterpolator( vectorInterpol );
+    vectorResample->SetSize( resample->GetSize() );
+    vectorResample->SetOutputStartIndex( resample->GetOutputStartIndex() );
+    vectorResample->SetOutputOrigin( resample->GetOutputOrigin() );
+    vectorResample->SetOutputSpacing( resample->GetOutputSpacing() );
+    vectorResample->SetOutputDirection( resample->GetOutputDirection() );
+    typename VectorImageType::PixelType defaultPixelValue( inputImage->GetNumberOfComponentsPerPixel() );
+    defaultPixelValue.Fill( static_cast<PixelType>( list.defaultPixelValue ) );
+    vectorResample->SetDefaultPixelValue( defaultPixelValue );
+    if( list.numberOfThread )
+      {
+      vectorResample->SetNumberOfThreads( list.numberOfThread );
+      }
+    vectorResample->Update();
+    outputImage = vectorResample->GetOutput();
+    outputImage->DisconnectPipeline();
+    inputImage = nullptr;
+    }
+  else
+    {
+    // Set interpolator
+    typename InterpolatorType::Pointer interpol;
+    interpol = SetInterpolator<ImageType>( list );
+    resample->SetTransform( transform );
+    resample->SetInterpolator( interpol );
+    std::vector<typename ImageType::Pointer> vectorOutputImage;
+    // Resample all the images separately
+    for( ::size_t idx = 0; idx < vectorOfImage.size(); idx++ )
+      {
+      resample->SetInput( vectorOfImage[idx] );
+      resample->Update();
+      vectorOutputImage.push_back( resample->GetOutput() );
+      vectorOutputImage[idx]->DisconnectPipeline();
+      }
+    outputImage = itk::VectorImage<PixelType, 3>::New();
+    AddImage<PixelType>( outputImage, vectorOutputImage );
+    vectorOutputImage.clear();
     }
-  typename itk::VectorImage<PixelType, 3>::Pointer outputImage;
-  outputImage = itk::VectorImage<PixelType, 3>::New();
-  AddImage<PixelType>( outputImage, vectorOutputImage );
-  vectorOutputImage.clear();
   // If necessary, transform gradient vectors with the loaded transformations
   int dwmriProblem = CheckDWMRI( dico, transform );
   if( list.space ) // && list.transformationFile.compare( "" ) )
@@ -1342,6 +1475,8 @@ int main( int argc, char * argv[] )
   list.imageCenter = imageCenter;
   list.transformsOrder = transformsOrder;
   list.notbulk = notbulk;
+  list.cacheTransformField = cacheTransformField;
+  list.transformFieldCache = transformFieldCache;
   // verify if all the vector parameters have the good length
   if( list.outputImageSpacing.size() != 3 || list.outputImageSize.size() != 3
       || ( list.outputImageOrigin.size() != 3
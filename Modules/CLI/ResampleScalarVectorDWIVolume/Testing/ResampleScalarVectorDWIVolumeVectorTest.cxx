@@ -0,0 +1,207 @@
+// ITK includes
+#include <itkImage.h>
+#include <itkImageFileReader.h>
+#include <itkImageFileWriter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkVectorImage.h>
+
+// STD includes
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef WIN32
+#define MODULE_IMPORT __declspec(dllimport)
+#else
+#define MODULE_IMPORT
+#endif
+
+extern "C" MODULE_IMPORT int ModuleEntryPoint(int, char * []);
+
+namespace
+{
+
+typedef short                            PixelType;
+typedef itk::VectorImage<PixelType, 3>   VectorImageType;
+typedef itk::Image<PixelType, 3>         ImageType;
+
+const unsigned int NumberOfComponents = 3;
+
+//----------------------------------------------------------------------------
+int RunModule( const std::string & transformFile, const std::string & interpolation,
+               const std::string & inputFile, const std::string & outputFile )
+{
+  std::vector<std::string> arguments;
+  arguments.push_back( "ResampleScalarVectorDWIVolume" );
+  arguments.push_back( "-f" );
+  arguments.push_back( transformFile );
+  arguments.push_back( "--interpolation" );
+  arguments.push_back( interpolation );
+  arguments.push_back( inputFile );
+  arguments.push_back( outputFile );
+  std::vector<char *> argv;
+  for( ::size_t i = 0; i < arguments.size(); ++i )
+    {
+    argv.push_back( const_cast<char *>( arguments[i].c_str() ) );
+    }
+  argv.push_back( nullptr );
+  return ModuleEntryPoint( static_cast<int>( arguments.size() ), &argv[0] );
+}
+
+//----------------------------------------------------------------------------
+template <class TImage>
+typename TImage::Pointer ReadImage( const std::string & fileName )
+{
+  typedef itk::ImageFileReader<TImage> ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( fileName );
+  reader->Update();
+  return reader->GetOutput();
+}
+
+//----------------------------------------------------------------------------
+template <class TImage>
+void WriteImage( TImage * image, const std::string & fileName )
+{
+  typedef itk::ImageFileWriter<TImage> WriterType;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetInput( image );
+  writer->SetFileName( fileName );
+  writer->Update();
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+// Vector volumes resampled with linear or nearest neighbor interpolation go
+// through a single ResampleImageFilter for all the components. The result
+// must be the one of each component resampled as a scalar volume.
+//
+// Usage: VectorTest <temporary directory> <linear|nn> <transform file>
+int ResampleScalarVectorDWIVolumeVectorTest( int argc, char * argv[] )
+{
+  if( argc < 4 )
+    {
+    std::cerr << "Usage: " << argv[0] << " <temporary directory> <linear|nn> <transform file>" << std::endl;
+    return EXIT_FAILURE;
+    }
+  const std::string temporaryDirectory = argv[1];
+  const std::string interpolation = argv[2];
+  const std::string transformFile = argv[3];
+  const std::string prefix = temporaryDirectory + "/ResampleScalarVectorDWIVolumeVectorTest_" + interpolation;
+
+  // Smooth vector volume, with different values in each component
+  VectorImageType::SizeType size;
+  size[0] = 24;
+  size[1] = 20;
+  size[2] = 16;
+  VectorImageType::SpacingType spacing;
+  spacing[0] = 1.2;
+  spacing[1] = 1.0;
+  spacing[2] = 1.5;
+  VectorImageType::PointType origin;
+  origin[0] = -14.;
+  origin[1] = -10.;
+  origin[2] = -12.;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions( size );
+  vectorImage->SetSpacing( spacing );
+  vectorImage->SetOrigin( origin );
+  vectorImage->SetNumberOfComponentsPerPixel( NumberOfComponents );
+  vectorImage->Allocate();
+  std::vector<ImageType::Pointer> componentImages;
+  for( unsigned int component = 0; component < NumberOfComponents; ++component )
+    {
+    ImageType::Pointer componentImage = ImageType::New();
+    componentImage->CopyInformation( vectorImage );
+    componentImage->SetRegions( vectorImage->GetLargestPossibleRegion() );
+    componentImage->Allocate();
+    componentImages.push_back( componentImage );
+    }
+  itk::ImageRegionIteratorWithIndex<VectorImageType> it( vectorImage, vectorImage->GetLargestPossibleRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const VectorImageType::IndexType index = it.GetIndex();
+    VectorImageType::PixelType pixel( NumberOfComponents );
+    for( unsigned int component = 0; component < NumberOfComponents; ++component )
+      {
+      const double value = 500. * ( component + 1 )
+        * std::sin( 0.3 * index[0] + component ) * std::cos( 0.2 * index[1] - 0.1 * index[2] );
+      pixel[component] = static_cast<PixelType>( value );
+      componentImages[component]->SetPixel( index, pixel[component] );
+      }
+    it.Set( pixel );
+    }
+
+  try
+    {
+    const std::string vectorInputFile = prefix + "_input.nrrd";
+    const std::string vectorOutputFile = prefix + "_output.nrrd";
+    WriteImage<VectorImageType>( vectorImage, vectorInputFile );
+    if( RunModule( transformFile, interpolation, vectorInputFile, vectorOutputFile ) != EXIT_SUCCESS )
+      {
+      std::cerr << "Failed to resample " << vectorInputFile << std::endl;
+      return EXIT_FAILURE;
+      }
+    VectorImageType::Pointer vectorOutput = ReadImage<VectorImageType>( vectorOutputFile );
+    if( vectorOutput->GetNumberOfComponentsPerPixel() != NumberOfComponents )
+      {
+      std::cerr << "Output has " << vectorOutput->GetNumberOfComponentsPerPixel()
+                << " components, expected " << NumberOfComponents << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // Integer values interpolated linearly may be rounded differently
+    const double tolerance = ( interpolation == "nn" ) ? 0. : 1.;
+    unsigned long numberOfDifferences = 0;
+    for( unsigned int component = 0; component < NumberOfComponents; ++component )
+      {
+      std::ostringstream componentFile;
+      componentFile << prefix << "_component" << component;
+      WriteImage<ImageType>( componentImages[component], componentFile.str() + "_input.nrrd" );
+      if( RunModule( transformFile, interpolation,
+                     componentFile.str() + "_input.nrrd", componentFile.str() + "_output.nrrd" ) != EXIT_SUCCESS )
+        {
+        std::cerr << "Failed to resample component " << component << std::endl;
+        return EXIT_FAILURE;
+        }
+      ImageType::Pointer componentOutput = ReadImage<ImageType>( componentFile.str() + "_output.nrrd" );
+      if( componentOutput->GetLargestPossibleRegion() != vectorOutput->GetLargestPossibleRegion() )
+        {
+        std::cerr << "Output of component " << component << " and vector output have different regions" << std::endl;
+        return EXIT_FAILURE;
+        }
+      itk::ImageRegionConstIterator<ImageType> componentIt( componentOutput, componentOutput->GetLargestPossibleRegion() );
+      itk::ImageRegionConstIterator<VectorImageType> vectorIt( vectorOutput, vectorOutput->GetLargestPossibleRegion() );
+      for( ; !componentIt.IsAtEnd(); ++componentIt, ++vectorIt )
+        {
+        const double difference = std::fabs( static_cast<double>( componentIt.Get() )
+                                             - static_cast<double>( vectorIt.Get()[component] ) );
+        if( difference > tolerance )
+          {
+          if( numberOfDifferences < 10 )
+            {
+            std::cerr << "Component " << component << " at " << componentIt.GetIndex() << ": "
+                      << vectorIt.Get()[component] << " instead of " << componentIt.Get() << std::endl;
+            }
+          ++numberOfDifferences;
+          }
+        }
+      }
+    if( numberOfDifferences > 0 )
+      {
+      std::cerr << numberOfDifferences << " voxels differ from the components resampled separately" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  catch( itk::ExceptionObject & exception )
+    {
+    std::cerr << exception << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
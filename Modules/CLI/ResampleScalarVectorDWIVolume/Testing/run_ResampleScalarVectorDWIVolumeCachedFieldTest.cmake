@@ -0,0 +1,42 @@
+# test_cmd ..............: test driver of the module
+# baseline ..............: expected output volume
+# input .................: volume to resample
+# output ................: name of the output file the <test_cmd> will produce
+# transform .............: non-linear transform file
+# transform_field_cache .: field cached by a previous run with the same parameters
+
+# Sanity checks
+set(expected_defined_vars test_cmd baseline input output transform transform_field_cache)
+foreach(var ${expected_defined_vars})
+  if(NOT ${var})
+    message(FATAL_ERROR "Variable ${var} not defined !")
+  endif()
+endforeach()
+
+if(NOT EXISTS ${transform_field_cache})
+  message(FATAL_ERROR "Transform field cache ${transform_field_cache} does not exist !")
+endif()
+
+# Run the test
+execute_process(
+  COMMAND ${test_cmd} --compare ${baseline} ${output}
+    ModuleEntryPoint
+      -f ${transform}
+      --interpolation ws
+      ${input}
+      ${output}
+      --transform_order input-to-output
+      --transform_field_cache ${transform_field_cache}
+  RESULT_VARIABLE test_not_successful
+  OUTPUT_VARIABLE test_output
+  ERROR_VARIABLE test_output
+  )
+message("${test_output}")
+
+if(test_not_successful)
+  message(SEND_ERROR "${output} does not match ${baseline}!")
+endif()
+
+if(NOT test_output MATCHES "Transform field read from cache")
+  message(SEND_ERROR "The transform field was not read from ${transform_field_cache}!")
+endif()
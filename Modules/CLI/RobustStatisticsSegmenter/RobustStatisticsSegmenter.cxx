@@ -77,6 +77,8 @@ int main(int argc, char* * argv)
   seg.setIntensityHomogeneity(intensityHomogeneity);
   seg.setCurvatureWeight(curvatureWeight / 1.5);
 
+  seg.setNumberOfThreads(numberOfThreads);
+
   seg.doSegmenation();
 
 //   typedef int PixelType;
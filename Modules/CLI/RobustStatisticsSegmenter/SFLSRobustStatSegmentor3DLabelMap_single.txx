@@ -4,7 +4,7 @@
 #include "SFLSRobustStatSegmentor3DLabelMap_single.h"
 
 #include <algorithm>
-#include <ctime>
+#include <chrono>
 
 #include <limits>
 
@@ -95,32 +95,33 @@ CSFLSRobustStatSegmentor3DLabelMap<TPixel>
       }
     }
 
-// #ifndef NDEBUG
-//     std::ofstream ff("/tmp/force.txt");
-// #endif
-  for( long i = 0; i < n; ++i )
+  // speed terms are computed concurrently, each point of the zero level set
+  // only writes its own entries of the buffers and of the feature cache
+  this->parallelizeLayer(n, [&](long first, long last)
     {
-    typename CSFLSLayer::iterator itz = m_lzIterVct[i];
-
-    long ix = (*itz)[0];
-    long iy = (*itz)[1];
-    long iz = (*itz)[2];
-
-    TIndex idx = {{ix, iy, iz}};
+    std::vector<double> f(m_numberOfFeature);
+    for( long i = first; i < last; ++i )
+      {
+      typename CSFLSLayer::iterator itz = m_lzIterVct[i];
 
-    kappaOnZeroLS[i] = this->computeKappa(ix, iy, iz);
+      long ix = (*itz)[0];
+      long iy = (*itz)[1];
+      long iz = (*itz)[2];
 
-    std::vector<double> f(m_numberOfFeature);
+      TIndex idx = {{ix, iy, iz}};
 
-    computeFeatureAt(idx, f);
+      kappaOnZeroLS[i] = this->computeKappa(ix, iy, iz);
 
-    // double a = -kernelEvaluation(f);
-    double a = -kernelEvaluationUsingPDF(f);
+      computeFeatureAt(idx, f);
 
-    fmax = fmax > fabs(a) ? fmax : fabs(a);
+      // cvForce[i] = -kernelEvaluation(f);
+      cvForce[i] = -kernelEvaluationUsingPDF(f);
+      }
+    });
+  for( long i = 0; i < n; ++i )
+    {
+    fmax = fmax > fabs(cvForce[i]) ? fmax : fabs(cvForce[i]);
     kappaMax = kappaMax > fabs(kappaOnZeroLS[i]) ? kappaMax : fabs(kappaOnZeroLS[i]);
-
-    cvForce[i] = a;
     }
 
   // std::cout<<"fmax = "<<fmax<<std::endl;
@@ -269,6 +270,7 @@ CSFLSRobustStatSegmentor3DLabelMap<TPixel>
     {
     // compute the feature
     std::vector<double> neighborIntensities;
+    neighborIntensities.reserve( (2 * m_statNeighborX + 1) * (2 * m_statNeighborY + 1) * (2 * m_statNeighborZ + 1) );
 
     long ix = idx[0];
     long iy = idx[1];
@@ -308,7 +310,9 @@ void
 CSFLSRobustStatSegmentor3DLabelMap<TPixel>
 ::doSegmenation()
 {
-  double startingTime = clock();
+  // wall clock time, the CPU time of the process grows with the number of threads
+  typedef std::chrono::steady_clock Clock;
+  const Clock::time_point startingTime = Clock::now();
 
   getThingsReady();
 
@@ -322,6 +326,9 @@ CSFLSRobustStatSegmentor3DLabelMap<TPixel>
    */
   this->initializeSFLS();
 
+  const Clock::time_point evolutionStartingTime = Clock::now();
+  unsigned int            numberOfIterations = 0;
+
 // #ifndef NDEBUG
 //   std::ofstream dbgf("/tmp/dbgo.txt", std::ios_base::app);
 // #endif
@@ -331,6 +338,13 @@ CSFLSRobustStatSegmentor3DLabelMap<TPixel>
     {
     // dbg//
     std::cout << "In iteration " << it << std::endl << std::flush;
+#ifndef NDEBUG
+    if( it > 0 )
+      {
+      double evolutionTime = std::chrono::duration<double>(Clock::now() - evolutionStartingTime).count();
+      std::cout << "Iterations/s: " << it / (evolutionTime + 1e-10) << std::endl << std::flush;
+      }
+#endif
     // DBG//
 
 //       #ifndef NDEBUG
@@ -354,6 +368,8 @@ CSFLSRobustStatSegmentor3DLabelMap<TPixel>
 
     this->oneStepLevelSetEvolution();
 
+    ++numberOfIterations;
+
     /*----------------------------------------------------------------------
       If the level set stops growing, stop */
     this->updateInsideVoxelCount();
@@ -396,7 +412,7 @@ CSFLSRobustStatSegmentor3DLabelMap<TPixel>
     /*If the inside physical volume exceed expected volume, stop
       ----------------------------------------------------------------------*/
 
-    double ellapsedTime = (clock() - startingTime) / static_cast<double>(CLOCKS_PER_SEC);
+    double ellapsedTime = std::chrono::duration<double>(Clock::now() - startingTime).count();
     if( ellapsedTime > (this->m_maxRunningTime) )
       {
       std::ofstream f("/tmp/o.txt");
@@ -413,6 +429,10 @@ CSFLSRobustStatSegmentor3DLabelMap<TPixel>
 //   dbgf.close();
 // #endif
 
+  double evolutionTime = std::chrono::duration<double>(Clock::now() - evolutionStartingTime).count();
+  std::cout << "Level set evolution: " << numberOfIterations << " iterations in " << evolutionTime << " s ("
+            << numberOfIterations / (evolutionTime + 1e-10) << " iterations/s)" << std::endl;
+
   return;
 }
 
@@ -11,6 +11,7 @@
 
 // itk
 #include "itkImage.h"
+#include "itkMultiThreaderBase.h"
 
 template <typename TPixel>
 class CSFLSSegmentor3D : public CSFLS
@@ -100,6 +101,10 @@ public:
 
   void setCurvatureWeight(double a);
 
+  /* Number of threads used for updating the narrow band, 0 uses the
+     ITK default. The result does not depend on the number of threads. */
+  void setNumberOfThreads(int n);
+
   LSImageType::Pointer getLevelSetFunction();
 
   /* ============================================================
@@ -155,6 +160,18 @@ protected:
   bool                    m_keepZeroLayerHistory;
   std::vector<CSFLSLayer> m_zeroLayerHistory;
 
+  /*----------------------------------------------------------------------
+    The points of a layer are split into contiguous ranges that are
+    processed concurrently. Each point only writes its own entry of the
+    output buffers, the layers themselves are modified serially, in
+    list order, so the evolution is identical to the serial one. */
+  itk::MultiThreaderBase::Pointer m_threader;
+
+  template <typename TFunction>
+  void parallelizeLayer(long n, TFunction function);
+
+  void getPhiOfTheNbhdsInLayer(const CSFLSLayer& layer, std::vector<double>& thePhi, std::vector<char>& found);
+
 };
 
 #include "SFLSSegmentor3D.txx"
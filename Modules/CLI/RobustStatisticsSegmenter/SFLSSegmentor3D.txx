@@ -48,6 +48,8 @@ CSFLSSegmentor3D<TPixel>
   m_keepZeroLayerHistory = false;
 
   m_done = false;
+
+  m_threader = itk::MultiThreaderBase::New();
 }
 
 /* ============================================================
@@ -156,6 +158,23 @@ CSFLSSegmentor3D<TPixel>
   return;
 }
 
+/* ============================================================
+   setNumberOfThreads    */
+template <typename TPixel>
+void
+CSFLSSegmentor3D<TPixel>
+::setNumberOfThreads(int n)
+{
+  m_threader = itk::MultiThreaderBase::New();
+  if( n > 0 )
+    {
+    m_threader->SetMaximumNumberOfThreads(n);
+    m_threader->SetNumberOfWorkUnits(n);
+    }
+
+  return;
+}
+
 /* ============================================================
    setMask    */
 template <typename TPixel>
@@ -340,6 +359,72 @@ CSFLSSegmentor3D<TPixel>
   return foundNbhd;
 }
 
+/* ============================================================
+   parallelizeLayer
+
+   Call function(first, last) on contiguous ranges of [0, n). */
+template <typename TPixel>
+template <typename TFunction>
+void
+CSFLSSegmentor3D<TPixel>
+::parallelizeLayer(long n, TFunction function)
+{
+  // more ranges than threads for load balancing, but not so small that
+  // scheduling dominates
+  const long minRangeSize = 256;
+  const long numberOfRanges = std::min(static_cast<long>(4 * m_threader->GetNumberOfWorkUnits() ),
+                                       (n + minRangeSize - 1) / minRangeSize);
+
+  if( numberOfRanges <= 1 )
+    {
+    function(0, n);
+    return;
+    }
+
+  m_threader->ParallelizeArray(0, numberOfRanges, [&](itk::SizeValueType range)
+    {
+    const long first = n * static_cast<long>(range) / numberOfRanges;
+    const long last = n * static_cast<long>(range + 1) / numberOfRanges;
+    function(first, last);
+    }, nullptr);
+}
+
+/* ============================================================
+   getPhiOfTheNbhdsInLayer
+
+   getPhiOfTheNbhdWhoIsClosestToZeroLevelInLayerCloserToZeroLevel for
+   all the points of the layer, in list order. */
+template <typename TPixel>
+void
+CSFLSSegmentor3D<TPixel>
+::getPhiOfTheNbhdsInLayer(const CSFLSLayer& layer, std::vector<double>& thePhi, std::vector<char>& found)
+{
+  const long n = layer.size();
+
+  std::vector<const NodeType *> nodes(n);
+    {
+    long i = 0;
+    for( CSFLSLayer::const_iterator it = layer.begin(); it != layer.end(); ++it )
+      {
+      nodes[i++] = &(*it);
+      }
+    }
+
+  thePhi.resize(n);
+  found.resize(n);
+
+  parallelizeLayer(n, [&](long first, long last)
+    {
+    for( long i = first; i < last; ++i )
+      {
+      const NodeType& node = *nodes[i];
+      found[i] = getPhiOfTheNbhdWhoIsClosestToZeroLevelInLayerCloserToZeroLevel(node[0], node[1], node[2], thePhi[i]);
+      }
+    });
+
+  return;
+}
+
 /* ============================================================
    normalizeForce
    Normalize m_force s.t. max(abs(m_force)) < 0.5 */
@@ -502,6 +587,12 @@ CSFLSSegmentor3D<TPixel>
 
     2.1 scan Ln1 values [-2.5 -1.5)[-1.5 -.5)[-.5 .5](.5 1.5](1.5 2.5]
     ==========                     */
+  /* the phi of the nbhds only depends on layers updated before, so it
+     is looked up concurrently for the whole layer */
+  std::vector<double> nbhdPhi;
+  std::vector<char>   nbhdFound;
+  getPhiOfTheNbhdsInLayer(m_ln1, nbhdPhi, nbhdFound);
+  long inbhd = 0;
   for( CSFLSLayer::iterator itn1 = m_ln1.begin(); itn1 != m_ln1.end(); )
     {
     long ix = (*itn1)[0];
@@ -510,8 +601,9 @@ CSFLSSegmentor3D<TPixel>
 
     TIndex idx = {{ix, iy, iz}};
 
-    double thePhi;
-    bool   found = getPhiOfTheNbhdWhoIsClosestToZeroLevelInLayerCloserToZeroLevel(ix, iy, iz, thePhi);
+    double thePhi = nbhdPhi[inbhd];
+    bool   found = nbhdFound[inbhd] != 0;
+    ++inbhd;
 
     if( found )
       {
@@ -551,6 +643,8 @@ CSFLSSegmentor3D<TPixel>
   /*--------------------------------------------------
     2.2 scan Lp1 values [-2.5 -1.5)[-1.5 -.5)[-.5 .5](.5 1.5](1.5 2.5]
     ========          */
+  getPhiOfTheNbhdsInLayer(m_lp1, nbhdPhi, nbhdFound);
+  inbhd = 0;
   for( CSFLSLayer::iterator itp1 = m_lp1.begin(); itp1 != m_lp1.end(); )
     {
     long ix = (*itp1)[0];
@@ -559,8 +653,9 @@ CSFLSSegmentor3D<TPixel>
 
     TIndex idx = {{ix, iy, iz}};
 
-    double thePhi;
-    bool   found = getPhiOfTheNbhdWhoIsClosestToZeroLevelInLayerCloserToZeroLevel(ix, iy, iz, thePhi);
+    double thePhi = nbhdPhi[inbhd];
+    bool   found = nbhdFound[inbhd] != 0;
+    ++inbhd;
 
     if( found )
       {
@@ -601,6 +696,8 @@ CSFLSSegmentor3D<TPixel>
   /*--------------------------------------------------
     2.3 scan Ln2 values [-2.5 -1.5)[-1.5 -.5)[-.5 .5](.5 1.5](1.5 2.5]
     ==========                                      */
+  getPhiOfTheNbhdsInLayer(m_ln2, nbhdPhi, nbhdFound);
+  inbhd = 0;
   for( CSFLSLayer::iterator itn2 = m_ln2.begin(); itn2 != m_ln2.end(); )
     {
     long ix = (*itn2)[0];
@@ -609,8 +706,9 @@ CSFLSSegmentor3D<TPixel>
 
     TIndex idx = {{ix, iy, iz}};
 
-    double thePhi;
-    bool   found = getPhiOfTheNbhdWhoIsClosestToZeroLevelInLayerCloserToZeroLevel(ix, iy, iz, thePhi);
+    double thePhi = nbhdPhi[inbhd];
+    bool   found = nbhdFound[inbhd] != 0;
+    ++inbhd;
 
     if( found )
       {
@@ -646,6 +744,8 @@ CSFLSSegmentor3D<TPixel>
   /*--------------------------------------------------
     2.4 scan Lp2 values [-2.5 -1.5)[-1.5 -.5)[-.5 .5](.5 1.5](1.5 2.5]
     ========= */
+  getPhiOfTheNbhdsInLayer(m_lp2, nbhdPhi, nbhdFound);
+  inbhd = 0;
   for( CSFLSLayer::iterator itp2 = m_lp2.begin(); itp2 != m_lp2.end(); )
     {
     long   ix = (*itp2)[0];
@@ -653,8 +753,9 @@ CSFLSSegmentor3D<TPixel>
     long   iz = (*itp2)[2];
     TIndex idx = {{ix, iy, iz}};
 
-    double thePhi;
-    bool   found = getPhiOfTheNbhdWhoIsClosestToZeroLevelInLayerCloserToZeroLevel(ix, iy, iz, thePhi);
+    double thePhi = nbhdPhi[inbhd];
+    bool   found = nbhdFound[inbhd] != 0;
+    ++inbhd;
 
     if( found )
       {
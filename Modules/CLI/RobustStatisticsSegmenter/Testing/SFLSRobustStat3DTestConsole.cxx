@@ -5,6 +5,7 @@
 // ITK includes
 #include <itkImageFileReader.h>
 #include <itkImageFileWriter.h>
+#include <itkImageRegionConstIterator.h>
 
 // ITK includes
 #include <itkConfigure.h>
@@ -13,17 +14,32 @@
 
 #include "labelMapPreprocessor.h"
 
+typedef short                                         PixelType;
+typedef CSFLSRobustStatSegmentor3DLabelMap<PixelType> SFLSRobustStatSegmentor3DLabelMap_c;
+typedef itk::Image<short, 3>                          MaskImageType;
+
 template <typename TPixel>
 itk::Image<short, 3>::Pointer
 getFinalMask(typename itk::Image<TPixel, 3>::Pointer img, unsigned char l, TPixel thod = 0);
 
+MaskImageType::Pointer
+segment(SFLSRobustStatSegmentor3DLabelMap_c::TImage::Pointer img,
+        SFLSRobustStatSegmentor3DLabelMap_c::TLabelImage::Pointer labelMap,
+        double expectedVolume, double intensityHomogeneity, double curvatureWeight,
+        int numberOfThreads);
+
+long countDifferentVoxels(MaskImageType::Pointer mask1, MaskImageType::Pointer mask2);
+
 int main(int argc, char* * argv)
 {
   itk::itkFactoryRegistration();
 
-  if( argc != 7 )
+  if( argc != 7 && argc != 8 )
     {
-    std::cerr << "Parameters: inputImage labelImageName outputImage expectedVolume intensityHomo[0~1] lambda[0~1]\n";
+    std::cerr << "Parameters: inputImage labelImageName outputImage expectedVolume intensityHomo[0~1] lambda[0~1]"
+              << " [numberOfThreads]\n"
+              << "The segmentation is single-threaded by default. If numberOfThreads is given and is not 1,"
+              << " the output is compared voxel by voxel with the single-threaded segmentation.\n";
     exit(-1);
     }
 
@@ -33,12 +49,9 @@ int main(int argc, char* * argv)
   double      expectedVolume = atof(argv[4]);
   double      intensityHomogeneity = atof(argv[5]);
   double      curvatureWeight = atof(argv[6]);
+  int         numberOfThreads = argc > 7 ? atoi(argv[7]) : 1;
 
-  double maxRunningTime = 10000;
-  short  labelValue = 1;
-
-  typedef short                                         PixelType;
-  typedef CSFLSRobustStatSegmentor3DLabelMap<PixelType> SFLSRobustStatSegmentor3DLabelMap_c;
+  short labelValue = 1;
 
   // read input image
   typedef SFLSRobustStatSegmentor3DLabelMap_c::TImage Image_t;
@@ -84,24 +97,23 @@ int main(int argc, char* * argv)
   LabelImage_t::Pointer newLabelMap = preprocessLabelMap<LabelImage_t::PixelType>(labelImg, labelValue);
 
   // do seg
-  SFLSRobustStatSegmentor3DLabelMap_c seg;
-  seg.setImage(img);
-
-  seg.setNumIter(10000); // a large enough number, s.t. will not be stopped by this criteria.
-  seg.setMaxVolume(expectedVolume);
-  seg.setInputLabelImage(newLabelMap);
-
-  seg.setMaxRunningTime(maxRunningTime);
-
-  seg.setIntensityHomogeneity(intensityHomogeneity);
-  seg.setCurvatureWeight(curvatureWeight / 1.5);
-
-  seg.doSegmenation();
+  MaskImageType::Pointer finalMask = segment(img, newLabelMap, expectedVolume,
+                                             intensityHomogeneity, curvatureWeight, numberOfThreads);
 
-  typedef itk::Image<short, 3> MaskImageType;
-
-  MaskImageType::Pointer finalMask = getFinalMask<float>(seg.mp_phi, labelValue, 2.0);
-  finalMask->CopyInformation(img);
+  // the narrow band update is multi-threaded, the result must not depend on
+  // the number of threads
+  if( numberOfThreads != 1 )
+    {
+    MaskImageType::Pointer singleThreadedMask = segment(img, newLabelMap, expectedVolume,
+                                                        intensityHomogeneity, curvatureWeight, 1);
+    long numberOfDifferentVoxels = countDifferentVoxels(finalMask, singleThreadedMask);
+    if( numberOfDifferentVoxels != 0 )
+      {
+      std::cerr << "Segmentation with " << numberOfThreads << " threads differs from the single-threaded"
+                << " segmentation in " << numberOfDifferentVoxels << " voxels" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
 
   typedef itk::ImageFileWriter<MaskImageType> WriterType;
   WriterType::Pointer outputWriter = WriterType::New();
@@ -123,6 +135,55 @@ int main(int argc, char* * argv)
   return EXIT_SUCCESS;
 }
 
+MaskImageType::Pointer
+segment(SFLSRobustStatSegmentor3DLabelMap_c::TImage::Pointer img,
+        SFLSRobustStatSegmentor3DLabelMap_c::TLabelImage::Pointer labelMap,
+        double expectedVolume, double intensityHomogeneity, double curvatureWeight,
+        int numberOfThreads)
+{
+  double maxRunningTime = 10000;
+  short  labelValue = 1;
+
+  SFLSRobustStatSegmentor3DLabelMap_c seg;
+  seg.setImage(img);
+
+  seg.setNumIter(10000); // a large enough number, s.t. will not be stopped by this criteria.
+  seg.setMaxVolume(expectedVolume);
+  seg.setInputLabelImage(labelMap);
+
+  seg.setMaxRunningTime(maxRunningTime);
+
+  seg.setIntensityHomogeneity(intensityHomogeneity);
+  seg.setCurvatureWeight(curvatureWeight / 1.5);
+
+  seg.setNumberOfThreads(numberOfThreads);
+
+  seg.doSegmenation();
+
+  MaskImageType::Pointer finalMask = getFinalMask<float>(seg.mp_phi, labelValue, 2.0);
+  finalMask->CopyInformation(img);
+  return finalMask;
+}
+
+long countDifferentVoxels(MaskImageType::Pointer mask1, MaskImageType::Pointer mask2)
+{
+  if( mask1->GetLargestPossibleRegion() != mask2->GetLargestPossibleRegion() )
+    {
+    return static_cast<long>(mask1->GetLargestPossibleRegion().GetNumberOfPixels() );
+    }
+  itk::ImageRegionConstIterator<MaskImageType> it1(mask1, mask1->GetLargestPossibleRegion() );
+  itk::ImageRegionConstIterator<MaskImageType> it2(mask2, mask2->GetLargestPossibleRegion() );
+  long numberOfDifferentVoxels = 0;
+  for( it1.GoToBegin(), it2.GoToBegin(); !it1.IsAtEnd(); ++it1, ++it2 )
+    {
+    if( it1.Get() != it2.Get() )
+      {
+      ++numberOfDifferentVoxels;
+      }
+    }
+  return numberOfDifferentVoxels;
+}
+
 template <typename TPixel>
 itk::Image<short, 3>::Pointer
 getFinalMask(typename itk::Image<TPixel, 3>::Pointer img, unsigned char l, TPixel thod)
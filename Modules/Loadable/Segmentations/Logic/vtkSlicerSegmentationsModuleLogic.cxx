@@ -2322,13 +2322,21 @@ void vtkSlicerSegmentationsModuleLogic::GetLabelValuesFromColorNode(vtkMRMLSegme
     segmentationNode->GetSegmentation()->GetSegmentIDs(segmentIds);
     }
 
-  int extraColorCount = colorTableNode->GetNumberOfColors(); // Color for segments that are not in the table
-  labelValues->SetNumberOfValues(segmentIds->GetNumberOfValues());
+  // Look up all the segment names in the color table at once
+  vtkNew<vtkStringArray> segmentNames;
+  segmentNames->SetNumberOfValues(segmentIds->GetNumberOfValues());
   for (int i = 0; i < segmentIds->GetNumberOfValues(); ++i)
     {
     vtkStdString segmentId = segmentIds->GetValue(i);
     const char* segmentName = segmentationNode->GetSegmentation()->GetSegment(segmentId)->GetName();
-    int labelValue = colorTableNode->GetColorIndexByName(segmentName);
+    segmentNames->SetValue(i, segmentName ? segmentName : "");
+    }
+  colorTableNode->GetColorIndicesByName(segmentNames, labelValues);
+
+  int extraColorCount = colorTableNode->GetNumberOfColors(); // Color for segments that are not in the table
+  for (int i = 0; i < segmentIds->GetNumberOfValues(); ++i)
+    {
+    int labelValue = labelValues->GetValue(i);
     if (labelValue < 0)
       {
       // Label value is not found in the color table
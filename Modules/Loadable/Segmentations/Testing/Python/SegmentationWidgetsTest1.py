@@ -30,6 +30,7 @@ class SegmentationWidgetsTest1(ScriptedLoadableModuleTest):
         self.TestSection_02_qMRMLSegmentsTableView()
         self.TestSection_03_qMRMLSegmentationGeometryWidget()
         self.TestSection_04_qMRMLSegmentEditorWidget()
+        self.TestSection_05_qMRMLSegmentsModel()
 
         logging.info('Test finished')
 
@@ -409,3 +410,81 @@ class SegmentationWidgetsTest1(ScriptedLoadableModuleTest):
         segmentEditorWidget.selectNextSegment()
         self.assertEqual(self.segmentEditorNode.GetSelectedSegmentID(), 'first')
         slicer.util.delayDisplay("Wrap around segments")
+
+    # ------------------------------------------------------------------------------
+    def TestSection_05_qMRMLSegmentsModel(self):
+        logging.info('Test section 5: qMRMLSegmentsModel')
+
+        numberOfSegments = 1000
+        segmentationNode = slicer.mrmlScene.AddNewNodeByClass('vtkMRMLSegmentationNode', 'ManySegments')
+        segmentationNode.CreateDefaultDisplayNodes()
+        segmentation = segmentationNode.GetSegmentation()
+        for segmentIndex in range(numberOfSegments):
+            segmentation.AddEmptySegment(f'Segment_{segmentIndex}', f'Segment {segmentIndex}')
+
+        segmentsTableView = slicer.qMRMLSegmentsTableView()
+        segmentsTableView.setMRMLScene(slicer.mrmlScene)
+        segmentsTableView.setSegmentationNode(segmentationNode)
+        segmentsTableView.show()
+        slicer.app.processEvents()
+
+        model = segmentsTableView.model()
+        # qMRMLSegmentsModel::SegmentIDRole
+        segmentIDRole = qt.Qt.UserRole + 1
+        binaryLabelmapName = slicer.vtkSegmentationConverter.GetSegmentationBinaryLabelmapRepresentationName()
+
+        def checkRows():
+            self.assertEqual(model.rowCount(), segmentation.GetNumberOfSegments())
+            for row in range(model.rowCount()):
+                segmentID = segmentation.GetNthSegmentID(row)
+                index = model.index(row, model.nameColumn)
+                self.assertEqual(model.data(index, segmentIDRole), segmentID)
+                self.assertEqual(model.data(index), segmentation.GetSegment(segmentID).GetName())
+            # Layers are cached for all the segments, check that the cache is up to date
+            for row in [0, model.rowCount() // 2, model.rowCount() - 1]:
+                segmentID = segmentation.GetNthSegmentID(row)
+                self.assertEqual(model.data(model.index(row, model.layerColumn)),
+                                 str(segmentation.GetLayerIndex(segmentID, binaryLabelmapName)))
+
+        checkRows()
+
+        # Rows are updated in place when segments are added, removed, reordered or renamed
+        segmentation.AddEmptySegment('Added', 'Added')
+        checkRows()
+        segmentation.RemoveSegment('Segment_500')
+        checkRows()
+        segmentation.SetSegmentIndex('Added', 0)
+        checkRows()
+        segmentation.GetSegment('Segment_10').SetName('Renamed')
+        checkRows()
+        slicer.app.processEvents()
+        slicer.util.delayDisplay("Many segments")
+
+        # Rows have the height of a line of text, they are not resized to their contents
+        verticalHeader = segmentsTableView.tableWidget().verticalHeader()
+        self.assertEqual(verticalHeader.sectionResizeMode(0), qt.QHeaderView.Fixed)
+        self.assertGreaterEqual(verticalHeader.defaultSectionSize, segmentsTableView.tableWidget().fontMetrics().height())
+        self.assertEqual(verticalHeader.sectionSize(0), verticalHeader.defaultSectionSize)
+        self.assertEqual(verticalHeader.sectionSize(model.rowCount() - 1), verticalHeader.defaultSectionSize)
+
+        # Terminology tooltips are cached by terminology
+        def tooltip(row):
+            return model.data(model.index(row, model.colorColumn), qt.Qt.ToolTipRole)
+
+        firstSegment = segmentation.GetNthSegment(0)
+        secondSegment = segmentation.GetNthSegment(1)
+        self.assertEqual(tooltip(0), model.terminologyTooltipForSegment(firstSegment))
+        self.assertEqual(tooltip(1), tooltip(0))
+        firstSegment.SetTag(firstSegment.GetTerminologyEntryTagName(),
+                            "Segmentation category and type - 3D Slicer General Anatomy list"
+                            "~SCT^85756007^Tissue~SCT^51114001^Artery~^^~Anatomic codes - DICOM master list~^^~^^")
+        self.assertEqual(tooltip(0), model.terminologyTooltipForSegment(firstSegment))
+        self.assertNotEqual(tooltip(0), tooltip(1))
+        self.assertEqual(tooltip(1), model.terminologyTooltipForSegment(secondSegment))
+        # The cache is cleared when the terminologies are modified
+        slicer.modules.terminologies.logic().Modified()
+        self.assertEqual(tooltip(0), model.terminologyTooltipForSegment(firstSegment))
+        self.assertEqual(tooltip(1), model.terminologyTooltipForSegment(secondSegment))
+
+        segmentsTableView.setSegmentationNode(None)
+        slicer.mrmlScene.RemoveNode(segmentationNode)
@@ -55,6 +55,10 @@
 // Segmentations logic includes
 #include "vtkSlicerSegmentationsModuleLogic.h"
 
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkNew.h>
+
 //------------------------------------------------------------------------------
 qMRMLSegmentsModelPrivate::qMRMLSegmentsModelPrivate(qMRMLSegmentsModel& object)
   : q_ptr(&object)
@@ -66,6 +70,8 @@ qMRMLSegmentsModelPrivate::qMRMLSegmentsModelPrivate(qMRMLSegmentsModel& object)
   , StatusColumn(-1)
   , LayerColumn(-1)
   , SegmentationNode(nullptr)
+  , RowCacheValid(false)
+  , LayerCacheValid(false)
 {
   this->CallBack = vtkSmartPointer<vtkCallbackCommand>::New();
 
@@ -97,6 +103,11 @@ void qMRMLSegmentsModelPrivate::init()
   this->CallBack->SetCallback(qMRMLSegmentsModel::onEvent);
 
   QObject::connect(q, SIGNAL(itemChanged(QStandardItem*)), q, SLOT(onItemChanged(QStandardItem*)));
+  QObject::connect(q, SIGNAL(rowsInserted(QModelIndex,int,int)), q, SLOT(invalidateRowCache()));
+  QObject::connect(q, SIGNAL(rowsRemoved(QModelIndex,int,int)), q, SLOT(invalidateRowCache()));
+  QObject::connect(q, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)), q, SLOT(invalidateRowCache()));
+  QObject::connect(q, SIGNAL(layoutChanged()), q, SLOT(invalidateRowCache()));
+  QObject::connect(q, SIGNAL(modelReset()), q, SLOT(invalidateRowCache()));
 
   q->setVisibilityColumn(0);
   q->setColorColumn(1);
@@ -169,7 +180,19 @@ QStandardItem* qMRMLSegmentsModelPrivate::insertSegment(QString segmentID, int r
     {
     row = this->SegmentationNode->GetSegmentation()->GetSegmentIndex(segmentID.toStdString());
     }
+  const bool appendRow = (row == q->rowCount());
+  const bool rowCacheWasValid = this->RowCacheValid;
   q->insertRow(row, items);
+  // Appending a row does not change the rows of the other segments
+  if (rowCacheWasValid && appendRow)
+    {
+    this->RowCache[segmentID] = row;
+    this->RowCacheValid = true;
+    }
+  else
+    {
+    this->RowCacheValid = false;
+    }
 
   item = items[0];
   if (q->itemFromSegmentID(segmentID) != item)
@@ -180,6 +203,132 @@ QStandardItem* qMRMLSegmentsModelPrivate::insertSegment(QString segmentID, int r
   return item;
 }
 
+//------------------------------------------------------------------------------
+int qMRMLSegmentsModelPrivate::segmentRow(const QString& segmentID)const
+{
+  Q_Q(const qMRMLSegmentsModel);
+  if (segmentID.isEmpty())
+    {
+    return -1;
+    }
+  if (!this->RowCacheValid)
+    {
+    this->rebuildRowCache();
+    }
+  QHash<QString, int>::const_iterator rowIt = this->RowCache.constFind(segmentID);
+  if (rowIt == this->RowCache.constEnd())
+    {
+    return -1;
+    }
+  QStandardItem* item = q->item(rowIt.value(), 0);
+  if (item && item->data(qMRMLSegmentsModel::SegmentIDRole).toString() == segmentID)
+    {
+    return rowIt.value();
+    }
+  // The rows have been changed without notification (e.g. signals were blocked)
+  this->rebuildRowCache();
+  return this->RowCache.value(segmentID, -1);
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSegmentsModelPrivate::rebuildRowCache()const
+{
+  Q_Q(const qMRMLSegmentsModel);
+  this->RowCache.clear();
+  const int rowCount = q->rowCount();
+  this->RowCache.reserve(rowCount);
+  for (int row = 0; row < rowCount; ++row)
+    {
+    QStandardItem* item = q->item(row, 0);
+    if (item)
+      {
+      this->RowCache[item->data(qMRMLSegmentsModel::SegmentIDRole).toString()] = row;
+      }
+    }
+  this->RowCacheValid = true;
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSegmentsModelPrivate::segmentLayer(const QString& segmentID)const
+{
+  if (this->LayerCacheValid)
+    {
+    return this->LayerCache.value(segmentID, -1);
+    }
+  this->LayerCache.clear();
+  this->LayerCacheValid = true;
+  vtkSegmentation* segmentation = this->SegmentationNode ? this->SegmentationNode->GetSegmentation() : nullptr;
+  if (!segmentation)
+    {
+    return -1;
+    }
+  // Same as vtkSegmentation::GetLayerIndex() but for all the segments at once
+  std::string representationName = vtkSegmentationConverter::GetBinaryLabelmapRepresentationName();
+  vtkNew<vtkCollection> layerObjects;
+  segmentation->GetLayerObjects(layerObjects, representationName);
+  QHash<vtkObject*, int> layerIndexes;
+  vtkCollectionSimpleIterator it;
+  vtkObject* layerObject = nullptr;
+  int layerIndex = 0;
+  for (layerObjects->InitTraversal(it); (layerObject = layerObjects->GetNextItemAsObject(it)); ++layerIndex)
+    {
+    layerIndexes[layerObject] = layerIndex;
+    }
+  std::vector<std::string> segmentIDs;
+  segmentation->GetSegmentIDs(segmentIDs);
+  for (const std::string& currentSegmentID : segmentIDs)
+    {
+    vtkSegment* segment = segmentation->GetSegment(currentSegmentID);
+    vtkObject* segmentObject = segment ? segment->GetRepresentation(representationName) : nullptr;
+    this->LayerCache[QString::fromStdString(currentSegmentID)] = layerIndexes.value(segmentObject, -1);
+    }
+  return this->LayerCache.value(segmentID, -1);
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSegmentsModelPrivate::invalidateLayers()
+{
+  Q_Q(qMRMLSegmentsModel);
+  this->LayerCacheValid = false;
+  if (this->LayerColumn < 0 || q->rowCount() == 0)
+    {
+    return;
+    }
+  emit q->dataChanged(q->index(0, this->LayerColumn), q->index(q->rowCount() - 1, this->LayerColumn));
+}
+
+//------------------------------------------------------------------------------
+QString qMRMLSegmentsModelPrivate::terminologyTooltip(vtkSegment* segment)
+{
+  Q_Q(qMRMLSegmentsModel);
+  std::string serializedTerminology;
+  if (!segment->GetTag(vtkSegment::GetTerminologyEntryTagName(), serializedTerminology))
+    {
+    return qMRMLSegmentsModel::terminologyTooltipForSegment(segment);
+    }
+
+  // The tooltips depend on the loaded terminologies, they are cleared when the logic is modified
+  vtkSlicerTerminologiesModuleLogic* terminologiesLogic = vtkSlicerTerminologiesModuleLogic::SafeDownCast(
+    qSlicerCoreApplication::application()->moduleLogic("Terminologies"));
+  if (terminologiesLogic != this->TerminologiesLogic)
+    {
+    q->qvtkReconnect(this->TerminologiesLogic, terminologiesLogic, vtkCommand::ModifiedEvent,
+      q, SLOT(clearTerminologyTooltipCache()));
+    this->TerminologiesLogic = terminologiesLogic;
+    this->TerminologyTooltipCache.clear();
+    }
+
+  QString terminology = QString::fromStdString(serializedTerminology);
+  QHash<QString, QString>::const_iterator tooltipIt = this->TerminologyTooltipCache.constFind(terminology);
+  if (tooltipIt != this->TerminologyTooltipCache.constEnd())
+    {
+    return tooltipIt.value();
+    }
+  QString tooltip = qMRMLSegmentsModel::terminologyTooltipForSegment(segment);
+  this->TerminologyTooltipCache[terminology] = tooltip;
+  return tooltip;
+}
+
 //------------------------------------------------------------------------------
 QString qMRMLSegmentsModelPrivate::getTerminologyUserDataForSegment(vtkSegment* segment)
 {
@@ -286,87 +435,114 @@ QModelIndex qMRMLSegmentsModel::indexFromSegmentID(QString segmentID, int column
 {
   Q_D(const qMRMLSegmentsModel);
 
-  QModelIndex itemIndex;
-  if (segmentID.isEmpty())
-    {
-    return itemIndex;
-    }
-
-  QModelIndex startIndex = this->index(0, 0);
-  // QAbstractItemModel::match doesn't browse through columns, we need to do it manually
-  QModelIndexList itemIndexes = this->match(
-    startIndex, SegmentIDRole, segmentID, 1, Qt::MatchExactly | Qt::MatchRecursive);
-  if (itemIndexes.size() == 0)
+  const int row = d->segmentRow(segmentID);
+  if (row < 0)
     {
     return QModelIndex();
     }
-  itemIndex = itemIndexes[0];
-
-  if (column == 0)
-    {
-    // QAbstractItemModel::match only search through the first column
-    return itemIndex;
-    }
-
-  // Add the QModelIndexes from the other columns
-  const int row = itemIndex.row();
-  QModelIndex nodeParentIndex = itemIndex.parent();
-  if (column >= this->columnCount(nodeParentIndex))
+  if (column >= this->columnCount())
     {
     qCritical() << Q_FUNC_INFO << ": Invalid column " << column;
     return QModelIndex();
     }
 
-  return this->index(row, column, itemIndex.parent());;
+  return this->index(row, column);
 }
 
 //------------------------------------------------------------------------------
 QModelIndexList qMRMLSegmentsModel::indexes(QString segmentID) const
 {
-  QModelIndex startIndex = this->index(0, 0);
-  // QAbstractItemModel::match doesn't browse through columns, we need to do it manually
-  QModelIndexList itemIndexes = this->match(
-    startIndex, SegmentIDRole, segmentID, 1, Qt::MatchExactly | Qt::MatchRecursive);
-  if (itemIndexes.size() != 1)
+  Q_D(const qMRMLSegmentsModel);
+
+  QModelIndexList itemIndexes;
+  const int row = d->segmentRow(segmentID);
+  if (row < 0)
     {
-    return QModelIndexList(); // If 0 it's empty, if >1 it's invalid (one item for each UID)
+    return itemIndexes;
     }
-  // Add the QModelIndexes from the other columns
-  const int row = itemIndexes[0].row();
-  for (int col = 1; col < this->columnCount(); ++col)
+  for (int col = 0; col < this->columnCount(); ++col)
     {
     itemIndexes << this->index(row, col);
     }
   return itemIndexes;
 }
 
+//------------------------------------------------------------------------------
+QVariant qMRMLSegmentsModel::data(const QModelIndex& index, int role/*=Qt::DisplayRole*/)const
+{
+  Q_D(const qMRMLSegmentsModel);
+  if (!index.isValid() || !d->SegmentationNode)
+    {
+    return QStandardItemModel::data(index, role);
+    }
+  if (role == IndexRole)
+    {
+    // Rows are kept in the order of the segments
+    return index.row();
+    }
+  if (index.column() == this->layerColumn())
+    {
+    if (role == Qt::DisplayRole)
+      {
+      QString segmentID = QStandardItemModel::data(index, SegmentIDRole).toString();
+      return QString::number(d->segmentLayer(segmentID));
+      }
+    if (role == Qt::TextAlignmentRole)
+      {
+      return int(Qt::AlignCenter);
+      }
+    }
+  else if (index.column() == this->colorColumn() && role == Qt::ToolTipRole)
+    {
+    QString segmentID = QStandardItemModel::data(index, SegmentIDRole).toString();
+    vtkSegment* segment = d->SegmentationNode->GetSegmentation()->GetSegment(segmentID.toStdString());
+    if (segment)
+      {
+      return const_cast<qMRMLSegmentsModelPrivate*>(d)->terminologyTooltip(segment);
+      }
+    }
+  return QStandardItemModel::data(index, role);
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSegmentsModel::invalidateRowCache()
+{
+  Q_D(qMRMLSegmentsModel);
+  d->RowCacheValid = false;
+}
+
 //------------------------------------------------------------------------------
 void qMRMLSegmentsModel::rebuildFromSegments()
 {
   Q_D(qMRMLSegmentsModel);
 
   this->beginResetModel();
+  // Views are reset at the end, there is no need to notify them of each row
+  bool wasBlocking = this->blockSignals(true);
 
   // Enabled so it can be interacted with
   this->invisibleRootItem()->setFlags(Qt::ItemIsEnabled);
 
   // Remove rows before populating
   this->removeRows(0, this->rowCount());
+  d->RowCache.clear();
+  d->RowCacheValid = true;
+  d->LayerCacheValid = false;
+  d->TerminologyTooltipCache.clear();
 
-  if (!d->SegmentationNode)
-    {
-    this->endResetModel();
-    return;
-    }
-
-  // Populate model with the segments
-  std::vector<std::string> segmentIDs;
-  d->SegmentationNode->GetSegmentation()->GetSegmentIDs(segmentIDs);
-  for (std::string segmentID : segmentIDs)
+  if (d->SegmentationNode)
     {
-    d->insertSegment(QString::fromStdString(segmentID));
+    // Populate model with the segments, in order
+    std::vector<std::string> segmentIDs;
+    d->SegmentationNode->GetSegmentation()->GetSegmentIDs(segmentIDs);
+    int row = 0;
+    for (const std::string& segmentID : segmentIDs)
+      {
+      d->insertSegment(QString::fromStdString(segmentID), row++);
+      }
     }
 
+  this->blockSignals(wasBlocking);
   this->endResetModel();
 }
 
@@ -457,9 +633,6 @@ void qMRMLSegmentsModel::updateItemDataFromSegment(QStandardItem* item, QString
     return;
     }
 
-  int index = segmentation->GetSegmentIndex(segmentID.toStdString());
-  item->setData(index, IndexRole);
-
   if (column == this->nameColumn())
     {
     item->setText(segment->GetName());
@@ -495,11 +668,7 @@ void qMRMLSegmentsModel::updateItemDataFromSegment(QStandardItem* item, QString
     }
   else if (column == this->layerColumn())
     {
-    int layer = segmentation->GetLayerIndex(segmentID.toStdString(), vtkSegmentationConverter::GetBinaryLabelmapRepresentationName());
-    std::stringstream ss;
-    ss << layer;
-    item->setText(QString::fromStdString(ss.str()));
-    item->setTextAlignment(Qt::AlignCenter);
+    // The layer is computed in data(), for all the segments at once
     }
   else
     {
@@ -523,8 +692,8 @@ void qMRMLSegmentsModel::updateItemDataFromSegment(QStandardItem* item, QString
       QString segmentTerminologyTagValue(d->getTerminologyUserDataForSegment(segment));
       if (segmentTerminologyTagValue != item->data(qSlicerTerminologyItemDelegate::TerminologyRole).toString())
         {
+        // The tooltip is computed in data() from the terminology
         item->setData(segmentTerminologyTagValue, qSlicerTerminologyItemDelegate::TerminologyRole);
-        item->setToolTip(qMRMLSegmentsTableView::terminologyTooltipForSegment(segment));
         }
       // Set color
       double* colorArray = segment->GetColor();
@@ -674,9 +843,6 @@ void qMRMLSegmentsModel::updateSegmentFromItemData(QString segmentID, QStandardI
       // Set name auto-generated flag
       segment->SetNameAutoGenerated(
         item->data(qSlicerTerminologyItemDelegate::NameAutoGeneratedRole).toBool());
-
-      // Update tooltip
-      item->setToolTip(qMRMLSegmentsTableView::terminologyTooltipForSegment(segment));
       }
     // Opacity changed
     else if (item->column() == this->opacityColumn())
@@ -794,6 +960,7 @@ void qMRMLSegmentsModel::onSegmentAdded(QString segmentID)
   if (!segmentID.isEmpty())
     {
     d->insertSegment(segmentID);
+    d->invalidateLayers();
     return;
     }
 
@@ -808,7 +975,7 @@ void qMRMLSegmentsModel::onSegmentAdded(QString segmentID)
       }
     d->insertSegment(currentSegmentID.c_str());
     }
-  this->updateItemsFromColumnIndex(this->layerColumn());
+  d->invalidateLayers();
 }
 
 //------------------------------------------------------------------------------
@@ -819,6 +986,7 @@ void qMRMLSegmentsModel::onSegmentRemoved(QString removedSegmentID)
     {
     QModelIndex index = this->indexFromSegmentID(removedSegmentID);
     this->removeRow(index.row());
+    d->invalidateLayers();
     return;
     }
 
@@ -836,21 +1004,24 @@ void qMRMLSegmentsModel::onSegmentRemoved(QString removedSegmentID)
       this->removeRow(index.row());
       }
     }
-  this->updateItemsFromColumnIndex(this->layerColumn());
+  d->invalidateLayers();
 }
 
 //------------------------------------------------------------------------------
 void qMRMLSegmentsModel::onSegmentModified(QString segmentID)
 {
+  Q_D(qMRMLSegmentsModel);
   this->updateItemsFromSegmentID(segmentID);
-  this->updateItemsFromColumnIndex(this->layerColumn());
+  // Modifying the labelmap of a segment may move it to another layer
+  d->invalidateLayers();
 }
 
 //------------------------------------------------------------------------------
 void qMRMLSegmentsModel::onSegmentOrderModified()
 {
+  Q_D(qMRMLSegmentsModel);
   this->reorderItems();
-  this->updateItemsFromColumnIndex(this->layerColumn());
+  d->invalidateLayers();
 }
 
 //------------------------------------------------------------------------------
@@ -878,17 +1049,35 @@ void qMRMLSegmentsModel::reorderItems()
 
   this->layoutAboutToBeChanged();
   bool wasBlocking = this->blockSignals(true);
-  for (int i = 0; i < segmentation->GetNumberOfSegments(); ++i)
+  std::vector<std::string> segmentIDs;
+  segmentation->GetSegmentIDs(segmentIDs);
+  const int numberOfSegments = static_cast<int>(segmentIDs.size());
+  for (int i = 0; i < numberOfSegments && i < this->rowCount(); ++i)
     {
-    std::string segmentID = segmentation->GetNthSegmentID(i);
-    QModelIndex index = this->indexFromSegmentID(segmentID.c_str());
-    if (index.row() == i)
+    QString segmentID = QString::fromStdString(segmentIDs[i]);
+    if (this->segmentIDFromIndex(this->index(i, 0)) == segmentID)
+      {
+      // Most rows are already in place, don't look them up
+      continue;
+      }
+    int row = -1;
+    for (int j = i + 1; j < this->rowCount(); ++j)
+      {
+      if (this->segmentIDFromIndex(this->index(j, 0)) == segmentID)
+        {
+        row = j;
+        break;
+        }
+      }
+    if (row < 0)
       {
       continue;
       }
-    QList<QStandardItem*> items = this->takeRow(index.row());
+    QList<QStandardItem*> items = this->takeRow(row);
     this->insertRow(i, items);
     }
+  // Rows have been moved without notification
+  d->RowCacheValid = false;
   this->blockSignals(wasBlocking);
   this->layoutChanged();
 }
@@ -1062,3 +1251,10 @@ QString qMRMLSegmentsModel::terminologyTooltipForSegment(vtkSegment* segment)
 
   return QString(terminologiesLogic->GetInfoStringFromTerminologyEntry(terminologyEntry).c_str());
 }
+
+//------------------------------------------------------------------------------
+void qMRMLSegmentsModel::clearTerminologyTooltipCache()
+{
+  Q_D(qMRMLSegmentsModel);
+  d->TerminologyTooltipCache.clear();
+}
@@ -43,6 +43,9 @@ class vtkSegment;
 /// for each segment in the vtkSegmentation.
 /// Individual segment items are updated only if the associated segment is updated
 /// (vtkSegmentation::SegmentModified)
+/// Data that is expensive to compute for every segment (segment index, layer and
+/// terminology tooltip) is not stored in the items but computed in data() when
+/// a view requests it, i.e. only for the displayed rows.
 class Q_SLICER_MODULE_SEGMENTATIONS_WIDGETS_EXPORT qMRMLSegmentsModel : public QStandardItemModel
 {
   Q_OBJECT
@@ -102,6 +105,10 @@ public:
   /// Return all the QModelIndexes (all the columns) for a given segment ID
   QModelIndexList indexes(QString segmentID)const;
 
+  /// Reimplemented to compute the segment index (IndexRole), the layer
+  /// (layer column) and the terminology tooltip (color column) on demand.
+  QVariant data(const QModelIndex& index, int role = Qt::DisplayRole)const override;
+
   /// The segmentation node that is used to populate the model
   vtkMRMLSegmentationNode* segmentationNode()const;
   virtual void setSegmentationNode(vtkMRMLSegmentationNode* segmentation);
@@ -125,6 +132,14 @@ protected slots:
   /// Needs maxColumnId() to be reimplemented in subclasses
   void updateColumnCount();
 
+  /// Invoked when the terminologies logic is modified, the terminology
+  /// tooltips are assembled again the next time they are needed.
+  void clearTerminologyTooltipCache();
+
+  /// Invoked when rows are inserted, removed or moved, the rows of the
+  /// segments are looked up again the next time they are needed.
+  void invalidateRowCache();
+
 protected:
   qMRMLSegmentsModel(qMRMLSegmentsModelPrivate* pimpl, QObject *parent=nullptr);
 
@@ -34,6 +34,7 @@
 
 // Qt includes
 #include <QFlags>
+#include <QHash>
 #include <QMap>
 
 // Segmentations includes
@@ -48,8 +49,10 @@
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
 
 class QStandardItemModel;
+class vtkSlicerTerminologiesModuleLogic;
 
 //------------------------------------------------------------------------------
 // qMRMLSegmentsModelPrivate
@@ -69,6 +72,25 @@ public:
   // If no row is specified, then the index is retrieved from the segmentation
   QStandardItem* insertSegment(QString segmentID, int row=-1);
 
+  /// Return the row of the segment, -1 if the segment is not in the model.
+  /// Rows are looked up in RowCache, which is rebuilt in one pass if it is
+  /// invalid or out of date.
+  int segmentRow(const QString& segmentID)const;
+  /// Rebuild RowCache from the items of the model
+  void rebuildRowCache()const;
+
+  /// Return the layer of the segment in the binary labelmap representation.
+  /// Layers of all the segments are computed at once and cached until
+  /// invalidateLayers() is called.
+  int segmentLayer(const QString& segmentID)const;
+  /// Mark the layers as out of date and notify the views that display them.
+  void invalidateLayers();
+
+  /// Return the terminology tooltip of the segment. Segments often share the
+  /// same terminology, so the tooltips are cached by serialized terminology
+  /// until the terminologies logic or the segmentation node changes.
+  QString terminologyTooltip(vtkSegment* segment);
+
   /// Get string to pass terminology information via table widget item
   QString getTerminologyUserDataForSegment(vtkSegment* segment);
 
@@ -93,6 +115,20 @@ public:
 
   /// Segmentation node
   vtkSmartPointer<vtkMRMLSegmentationNode> SegmentationNode;
+
+  /// Row of the segments by segment ID. Kept up-to-date when segments are
+  /// appended or removed from the end, invalidated by other row changes.
+  mutable QHash<QString, int> RowCache;
+  mutable bool RowCacheValid;
+
+  /// Layer of the segments by segment ID
+  mutable QHash<QString, int> LayerCache;
+  mutable bool LayerCacheValid;
+
+  /// Terminology tooltips by serialized terminology
+  QHash<QString, QString> TerminologyTooltipCache;
+  /// Terminologies logic observed to clear TerminologyTooltipCache
+  vtkWeakPointer<vtkSlicerTerminologiesModuleLogic> TerminologiesLogic;
 };
 
 #endif
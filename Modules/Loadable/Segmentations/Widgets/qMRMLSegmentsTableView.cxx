@@ -64,6 +64,7 @@
 #include <QMessageBox>
 #include <QModelIndex>
 #include <QStringList>
+#include <QStyle>
 #include <QTimer>
 #include <QToolButton>
 
@@ -274,7 +275,11 @@ void qMRMLSegmentsTableViewPrivate::init()
   this->SegmentsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
   this->SegmentsTable->horizontalHeader()->setSectionResizeMode(this->Model->nameColumn(), QHeaderView::Stretch);
   this->SegmentsTable->horizontalHeader()->setStretchLastSection(false);
-  this->SegmentsTable->verticalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+  // Rows have the same height, the height of a line of text. Resizing them to their contents
+  // would require computing the data of all the segments instead of only the displayed ones.
+  this->SegmentsTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+  this->SegmentsTable->verticalHeader()->setDefaultSectionSize(this->SegmentsTable->fontMetrics().height()
+    + 2 * this->SegmentsTable->style()->pixelMetric(QStyle::PM_FocusFrameVMargin, nullptr, this->SegmentsTable));
 
   // Select rows
   this->SegmentsTable->setSelectionBehavior(QAbstractItemView::SelectRows);
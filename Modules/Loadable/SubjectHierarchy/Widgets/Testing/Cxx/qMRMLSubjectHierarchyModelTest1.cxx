@@ -0,0 +1,200 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Copyright (c) Kitware Inc.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QApplication>
+
+// SubjectHierarchy includes
+#include "qMRMLSortFilterSubjectHierarchyProxyModel.h"
+#include "qMRMLSubjectHierarchyModel.h"
+#include "qSlicerSubjectHierarchyPluginHandler.h"
+
+// MRML includes
+#include <vtkMRMLCoreTestingMacros.h>
+#include <vtkMRMLDisplayNode.h>
+#include <vtkMRMLModelNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSubjectHierarchyNode.h>
+
+// VTK includes
+#include <vtkNew.h>
+#include "qMRMLWidget.h"
+
+// STD includes
+#include <string>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+vtkIdType createFolders(vtkMRMLSubjectHierarchyNode* shNode, vtkIdType parentItemID,
+                        const std::string& name, int numberOfFolders)
+{
+  vtkIdType lastFolderItemID = vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID;
+  for (int folderIndex = 0; folderIndex < numberOfFolders; ++folderIndex)
+    {
+    lastFolderItemID = shNode->CreateFolderItem(parentItemID, name + std::to_string(folderIndex));
+    }
+  return lastFolderItemID;
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType childItemID(qMRMLSubjectHierarchyModel& model, const QModelIndex& parent, int row)
+{
+  return model.subjectHierarchyItemFromIndex(model.index(row, 0, parent));
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int qMRMLSubjectHierarchyModelTest1(int argc, char* argv[])
+{
+  qMRMLWidget::preInitializeApplication();
+  QApplication app(argc, argv);
+  qMRMLWidget::postInitializeApplication();
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkMRMLSubjectHierarchyNode* shNode = vtkMRMLSubjectHierarchyNode::GetSubjectHierarchyNode(scene);
+  CHECK_NOT_NULL(shNode);
+  // Assign the default plugin to the created items
+  qSlicerSubjectHierarchyPluginHandler::instance()->setMRMLScene(scene);
+  vtkIdType sceneItemID = shNode->GetSceneItemID();
+
+  // The branches have more children than the number of rows created at once (256)
+  // Scene
+  //   + Large: Child0 ... Child598, Match
+  //   + Source: Moved: MovedChild
+  //   + Target: Target0 ... Target299
+  //   + Parent: Orphan0: OrphanChild, Orphan1
+  //   + Model
+  const int numberOfChildren = 600;
+  vtkIdType largeFolderID = shNode->CreateFolderItem(sceneItemID, "Large");
+  createFolders(shNode, largeFolderID, "Child", numberOfChildren - 1);
+  vtkIdType matchID = shNode->CreateFolderItem(largeFolderID, "Match");
+
+  vtkIdType sourceFolderID = shNode->CreateFolderItem(sceneItemID, "Source");
+  vtkIdType movedID = shNode->CreateFolderItem(sourceFolderID, "Moved");
+  vtkIdType movedChildID = shNode->CreateFolderItem(movedID, "MovedChild");
+  const int numberOfTargetChildren = 300;
+  vtkIdType targetFolderID = shNode->CreateFolderItem(sceneItemID, "Target");
+  vtkIdType lastTargetChildID = createFolders(shNode, targetFolderID, "Target", numberOfTargetChildren);
+
+  vtkIdType parentFolderID = shNode->CreateFolderItem(sceneItemID, "Parent");
+  vtkIdType orphan0ID = shNode->CreateFolderItem(parentFolderID, "Orphan0");
+  vtkIdType orphanChildID = shNode->CreateFolderItem(orphan0ID, "OrphanChild");
+  vtkIdType orphan1ID = shNode->CreateFolderItem(parentFolderID, "Orphan1");
+
+  vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(scene->AddNewNodeByClass("vtkMRMLModelNode", "Model"));
+  modelNode->CreateDefaultDisplayNodes();
+  vtkIdType modelItemID = shNode->CreateItem(sceneItemID, modelNode);
+
+  qMRMLSubjectHierarchyModel model;
+  model.setVisibilityColumn(1);
+  model.setMRMLScene(scene);
+  qMRMLSortFilterSubjectHierarchyProxyModel proxyModel;
+  proxyModel.setSourceModel(&model);
+
+  //
+  // Only the first rows are created
+  //
+  QModelIndex sceneIndex = model.subjectHierarchySceneIndex();
+  CHECK_BOOL(sceneIndex.isValid(), true);
+  CHECK_INT(model.rowCount(sceneIndex), 5);
+  QModelIndex largeFolderIndex = model.indexFromSubjectHierarchyItem(largeFolderID);
+  CHECK_BOOL(largeFolderIndex.isValid(), true);
+  CHECK_INT(model.rowCount(largeFolderIndex), 0);
+  CHECK_BOOL(model.hasChildren(largeFolderIndex), true);
+  CHECK_BOOL(model.canFetchMore(largeFolderIndex), true);
+
+  //
+  // Filtered branch: the proxy keeps fetching until a row is accepted
+  //
+  proxyModel.setNameFilter("Match");
+  QModelIndex proxyLargeFolderIndex = proxyModel.mapFromSource(largeFolderIndex);
+  CHECK_BOOL(proxyLargeFolderIndex.isValid(), true);
+  CHECK_INT(proxyModel.rowCount(proxyLargeFolderIndex), 0);
+  CHECK_BOOL(proxyModel.canFetchMore(proxyLargeFolderIndex), true);
+  proxyModel.fetchMore(proxyLargeFolderIndex);
+  CHECK_INT(proxyModel.rowCount(proxyLargeFolderIndex), 1);
+  CHECK_BOOL(proxyModel.subjectHierarchyItemFromIndex(
+    proxyModel.index(0, 0, proxyLargeFolderIndex)) == matchID, true);
+  CHECK_INT(model.rowCount(largeFolderIndex), numberOfChildren);
+  CHECK_BOOL(model.canFetchMore(largeFolderIndex), false);
+  // Nothing left to fetch
+  proxyModel.fetchMore(proxyLargeFolderIndex);
+  CHECK_INT(proxyModel.rowCount(proxyLargeFolderIndex), 1);
+  proxyModel.setNameFilter(QString());
+
+  //
+  // Move a row into a branch that has not been fetched: the row is kept with its children
+  //
+  QStandardItem* movedItem = model.itemFromSubjectHierarchyItem(movedID);
+  CHECK_NOT_NULL(movedItem);
+  CHECK_NOT_NULL(model.itemFromSubjectHierarchyItem(movedChildID));
+  CHECK_INT(movedItem->rowCount(), 1);
+  QModelIndex sourceFolderIndex = model.indexFromSubjectHierarchyItem(sourceFolderID);
+  QModelIndex targetFolderIndex = model.indexFromSubjectHierarchyItem(targetFolderID);
+  CHECK_INT(model.rowCount(targetFolderIndex), 0);
+
+  shNode->SetItemParent(movedID, targetFolderID);
+
+  CHECK_INT(model.rowCount(sourceFolderIndex), 0);
+  CHECK_BOOL(model.canFetchMore(sourceFolderIndex), false);
+  // The rows of the preceding siblings are created, the moved row is the last one
+  CHECK_INT(model.rowCount(targetFolderIndex), numberOfTargetChildren + 1);
+  CHECK_BOOL(model.canFetchMore(targetFolderIndex), false);
+  CHECK_BOOL(childItemID(model, targetFolderIndex, numberOfTargetChildren - 1) == lastTargetChildID, true);
+  CHECK_POINTER(model.itemFromIndex(targetFolderIndex)->child(numberOfTargetChildren), movedItem);
+  CHECK_INT(movedItem->rowCount(), 1);
+  CHECK_BOOL(model.subjectHierarchyItemFromItem(movedItem->child(0)) == movedChildID, true);
+  CHECK_BOOL(model.indexFromSubjectHierarchyItem(movedID) == movedItem->index(), true);
+  CHECK_BOOL(model.indexFromSubjectHierarchyItem(movedChildID).parent() == movedItem->index(), true);
+
+  //
+  // Orphans: the children of a removed item are moved under the scene with their rows
+  //
+  QStandardItem* orphan0Item = model.itemFromSubjectHierarchyItem(orphanChildID)->parent();
+  CHECK_NOT_NULL(orphan0Item);
+  CHECK_BOOL(model.subjectHierarchyItemFromItem(orphan0Item) == orphan0ID, true);
+  CHECK_BOOL(shNode->RemoveItem(parentFolderID, false, false), true);
+  CHECK_BOOL(model.indexFromSubjectHierarchyItem(parentFolderID).isValid(), false);
+  CHECK_INT(model.rowCount(sceneIndex), shNode->GetNumberOfItemChildren(sceneItemID));
+  for (int row = 0; row < model.rowCount(sceneIndex); ++row)
+    {
+    CHECK_BOOL(childItemID(model, sceneIndex, row) == shNode->GetItemByPositionUnderParent(sceneItemID, row), true);
+    }
+  CHECK_POINTER(model.itemFromSubjectHierarchyItem(orphan0ID), orphan0Item);
+  CHECK_BOOL(model.indexFromSubjectHierarchyItem(orphan0ID).parent() == sceneIndex, true);
+  CHECK_BOOL(model.indexFromSubjectHierarchyItem(orphan1ID).parent() == sceneIndex, true);
+  CHECK_BOOL(model.indexFromSubjectHierarchyItem(orphanChildID).parent() == orphan0Item->index(), true);
+
+  //
+  // Visibility is cached until the item is modified
+  //
+  QModelIndex visibilityIndex = model.indexFromSubjectHierarchyItem(modelItemID, model.visibilityColumn());
+  CHECK_BOOL(visibilityIndex.isValid(), true);
+  CHECK_INT(model.data(visibilityIndex, qMRMLSubjectHierarchyModel::VisibilityRole).toInt(), 1);
+  modelNode->GetDisplayNode()->SetVisibility(0);
+  visibilityIndex = model.indexFromSubjectHierarchyItem(modelItemID, model.visibilityColumn());
+  CHECK_INT(model.data(visibilityIndex, qMRMLSubjectHierarchyModel::VisibilityRole).toInt(), 0);
+  modelNode->GetDisplayNode()->SetVisibility(1);
+  visibilityIndex = model.indexFromSubjectHierarchyItem(modelItemID, model.visibilityColumn());
+  CHECK_INT(model.data(visibilityIndex, qMRMLSubjectHierarchyModel::VisibilityRole).toInt(), 1);
+
+  qSlicerSubjectHierarchyPluginHandler::instance()->setMRMLScene(nullptr);
+  return EXIT_SUCCESS;
+}
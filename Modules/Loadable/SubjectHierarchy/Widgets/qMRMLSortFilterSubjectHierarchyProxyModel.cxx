@@ -684,6 +684,30 @@ bool qMRMLSortFilterSubjectHierarchyProxyModel::filterAcceptsRow(int sourceRow,
   return (this->filterAcceptsItem(itemID) != Reject);
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSortFilterSubjectHierarchyProxyModel::fetchMore(const QModelIndex& parent)
+{
+  QAbstractItemModel* model = this->sourceModel();
+  if (!model)
+    {
+    return;
+    }
+  QModelIndex sourceParent = this->mapToSource(parent);
+  const int rowCount = this->rowCount(parent);
+  // Fetch batches until one of them has accepted rows. Stop if the source
+  // does not add rows, canFetchMore() would then stay true forever.
+  while (model->canFetchMore(sourceParent))
+    {
+    const int sourceRowCount = model->rowCount(sourceParent);
+    model->fetchMore(sourceParent);
+    if (this->rowCount(parent) > rowCount
+      || model->rowCount(sourceParent) <= sourceRowCount)
+      {
+      break;
+      }
+    }
+}
+
 //------------------------------------------------------------------------------
 qMRMLSortFilterSubjectHierarchyProxyModel::AcceptType qMRMLSortFilterSubjectHierarchyProxyModel::filterAcceptsItem(
   vtkIdType itemID, bool canAcceptIfAnyChildIsAccepted/*=true*/)const
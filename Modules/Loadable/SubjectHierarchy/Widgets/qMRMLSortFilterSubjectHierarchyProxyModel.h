@@ -163,6 +163,11 @@ public:
   /// This method test each item via \a filterAcceptsItem
   bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent)const override;
 
+  /// Reimplemented to keep fetching the rows of the children of \a parent in the source model
+  /// until one of them is accepted or all of them have been fetched. Otherwise a batch of
+  /// rejected rows would not add any visible row and the view would stop fetching the branch.
+  void fetchMore(const QModelIndex& parent) override;
+
   Qt::ItemFlags flags(const QModelIndex & index)const override;
 
 public slots:
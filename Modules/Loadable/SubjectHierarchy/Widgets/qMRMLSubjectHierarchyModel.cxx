@@ -58,6 +58,10 @@
 #include "qSlicerSubjectHierarchyAbstractPlugin.h"
 #include "qSlicerSubjectHierarchyDefaultPlugin.h"
 
+// STD includes
+#include <algorithm>
+#include <limits>
+
 
 //------------------------------------------------------------------------------
 qMRMLSubjectHierarchyModelPrivate::qMRMLSubjectHierarchyModelPrivate(qMRMLSubjectHierarchyModel& object)
@@ -70,6 +74,8 @@ qMRMLSubjectHierarchyModelPrivate::qMRMLSubjectHierarchyModelPrivate(qMRMLSubjec
   , DescriptionColumn(-1)
   , NoneEnabled(false)
   , NoneDisplay(qMRMLSubjectHierarchyModel::tr("None"))
+  , FetchBatchSize(256)
+  , InsertingRow(false)
   , SubjectHierarchyNode(nullptr)
   , MRMLScene(nullptr)
   , TerminologiesModuleLogic(nullptr)
@@ -163,30 +169,35 @@ QString qMRMLSubjectHierarchyModelPrivate::subjectHierarchyItemName(vtkIdType it
 QStandardItem* qMRMLSubjectHierarchyModelPrivate::insertSubjectHierarchyItem(vtkIdType itemID, int index)
 {
   Q_Q(qMRMLSubjectHierarchyModel);
-  QStandardItem* item = q->itemFromSubjectHierarchyItem(itemID);
+  QStandardItem* item = this->existingItemFromSubjectHierarchyItem(itemID);
   if (item)
     {
-    // It is possible that the item has been already added if it is the parent of a child item already inserted
+    // It is possible that the item has been already added if its branch has been fetched meanwhile
     return item;
     }
   vtkIdType parentItemID = q->parentSubjectHierarchyItem(itemID);
-  QStandardItem* parentItem = q->itemFromSubjectHierarchyItem(parentItemID);
+  if (!parentItemID)
+    {
+    qCritical() << Q_FUNC_INFO << ": Unable to get parent for subject hierarchy item with ID " << itemID;
+    return nullptr;
+    }
+  QStandardItem* parentItem = this->existingItemFromSubjectHierarchyItem(parentItemID);
   if (!parentItem)
     {
-    if (!parentItemID)
-      {
-      qCritical() << Q_FUNC_INFO << ": Unable to get parent for subject hierarchy item with ID " << itemID;
-      return nullptr;
-      }
-    parentItem = q->insertSubjectHierarchyItem(parentItemID);
-    if (!parentItem)
-      {
-      qCritical() << Q_FUNC_INFO << ": Failed to insert parent subject hierarchy item with ID " << parentItemID;
-      return nullptr;
-      }
+    // The branch containing the parent has not been fetched yet, the row will be created then
+    return nullptr;
+    }
+  // The created rows are always the first children in subject hierarchy order. If the branch
+  // has not been fetched until the item then its row will be created with the rest of the branch.
+  const int extraRows = this->extraRowCount(parentItem);
+  const int numberOfChildRows = parentItem->rowCount() - extraRows;
+  if ( index - extraRows >= numberOfChildRows
+    && numberOfChildRows < this->SubjectHierarchyNode->GetNumberOfItemChildren(parentItemID) - 1 )
+    {
+    return nullptr;
     }
   item = q->insertSubjectHierarchyItem(itemID, parentItem, index);
-  if (q->itemFromSubjectHierarchyItem(itemID) != item)
+  if (this->existingItemFromSubjectHierarchyItem(itemID) != item)
     {
     qCritical() << Q_FUNC_INFO << ": Item mismatch when inserting subject hierarchy item with ID " << itemID;
     return nullptr;
@@ -195,7 +206,204 @@ QStandardItem* qMRMLSubjectHierarchyModelPrivate::insertSubjectHierarchyItem(vtk
 }
 
 //------------------------------------------------------------------------------
-vtkSlicerTerminologiesModuleLogic* qMRMLSubjectHierarchyModelPrivate::terminologiesModuleLogic()
+QModelIndex qMRMLSubjectHierarchyModelPrivate::indexFromSubjectHierarchyItem(vtkIdType itemID, int column, bool fetch)const
+{
+  Q_Q(const qMRMLSubjectHierarchyModel);
+  QModelIndex itemIndex;
+  if (!itemID || !this->SubjectHierarchyNode)
+    {
+    return itemIndex;
+    }
+  // Rows must not be created while the model is notified about a row being inserted
+  fetch = fetch && !this->InsertingRow;
+
+  // Try to find the index in the cache first
+  QHash<vtkIdType,QPersistentModelIndex>::iterator rowCacheIt = this->RowCache.find(itemID);
+  if (rowCacheIt == this->RowCache.end())
+    {
+    if (!fetch || !this->SubjectHierarchyNode->HasItem(itemID))
+      {
+      // Not found in cache, therefore it has not been inserted in the model
+      return itemIndex;
+      }
+    }
+  else if (rowCacheIt.value().isValid())
+    {
+    // An entry found in the cache. If the item at the cached index matches the requested item ID then we use it.
+    QStandardItem* item = q->itemFromIndex(rowCacheIt.value());
+    if (item && item->data(qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole).toLongLong() == itemID)
+      {
+      // ID matched
+      itemIndex = rowCacheIt.value();
+      }
+    }
+
+  // The cache was not up-to-date. Look for the item in the rows of its parent.
+  if (!itemIndex.isValid() && itemID == this->SubjectHierarchyNode->GetSceneItemID())
+    {
+    itemIndex = q->subjectHierarchySceneIndex();
+    }
+  else if (!itemIndex.isValid() && this->SubjectHierarchyNode->HasItem(itemID))
+    {
+    vtkIdType parentItemID = this->SubjectHierarchyNode->GetItemParent(itemID);
+    QStandardItem* parentItem = q->itemFromIndex(this->indexFromSubjectHierarchyItem(parentItemID, 0, fetch));
+    if (parentItem)
+      {
+      for (int row = 0; row < parentItem->rowCount(); ++row)
+        {
+        QStandardItem* child = parentItem->child(row);
+        if (child && child->data(qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole).toLongLong() == itemID)
+          {
+          itemIndex = child->index();
+          break;
+          }
+        }
+      if (!itemIndex.isValid() && fetch)
+        {
+        // Create the rows of the branch until the item
+        const_cast<qMRMLSubjectHierarchyModelPrivate*>(this)->fetchSubjectHierarchyChildren(
+          parentItem, std::numeric_limits<int>::max(), itemID);
+        QStandardItem* item = this->existingItemFromSubjectHierarchyItem(itemID);
+        itemIndex = (item ? item->index() : QModelIndex());
+        }
+      }
+    }
+  if (!itemIndex.isValid())
+    {
+    this->RowCache.remove(itemID);
+    return itemIndex;
+    }
+  this->RowCache[itemID] = itemIndex;
+
+  if (column == 0)
+    {
+    return itemIndex;
+    }
+  // Get the index of the other column in the same row
+  const int row = itemIndex.row();
+  QModelIndex nodeParentIndex = itemIndex.parent();
+  if (column >= q->columnCount(nodeParentIndex))
+    {
+    qCritical() << Q_FUNC_INFO << ": Invalid column " << column;
+    return QModelIndex();
+    }
+  return ctk::modelChildIndex(const_cast<qMRMLSubjectHierarchyModel*>(q), nodeParentIndex, row, column);
+}
+
+//------------------------------------------------------------------------------
+QStandardItem* qMRMLSubjectHierarchyModelPrivate::existingItemFromSubjectHierarchyItem(vtkIdType itemID, int column/*=0*/)const
+{
+  Q_Q(const qMRMLSubjectHierarchyModel);
+  return q->itemFromIndex(this->indexFromSubjectHierarchyItem(itemID, column, false));
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSubjectHierarchyModelPrivate::fetchSubjectHierarchyChildren(
+  QStandardItem* parentItem, int maximumNumberOfRows, vtkIdType lastItemID/*=0*/)
+{
+  Q_Q(qMRMLSubjectHierarchyModel);
+  vtkIdType parentItemID = q->subjectHierarchyItemFromItem(parentItem);
+  if (!parentItemID || !this->SubjectHierarchyNode->HasItem(parentItemID))
+    {
+    return 0;
+    }
+  std::vector<vtkIdType> childItemIDs;
+  this->SubjectHierarchyNode->GetItemChildren(parentItemID, childItemIDs, false);
+
+  // Create the missing rows in subject hierarchy order. The row of a child that already exists
+  // is not touched, it is only counted to determine the position of the following rows.
+  int numberOfCreatedRows = 0;
+  int row = this->extraRowCount(parentItem);
+  for (std::vector<vtkIdType>::iterator childIt = childItemIDs.begin();
+    childIt != childItemIDs.end() && numberOfCreatedRows < maximumNumberOfRows; ++childIt, ++row)
+    {
+    vtkIdType childItemID = (*childIt);
+    if (!this->existingItemFromSubjectHierarchyItem(childItemID))
+      {
+      q->insertSubjectHierarchyItem(childItemID, parentItem, qMin(row, parentItem->rowCount()));
+      ++numberOfCreatedRows;
+      }
+    if (childItemID == lastItemID)
+      {
+      break;
+      }
+    }
+  return numberOfCreatedRows;
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSubjectHierarchyModelPrivate::extraRowCount(QStandardItem* parentItem)const
+{
+  // The None item is the first row under the scene item
+  if ( this->NoneEnabled && parentItem && parentItem->child(0)
+    && parentItem->child(0)->data(Qt::WhatsThisRole).toString() == this->extraItemIdentifier() )
+    {
+    return 1;
+    }
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLSubjectHierarchyModelPrivate::insertTakenRow(vtkIdType itemID, QList<QStandardItem*> row)
+{
+  Q_Q(qMRMLSubjectHierarchyModel);
+  if (!this->SubjectHierarchyNode || !this->SubjectHierarchyNode->HasItem(itemID))
+    {
+    // The item has been removed together with its former parent
+    qDeleteAll(row);
+    return false;
+    }
+  if (this->existingItemFromSubjectHierarchyItem(itemID))
+    {
+    // A new row has already been created for the item when fetching the branch of a sibling
+    qDeleteAll(row);
+    return false;
+    }
+
+  // Fetch the branches containing the new parent: the row must be kept, as it may have child rows
+  // and it may be referenced by the views (current index, selection, expanded state)
+  vtkIdType parentItemID = this->SubjectHierarchyNode->GetItemParent(itemID);
+  QStandardItem* parentItem = q->itemFromIndex(this->indexFromSubjectHierarchyItem(parentItemID, 0, true));
+  std::vector<vtkIdType> childItemIDs;
+  this->SubjectHierarchyNode->GetItemChildren(parentItemID, childItemIDs, false);
+  std::vector<vtkIdType>::iterator itemIt = std::find(childItemIDs.begin(), childItemIDs.end(), itemID);
+  if (!parentItem || itemIt == childItemIDs.end())
+    {
+    qCritical() << Q_FUNC_INFO << ": Unable to find parent row for subject hierarchy item with ID " << itemID;
+    qDeleteAll(row);
+    return false;
+    }
+
+  // The rows of a branch are always the first children in subject hierarchy order, so the rows of
+  // the preceding siblings are created before inserting the row at the position of the item
+  if (itemIt != childItemIDs.begin())
+    {
+    this->fetchSubjectHierarchyChildren(parentItem, std::numeric_limits<int>::max(), *(itemIt - 1));
+    }
+  const int newRow = this->extraRowCount(parentItem) + static_cast<int>(itemIt - childItemIDs.begin());
+  this->InsertingRow = true;
+  parentItem->insertRow(qMin(newRow, parentItem->rowCount()), row);
+  this->InsertingRow = false;
+  this->RowCache[itemID] = row[0]->index();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+int qMRMLSubjectHierarchyModelPrivate::displayVisibility(
+  vtkIdType itemID, qSlicerSubjectHierarchyAbstractPlugin* ownerPlugin)const
+{
+  QHash<vtkIdType, int>::const_iterator visibilityIt = this->VisibilityCache.constFind(itemID);
+  if (visibilityIt != this->VisibilityCache.constEnd())
+    {
+    return visibilityIt.value();
+    }
+  int visible = ownerPlugin->getDisplayVisibility(itemID);
+  this->VisibilityCache[itemID] = visible;
+  return visible;
+}
+
+//------------------------------------------------------------------------------
+vtkSlicerTerminologiesModuleLogic* qMRMLSubjectHierarchyModelPrivate::terminologiesModuleLogic()const
 {
   if (this->TerminologiesModuleLogic)
     {
@@ -380,85 +588,160 @@ QStandardItem* qMRMLSubjectHierarchyModel::itemFromSubjectHierarchyItem(vtkIdTyp
 QModelIndex qMRMLSubjectHierarchyModel::indexFromSubjectHierarchyItem(vtkIdType itemID, int column/*=0*/)const
 {
   Q_D(const qMRMLSubjectHierarchyModel);
+  return d->indexFromSubjectHierarchyItem(itemID, column, true);
+}
 
-  QModelIndex itemIndex;
-  if (!itemID)
+//------------------------------------------------------------------------------
+QModelIndexList qMRMLSubjectHierarchyModel::indexes(vtkIdType itemID)const
+{
+  QModelIndexList shItemIndexes;
+  QModelIndex shItemIndex = this->indexFromSubjectHierarchyItem(itemID);
+  if (!shItemIndex.isValid())
     {
-    return itemIndex;
+    return shItemIndexes;
+    }
+  // Add the QModelIndexes from the other columns
+  const int row = shItemIndex.row();
+  QModelIndex shItemParentIndex = shItemIndex.parent();
+  const int sceneColumnCount = this->columnCount(shItemParentIndex);
+  for (int col=0; col<sceneColumnCount; ++col)
+    {
+    shItemIndexes << this->index(row, col, shItemParentIndex);
     }
+  return shItemIndexes;
+}
 
-  // Try to find the nodeIndex in the cache first
-  QMap<vtkIdType,QPersistentModelIndex>::iterator rowCacheIt = d->RowCache.find(itemID);
-  if (rowCacheIt==d->RowCache.end())
+//------------------------------------------------------------------------------
+QVariant qMRMLSubjectHierarchyModel::data(const QModelIndex& index, int role)const
+{
+  Q_D(const qMRMLSubjectHierarchyModel);
+  const int column = index.column();
+  if ( !d->SubjectHierarchyNode || !index.isValid() || column < 0
+    || (column != this->visibilityColumn() && column != this->transformColumn() && column != this->colorColumn()) )
     {
-    // Not found in cache, therefore it cannot be in the model
-    return itemIndex;
+    return this->Superclass::data(index, role);
     }
-  if (rowCacheIt.value().isValid())
+  vtkIdType shItemID = this->Superclass::data(index, SubjectHierarchyItemIDRole).toLongLong();
+  if ( !shItemID || shItemID == d->SubjectHierarchyNode->GetSceneItemID()
+    || !d->SubjectHierarchyNode->HasItem(shItemID)
+    || d->SubjectHierarchyNode->GetItemOwnerPluginName(shItemID).empty() )
     {
-    // An entry found in the cache. If the item at the cached index matches the requested item ID then we use it.
-    QStandardItem* item = this->itemFromIndex(rowCacheIt.value());
-    if (item && item->data(qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole).toLongLong() == itemID)
-      {
-      // ID matched
-      itemIndex = rowCacheIt.value();
-      }
+    return this->Superclass::data(index, role);
     }
 
-  // The cache was not up-to-date. Do a slow linear search.
-  if (!itemIndex.isValid())
+  // Visibility column
+  if (column == this->visibilityColumn() && (role == VisibilityRole || role == Qt::DecorationRole))
     {
-    // QAbstractItemModel::match doesn't browse through columns, we need to do it manually
-    QModelIndexList itemIndexes = this->match(
-      this->subjectHierarchySceneIndex(), SubjectHierarchyItemIDRole, itemID, 1, Qt::MatchExactly | Qt::MatchRecursive);
-    if (itemIndexes.size() == 0)
+    qSlicerSubjectHierarchyAbstractPlugin* ownerPlugin =
+      qSlicerSubjectHierarchyPluginHandler::instance()->getOwnerPluginForSubjectHierarchyItem(shItemID);
+    if (!ownerPlugin)
       {
-      d->RowCache.remove(itemID);
-      return QModelIndex();
+      return QVariant();
       }
-    itemIndex = itemIndexes[0];
-    d->RowCache[itemID] = itemIndex;
+    // Have owner plugin give the visibility state and icon
+    int visible = d->displayVisibility(shItemID, ownerPlugin);
+    if (role == VisibilityRole)
+      {
+      return visible;
+      }
+    QIcon visibilityIcon = ownerPlugin->visibilityIcon(visible);
+    if (visibilityIcon.isNull())
+      {
+      return QVariant();
+      }
+    return visibilityIcon;
     }
-  if (column == 0)
+  // Transform column
+  if ( column == this->transformColumn()
+    && (role == TransformIDRole || role == Qt::DecorationRole || role == Qt::ToolTipRole) )
     {
-    // QAbstractItemModel::match only search through the first column
-    return itemIndex;
+    vtkMRMLTransformableNode* transformableNode = vtkMRMLTransformableNode::SafeDownCast(
+      d->SubjectHierarchyNode->GetItemDataNode(shItemID) );
+    if (transformableNode)
+      {
+      vtkMRMLTransformNode* parentTransformNode = transformableNode->GetParentTransformNode();
+      if (role == TransformIDRole)
+        {
+        return QString(parentTransformNode ? parentTransformNode->GetID() : "");
+        }
+      if (role == Qt::ToolTipRole)
+        {
+        return ( parentTransformNode ? tr("%1 (%2)").arg(parentTransformNode->GetName()).arg(parentTransformNode->GetID()) : QString() );
+        }
+      if (!parentTransformNode)
+        {
+        return d->NoTransformIcon;
+        }
+      return (parentTransformNode->IsLinear() ? d->LinearTransformIcon : d->DeformableTransformIcon);
+      }
+    if (role == TransformIDRole)
+      {
+      return QVariant();
+      }
+    // Transform can be applied to the children of folders
+    bool hasChildren = (d->SubjectHierarchyNode->GetNumberOfItemChildren(shItemID) > 0);
+    if (role == Qt::ToolTipRole)
+      {
+      return (hasChildren ? tr("Apply transform to children") : tr("This node is not transformable"));
+      }
+    if (!hasChildren)
+      {
+      return QVariant();
+      }
+    return d->FolderTransformIcon;
     }
-  // Add the QModelIndexes from the other columns
-  const int row = itemIndex.row();
-  QModelIndex nodeParentIndex = itemIndex.parent();
-  if (column >= this->columnCount(nodeParentIndex))
+  // Color column
+  if (column == this->colorColumn() && role == Qt::ToolTipRole)
     {
-    qCritical() << Q_FUNC_INFO << ": Invalid column " << column;
-    return QModelIndex();
+    // Assemble tooltip from the terminology stored in the item
+    vtkSlicerTerminologiesModuleLogic* terminologiesLogic = d->terminologiesModuleLogic();
+    if (!terminologiesLogic)
+      {
+      qCritical() << Q_FUNC_INFO << ": Terminologies module is not found";
+      return QVariant();
+      }
+    vtkSmartPointer<vtkSlicerTerminologyEntry> terminologyEntry = vtkSmartPointer<vtkSlicerTerminologyEntry>::New();
+    terminologiesLogic->DeserializeTerminologyEntry(
+      this->Superclass::data(index, qSlicerTerminologyItemDelegate::TerminologyRole).toString().toUtf8().constData(), terminologyEntry);
+    return QString(terminologiesLogic->GetInfoStringFromTerminologyEntry(terminologyEntry).c_str());
     }
-  return ctk::modelChildIndex(const_cast<qMRMLSubjectHierarchyModel*>(this), nodeParentIndex, row, column);
+  return this->Superclass::data(index, role);
 }
 
 //------------------------------------------------------------------------------
-QModelIndexList qMRMLSubjectHierarchyModel::indexes(vtkIdType itemID)const
+bool qMRMLSubjectHierarchyModel::hasChildren(const QModelIndex& parent)const
+{
+  return this->canFetchMore(parent) || this->Superclass::hasChildren(parent);
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLSubjectHierarchyModel::canFetchMore(const QModelIndex& parent)const
 {
-  QModelIndex scene = this->subjectHierarchySceneIndex();
-  if (scene == QModelIndex())
+  Q_D(const qMRMLSubjectHierarchyModel);
+  // The scene item is always created, and child rows are only added to the first column
+  if (!d->SubjectHierarchyNode || !parent.isValid() || parent.column() != 0)
     {
-    return QModelIndexList();
+    return false;
     }
-  // QAbstractItemModel::match doesn't browse through columns, we need to do it manually
-  QModelIndexList shItemIndexes = this->match(
-    scene, qMRMLSubjectHierarchyModel::SubjectHierarchyItemIDRole, QVariant(qlonglong(itemID)), 1, Qt::MatchExactly | Qt::MatchRecursive);
-  if (shItemIndexes.size() != 1)
+  QStandardItem* parentItem = this->itemFromIndex(parent);
+  vtkIdType parentItemID = this->subjectHierarchyItemFromItem(parentItem);
+  if (!parentItemID || !d->SubjectHierarchyNode->HasItem(parentItemID))
     {
-    return QModelIndexList(); // If 0 it's empty, if >1 it's invalid (one item for each UID)
+    return false;
     }
-  // Add the QModelIndexes from the other columns
-  const int row = shItemIndexes[0].row();
-  QModelIndex shItemParentIndex = shItemIndexes[0].parent();
-  const int sceneColumnCount = this->columnCount(shItemParentIndex);
-  for (int col=1; col<sceneColumnCount; ++col)
+  return ( parentItem->rowCount() - d->extraRowCount(parentItem)
+    < d->SubjectHierarchyNode->GetNumberOfItemChildren(parentItemID) );
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSubjectHierarchyModel::fetchMore(const QModelIndex& parent)
+{
+  Q_D(qMRMLSubjectHierarchyModel);
+  if (d->InsertingRow || !this->canFetchMore(parent))
     {
-    shItemIndexes << this->index(row, col, shItemParentIndex);
+    return;
     }
-  return shItemIndexes;
+  d->fetchSubjectHierarchyChildren(this->itemFromIndex(parent), d->FetchBatchSize);
 }
 
 //------------------------------------------------------------------------------
@@ -721,6 +1004,7 @@ void qMRMLSubjectHierarchyModel::rebuildFromSubjectHierarchy()
   Q_D(qMRMLSubjectHierarchyModel);
 
   d->RowCache.clear();
+  d->VisibilityCache.clear();
 
   // Enabled so it can be interacted with
   this->invisibleRootItem()->setFlags(Qt::ItemIsEnabled);
@@ -796,25 +1080,9 @@ void qMRMLSubjectHierarchyModel::rebuildFromSubjectHierarchy()
     this->subjectHierarchySceneItem()->insertRow(0, items);
     }
 
-  // Populate subject hierarchy with the items
-  std::vector<vtkIdType> allItemIDs;
-  d->SubjectHierarchyNode->GetItemChildren(d->SubjectHierarchyNode->GetSceneItemID(), allItemIDs, true);
-  for (std::vector<vtkIdType>::iterator itemIt=allItemIDs.begin(); itemIt!=allItemIDs.end(); ++itemIt)
-    {
-    vtkIdType itemID = (*itemIt);
-    int index = this->subjectHierarchyItemIndex(itemID);
-    d->insertSubjectHierarchyItem(itemID, index);
-    }
-
-  // Update expanded states (during inserting the update calls did not find valid indices, so
-  // expand and collapse statuses were not set in the tree view)
-  for (std::vector<vtkIdType>::iterator itemIt=allItemIDs.begin(); itemIt!=allItemIDs.end(); ++itemIt)
-    {
-    vtkIdType itemID = (*itemIt);
-    // Expanded states are handled with the name column
-    QStandardItem* item = this->itemFromSubjectHierarchyItem(itemID, this->nameColumn());
-    this->updateItemDataFromSubjectHierarchyItem(item, itemID, this->nameColumn());
-    }
+  // Populate the first rows under the scene. Deeper branches are created when they are fetched
+  // by the views (expanded or scrolled into view), or when the index of an item is requested.
+  d->fetchSubjectHierarchyChildren(this->subjectHierarchySceneItem(), d->FetchBatchSize);
 
   emit subjectHierarchyUpdated();
 }
@@ -850,9 +1118,24 @@ QStandardItem* qMRMLSubjectHierarchyModel::insertSubjectHierarchyItem(vtkIdType
   // model but we don't know its index yet. This is needed because a custom widget may be notified
   // about row insertion before insertRow() returns (and the RowCache entry is added).
   d->RowCache[itemID] = QModelIndex();
+  d->InsertingRow = true;
   parent->insertRow(row, items);
+  d->InsertingRow = false;
   d->RowCache[itemID] = items[0]->index();
 
+  // Set expanded state now that the item has a valid index
+  if (d->SubjectHierarchyNode && this->nameColumn() >= 0)
+    {
+    if (d->SubjectHierarchyNode->GetItemExpanded(itemID))
+      {
+      emit requestExpandItem(itemID);
+      }
+    else
+      {
+      emit requestCollapseItem(itemID);
+      }
+    }
+
   return items[0];
 }
 
@@ -933,20 +1216,15 @@ void qMRMLSubjectHierarchyModel::updateItemFromSubjectHierarchyItem(QStandardIte
   if (this->canBeAChild(shItemID))
     {
     QStandardItem* parentItem = item->parent();
-    QStandardItem* newParentItem = this->itemFromSubjectHierarchyItem(this->parentSubjectHierarchyItem(shItemID));
-    if (!newParentItem)
-      {
-      newParentItem = this->subjectHierarchySceneItem();
-      }
     // If the item has no parent, then it means it hasn't been put into the hierarchy yet and it will do it automatically
-    if (parentItem && parentItem != newParentItem)
+    if (parentItem && parentItem != d->existingItemFromSubjectHierarchyItem(this->parentSubjectHierarchyItem(shItemID)))
       {
-      int newIndex = this->subjectHierarchyItemIndex(shItemID);
-      if (parentItem != newParentItem || newIndex != item->row())
+      // Reparent items. If the branch of the new parent has not been fetched until the item
+      // then it is fetched up to the item, so that the row is kept.
+      QList<QStandardItem*> children = parentItem->takeRow(item->row());
+      if (!d->insertTakenRow(shItemID, children))
         {
-        // Reparent items
-        QList<QStandardItem*> children = parentItem->takeRow(item->row());
-        newParentItem->insertRow(newIndex, children);
+        return;
         }
       }
     }
@@ -1039,14 +1317,18 @@ void qMRMLSubjectHierarchyModel::updateItemDataFromSubjectHierarchyItem(QStandar
       item->setIcon(d->UnknownIcon);
       }
 
-    // Set expanded state (in the name column so that it is only processed once for each item)
-    if (d->SubjectHierarchyNode->GetItemExpanded(shItemID))
-      {
-      emit requestExpandItem(shItemID);
-      }
-    else
+    // Set expanded state (in the name column so that it is only processed once for each item).
+    // Items that are being inserted have no valid index yet, their state is set after insertion.
+    if (item->model() == this)
       {
-      emit requestCollapseItem(shItemID);
+      if (d->SubjectHierarchyNode->GetItemExpanded(shItemID))
+        {
+        emit requestExpandItem(shItemID);
+        }
+      else
+        {
+        emit requestCollapseItem(shItemID);
+        }
       }
     }
   // Description column
@@ -1070,21 +1352,11 @@ void qMRMLSubjectHierarchyModel::updateItemDataFromSubjectHierarchyItem(QStandar
   // Visibility column
   if (column == this->visibilityColumn())
     {
-    // Have owner plugin give the visibility state and icon
-    int visible = ownerPlugin->getDisplayVisibility(shItemID);
-    QIcon visibilityIcon = ownerPlugin->visibilityIcon(visible);
-
-    // It should be fine to set the icon even if it is the same, but due
-    // to a bug in Qt (http://bugreports.qt.nokia.com/browse/QTBUG-20248),
-    // it would fire a superfluous itemChanged() signal.
-    if ( item->data(VisibilityRole).isNull()
-      || item->data(VisibilityRole).toInt() != visible )
+    // Visibility is computed on demand in data(), only let the views know that it may have changed
+    d->VisibilityCache.remove(shItemID);
+    if (item->model() == this)
       {
-      item->setData(visible, VisibilityRole);
-      if (!visibilityIcon.isNull())
-        {
-        item->setIcon(visibilityIcon);
-        }
+      emit dataChanged(item->index(), item->index());
       }
     }
   // Color column
@@ -1115,19 +1387,8 @@ void qMRMLSubjectHierarchyModel::updateItemDataFromSubjectHierarchyItem(QStandar
       item->setData(colorAutoGenerated, qSlicerTerminologyItemDelegate::ColorAutoGeneratedRole);
       }
 
-    // Set item color
+    // Set item color (the tooltip describing the terminology is assembled on demand in data())
     item->setData(color, Qt::DecorationRole);
-
-    // Assemble and set tooltip
-    vtkSlicerTerminologiesModuleLogic* terminologiesLogic = d->terminologiesModuleLogic();
-    if (!terminologiesLogic)
-      {
-      qCritical() << Q_FUNC_INFO << ": Terminologies module is not found";
-      }
-    vtkSmartPointer<vtkSlicerTerminologyEntry> terminologyEntry = vtkSmartPointer<vtkSlicerTerminologyEntry>::New();
-    terminologiesLogic->DeserializeTerminologyEntry(
-      item->data(qSlicerTerminologyItemDelegate::TerminologyRole).toString().toUtf8().constData(), terminologyEntry);
-    item->setToolTip(terminologiesLogic->GetInfoStringFromTerminologyEntry(terminologyEntry).c_str());
     }
   // Transform column
   if (column == this->transformColumn())
@@ -1136,39 +1397,10 @@ void qMRMLSubjectHierarchyModel::updateItemDataFromSubjectHierarchyItem(QStandar
       {
       item->setData("Transform", Qt::WhatsThisRole);
       }
-
-    QIcon icon;
-    vtkMRMLNode* dataNode = d->SubjectHierarchyNode->GetItemDataNode(shItemID);
-    vtkMRMLTransformableNode* transformableNode = vtkMRMLTransformableNode::SafeDownCast(dataNode);
-    if (transformableNode)
-      {
-      icon = d->NoTransformIcon;
-      vtkMRMLTransformNode* parentTransformNode = ( transformableNode->GetParentTransformNode() ? transformableNode->GetParentTransformNode() : nullptr );
-      QString transformNodeId( parentTransformNode ? parentTransformNode->GetID() : "" );
-      QString transformNodeName( parentTransformNode ? parentTransformNode->GetName() : "" );
-      // Only change item if the transform itself changed
-      if (item->data().toString().compare(transformNodeId))
-        {
-        item->setData(transformNodeId, TransformIDRole);
-        item->setToolTip( parentTransformNode ? tr("%1 (%2)").arg(parentTransformNode->GetName()).arg(parentTransformNode->GetID()) : "" );
-        if (parentTransformNode)
-          {
-          icon = (parentTransformNode->IsLinear() ? d->LinearTransformIcon : d->DeformableTransformIcon);
-          }
-        }
-      }
-    else if (d->SubjectHierarchyNode->GetNumberOfItemChildren(shItemID, true))
+    // Transform ID, icon and tooltip are computed on demand in data(), only let the views know that they may have changed
+    if (item->model() == this)
       {
-      icon = d->FolderTransformIcon;
-      item->setToolTip(tr("Apply transform to children"));
-      }
-    else
-      {
-      item->setToolTip(tr("This node is not transformable"));
-      }
-    if (item->icon().cacheKey() != icon.cacheKey()) // Only set if it changed (https://bugreports.qt-project.org/browse/QTBUG-20248)
-      {
-      item->setIcon(icon);
+      emit dataChanged(item->index(), item->index());
       }
     }
 }
@@ -1289,7 +1521,12 @@ void qMRMLSubjectHierarchyModel::updateSubjectHierarchyItemFromItemData(vtkIdTyp
   // Visibility column
   if (item->column() == this->visibilityColumn() && !item->data(VisibilityRole).isNull())
     {
+    // The value set in the item is only a request, the displayed visibility is computed in data().
+    // Clear it so that it is not applied again by a later update of the item.
     int visible = item->data(VisibilityRole).toInt();
+    bool blocked = this->blockSignals(true);
+    item->setData(QVariant(), VisibilityRole);
+    this->blockSignals(blocked);
     if (visible > -1 && visible != ownerPlugin->getDisplayVisibility(shItemID))
       {
       // Have owner plugin set the display visibility
@@ -1325,9 +1562,14 @@ void qMRMLSubjectHierarchyModel::updateSubjectHierarchyItemFromItemData(vtkIdTyp
       }
     }
   // Transform column
-  if (item->column() == this->transformColumn())
+  if (item->column() == this->transformColumn() && item->data(TransformIDRole).isValid())
     {
+    // The value set in the item is only a request, the displayed transform is computed in data().
+    // Clear it so that it is not applied again by a later update of the item.
     QVariant transformIdData = item->data(TransformIDRole);
+    bool blocked = this->blockSignals(true);
+    item->setData(QVariant(), TransformIDRole);
+    this->blockSignals(blocked);
     std::string newParentTransformNodeIdStr = transformIdData.toString().toUtf8().constData();
     vtkMRMLTransformNode* newParentTransformNode =
       vtkMRMLTransformNode::SafeDownCast( d->MRMLScene->GetNodeByID(newParentTransformNodeIdStr) );
@@ -1377,46 +1619,54 @@ void qMRMLSubjectHierarchyModel::updateSubjectHierarchyItemFromItemData(vtkIdTyp
 void qMRMLSubjectHierarchyModel::updateModelItems(vtkIdType itemID)
 {
   Q_D(qMRMLSubjectHierarchyModel);
-  if (d->MRMLScene->IsClosing() || d->MRMLScene->IsBatchProcessing())
+  if (!d->SubjectHierarchyNode || d->MRMLScene->IsClosing() || d->MRMLScene->IsBatchProcessing())
     {
     return;
     }
 
-  QModelIndexList itemIndexes = this->indexes(itemID);
-  if (!itemIndexes.count())
+  QStandardItem* item = d->existingItemFromSubjectHierarchyItem(itemID);
+  if (!item)
     {
-    // Can happen while the item is added, the plugin handler sets the owner plugin, which triggers
+    // The children of a removed item are reparented before the item removed event. Their rows
+    // have been taken from the model, they are inserted back as soon as their new parent is set.
+    for (QList<QList<QStandardItem*> >::iterator orphanIt = d->Orphans.begin(); orphanIt != d->Orphans.end(); ++orphanIt)
+      {
+      if (!orphanIt->at(0)->parent() && this->subjectHierarchyItemFromItem(orphanIt->at(0)) == itemID)
+        {
+        QList<QStandardItem*> orphans = *orphanIt;
+        d->Orphans.erase(orphanIt);
+        d->insertTakenRow(itemID, orphans);
+        return;
+        }
+      }
+    // The row of the item has not been created. If the item has just been moved under a parent
+    // whose branch is fully fetched then the row is created now, otherwise when the branch is fetched.
+    // Can also happen while the item is added, the plugin handler sets the owner plugin, which triggers
     // item modified before it can be inserted to the model
+    if (d->SubjectHierarchyNode->HasItem(itemID) && this->canBeAChild(itemID))
+      {
+      vtkIdType parentItemID = this->parentSubjectHierarchyItem(itemID);
+      QStandardItem* parentItem = d->existingItemFromSubjectHierarchyItem(parentItemID);
+      if ( parentItem && parentItem->rowCount() - d->extraRowCount(parentItem)
+        == d->SubjectHierarchyNode->GetNumberOfItemChildren(parentItemID) - 1 )
+        {
+        this->insertSubjectHierarchyItem(itemID);
+        }
+      }
     return;
     }
 
-  for (int currentIndex=0; currentIndex<itemIndexes.size(); ++currentIndex)
+  const int columnCount = (item->parent() ? item->parent()->columnCount() : this->columnCount());
+  for (int column=0; column<columnCount; ++column)
     {
-    // Note: If this loop is changed to foreach update after reparenting stops working.
-    //   Apparently foreach makes a deep copy of itemIndexes, and as the indices change after the
-    //   first reparenting in the updateItemFromSubjectHierarchyItem for column 0, the old indices
-    //   are being used for the subsequent columns, which yield new items, and reparenting is
-    //   performed on those too. With regular for and [] operator, the updated indices are got,
-    //   so reparenting is only performed once, which is the desired behavior.
-    QModelIndex index = itemIndexes[currentIndex];
-    QStandardItem* item = this->itemFromIndex(index);
-    int oldRow = item->row();
-    QStandardItem* oldParent = item->parent();
-
-    this->updateItemFromSubjectHierarchyItem(item, itemID, item->column());
-
-    // If the item was reparented, then we need to rescan the indexes again as they may be wrong
-    if (item->row() != oldRow || item->parent() != oldParent)
+    // Get the item of each column after the previous one has been updated, as that may have
+    // moved the row (reparenting) or deleted it (item removed meanwhile)
+    item = d->existingItemFromSubjectHierarchyItem(itemID, column);
+    if (!item)
       {
-      int oldSize = itemIndexes.size();
-      itemIndexes = this->indexes(itemID);
-      int newSize = itemIndexes.size();
-      if (oldSize != newSize)
-        {
-        qCritical() << Q_FUNC_INFO << ": Index mismatch";
-        return;
-        }
+      return;
       }
+    this->updateItemFromSubjectHierarchyItem(item, itemID, column);
     }
 }
 
@@ -1497,11 +1747,10 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAboutToBeRemoved(vtkIdTyp
     return;
     }
 
-  QModelIndexList itemIndexes = this->match(
-    this->subjectHierarchySceneIndex(), SubjectHierarchyItemIDRole, itemID, 1, Qt::MatchExactly | Qt::MatchRecursive );
-  if (itemIndexes.count() > 0)
+  d->VisibilityCache.remove(itemID);
+  QStandardItem* item = d->existingItemFromSubjectHierarchyItem(itemID);
+  if (item)
     {
-    QStandardItem* item = this->itemFromIndex(itemIndexes[0].sibling(itemIndexes[0].row(),0));
     // The children may be lost if not reparented, we ensure they got reparented.
     while (item->rowCount())
       {
@@ -1516,8 +1765,10 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemAboutToBeRemoved(vtkIdTyp
         d->Orphans.removeAll(orphans);
         }
       }
-    this->removeRow(itemIndexes[0].row(), itemIndexes[0].parent());
+    QModelIndex itemIndex = item->index();
+    this->removeRow(itemIndex.row(), itemIndex.parent());
     }
+  d->RowCache.remove(itemID);
 }
 
 //------------------------------------------------------------------------------
@@ -1529,7 +1780,7 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemRemoved(vtkIdType removed
     {
     return;
     }
-  // The removed item may have had children, if they haven't been updated, they are likely to be lost
+  // The removed item may have had children, if they haven't been reparented yet, they are likely to be lost
   // (not reachable when browsing the model), we need to reparent them.
   foreach(QList<QStandardItem*> orphans, d->Orphans)
     {
@@ -1539,16 +1790,8 @@ void qMRMLSubjectHierarchyModel::onSubjectHierarchyItemRemoved(vtkIdType removed
       {
       continue;
       }
-    vtkIdType itemID = this->subjectHierarchyItemFromItem(orphan);
-    int newIndex = this->subjectHierarchyItemIndex(itemID);
-    QStandardItem* newParentItem = this->itemFromSubjectHierarchyItem(
-      this->parentSubjectHierarchyItem(itemID) );
-    if (!newParentItem)
-      {
-      newParentItem = this->subjectHierarchySceneItem();
-      }
-    // Reparent orphans
-    newParentItem->insertRow(newIndex, orphans);
+    // Reparent orphans under the row of their new parent (fetched up to the orphan if needed)
+    d->insertTakenRow(this->subjectHierarchyItemFromItem(orphan), orphans);
     }
   d->Orphans.clear();
 }
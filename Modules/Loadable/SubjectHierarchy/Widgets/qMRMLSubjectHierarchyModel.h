@@ -42,9 +42,12 @@ class vtkMRMLScene;
 ///
 /// It is associated to the pseudo-singleton subject hierarchy node, and it creates one model item
 /// for each subject hierarchy item. It handles reparenting, reordering, etc.
-/// The whole model is regenerated when the Modified event is invoked on the subject hierarchy node,
-/// but only the individual items are updated when per-item events are invoked (such as
-/// vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemModifiedEvent)
+/// The rows are created lazily: the children of an item are only created when its branch is
+/// fetched (see canFetchMore() and fetchMore(), called by the views when a branch is expanded or
+/// scrolled into view) or when the index of an item in the branch is requested. Per-item events
+/// (such as vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemModifiedEvent) are applied in place
+/// on the rows that exist. The model is only regenerated after scene import and batch processing.
+/// Visibility and transform column data are computed on demand in data().
 ///
 class Q_SLICER_MODULE_SUBJECTHIERARCHY_WIDGETS_EXPORT qMRMLSubjectHierarchyModel : public QStandardItemModel
 {
@@ -126,6 +129,15 @@ public:
   QString noneDisplay()const;
   void setNoneDisplay(const QString& displayName);
 
+  /// Reimplemented to compute visibility, transform and color tooltip data on demand
+  QVariant data(const QModelIndex& index, int role=Qt::DisplayRole)const override;
+  /// Reimplemented to report children of items whose branch has not been fetched yet
+  bool hasChildren(const QModelIndex& parent=QModelIndex())const override;
+  /// Return true if not all the rows of the children of \a parent have been created
+  bool canFetchMore(const QModelIndex& parent)const override;
+  /// Create the next batch of rows of the children of \a parent
+  void fetchMore(const QModelIndex& parent) override;
+
   Qt::DropActions supportedDropActions()const override;
   QMimeData* mimeData(const QModelIndexList& indexes)const override;
   bool dropMimeData(const QMimeData *data, Qt::DropAction action,
@@ -145,10 +157,13 @@ public:
 
   vtkIdType subjectHierarchyItemFromIndex(const QModelIndex &index)const;
   vtkIdType subjectHierarchyItemFromItem(QStandardItem* item)const;
+  /// Get the model index of a subject hierarchy item. If the row of the item has not been created
+  /// yet then the branches containing it are fetched until it is created.
   QModelIndex indexFromSubjectHierarchyItem(vtkIdType itemID, int column=0)const;
   QStandardItem* itemFromSubjectHierarchyItem(vtkIdType itemID, int column=0)const;
 
-  /// Return all the QModelIndexes (all the columns) for a given subject hierarchy item
+  /// Return all the QModelIndexes (all the columns) for a given subject hierarchy item.
+  /// Like indexFromSubjectHierarchyItem(), it creates the row of the item if needed.
   QModelIndexList indexes(vtkIdType itemID)const;
 
   Q_INVOKABLE virtual vtkIdType parentSubjectHierarchyItem(vtkIdType itemID)const;
@@ -36,7 +36,7 @@
 
 // Qt includes
 #include <QFlags>
-#include <QMap>
+#include <QHash>
 
 // SubjectHierarchy includes
 #include "qSlicerSubjectHierarchyModuleWidgetsExport.h"
@@ -52,6 +52,7 @@
 #include <vtkSmartPointer.h>
 
 class QStandardItemModel;
+class qSlicerSubjectHierarchyAbstractPlugin;
 class vtkSlicerTerminologiesModuleLogic;
 
 //------------------------------------------------------------------------------
@@ -68,19 +69,46 @@ public:
   virtual ~qMRMLSubjectHierarchyModelPrivate();
   void init();
 
-  /// This method is called by qMRMLSubjectHierarchyModel::rebuildFromSubjectHierarchy() to speed up
-  /// the loading. By explicitly specifying the \a index, it skips item lookup within their parents
-  /// happening in qMRMLSubjectHierarchyModel::subjectHierarchyItemIndex(vtkIdType).
+  /// Insert the row of a subject hierarchy item at \a index under the row of its parent.
+  /// The row is only created if the rows of its siblings before \a index have been created
+  /// (i.e. the branch has been fetched until the item), otherwise it is created when the
+  /// branch is fetched. Returns nullptr if the row was not created.
   virtual QStandardItem* insertSubjectHierarchyItem(vtkIdType itemID, int index);
 
+  /// Find the model index of a subject hierarchy item.
+  /// If \a fetch is false then only the rows that have been created so far are considered,
+  /// otherwise the branches containing the item are fetched until the row of the item is created.
+  QModelIndex indexFromSubjectHierarchyItem(vtkIdType itemID, int column, bool fetch)const;
+  /// Get the model item of a subject hierarchy item if its row has been created, nullptr otherwise.
+  /// Does not fetch branches (in contrast to qMRMLSubjectHierarchyModel::itemFromSubjectHierarchyItem).
+  QStandardItem* existingItemFromSubjectHierarchyItem(vtkIdType itemID, int column=0)const;
+
+  /// Create the rows of the children of \a parentItem that have not been created yet, in the order
+  /// of the subject hierarchy. Stops after \a maximumNumberOfRows rows or after the row of
+  /// \a lastItemID has been created.
+  /// \return Number of created rows
+  int fetchSubjectHierarchyChildren(QStandardItem* parentItem, int maximumNumberOfRows, vtkIdType lastItemID=0);
+  /// Number of rows under \a parentItem that do not correspond to subject hierarchy items (None item)
+  int extraRowCount(QStandardItem* parentItem)const;
+  /// Insert a row that has been taken from the model (when moving or orphaning it) under the row
+  /// of the current parent of the subject hierarchy item. The branches containing the parent are
+  /// fetched until the preceding sibling of the item so that the row is kept at its position.
+  /// The row is deleted only if the item no longer exists or a row has already been created for it.
+  /// \return True if the row was inserted, false if it was deleted
+  bool insertTakenRow(vtkIdType itemID, QList<QStandardItem*> row);
+
+  /// Get the display visibility of an item from its owner plugin. The result is cached until the
+  /// visibility column of the item is updated.
+  int displayVisibility(vtkIdType itemID, qSlicerSubjectHierarchyAbstractPlugin* ownerPlugin)const;
+
   /// Convenience function to get name for subject hierarchy item
   QString subjectHierarchyItemName(vtkIdType itemID);
 
   /// Get terminologies module logic. If not found in cache get from module object
-  vtkSlicerTerminologiesModuleLogic* terminologiesModuleLogic();
+  vtkSlicerTerminologiesModuleLogic* terminologiesModuleLogic()const;
 
   /// Get extra item identifier
-  const QString extraItemIdentifier() { return QString("ExtraItem"); };
+  const QString extraItemIdentifier()const { return QString("ExtraItem"); };
 
 public:
   vtkSmartPointer<vtkCallbackCommand> CallBack;
@@ -96,6 +124,11 @@ public:
   bool NoneEnabled;
   QString NoneDisplay;
 
+  /// Maximum number of rows created at once when a branch is expanded or scrolled
+  int FetchBatchSize;
+  /// Set while a row is being inserted, to prevent creating rows from the handlers of the insertion signals
+  bool InsertingRow;
+
   QIcon VisibleIcon;
   QIcon HiddenIcon;
   QIcon PartiallyVisibleIcon;
@@ -129,8 +162,12 @@ public:
   // Map from subject hierarchy item to row.
   // It just stores the result of the latest lookup by \sa indexFromSubjectHierarchyItem,
   // not guaranteed to contain up-to-date information, should be just used as a search hint.
-  // If the item cannot be found at the given index then we need to browse through all model items.
-  mutable QMap<vtkIdType, QPersistentModelIndex> RowCache;
+  // If the item cannot be found at the given index then we need to browse through the rows of its parent.
+  // Items that are not in the cache have not been inserted in the model.
+  mutable QHash<vtkIdType, QPersistentModelIndex> RowCache;
+
+  // Display visibility of the items, computed on demand by qMRMLSubjectHierarchyModel::data()
+  mutable QHash<vtkIdType, int> VisibilityCache;
 };
 
 #endif
@@ -44,6 +44,8 @@
 
 // STD includes
 #include <algorithm>
+#include <map>
+#include <unordered_map>
 
 #include "rapidjson/document.h"     // rapidjson's DOM-style API
 #include "rapidjson/prettywriter.h" // for stringify JSON
@@ -69,10 +71,27 @@ public:
   vtkInternal();
   ~vtkInternal();
 
-  /// Utility function to get code in Json array
+  /// Index of the codes of a Json array. Key is the coding scheme designator and the
+  /// code value, value is the index of the code object in the array.
+  struct CodeIndex
+    {
+    bool Indexed{false};
+    rapidjson::SizeType ArraySize{0};
+    std::unordered_map<std::string, rapidjson::SizeType> ItemIndexes;
+    };
+  /// Utility function to get code in Json array using an index of the codes of the array.
+  /// The index is built at the first lookup, then only the items appended to the
+  /// array since the previous lookup are indexed. It is rebuilt if the array shrinks.
+  /// Items must not be replaced by items with a different code.
   /// \param foundIndex Output parameter for index of found object in input array. -1 if not found
   /// \return Json object if found, otherwise null Json object
-  rapidjson::Value& GetCodeInArray(CodeIdentifier codeId, rapidjson::Value& jsonArray, int &foundIndex);
+  rapidjson::Value& GetCodeInIndexedArray(CodeIdentifier codeId, rapidjson::Value& jsonArray,
+    CodeIndex& codeIndex, int &foundIndex);
+  /// Same as above, using the index stored for the array in \sa CodeIndexes.
+  /// Only to be used on arrays of the loaded contexts.
+  rapidjson::Value& GetCodeInIndexedArray(CodeIdentifier codeId, rapidjson::Value& jsonArray);
+  /// Remove all the indexes, must be called when a loaded context is changed
+  void ClearIndexes();
 
   /// Get root Json value for the terminology with given name
   rapidjson::Value& GetTerminologyRootByName(std::string terminologyName);
@@ -102,6 +121,19 @@ public:
   /// \return Null Json value on failure, the type Json object otherwise
   rapidjson::Value& GetTypeModifierInTerminologyType(std::string terminologyName, CodeIdentifier categoryId, CodeIdentifier typeId, CodeIdentifier modifierId);
 
+  /// Location of a type or type modifier in a terminology
+  struct SlicerLabelLocation
+    {
+    CodeIdentifier CategoryId;
+    CodeIdentifier TypeId;
+    CodeIdentifier TypeModifierId;
+    };
+  /// Collect the types and type modifiers of a terminology by their 3dSlicerLabel
+  /// \param categoryArray Category array of the terminology
+  /// \param slicerLabelIndex Output map of the locations by label
+  void IndexSlicerLabels(std::string terminologyName, rapidjson::Value& categoryArray,
+    std::unordered_map<std::string, SlicerLabelLocation>& slicerLabelIndex);
+
   /// Get root Json value for the anatomic context with given name
   rapidjson::Value& GetAnatomicContextRootByName(std::string anatomicContextName);
 
@@ -138,8 +170,10 @@ public:
   void GetJsonCodeFromIdentifier(rapidjson::Value& code, CodeIdentifier identifier, rapidjson::Document::AllocatorType& allocator);
 
   /// Utility function for safe (memory-leak-free) setting of a document pointer in map
-  static void SetDocumentInTerminologyMap(TerminologyMap& terminologyMap, const std::string& name, rapidjson::Document* doc)
+  void SetDocumentInTerminologyMap(TerminologyMap& terminologyMap, const std::string& name, rapidjson::Document* doc)
     {
+    // The document may have been modified even if it is the same object
+    this->ClearIndexes();
     if (terminologyMap.find(name) != terminologyMap.end())
       {
       if (doc == terminologyMap[name])
@@ -160,8 +194,26 @@ public:
 
   /// Loaded anatomical region contexts. Key is the context name, value is the root item.
   TerminologyMap LoadedAnatomicContexts;
+
+  /// Code indexes of the arrays of the loaded contexts (categories, types, modifiers,
+  /// regions) that have been looked up. Key is the address of the array.
+  std::unordered_map<const rapidjson::Value*, CodeIndex> CodeIndexes;
+
+  /// Types and type modifiers by 3dSlicerLabel, for each terminology that has been
+  /// searched by label. Only the first occurrence of a label is stored.
+  std::map<std::string, std::unordered_map<std::string, SlicerLabelLocation> > SlicerLabelIndexes;
 };
 
+//---------------------------------------------------------------------------
+namespace
+{
+std::string CodeIndexKey(const std::string& codingSchemeDesignator, const std::string& codeValue)
+{
+  // Coding scheme designators don't contain new lines
+  return codingSchemeDesignator + "\n" + codeValue;
+}
+}
+
 //---------------------------------------------------------------------------
 // vtkInternal methods
 
@@ -184,35 +236,68 @@ vtkSlicerTerminologiesModuleLogic::vtkInternal::~vtkInternal()
 }
 
 //---------------------------------------------------------------------------
-rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCodeInArray(CodeIdentifier codeId, rapidjson::Value &jsonArray, int &foundIndex)
+rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCodeInIndexedArray(
+  CodeIdentifier codeId, rapidjson::Value &jsonArray, CodeIndex& codeIndex, int &foundIndex)
 {
+  foundIndex = -1;
   if (!jsonArray.IsArray())
     {
     return JSON_EMPTY_VALUE;
     }
 
-  // Traverse array and try to find the object with given identifier
-  rapidjson::SizeType index = 0;
-  while (index<jsonArray.Size())
+  if (!codeIndex.Indexed || jsonArray.Size() < codeIndex.ArraySize)
+    {
+    codeIndex.ItemIndexes.clear();
+    codeIndex.ArraySize = 0;
+    codeIndex.Indexed = true;
+    }
+  // Index the items that have been appended since the previous lookup
+  for (rapidjson::SizeType index = codeIndex.ArraySize; index < jsonArray.Size(); ++index)
     {
     rapidjson::Value& currentObject = jsonArray[index];
-    if (currentObject.IsObject())
+    if (!currentObject.IsObject())
       {
-      rapidjson::Value& codingSchemeDesignator = currentObject["CodingSchemeDesignator"];
-      rapidjson::Value& codeValue = currentObject["CodeValue"];
-      if ( codingSchemeDesignator.IsString() && !codeId.CodingSchemeDesignator.compare(codingSchemeDesignator.GetString())
-        && codeValue.IsString() && !codeId.CodeValue.compare(codeValue.GetString()) )
-        {
-        foundIndex = index;
-        return currentObject;
-        }
+      continue;
       }
-    ++index;
+    rapidjson::Value::MemberIterator codingSchemeDesignator = currentObject.FindMember("CodingSchemeDesignator");
+    rapidjson::Value::MemberIterator codeValue = currentObject.FindMember("CodeValue");
+    if (codingSchemeDesignator == currentObject.MemberEnd() || !codingSchemeDesignator->value.IsString()
+      || codeValue == currentObject.MemberEnd() || !codeValue->value.IsString())
+      {
+      continue;
+      }
+    // Keep the first occurrence of a code
+    codeIndex.ItemIndexes.insert(std::make_pair(
+      CodeIndexKey(codingSchemeDesignator->value.GetString(), codeValue->value.GetString()), index));
     }
+  codeIndex.ArraySize = jsonArray.Size();
 
-  // Not found
-  foundIndex = -1;
-  return JSON_EMPTY_VALUE;
+  std::unordered_map<std::string, rapidjson::SizeType>::iterator itemIt =
+    codeIndex.ItemIndexes.find(CodeIndexKey(codeId.CodingSchemeDesignator, codeId.CodeValue));
+  if (itemIt == codeIndex.ItemIndexes.end())
+    {
+    return JSON_EMPTY_VALUE;
+    }
+  foundIndex = static_cast<int>(itemIt->second);
+  return jsonArray[itemIt->second];
+}
+
+//---------------------------------------------------------------------------
+rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCodeInIndexedArray(CodeIdentifier codeId, rapidjson::Value &jsonArray)
+{
+  if (!jsonArray.IsArray())
+    {
+    return JSON_EMPTY_VALUE;
+    }
+  int foundIndex = -1;
+  return this->GetCodeInIndexedArray(codeId, jsonArray, this->CodeIndexes[&jsonArray], foundIndex);
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::ClearIndexes()
+{
+  this->CodeIndexes.clear();
+  this->SlicerLabelIndexes.clear();
 }
 
 //---------------------------------------------------------------------------
@@ -271,8 +356,7 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetCategoryInT
     return JSON_EMPTY_VALUE;
     }
 
-  int index = -1;
-  return this->GetCodeInArray(categoryId, categoryArray, index);
+  return this->GetCodeInIndexedArray(categoryId, categoryArray);
 }
 
 //---------------------------------------------------------------------------
@@ -370,8 +454,7 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetTypeInTermi
     return JSON_EMPTY_VALUE;
     }
 
-  int index = -1;
-  return this->GetCodeInArray(typeId, typeArray, index);
+  return this->GetCodeInIndexedArray(typeId, typeArray);
 }
 
 //---------------------------------------------------------------------------
@@ -498,8 +581,7 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetTypeModifie
     return JSON_EMPTY_VALUE;
     }
 
-  int index = -1;
-  return this->GetCodeInArray(modifierId, typeModifierArray, index);
+  return this->GetCodeInIndexedArray(modifierId, typeModifierArray);
 }
 
 //---------------------------------------------------------------------------
@@ -558,8 +640,7 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetRegionInAna
     return JSON_EMPTY_VALUE;
     }
 
-  int index = -1;
-  return this->GetCodeInArray(regionId, regionArray, index);
+  return this->GetCodeInIndexedArray(regionId, regionArray);
 }
 
 //---------------------------------------------------------------------------
@@ -610,8 +691,100 @@ rapidjson::Value& vtkSlicerTerminologiesModuleLogic::vtkInternal::GetRegionModif
     return JSON_EMPTY_VALUE;
     }
 
-  int index = -1;
-  return this->GetCodeInArray(modifierId, regionModifierArray, index);
+  return this->GetCodeInIndexedArray(modifierId, regionModifierArray);
+}
+
+//---------------------------------------------------------------------------
+void vtkSlicerTerminologiesModuleLogic::vtkInternal::IndexSlicerLabels(std::string terminologyName,
+  rapidjson::Value& categoryArray, std::unordered_map<std::string, SlicerLabelLocation>& slicerLabelIndex)
+{
+  // Traverse categories
+  for (rapidjson::SizeType categoryIndex = 0; categoryIndex < categoryArray.Size(); ++categoryIndex)
+    {
+    rapidjson::Value& category = categoryArray[categoryIndex];
+    if (!category.IsObject())
+      {
+      continue;
+      }
+    rapidjson::Value& categoryName = category["CodeMeaning"];
+    rapidjson::Value& categoryCodingSchemeDesignator = category["CodingSchemeDesignator"];
+    rapidjson::Value& categoryCodeValue = category["CodeValue"];
+    if (!categoryName.IsString() || !categoryCodingSchemeDesignator.IsString() || !categoryCodeValue.IsString())
+      {
+      vtkGenericWarningMacro("IndexSlicerLabels: Invalid category in terminology '" << terminologyName << "'");
+      continue;
+      }
+    CodeIdentifier categoryId(categoryCodingSchemeDesignator.GetString(), categoryCodeValue.GetString(), categoryName.GetString());
+    rapidjson::Value::MemberIterator typeArrayIt = category.FindMember("Type");
+    if (typeArrayIt == category.MemberEnd() || !typeArrayIt->value.IsArray())
+      {
+      vtkGenericWarningMacro("IndexSlicerLabels: Failed to find Type array member in category '"
+        << categoryId.CodeMeaning << "' in terminology '" << terminologyName << "'");
+      continue;
+      }
+    rapidjson::Value& typeArray = typeArrayIt->value;
+
+    // Traverse types
+    for (rapidjson::SizeType typeIndex = 0; typeIndex < typeArray.Size(); ++typeIndex)
+      {
+      rapidjson::Value& type = typeArray[typeIndex];
+      if (!type.IsObject())
+        {
+        continue;
+        }
+      rapidjson::Value& typeName = type["CodeMeaning"];
+      rapidjson::Value& typeCodingSchemeDesignator = type["CodingSchemeDesignator"];
+      rapidjson::Value& typeCodeValue = type["CodeValue"];
+      if (!typeName.IsString() || !typeCodingSchemeDesignator.IsString() || !typeCodeValue.IsString())
+        {
+        vtkGenericWarningMacro("IndexSlicerLabels: Invalid type in category '"
+          << categoryId.CodeMeaning << "' in terminology '" << terminologyName << "'");
+        continue;
+        }
+      CodeIdentifier typeId(typeCodingSchemeDesignator.GetString(), typeCodeValue.GetString(), typeName.GetString());
+      rapidjson::Value::MemberIterator slicerLabelIt = type.FindMember("3dSlicerLabel");
+      if (slicerLabelIt != type.MemberEnd() && slicerLabelIt->value.IsString())
+        {
+        // Keep the first occurrence of the label
+        SlicerLabelLocation location;
+        location.CategoryId = categoryId;
+        location.TypeId = typeId;
+        slicerLabelIndex.insert(std::make_pair(std::string(slicerLabelIt->value.GetString()), location));
+        }
+
+      rapidjson::Value::MemberIterator typeModifierArrayIt = type.FindMember("Modifier");
+      if (typeModifierArrayIt == type.MemberEnd() || !typeModifierArrayIt->value.IsArray())
+        {
+        continue;
+        }
+      rapidjson::Value& typeModifierArray = typeModifierArrayIt->value;
+
+      // Traverse type modifiers
+      for (rapidjson::SizeType typeModifierIndex = 0; typeModifierIndex < typeModifierArray.Size(); ++typeModifierIndex)
+        {
+        rapidjson::Value& typeModifier = typeModifierArray[typeModifierIndex];
+        if (!typeModifier.IsObject())
+          {
+          continue;
+          }
+        rapidjson::Value& typeModifierName = typeModifier["CodeMeaning"];
+        rapidjson::Value& typeModifierCodingSchemeDesignator = typeModifier["CodingSchemeDesignator"];
+        rapidjson::Value& typeModifierCodeValue = typeModifier["CodeValue"];
+        rapidjson::Value::MemberIterator modifierSlicerLabelIt = typeModifier.FindMember("3dSlicerLabel");
+        if (!typeModifierName.IsString() || !typeModifierCodingSchemeDesignator.IsString() || !typeModifierCodeValue.IsString()
+          || modifierSlicerLabelIt == typeModifier.MemberEnd() || !modifierSlicerLabelIt->value.IsString())
+          {
+          continue;
+          }
+        SlicerLabelLocation location;
+        location.CategoryId = categoryId;
+        location.TypeId = typeId;
+        location.TypeModifierId = CodeIdentifier(typeModifierCodingSchemeDesignator.GetString(),
+          typeModifierCodeValue.GetString(), typeModifierName.GetString());
+        slicerLabelIndex.insert(std::make_pair(std::string(modifierSlicerLabelIt->value.GetString()), location));
+        }
+      }
+    }
 }
 
 //---------------------------------------------------------------------------
@@ -651,6 +824,12 @@ bool vtkSlicerTerminologiesModuleLogic::vtkInternal::ConvertSegmentationDescript
     categoryArray.SetArray();
     }
 
+  // Indexes of the category array, of the type arrays by category and of the type modifier
+  // arrays by category and type, so that the arrays are not traversed for each segment
+  CodeIndex categoryIndex;
+  std::unordered_map<std::string, CodeIndex> typeIndexes;
+  std::unordered_map<std::string, CodeIndex> typeModifierIndexes;
+
   // Parse segment attributes
   bool entryAdded = false;
   rapidjson::SizeType index = 0;
@@ -680,8 +859,9 @@ bool vtkSlicerTerminologiesModuleLogic::vtkInternal::ConvertSegmentationDescript
     // Get type array if category already exists, create empty otherwise
     vtkSlicerTerminologiesModuleLogic::CodeIdentifier categoryId(
       segmentCategory["CodingSchemeDesignator"].GetString(), segmentCategory["CodeValue"].GetString(), segmentCategory["CodeMeaning"].GetString() );
+    std::string categoryKey = CodeIndexKey(categoryId.CodingSchemeDesignator, categoryId.CodeValue);
     int foundCategoryIndex = -1;
-    rapidjson::Value category(this->GetCodeInArray(categoryId, categoryArray, foundCategoryIndex), allocator);
+    rapidjson::Value category(this->GetCodeInIndexedArray(categoryId, categoryArray, categoryIndex, foundCategoryIndex), allocator);
     rapidjson::Value typeArray;
     if (category.IsObject() && category.HasMember("Type"))
       {
@@ -703,8 +883,9 @@ bool vtkSlicerTerminologiesModuleLogic::vtkInternal::ConvertSegmentationDescript
     // Get type from type array, create empty type if not found
     vtkSlicerTerminologiesModuleLogic::CodeIdentifier typeId(
       segmentType["CodingSchemeDesignator"].GetString(), segmentType["CodeValue"].GetString(), segmentType["CodeMeaning"].GetString() );
+    std::string typeKey = categoryKey + "\n" + CodeIndexKey(typeId.CodingSchemeDesignator, typeId.CodeValue);
     int foundTypeIndex = -1;
-    rapidjson::Value type(this->GetCodeInArray(typeId, typeArray, foundTypeIndex), allocator);
+    rapidjson::Value type(this->GetCodeInIndexedArray(typeId, typeArray, typeIndexes[categoryKey], foundTypeIndex), allocator);
     rapidjson::Value typeModifierArray;
     if (type.IsObject())
       {
@@ -742,7 +923,8 @@ bool vtkSlicerTerminologiesModuleLogic::vtkInternal::ConvertSegmentationDescript
         segmentTypeModifier["CodeValue"].GetString(),
         segmentTypeModifier["CodeMeaning"].GetString() );
       int foundTypeModifierIndex = -1;
-      rapidjson::Value typeModifier(this->GetCodeInArray(typeModifierId, typeModifierArray, foundTypeModifierIndex), allocator);
+      rapidjson::Value typeModifier(this->GetCodeInIndexedArray(
+        typeModifierId, typeModifierArray, typeModifierIndexes[typeKey], foundTypeModifierIndex), allocator);
       // Modifier already exists, nothing to do
       if (typeModifier.IsObject())
         {
@@ -870,6 +1052,11 @@ bool vtkSlicerTerminologiesModuleLogic::vtkInternal::ConvertSegmentationDescript
     regionArray.SetArray();
     }
 
+  // Indexes of the region array and of the region modifier arrays by region,
+  // so that the arrays are not traversed for each segment
+  CodeIndex regionIndex;
+  std::unordered_map<std::string, CodeIndex> regionModifierIndexes;
+
   // Parse segment attributes
   bool entryAdded = false;
   rapidjson::SizeType index = 0;
@@ -896,7 +1083,7 @@ bool vtkSlicerTerminologiesModuleLogic::vtkInternal::ConvertSegmentationDescript
     vtkSlicerTerminologiesModuleLogic::CodeIdentifier regionId(
       segmentRegion["CodingSchemeDesignator"].GetString(), segmentRegion["CodeValue"].GetString(), segmentRegion["CodeMeaning"].GetString() );
     int foundRegionIndex = -1;
-    rapidjson::Value region(this->GetCodeInArray(regionId, regionArray, foundRegionIndex), allocator);
+    rapidjson::Value region(this->GetCodeInIndexedArray(regionId, regionArray, regionIndex, foundRegionIndex), allocator);
     rapidjson::Value regionModifierArray;
     if (region.IsObject())
       {
@@ -921,7 +1108,8 @@ bool vtkSlicerTerminologiesModuleLogic::vtkInternal::ConvertSegmentationDescript
         segmentRegionModifier["CodeValue"].GetString(),
         segmentRegionModifier["CodeMeaning"].GetString() );
       int foundRegionModifierIndex = -1;
-      rapidjson::Value regionModifier(this->GetCodeInArray(regionModifierId, regionModifierArray, foundRegionModifierIndex), allocator);
+      rapidjson::Value regionModifier(this->GetCodeInIndexedArray(regionModifierId, regionModifierArray,
+        regionModifierIndexes[CodeIndexKey(regionId.CodingSchemeDesignator, regionId.CodeValue)], foundRegionModifierIndex), allocator);
       // Modifier already exists, nothing to do
       if (regionModifier.IsObject())
         {
@@ -1063,7 +1251,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadContextFromFile(std::string filePath
     {
     // Store terminology
     std::string contextName = (*jsonRoot)["SegmentationCategoryTypeContextName"].GetString();
-    vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+    this->Internal->SetDocumentInTerminologyMap(
       this->Internal->LoadedTerminologies, contextName, jsonRoot);
     vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
     }
@@ -1071,7 +1259,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadContextFromFile(std::string filePath
     {
     // Store anatomic context
     std::string contextName = (*jsonRoot)["AnatomicContextName"].GetString();
-    vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+    this->Internal->SetDocumentInTerminologyMap(
       this->Internal->LoadedAnatomicContexts, contextName, jsonRoot);
     vtkDebugMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
     }
@@ -1130,7 +1318,7 @@ std::string vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromFile(std::stri
 
   // Store terminology
   std::string contextName = (*terminologyRoot)["SegmentationCategoryTypeContextName"].GetString();
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedTerminologies, contextName, terminologyRoot);
 
   vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
@@ -1171,6 +1359,8 @@ bool vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromSegmentDescriptorFile
     convertedDoc = new rapidjson::Document;
     }
 
+  // The loaded context may be modified by the conversion
+  this->Internal->ClearIndexes();
   bool success = this->Internal->ConvertSegmentationDescriptorToTerminologyContext(descriptorDoc, *convertedDoc, contextName);
   if (!success)
     {
@@ -1180,7 +1370,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadTerminologyFromSegmentDescriptorFile
     }
 
   // Store terminology
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedTerminologies, contextName, convertedDoc );
 
   vtkDebugMacro("Terminology named '" << contextName << "' successfully loaded from file " << filePath);
@@ -1248,7 +1438,7 @@ std::string vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromFile(std::
 
   // Store anatomic context
   std::string contextName = (*anatomicContextRoot)["AnatomicContextName"].GetString();
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedAnatomicContexts, contextName, anatomicContextRoot);
 
   vtkDebugMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
@@ -1289,6 +1479,8 @@ bool vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromSegmentDescriptor
     convertedDoc = new rapidjson::Document;
     }
 
+  // The loaded context may be modified by the conversion
+  this->Internal->ClearIndexes();
   bool success = this->Internal->ConvertSegmentationDescriptorToAnatomicContext(descriptorDoc, *convertedDoc, contextName);
   if (!success)
     {
@@ -1298,7 +1490,7 @@ bool vtkSlicerTerminologiesModuleLogic::LoadAnatomicContextFromSegmentDescriptor
     }
 
   // Store anatomic context
-  vtkSlicerTerminologiesModuleLogic::vtkInternal::SetDocumentInTerminologyMap(
+  this->Internal->SetDocumentInTerminologyMap(
     this->Internal->LoadedAnatomicContexts, contextName, convertedDoc );
 
   vtkDebugMacro("Anatomic context named '" << contextName << "' successfully loaded from file " << filePath);
@@ -2210,125 +2402,33 @@ bool vtkSlicerTerminologiesModuleLogic::FindTypeInTerminologyBy3dSlicerLabel(std
     return false;
     }
 
-  rapidjson::Value& categoryArray = this->Internal->GetCategoryArrayInTerminology(terminologyName);
-  if (categoryArray.IsNull())
+  std::map<std::string, std::unordered_map<std::string, vtkInternal::SlicerLabelLocation> >::iterator labelIndexIt =
+    this->Internal->SlicerLabelIndexes.find(terminologyName);
+  if (labelIndexIt == this->Internal->SlicerLabelIndexes.end())
     {
-    vtkErrorMacro("FindTypeInTerminologyBy3dSlicerLabel: Failed to find terminology '" << terminologyName << "'");
-    return false;
+    rapidjson::Value& categoryArray = this->Internal->GetCategoryArrayInTerminology(terminologyName);
+    if (categoryArray.IsNull())
+      {
+      vtkErrorMacro("FindTypeInTerminologyBy3dSlicerLabel: Failed to find terminology '" << terminologyName << "'");
+      return false;
+      }
+    // Index all the labels of the terminology at once, subsequent searches are lookups
+    labelIndexIt = this->Internal->SlicerLabelIndexes.insert(std::make_pair(
+      terminologyName, std::unordered_map<std::string, vtkInternal::SlicerLabelLocation>())).first;
+    this->Internal->IndexSlicerLabels(terminologyName, categoryArray, labelIndexIt->second);
     }
 
-  bool found = false;
+  std::unordered_map<std::string, vtkInternal::SlicerLabelLocation>::iterator locationIt = labelIndexIt->second.find(slicerLabel);
+  bool found = (locationIt != labelIndexIt->second.end());
   CodeIdentifier foundCategoryId;
   CodeIdentifier foundTypeId;
   CodeIdentifier foundTypeModifierId;
-
-  // Traverse categories
-  rapidjson::SizeType categoryIndex = 0;
-  while (categoryIndex < categoryArray.Size())
+  if (found)
     {
-    rapidjson::Value& category = categoryArray[categoryIndex];
-    if (category.IsObject())
-      {
-      rapidjson::Value& categoryName = category["CodeMeaning"];
-      rapidjson::Value& categoryCodingSchemeDesignator = category["CodingSchemeDesignator"];
-      rapidjson::Value& categoryCodeValue = category["CodeValue"];
-      if (categoryName.IsString() && categoryCodingSchemeDesignator.IsString() && categoryCodeValue.IsString())
-        {
-        CodeIdentifier categoryId(categoryCodingSchemeDesignator.GetString(), categoryCodeValue.GetString(), categoryName.GetString());
-        rapidjson::Value& typeArray = this->Internal->GetTypeArrayInTerminologyCategory(terminologyName, categoryId);
-        if (typeArray.IsNull())
-          {
-          vtkErrorMacro("FindTypeInTerminologyBy3dSlicerLabel: Failed to find category '"
-            << categoryId.CodeMeaning << "' in terminology '" << terminologyName << "'");
-          ++categoryIndex;
-          continue;
-          }
-
-        // Traverse types
-        rapidjson::SizeType typeIndex = 0;
-        while (typeIndex < typeArray.Size())
-          {
-          rapidjson::Value& type = typeArray[typeIndex];
-          if (type.IsObject())
-            {
-            rapidjson::Value& typeName = type["CodeMeaning"];
-            rapidjson::Value& typeCodingSchemeDesignator = type["CodingSchemeDesignator"];
-            rapidjson::Value& typeCodeValue = type["CodeValue"];
-            if (typeName.IsString() && typeCodingSchemeDesignator.IsString() && typeCodeValue.IsString())
-              {
-              CodeIdentifier typeId(typeCodingSchemeDesignator.GetString(), typeCodeValue.GetString(), typeName.GetString());
-              rapidjson::Value::MemberIterator currentSlicerLabelIt = type.FindMember("3dSlicerLabel");
-              if (currentSlicerLabelIt != type.MemberEnd() && !slicerLabel.compare(currentSlicerLabelIt->value.GetString()))
-                {
-                // 3dSlicerLabel found in type
-                found = true;
-                foundCategoryId = categoryId;
-                foundTypeId = typeId;
-                break;
-                }
-
-              rapidjson::Value& typeModifierArray = this->Internal->GetTypeModifierArrayInTerminologyType(terminologyName, categoryId, typeId);
-              if (typeModifierArray.IsNull())
-                {
-                ++typeIndex;
-                continue;
-                }
-
-              // Traverse type modifiers
-              rapidjson::SizeType typeModifierIndex = 0;
-              while (typeModifierIndex < typeModifierArray.Size())
-                {
-                rapidjson::Value& typeModifier = typeModifierArray[typeModifierIndex];
-                if (typeModifier.IsObject())
-                  {
-                  rapidjson::Value& typeModifierName = typeModifier["CodeMeaning"];
-                  rapidjson::Value& typeModifierCodingSchemeDesignator = typeModifier["CodingSchemeDesignator"];
-                  rapidjson::Value& typeModifierCodeValue = typeModifier["CodeValue"];
-                  if (typeModifierName.IsString() && typeModifierCodingSchemeDesignator.IsString() && typeModifierCodeValue.IsString())
-                    {
-                    CodeIdentifier typeModifierId(typeModifierCodingSchemeDesignator.GetString(),
-                      typeModifierCodeValue.GetString(), typeModifierName.GetString());
-                    rapidjson::Value::MemberIterator currentSlicerLabelIt = typeModifier.FindMember("3dSlicerLabel");
-                    if (currentSlicerLabelIt != typeModifier.MemberEnd() && !slicerLabel.compare(currentSlicerLabelIt->value.GetString()))
-                      {
-                      // 3dSlicerLabel found in type modifier
-                      found = true;
-                      foundCategoryId = categoryId;
-                      foundTypeId = typeId;
-                      foundTypeModifierId = typeModifierId;
-                      break;
-                      }
-                    }
-                  }
-                ++typeModifierIndex;
-                } // For all type modifiers
-
-              if (found)
-                {
-                break;
-                }
-              }
-            else
-              {
-              vtkErrorMacro("FindTypeInTerminologyBy3dSlicerLabel: Invalid type '" << typeName.GetString() << "in category '"
-                << categoryId.CodeMeaning << "' in terminology '" << terminologyName << "'");
-              }
-            }
-          ++typeIndex;
-          } // For all types
-
-        if (found)
-          {
-          break;
-          }
-        }
-      else
-        {
-        vtkErrorMacro("FindTypeInTerminologyBy3dSlicerLabel: Invalid category '" << categoryName.GetString() << "' in terminology '" << terminologyName << "'");
-        }
-      }
-    ++categoryIndex;
-    } // For all categories
+    foundCategoryId = locationIt->second.CategoryId;
+    foundTypeId = locationIt->second.TypeId;
+    foundTypeModifierId = locationIt->second.TypeModifierId;
+    }
 
   if (found)
     {
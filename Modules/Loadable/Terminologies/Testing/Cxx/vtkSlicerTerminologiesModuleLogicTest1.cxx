@@ -0,0 +1,114 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Terminologies includes
+#include "vtkSlicerTerminologiesModuleLogic.h"
+#include "vtkSlicerTerminologyCategory.h"
+#include "vtkSlicerTerminologyEntry.h"
+#include "vtkSlicerTerminologyType.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkTestingOutputWindow.h>
+
+//----------------------------------------------------------------------------
+int vtkSlicerTerminologiesModuleLogicTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/input/data" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string inputDir(argv[1]);
+
+  typedef vtkSlicerTerminologiesModuleLogic::CodeIdentifier CodeIdentifier;
+  CodeIdentifier tissueCategoryId("SCT", "85756007", "Tissue");
+  CodeIdentifier tissueTypeId("SCT", "85756007", "Tissue");
+  CodeIdentifier arteryTypeId("SCT", "51114001", "Artery");
+  CodeIdentifier veinTypeId("SCT", "29092000", "Vein");
+  CodeIdentifier rightModifierId("SCT", "24028007", "Right");
+  CodeIdentifier leftModifierId("SCT", "7771000", "Left");
+
+  vtkNew<vtkSlicerTerminologiesModuleLogic> logic;
+  std::string terminologyName = logic->LoadTerminologyFromFile(inputDir + "/TestTerminology.term.json");
+  CHECK_STD_STRING(terminologyName, "Test terminology");
+
+  // Lookup by code
+  vtkNew<vtkSlicerTerminologyCategory> category;
+  CHECK_BOOL(logic->GetCategoryInTerminology(terminologyName, tissueCategoryId, category), true);
+  CHECK_STRING(category->GetCodeMeaning(), "Tissue");
+
+  vtkNew<vtkSlicerTerminologyType> type;
+  CHECK_BOOL(logic->GetTypeInTerminologyCategory(terminologyName, tissueCategoryId, arteryTypeId, type), true);
+  CHECK_STRING(type->GetCodeValue(), "51114001");
+  CHECK_STRING(type->GetSlicerLabel(), "artery");
+  // Second lookup in the same array uses the index built by the first one
+  CHECK_BOOL(logic->GetTypeInTerminologyCategory(terminologyName, tissueCategoryId, tissueTypeId, type), true);
+  CHECK_STRING(type->GetCodeMeaning(), "Tissue");
+
+  vtkNew<vtkSlicerTerminologyType> typeModifier;
+  CHECK_BOOL(logic->GetTypeModifierInTerminologyType(
+    terminologyName, tissueCategoryId, arteryTypeId, rightModifierId, typeModifier), true);
+  CHECK_STRING(typeModifier->GetCodeMeaning(), "Right");
+
+  // Lookup by 3dSlicerLabel
+  vtkNew<vtkSlicerTerminologyEntry> entry;
+  CHECK_BOOL(logic->FindTypeInTerminologyBy3dSlicerLabel(terminologyName, "artery", entry), true);
+  CHECK_STRING(entry->GetCategoryObject()->GetCodeValue(), "85756007");
+  CHECK_STRING(entry->GetTypeObject()->GetCodeValue(), "51114001");
+
+  CHECK_BOOL(logic->FindTypeInTerminologyBy3dSlicerLabel(terminologyName, "right artery", entry), true);
+  CHECK_STRING(entry->GetTypeObject()->GetCodeValue(), "51114001");
+  CHECK_STRING(entry->GetTypeModifierObject()->GetCodeValue(), "24028007");
+
+  // Misses
+  CHECK_BOOL(logic->FindTypeInTerminologyBy3dSlicerLabel(terminologyName, "vein", entry), false);
+
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(logic->GetTypeInTerminologyCategory(terminologyName, tissueCategoryId, veinTypeId, type), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  CHECK_BOOL(logic->GetTypeModifierInTerminologyType(
+    terminologyName, tissueCategoryId, arteryTypeId, leftModifierId, typeModifier), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  // Add types and modifiers to the loaded terminology. The descriptor contains the vein
+  // type twice, so it must be found in the array once it has been appended to it.
+  CHECK_BOOL(logic->LoadTerminologyFromSegmentDescriptorFile(terminologyName, inputDir + "/TestSegmentDescriptor.json"), true);
+  CHECK_INT(logic->GetNumberOfTypesInTerminologyCategory(terminologyName, category), 3);
+  CHECK_INT(logic->GetNumberOfTypeModifiersInTerminologyType(terminologyName, category, entry->GetTypeObject()), 2);
+
+  // Lookups after the arrays have changed
+  CHECK_BOOL(logic->GetTypeInTerminologyCategory(terminologyName, tissueCategoryId, veinTypeId, type), true);
+  CHECK_STRING(type->GetCodeMeaning(), "Vein");
+  CHECK_BOOL(logic->GetTypeInTerminologyCategory(terminologyName, tissueCategoryId, arteryTypeId, type), true);
+  CHECK_STRING(type->GetCodeMeaning(), "Artery");
+  CHECK_BOOL(logic->GetTypeModifierInTerminologyType(
+    terminologyName, tissueCategoryId, arteryTypeId, leftModifierId, typeModifier), true);
+  CHECK_STRING(typeModifier->GetCodeMeaning(), "Left");
+  CHECK_BOOL(logic->GetTypeModifierInTerminologyType(
+    terminologyName, tissueCategoryId, arteryTypeId, rightModifierId, typeModifier), true);
+  CHECK_STRING(typeModifier->GetCodeMeaning(), "Right");
+  CHECK_BOOL(logic->FindTypeInTerminologyBy3dSlicerLabel(terminologyName, "right artery", entry), true);
+  CHECK_STRING(entry->GetTypeModifierObject()->GetCodeValue(), "24028007");
+
+  return EXIT_SUCCESS;
+}
@@ -29,6 +29,7 @@
 #include <vtkCacheManager.h>
 #include <vtkMRMLColorNode.h>
 #include <vtkMRMLLabelMapVolumeDisplayNode.h>
+#include <vtkMRMLScalarVolumeDisplayNode.h>
 #include <vtkMRMLScene.h>
 #include <vtkMRMLViewNode.h>
 #include <vtkMRMLVectorVolumeDisplayNode.h>
@@ -44,6 +45,7 @@
 // VTK includes
 #include <vtkColorTransferFunction.h>
 #include <vtkImageData.h>
+#include <vtkImageHistogramStatistics.h>
 #include <vtkLookupTable.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
@@ -59,6 +61,42 @@
 // STD includes
 #include <algorithm>
 
+namespace
+{
+//----------------------------------------------------------------------------
+/// Get scalar range of a single-component volume from the histogram that is
+/// cached by its scalar volume display node (also used for automatic
+/// window/level), to avoid scanning all the voxels again.
+/// Falls back to the scalar range of the image data, which is also used if
+/// the histogram is computed from sampled voxels because sampling may miss
+/// the minimum and maximum.
+bool GetVolumeScalarRange(vtkMRMLVolumeNode* volumeNode, double range[2])
+{
+  vtkImageData* imageData = volumeNode ? volumeNode->GetImageData() : nullptr;
+  if (!imageData || !imageData->GetPointData() || !imageData->GetPointData()->GetScalars())
+  {
+    return false;
+  }
+  vtkMRMLScalarVolumeDisplayNode* displayNode = vtkMRMLScalarVolumeDisplayNode::SafeDownCast(volumeNode->GetDisplayNode());
+  vtkImageHistogramStatistics* histogramStatistics = nullptr;
+  if (displayNode && displayNode->GetHistogramSamplingStride() == 1
+    && imageData->GetNumberOfScalarComponents() == 1)
+  {
+    histogramStatistics = displayNode->GetHistogramStatistics();
+  }
+  if (histogramStatistics)
+  {
+    range[0] = histogramStatistics->GetMinimum();
+    range[1] = histogramStatistics->GetMaximum();
+  }
+  else
+  {
+    imageData->GetPointData()->GetScalars()->GetRange(range);
+  }
+  return true;
+}
+}
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerVolumeRenderingLogic);
 
@@ -410,9 +448,8 @@ void vtkSlicerVolumeRenderingLogic::UpdateTranferFunctionRangeFromImage(vtkMRMLV
   {
     return;
   }
-  vtkImageData *input = vtkMRMLScalarVolumeNode::SafeDownCast(vspNode->GetVolumeNode())->GetImageData();
   vtkVolumeProperty *prop = vspNode->GetVolumePropertyNode()->GetVolumeProperty();
-  if (input == nullptr || prop == nullptr)
+  if (prop == nullptr)
   {
     return;
   }
@@ -420,14 +457,11 @@ void vtkSlicerVolumeRenderingLogic::UpdateTranferFunctionRangeFromImage(vtkMRMLV
   //update scalar range
   vtkColorTransferFunction *functionColor = prop->GetRGBTransferFunction();
 
-  vtkDataArray* scalars = input->GetPointData()->GetScalars();
-  if (!scalars)
+  double rangeNew[2];
+  if (!GetVolumeScalarRange(vspNode->GetVolumeNode(), rangeNew))
   {
     return;
   }
-
-  double rangeNew[2];
-  scalars->GetRange(rangeNew);
   functionColor->AdjustRange(rangeNew);
   vtkDebugMacro("Color range: "<< functionColor->GetRange()[0] << " " << functionColor->GetRange()[1]);
 
@@ -1478,7 +1512,8 @@ bool vtkSlicerVolumeRenderingLogic::SetRecommendedVolumeRenderingProperties(vtkM
     return false;
   }
 
-  double* scalarRange = volumeNode->GetImageData()->GetScalarRange();
+  double scalarRange[2] = { 0.0, 0.0 };
+  GetVolumeScalarRange(volumeNode, scalarRange);
   double scalarRangeSize = scalarRange[1] - scalarRange[0];
 
   if (volumeNode->GetImageData()->GetScalarType() == VTK_UNSIGNED_CHAR)
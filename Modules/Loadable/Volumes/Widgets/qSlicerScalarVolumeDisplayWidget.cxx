@@ -22,8 +22,10 @@
 #include <vtkAlgorithmOutput.h>
 #include <vtkColorTransferFunction.h>
 #include <vtkImageData.h>
+#include <vtkImageHistogramStatistics.h>
 #include <vtkPointData.h>
 #include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
 
 // Qt includes
 #include <QDebug>
@@ -35,6 +37,7 @@
 #include "vtkSlicerVolumesLogic.h"
 
 // STD includes
+#include <algorithm>
 #include <limits>
 
 //-----------------------------------------------------------------------------
@@ -52,6 +55,10 @@ public:
 
   ctkVTKHistogram* Histogram;
   vtkSmartPointer<vtkColorTransferFunction> ColorTransferFunction;
+  /// Image, voxel values and their modified time that the histogram was last built from
+  vtkWeakPointer<vtkImageData> HistogramImageData;
+  vtkWeakPointer<vtkDataArray> HistogramVoxelValues;
+  vtkMTimeType HistogramMTime;
 };
 
 //-----------------------------------------------------------------------------
@@ -61,6 +68,7 @@ qSlicerScalarVolumeDisplayWidgetPrivate::qSlicerScalarVolumeDisplayWidgetPrivate
 {
   this->Histogram = new ctkVTKHistogram();
   this->ColorTransferFunction = vtkSmartPointer<vtkColorTransferFunction>::New();
+  this->HistogramMTime = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -247,6 +255,17 @@ void qSlicerScalarVolumeDisplayWidget::updateHistogram()
   vtkImageData* imageData = volumeNode ? volumeNode->GetImageData() : nullptr;
   vtkPointData* pointData = imageData ? imageData->GetPointData() : nullptr;
   vtkDataArray* voxelValues = pointData ? pointData->GetScalars() : nullptr;
+  // Use the voxels of the histogram that the display node computes for
+  // automatic window/level. They are only updated when the image changes and
+  // they are subsampled if the display node's histogram sampling stride is set.
+  vtkMRMLScalarVolumeDisplayNode* histogramDisplayNode = this->volumeDisplayNode();
+  vtkImageHistogramStatistics* histogramStatistics = nullptr;
+  if (voxelValues && voxelValues->GetNumberOfComponents() == 1 && histogramDisplayNode
+    && histogramDisplayNode->GetHistogramScalars())
+    {
+    voxelValues = histogramDisplayNode->GetHistogramScalars();
+    histogramStatistics = histogramDisplayNode->GetHistogramStatistics();
+    }
 
   // If there are no voxel values then we completely hide the histogram section
   d->HistogramGroupBox->setVisible(voxelValues != nullptr);
@@ -259,33 +278,58 @@ void qSlicerScalarVolumeDisplayWidget::updateHistogram()
   if (!voxelValues || !this->isVisible() || d->HistogramGroupBox->collapsed())
     {
     d->ColorTransferFunction->RemoveAllPoints();
+    d->HistogramImageData = nullptr;
+    d->HistogramVoxelValues = nullptr;
     return;
     }
 
-  // Update histogram
-
-  // Screen resolution is limited, therefore it does not make sense to compute
-  // many bin counts.
-  const int maxBinCount = 1000;
-  if (voxelValues->GetDataType() == VTK_FLOAT || voxelValues->GetDataType() == VTK_DOUBLE)
-    {
-    d->Histogram->setNumberOfBins(maxBinCount);
-    }
-  else
+  // Update histogram (only if the image or the voxel values have changed since the last build).
+  // The content of the image may be modified without modifying the sampled voxel values array.
+  vtkMTimeType histogramMTime = std::max(std::max(imageData->GetMTime(), pointData->GetScalars()->GetMTime()),
+    voxelValues->GetMTime());
+  if (imageData != d->HistogramImageData || voxelValues != d->HistogramVoxelValues
+    || histogramMTime != d->HistogramMTime)
     {
-    double* range = voxelValues->GetRange();
-    int binCount = static_cast<int>(range[1] - range[0] + 1);
-    if (binCount > maxBinCount)
+    // Screen resolution is limited, therefore it does not make sense to compute
+    // many bin counts.
+    const int maxBinCount = 1000;
+    if (voxelValues->GetDataType() == VTK_FLOAT || voxelValues->GetDataType() == VTK_DOUBLE)
       {
-      binCount = maxBinCount;
+      d->Histogram->setNumberOfBins(maxBinCount);
       }
-    if (binCount < 1)
+    else
       {
-      binCount = 1;
+      double range[2] = { 0.0, 0.0 };
+      if (histogramStatistics && histogramDisplayNode->GetHistogramSamplingStride() > 1)
+        {
+        // Sampling may miss the minimum and maximum, use the range of all voxels
+        imageData->GetScalarRange(range);
+        }
+      else if (histogramStatistics)
+        {
+        range[0] = histogramStatistics->GetMinimum();
+        range[1] = histogramStatistics->GetMaximum();
+        }
+      else
+        {
+        voxelValues->GetRange(range);
+        }
+      int binCount = static_cast<int>(range[1] - range[0] + 1);
+      if (binCount > maxBinCount)
+        {
+        binCount = maxBinCount;
+        }
+      if (binCount < 1)
+        {
+        binCount = 1;
+        }
+      d->Histogram->setNumberOfBins(binCount);
       }
-    d->Histogram->setNumberOfBins(binCount);
+    d->Histogram->build();
     }
-  d->Histogram->build();
+  d->HistogramImageData = imageData;
+  d->HistogramVoxelValues = voxelValues;
+  d->HistogramMTime = histogramMTime;
 
   // Update histogram background
 